@@ -0,0 +1,78 @@
+#include "GltfLoader.hpp"
+#include "ObjParser.hpp"
+#include "TangentSpace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+/**
+ * Загрузка одной и той же модели из OBJ и из GLB: OBJ разбирается ObjParser
+ * и получает нормали и касательные, как в loadModel(), затем та же сетка
+ * сохраняется в .glb и читается GltfLoader в заранее выделенные массивы
+ * (в приложении на их месте staging-буферы). Время — лучшее из нескольких запусков.
+ *
+ * Запуск: ModelLoadBenchmark [model.obj] [запусков]
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string modelPath = argc > 1 ? argv[1] : "model/viking.obj";
+    const int runs = argc > 2 ? std::max(1, std::stoi(argv[2])) : 5;
+
+    try {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        double objTime = 1e30;
+        for (int run = 0; run < runs; ++run) {
+            vertices.clear();
+            indices.clear();
+            const auto start = Clock::now();
+            ObjParser().load(modelPath, vertices, indices);
+            if (!TangentSpace::hasNormals(vertices)) {
+                TangentSpace::generateNormals(vertices, indices);
+            }
+            TangentSpace::generateTangents(vertices, indices);
+            objTime = std::min(objTime, milliseconds(start));
+        }
+
+        const std::string glbPath = (std::filesystem::temp_directory_path() / "ModelLoadBenchmark.glb").string();
+        GltfLoader::writeGlb(glbPath, vertices, indices);
+
+        std::vector<Vertex> staging(vertices.size());
+        std::vector<uint32_t> stagingIndices(indices.size());
+        double glbTime = 1e30;
+        double parseTime = 0.0;
+        for (int run = 0; run < runs; ++run) {
+            const auto start = Clock::now();
+            GltfLoader gltf(glbPath);
+            gltf.writeVertices(staging.data());
+            gltf.writeIndices(stagingIndices.data());
+            const double elapsed = milliseconds(start);
+            if (elapsed < glbTime) {
+                glbTime = elapsed;
+                parseTime = gltf.getStats().parseSeconds * 1000.0;
+            }
+        }
+
+        const double objSize = std::filesystem::file_size(modelPath) / (1024.0 * 1024.0);
+        const double glbSize = std::filesystem::file_size(glbPath) / (1024.0 * 1024.0);
+        std::cout << modelPath << ": " << vertices.size() << " vertices, " << indices.size() / 3 << " triangles\n"
+                  << "  OBJ: " << objSize << " MB, parse + normals/tangents " << objTime << " ms\n"
+                  << "  GLB: " << glbSize << " MB, load " << glbTime << " ms (JSON and accessors " << parseTime
+                  << " ms), x" << objTime / glbTime << " faster\n";
+        std::filesystem::remove(glbPath);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+#include "ObjParser.hpp"
+#include "PackedVertex.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+/**
+ * Сжатие вершин в PackedVertex: скалярный эталон против SIMD-ядра, объём
+ * вершинного буфера до и после и ошибка восстановления позиций.
+ *
+ * Запуск: PackBenchmark [model.obj] [число вершин синтетической сетки]
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void run(const std::string& name, const std::vector<Vertex>& vertices) {
+        const VertexQuantization quantization = VertexPacking::computeQuantization(vertices.data(), vertices.size());
+        std::vector<PackedVertex> scalar(vertices.size()), simd(vertices.size());
+
+        auto start = Clock::now();
+        VertexPacking::encodeScalar(vertices.data(), vertices.size(), quantization, scalar.data());
+        const double scalarTime = milliseconds(start);
+
+        start = Clock::now();
+        VertexPacking::encode(vertices.data(), vertices.size(), quantization, simd.data());
+        const double simdTime = milliseconds(start);
+
+        float maxError = 0.0f;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            maxError = std::max(maxError, glm::length(VertexPacking::decode(simd[i], quantization).pos - vertices[i].pos));
+        }
+
+        const double fullMB = vertices.size() * sizeof(Vertex) / (1024.0 * 1024.0);
+        const double packedMB = vertices.size() * sizeof(PackedVertex) / (1024.0 * 1024.0);
+        std::cout << name << ": " << vertices.size() << " vertices, " << fullMB << " MB -> " << packedMB
+                  << " MB (" << 100.0 * packedMB / fullMB << "%)\n"
+                  << "  scalar encode: " << scalarTime << " ms\n"
+                  << "  SIMD encode:   " << simdTime << " ms (x" << scalarTime / simdTime << ")\n"
+                  << "  max position error: " << maxError << "\n";
+        if (std::memcmp(scalar.data(), simd.data(), simd.size() * sizeof(PackedVertex)) != 0) {
+            std::cout << "  MISMATCH: SIMD and scalar encodings differ\n";
+        }
+    }
+
+    std::vector<Vertex> gridVertices(size_t count) {
+        const size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(count))) + 1;
+        std::vector<Vertex> vertices;
+        vertices.reserve(side * side);
+        for (size_t y = 0; y < side; ++y) {
+            for (size_t x = 0; x < side; ++x) {
+                Vertex vertex{};
+                const float u = static_cast<float>(x) / static_cast<float>(side);
+                const float v = static_cast<float>(y) / static_cast<float>(side);
+                vertex.pos = {u * 10.0f, std::sin(u * 20.0f) * std::cos(v * 20.0f), v * 10.0f};
+                vertex.color = {1.0f, 1.0f, 1.0f};
+                vertex.texCoord = {u, v};
+                vertex.normal = glm::normalize(glm::vec3(-std::cos(u * 20.0f), 1.0f, std::sin(v * 20.0f)));
+                vertices.push_back(vertex);
+            }
+        }
+        return vertices;
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string modelPath = argc > 1 ? argv[1] : "model/viking.obj";
+    const size_t syntheticVertices = argc > 2 ? std::stoull(argv[2]) : 4000000;
+
+    try {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        ObjParser().load(modelPath, vertices, indices);
+        run(modelPath, vertices);
+
+        run("synthetic grid", gridVertices(syntheticVertices));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
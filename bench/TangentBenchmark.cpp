@@ -0,0 +1,96 @@
+#include "ObjParser.hpp"
+#include "Parallel.hpp"
+#include "TangentSpace.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+/**
+ * Генерация нормалей и касательных TangentSpace на 1..N потоках: модель и
+ * синтетическая сетка (по умолчанию 20 млн треугольников, около 1.3 ГБ памяти).
+ *
+ * Запуск: TangentBenchmark [model.obj] [число треугольников синтетической сетки] [N]
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void run(const std::string& name, const std::vector<Vertex>& source, const std::vector<uint32_t>& indices,
+             unsigned maxThreads) {
+        const size_t triangleCount = indices.size() / 3;
+        std::cout << name << ": " << source.size() << " vertices, " << triangleCount << " triangles\n";
+
+        std::vector<Vertex> vertices;
+        double singleThreaded = 0.0;
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            vertices = source;
+            const auto normalStart = Clock::now();
+            TangentSpace::generateNormals(vertices, indices, threads);
+            const double normalTime = milliseconds(normalStart);
+
+            std::vector<uint32_t> splitIndices = indices; // Швы зеркальной UV переводят индексы на копии вершин
+            const auto tangentStart = Clock::now();
+            TangentSpace::generateTangents(vertices, splitIndices, threads);
+            const double tangentTime = milliseconds(tangentStart);
+
+            const double total = normalTime + tangentTime;
+            if (threads == 1) {
+                singleThreaded = total;
+            }
+            std::cout << "  x" << threads << ": normals " << normalTime << " ms, tangents " << tangentTime
+                      << " ms, " << triangleCount / (total * 1000.0) << " Mtri/s (x" << singleThreaded / total << ")\n";
+        }
+    }
+
+    // Волнистая сетка: каждая внутренняя вершина входит в шесть треугольников
+    void makeGrid(size_t triangleCount, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        const size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(triangleCount) / 2.0)) + 1;
+        vertices.resize((side + 1) * (side + 1));
+        for (size_t y = 0; y <= side; ++y) {
+            for (size_t x = 0; x <= side; ++x) {
+                Vertex& vertex = vertices[y * (side + 1) + x];
+                const float u = static_cast<float>(x) / static_cast<float>(side);
+                const float v = static_cast<float>(y) / static_cast<float>(side);
+                vertex = Vertex{};
+                vertex.pos = {u * 10.0f, std::sin(u * 20.0f) * std::cos(v * 20.0f), v * 10.0f};
+                vertex.color = {1.0f, 1.0f, 1.0f};
+                vertex.texCoord = {u, v};
+            }
+        }
+
+        indices.clear();
+        indices.reserve(side * side * 6);
+        for (size_t y = 0; y < side; ++y) {
+            for (size_t x = 0; x < side; ++x) {
+                const uint32_t v = static_cast<uint32_t>(y * (side + 1) + x);
+                const uint32_t below = static_cast<uint32_t>(v + side + 1);
+                indices.insert(indices.end(), {v, v + 1, below + 1, v, below + 1, below});
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string modelPath = argc > 1 ? argv[1] : "model/viking.obj";
+    const size_t syntheticTriangles = argc > 2 ? std::stoull(argv[2]) : 20000000;
+    const unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : Parallel::workerCount();
+
+    try {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        ObjParser().load(modelPath, vertices, indices);
+        run(modelPath, vertices, indices, maxThreads);
+
+        makeGrid(syntheticTriangles, vertices, indices);
+        run("synthetic grid", vertices, indices, maxThreads);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+#include "ObjParser.hpp"
+#include "Parallel.hpp"
+#include "VertexWelder.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Сравнение устранения дубликатов на одних и тех же углах граней: прежний
+ * std::unordered_map<Vertex, uint32_t> (count() + operator[]) против VertexWelder
+ * и параллельной склейкой VertexWelder::weldAll() на 1..N потоках.
+ *
+ * Запуск: WeldBenchmark [model.obj] [число углов синтетической сетки] [N]
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double weldWithUnorderedMap(const std::vector<Vertex>& corners, size_t& uniqueCount) {
+        const auto start = Clock::now();
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        indices.reserve(corners.size());
+        std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+        for (const Vertex& vertex : corners) {
+            if (uniqueVertices.count(vertex) == 0) {
+                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(vertex);
+            }
+            indices.push_back(uniqueVertices[vertex]);
+        }
+        uniqueCount = vertices.size();
+        return milliseconds(start);
+    }
+
+    double weldWithWelder(const std::vector<Vertex>& corners, size_t estimate, size_t& uniqueCount) {
+        const auto start = Clock::now();
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        indices.reserve(corners.size());
+        VertexWelder welder(vertices, estimate);
+        for (const Vertex& vertex : corners) {
+            indices.push_back(welder.weld(vertex));
+        }
+        uniqueCount = vertices.size();
+        return milliseconds(start);
+    }
+
+    double weldAll(const std::vector<Vertex>& corners, unsigned threads, size_t& uniqueCount) {
+        const auto start = Clock::now();
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        VertexWelder::weldAll(corners, vertices, indices, 0.0f, threads);
+        uniqueCount = vertices.size();
+        return milliseconds(start);
+    }
+
+    void run(const std::string& name, const std::vector<Vertex>& corners, size_t estimate, unsigned maxThreads) {
+        size_t mapUnique = 0;
+        size_t welderUnique = 0;
+        const double mapTime = weldWithUnorderedMap(corners, mapUnique);
+        const double welderTime = weldWithWelder(corners, estimate, welderUnique);
+
+        std::cout << name << ": " << corners.size() << " corners -> " << welderUnique << " vertices\n"
+                  << "  unordered_map: " << mapTime << " ms\n"
+                  << "  VertexWelder:  " << welderTime << " ms (x" << mapTime / welderTime << ")\n";
+        if (mapUnique != welderUnique) {
+            std::cout << "  MISMATCH: unordered_map produced " << mapUnique << " vertices\n";
+        }
+
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            size_t parallelUnique = 0;
+            const double parallelTime = weldAll(corners, threads, parallelUnique);
+            std::cout << "  weldAll x" << threads << ":  " << parallelTime << " ms (x" << mapTime / parallelTime << ")\n";
+            if (parallelUnique != welderUnique) {
+                std::cout << "  MISMATCH: weldAll produced " << parallelUnique << " vertices\n";
+            }
+        }
+    }
+
+    // Развёртывает проиндексированную модель обратно в поток углов
+    std::vector<Vertex> modelCorners(const std::string& path, size_t& uniqueCount) {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        ObjParser().load(path, vertices, indices);
+        uniqueCount = vertices.size();
+
+        std::vector<Vertex> corners;
+        corners.reserve(indices.size());
+        for (uint32_t index : indices) {
+            corners.push_back(vertices[index]);
+        }
+        return corners;
+    }
+
+    // Регулярная сетка: каждая внутренняя вершина входит в шесть треугольников
+    std::vector<Vertex> gridCorners(size_t cornerCount, size_t& uniqueCount) {
+        const size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(cornerCount) / 6.0)) + 1;
+        uniqueCount = (side + 1) * (side + 1);
+
+        auto gridVertex = [side](size_t x, size_t y) {
+            Vertex vertex{};
+            const float u = static_cast<float>(x) / static_cast<float>(side);
+            const float v = static_cast<float>(y) / static_cast<float>(side);
+            vertex.pos = {u * 10.0f, std::sin(u * 20.0f) * std::cos(v * 20.0f), v * 10.0f};
+            vertex.color = {1.0f, 1.0f, 1.0f};
+            vertex.texCoord = {u, v};
+            return vertex;
+        };
+
+        std::vector<Vertex> corners;
+        corners.reserve(side * side * 6);
+        for (size_t y = 0; y < side; ++y) {
+            for (size_t x = 0; x < side; ++x) {
+                corners.push_back(gridVertex(x, y));
+                corners.push_back(gridVertex(x + 1, y));
+                corners.push_back(gridVertex(x + 1, y + 1));
+                corners.push_back(gridVertex(x, y));
+                corners.push_back(gridVertex(x + 1, y + 1));
+                corners.push_back(gridVertex(x, y + 1));
+            }
+        }
+        return corners;
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string modelPath = argc > 1 ? argv[1] : "model/viking.obj";
+    const size_t syntheticCorners = argc > 2 ? std::stoull(argv[2]) : 10000000;
+    const unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : Parallel::workerCount();
+
+    try {
+        size_t estimate = 0;
+        const std::vector<Vertex> model = modelCorners(modelPath, estimate);
+        run(modelPath, model, estimate, maxThreads);
+
+        const std::vector<Vertex> grid = gridCorners(syntheticCorners, estimate);
+        run("synthetic grid", grid, estimate, maxThreads);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,6 +1,11 @@
 #version 450
 
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D texSampler; // Текстура материала
+
+// Смещение 48: первые байты блока занимают параметры квантования вершинного шейдера
+layout(push_constant) uniform MaterialConstants {
+    layout(offset = 48) vec4 diffuse; // Kd материала
+} material;
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
@@ -8,5 +13,5 @@ layout(location = 1) in vec2 fragTexCoord;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = texture(texSampler, fragTexCoord);
+    outColor = texture(texSampler, fragTexCoord) * material.diffuse * vec4(fragColor, 1.0); // Цвет вершины: белый у OBJ, свой у PLY
 }
\ No newline at end of file
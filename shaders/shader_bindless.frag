@@ -0,0 +1,20 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Все текстуры в одном массиве; заполнены только первые элементы (PipelineManager::isBindless)
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+// Смещение 48: первые байты блока занимают параметры квантования вершинного шейдера
+layout(push_constant) uniform MaterialConstants {
+    layout(offset = 48) vec4 diffuse; // Kd материала
+    uint textureIndex;                // Номер текстуры материала; одинаков для всего вызова отрисовки
+} material;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = texture(textures[material.textureIndex], fragTexCoord) * material.diffuse * vec4(fragColor, 1.0);
+}
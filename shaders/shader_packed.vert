@@ -0,0 +1,38 @@
+#version 450
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// Параметры восстановления сжатых вершин (VertexQuantization)
+layout(push_constant) uniform VertexQuantization {
+    vec4 positionScale;
+    vec4 positionOffset;
+    vec4 texCoordScaleOffset;
+} quantization;
+
+layout(location = 0) in vec4 inPosition; // unorm16 относительно габаритов сетки
+layout(location = 1) in vec2 inNormal;   // октаэдрическая развёртка, snorm16
+layout(location = 2) in vec2 inTexCoord; // unorm16 относительно диапазона UV
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNormal;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float fold = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -fold : fold;
+    n.y += n.y >= 0.0 ? -fold : fold;
+    return normalize(n);
+}
+
+void main() {
+    vec3 position = quantization.positionOffset.xyz + inPosition.xyz * quantization.positionScale.xyz;
+    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(position, 1.0);
+    fragColor = vec3(1.0); // Упаковываются только сетки без цветов вершин
+    fragTexCoord = quantization.texCoordScaleOffset.zw + inTexCoord * quantization.texCoordScaleOffset.xy;
+    fragNormal = mat3(ubo.model) * octDecode(inNormal);
+}
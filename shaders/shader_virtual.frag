@@ -0,0 +1,74 @@
+#version 450
+
+// Виртуальная текстура (VirtualTextureStreamer): тексели берутся из атласа резидентных страниц
+layout(set = 1, binding = 0) uniform sampler2D pageAtlas;
+
+// Раскладка совпадает с VirtualTextureStreamer::PageTableHeader, за ним — PageTable::Entry на каждую страницу
+layout(std430, set = 1, binding = 1) readonly buffer PageTable {
+    uint width;
+    uint height;
+    uint tileSize;
+    uint border;
+    uint atlasPages;
+    uint levelCount;
+    uint frame;
+    uint padding;
+    uvec4 levels[16]; // Первая запись уровня, страниц по x и по y
+    uvec2 entries[];  // Слот | уровень << 24 и x | y << 16 резидентной страницы или её предка
+} pageTable;
+
+// Метка кадра, в котором страница была нужна; читает VirtualTextureStreamer::update()
+layout(std430, set = 1, binding = 2) writeonly buffer Feedback {
+    uint requested[];
+} feedback;
+
+// Смещение 48: первые байты блока занимают параметры квантования вершинного шейдера
+layout(push_constant) uniform MaterialConstants {
+    layout(offset = 48) vec4 diffuse; // Kd материала
+} material;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+vec2 levelSize(uint level) {
+    return vec2(max(uvec2(1u), uvec2(pageTable.width, pageTable.height) >> level));
+}
+
+void main() {
+    // Уровень по производным координат в текселях уровня 0; до fract(), чтобы шов повтора не давал скачка
+    vec2 texel = fragTexCoord * vec2(pageTable.width, pageTable.height);
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1.0));
+    uint level = min(uint(lod), pageTable.levelCount - 1u);
+
+    vec2 uv = fract(fragTexCoord);
+    uvec4 levelInfo = pageTable.levels[level];
+    uvec2 tile = min(uvec2(uv * levelSize(level)) / pageTable.tileSize, levelInfo.yz - 1u);
+    uint index = levelInfo.x + tile.y * levelInfo.y + tile.x;
+
+    // Обратную связь пишет каждый четвёртый пиксель, с кадра на кадр — разный: меньше записей в один адрес
+    uvec2 pixel = uvec2(gl_FragCoord.xy);
+    if (((pixel.x + pixel.y * 2u + pageTable.frame) & 3u) == 0u) {
+        feedback.requested[index] = pageTable.frame;
+    }
+
+    // Нужная страница или её ближайший резидентный предок
+    uvec2 entry = pageTable.entries[index];
+    uint slot = entry.x & 0xFFFFFFu;
+    uint residentLevel = entry.x >> 24;
+    vec2 residentTile = vec2(entry.y & 0xFFFFu, entry.y >> 16);
+    float tileSize = float(pageTable.tileSize);
+    float border = float(pageTable.border);
+    vec2 inTile = uv * levelSize(residentLevel) - residentTile * tileSize;
+    // Билинейная выборка не выходит за рамку страницы в соседний слот атласа
+    inTile = clamp(inTile, vec2(0.5 - border), vec2(tileSize + border - 0.5));
+
+    float pageExtent = tileSize + 2.0 * border;
+    vec2 slotOrigin = vec2(slot % pageTable.atlasPages, slot / pageTable.atlasPages) * pageExtent;
+    vec2 atlasUV = (slotOrigin + border + inTile) / (float(pageTable.atlasPages) * pageExtent);
+
+    outColor = textureLod(pageAtlas, atlasUV, 0.0) * material.diffuse * vec4(fragColor, 1.0);
+}
@@ -2,7 +2,8 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 
-Application::Application() : enableValidationLayers(true) {
+Application::Application(const Options& options)
+    : enableValidationLayers(true), options_(options), startTime_(std::chrono::steady_clock::now()) {
     try {
         initializeGLFW();
         initializeManagers();
@@ -27,18 +28,18 @@ void Application::initializeManagers() {
     surfaceManager = std::make_unique<SurfaceManager>(*instanceManager, *windowManager);
     deviceManager = std::make_unique<DeviceManager>(*instanceManager, *surfaceManager);
     swapChainManager = std::make_unique<SwapChainManager>(*deviceManager, *surfaceManager, *windowManager);
-    pipelineManager = std::make_unique<PipelineManager>(*deviceManager, *swapChainManager);
+    pipelineManager = std::make_unique<PipelineManager>(*deviceManager, *swapChainManager, options_.bindlessTextures);
     commandManager = std::make_unique<CommandManager>(*deviceManager, *swapChainManager, *pipelineManager);
+    // Модель и текстуры грузятся в фоне, а до их прихода рисуется заглушка: окно не остаётся чёрным
+    assetLoader = std::make_unique<AssetLoader>(*deviceManager, *swapChainManager, options_);
     bufferManager = std::make_unique<BufferManager>(
-        *deviceManager, commandManager->getCommandPool(), *swapChainManager
+        *deviceManager, commandManager->getCommandPool(), *swapChainManager, BufferManager::PlaceholderGeometry{}
     );
     textureManager = std::make_unique<TextureManager>(
             *bufferManager, 
             *deviceManager, 
             *swapChainManager
         );
-
-    
 }
 
 void Application::initializeRenderer() {
@@ -57,6 +58,13 @@ void Application::initializeRenderer() {
 }
 
 void Application::cleanup() {
+    if (assetLoader && !assetLoader->ready()) {
+        // vkDeviceWaitIdle нельзя вызывать, пока фоновый поток отправляет копирования в очередь
+        std::cout << "Waiting for background asset loading to finish..." << std::endl;
+    }
+    if (assetLoader) {
+        assetLoader->wait();
+    }
     if (deviceManager && deviceManager->device()) {
         vkDeviceWaitIdle(deviceManager->device()); // Ждём завершения всех операций GPU
     }
@@ -64,6 +72,7 @@ void Application::cleanup() {
     renderer.reset();
     textureManager.reset();
     bufferManager.reset();
+    assetLoader.reset(); // Пул загрузки — после буферов модели, созданных на нём
     commandManager.reset();
     swapChainManager.reset();
     pipelineManager.reset();
@@ -85,5 +94,30 @@ void Application::mainLoop() {
 }
 
 void Application::drawFrame() {
+    const bool swapAssets = assetLoader && !fullDetail_ && assetLoader->ready();
+    if (swapAssets) {
+        // Граница кадров: renderer дожидается предыдущего кадра и переключается на загруженную модель
+        AssetLoader::Assets assets = assetLoader->take();
+        renderer->replaceAssets(*assets.buffers, *assets.textures);
+        textureManager = std::move(assets.textures);
+        bufferManager = std::move(assets.buffers);
+        fullDetail_ = true;
+    }
+
     renderer->drawFrame();
+
+    if (!firstFrameShown_ || swapAssets) {
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime_).count();
+        std::cout << (swapAssets ? "Time to full detail: " : "Time to first frame: ") << elapsed << " ms" << std::endl;
+        if (swapAssets) {
+            const MemoryAllocator::Stats memory = deviceManager->allocator().stats();
+            std::cout << "GPU memory: " << memory.blockCount << " blocks (" << memory.blockBytes / (1024.0 * 1024.0)
+                      << " MB) holding " << memory.allocationCount << " resources ("
+                      << memory.allocatedBytes / (1024.0 * 1024.0) << " MB), " << memory.dedicatedCount
+                      << " dedicated (" << memory.dedicatedBytes / (1024.0 * 1024.0) << " MB); "
+                      << memory.deviceAllocations << " of " << memory.maxDeviceAllocations
+                      << " device allocations" << std::endl;
+        }
+        firstFrameShown_ = true;
+    }
 }
\ No newline at end of file
@@ -2,10 +2,13 @@
 #define APPLICATION_H
 
 #include "VulkanRenderer.hpp"
+#include "AssetLoader.hpp"
+#include "Options.hpp"
+#include <chrono>
 
 class Application {
 public:
-    Application();
+    explicit Application(const Options& options = {});
     ~Application();
 
 
@@ -29,6 +32,7 @@ public:
 private:
 
     bool enableValidationLayers = true;
+    Options options_;
     std::unique_ptr<WindowManager> windowManager;
     std::unique_ptr<InstanceManager> instanceManager;
     std::unique_ptr<SurfaceManager> surfaceManager;
@@ -36,9 +40,14 @@ private:
     std::unique_ptr<SwapChainManager> swapChainManager;
     std::unique_ptr<PipelineManager> pipelineManager;
     std::unique_ptr<CommandManager> commandManager;
-    std::unique_ptr<BufferManager> bufferManager;
+    std::unique_ptr<AssetLoader> assetLoader;
+    std::unique_ptr<BufferManager> bufferManager; ///< Заглушка, пока assetLoader не загрузил модель
     std::unique_ptr<TextureManager> textureManager;
     std::unique_ptr<VulkanRenderer> renderer;
+
+    std::chrono::steady_clock::time_point startTime_; ///< Отсчёт времени до первого кадра и до полной детализации
+    bool firstFrameShown_ = false;
+    bool fullDetail_ = false; ///< Модель из assetLoader уже рисуется вместо заглушки
 };
 
 #endif
\ No newline at end of file
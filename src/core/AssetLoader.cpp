@@ -0,0 +1,52 @@
+#include "AssetLoader.hpp"
+#include <iostream>
+
+AssetLoader::AssetLoader(DeviceManager& deviceManager, SwapChainManager& swapChainManager, const Options& options)
+    : uploadPool_(nullptr, VulkanDeleter<VkCommandPool_T, vkDestroyCommandPool, VkDevice>(nullptr)) {
+    QueueFamilyIndices queueFamilyIndices = deviceManager.findQueueFamilies(deviceManager.physicalDevice());
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // Только короткоживущие буферы копирования
+    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+
+    VkCommandPool rawCommandPool;
+    if (vkCreateCommandPool(deviceManager.device(), &poolInfo, nullptr, &rawCommandPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create upload command pool!");
+    }
+    uploadPool_ = VkCommandPoolPtr(rawCommandPool,
+        VulkanDeleter<VkCommandPool_T, vkDestroyCommandPool, VkDevice>(deviceManager.device()));
+
+    // options копируются: поток может пережить объект, из которого их взяли
+    future_ = std::async(std::launch::async, [this, &deviceManager, &swapChainManager, options]() {
+        const auto startTime = std::chrono::steady_clock::now();
+        Assets assets;
+        assets.buffers = std::make_unique<BufferManager>(deviceManager, uploadPool_.get(), swapChainManager, options);
+        assets.textures = std::make_unique<TextureManager>(*assets.buffers, deviceManager, swapChainManager,
+                                                           options);
+        seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return assets;
+    });
+}
+
+AssetLoader::~AssetLoader() {
+    if (future_.valid()) {
+        future_.wait();
+    }
+}
+
+bool AssetLoader::ready() const {
+    return future_.valid() && future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+AssetLoader::Assets AssetLoader::take() {
+    Assets assets = future_.get();
+    std::cout << "Assets loaded in background in " << seconds_ * 1000.0 << " ms" << std::endl;
+    return assets;
+}
+
+void AssetLoader::wait() const {
+    if (future_.valid()) {
+        future_.wait();
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "BufferManager.hpp"
+#include "DeviceManager.hpp"
+#include "Options.hpp"
+#include "SwapChainManager.hpp"
+#include "TextureManager.hpp"
+#include "VulkanTypes.hpp"
+#include <chrono>
+#include <future>
+#include <memory>
+
+/**
+ * @brief Фоновая загрузка модели и её текстур
+ *
+ * BufferManager и TextureManager для модели создаются на отдельном потоке со
+ * своим пулом команд, пока главный поток рисует заглушку. Разбор файлов,
+ * декодирование изображений и заполнение staging-буферов идут параллельно с
+ * кадрами; с рендером поток делит только очередь, которая захватывается на
+ * время vkQueueSubmit (SwapChainManager::getQueueMutex()).
+ *
+ * Готовые ресурсы забирает главный поток между кадрами (ready()/take()),
+ * а ошибка загрузки пробрасывается из take().
+ */
+class AssetLoader {
+public:
+    struct Assets {
+        std::unique_ptr<BufferManager> buffers;
+        std::unique_ptr<TextureManager> textures;
+    };
+
+    /**
+     * @brief Запускает загрузку; ссылки должны жить дольше объекта
+     */
+    AssetLoader(DeviceManager& deviceManager, SwapChainManager& swapChainManager, const Options& options);
+
+    /// Дожидается потока: незабранные ресурсы освобождаются, пока устройство ещё живо
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /// Завершилась ли загрузка (успешно или с ошибкой); не блокирует
+    bool ready() const;
+
+    /**
+     * @brief Забирает ресурсы; вызывается один раз после ready()
+     * @throws исключение, с которым завершилась загрузка
+     */
+    Assets take();
+
+    /// Блокирует до конца загрузки (перед vkDeviceWaitIdle при закрытии окна)
+    void wait() const;
+
+    /// Длительность загрузки на фоновом потоке
+    double seconds() const { return seconds_; }
+
+private:
+    VkCommandPoolPtr uploadPool_; ///< Пул фонового потока: пулы команд нельзя делить между потоками
+    double seconds_ = 0.0;
+    std::future<Assets> future_;  ///< Последним: его деструктор дожидается потока, пока пул ещё жив
+};
@@ -5,6 +5,10 @@
 
 class BasicTriangleStrategy : public PipelineStrategy {
 public:
+    explicit BasicTriangleStrategy(VertexFormat vertexFormat = VertexFormat::FULL,
+                                   const char* fragmentShader = SHADER_DIR "/frag.spv")
+        : vertexFormat_(vertexFormat), fragmentShader_(fragmentShader) {}
+
     VkPipelinePtr createGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VkPipelineLayout layout) override {
         PipelineBuilder builder(device, renderPass);
         std::vector<VkDynamicState> dynamicStates{
@@ -12,8 +16,9 @@ public:
             VK_DYNAMIC_STATE_SCISSOR
         };
         return builder
-            .setShaders(SHADER_DIR "/vert.spv", SHADER_DIR "/frag.spv")
-            .setVertexInfo()
+            .setShaders(vertexFormat_ == VertexFormat::PACKED ? SHADER_DIR "/vert_packed.spv" : SHADER_DIR "/vert.spv",
+                        fragmentShader_)
+            .setVertexInfo(vertexFormat_)
             .setPipelineLayout(layout) 
             .setColorBlending() 
             .setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
@@ -26,4 +31,8 @@ public:
             .setDepth()
             .build();
     }
+
+private:
+    VertexFormat vertexFormat_;
+    const char* fragmentShader_;
 };
\ No newline at end of file
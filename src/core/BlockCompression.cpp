@@ -0,0 +1,435 @@
+#include "BlockCompression.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    constexpr int PIXELS = 16;
+    constexpr int POWER_ITERATIONS = 8;
+
+    /// Веса интерполяции 4-битных индексов BC7 (из 64)
+    constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    inline int clampByte(float value) {
+        return std::min(255, std::max(0, static_cast<int>(std::lround(value))));
+    }
+
+    /**
+     * @brief Среднее и главная ось облака точек (степенной метод по ковариационной матрице)
+     *
+     * Учитываются только точки с used[i]; channels — 3 для RGB или 4 для RGBA.
+     */
+    void principalAxis(const float (*points)[4], const bool* used, int channels, float* mean, float* axis) {
+        int count = 0;
+        std::fill(mean, mean + 4, 0.0f);
+        for (int i = 0; i < PIXELS; ++i) {
+            if (used[i]) {
+                for (int c = 0; c < channels; ++c) {
+                    mean[c] += points[i][c];
+                }
+                ++count;
+            }
+        }
+        for (int c = 0; c < channels; ++c) {
+            mean[c] /= static_cast<float>(std::max(count, 1));
+        }
+
+        float covariance[4][4] = {};
+        for (int i = 0; i < PIXELS; ++i) {
+            if (!used[i]) {
+                continue;
+            }
+            for (int a = 0; a < channels; ++a) {
+                for (int b = 0; b < channels; ++b) {
+                    covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+                }
+            }
+        }
+
+        // Начальное приближение — столбец канала с наибольшим разбросом: он не ортогонален главной оси
+        int widest = 0;
+        for (int c = 1; c < channels; ++c) {
+            if (covariance[c][c] > covariance[widest][widest]) {
+                widest = c;
+            }
+        }
+        std::fill(axis, axis + 4, 0.0f);
+        for (int c = 0; c < channels; ++c) {
+            axis[c] = covariance[c][widest];
+        }
+        for (int iteration = 0; iteration <= POWER_ITERATIONS; ++iteration) {
+            float length = 0.0f;
+            for (int c = 0; c < channels; ++c) {
+                length += axis[c] * axis[c];
+            }
+            length = std::sqrt(length);
+            if (length < 1e-6f) {
+                // Все точки совпадают: направление не важно, концы сойдутся в среднем
+                std::fill(axis, axis + channels, 0.0f);
+                return;
+            }
+            for (int c = 0; c < channels; ++c) {
+                axis[c] /= length;
+            }
+            if (iteration == POWER_ITERATIONS) {
+                return;
+            }
+            float next[4] = {};
+            for (int a = 0; a < channels; ++a) {
+                for (int b = 0; b < channels; ++b) {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+            }
+            std::copy(next, next + channels, axis);
+        }
+    }
+
+    /// Крайние проекции точек на ось: концы отрезка, на котором лежит палитра блока
+    void axisEndpoints(const float (*points)[4], const bool* used, int channels, float* low, float* high) {
+        float mean[4], axis[4];
+        principalAxis(points, used, channels, mean, axis);
+        float minimum = std::numeric_limits<float>::max();
+        float maximum = std::numeric_limits<float>::lowest();
+        for (int i = 0; i < PIXELS; ++i) {
+            if (!used[i]) {
+                continue;
+            }
+            float t = 0.0f;
+            for (int c = 0; c < channels; ++c) {
+                t += (points[i][c] - mean[c]) * axis[c];
+            }
+            minimum = std::min(minimum, t);
+            maximum = std::max(maximum, t);
+        }
+        for (int c = 0; c < channels; ++c) {
+            low[c] = mean[c] + axis[c] * minimum;
+            high[c] = mean[c] + axis[c] * maximum;
+        }
+    }
+
+    inline uint16_t packRgb565(const float* rgb) {
+        const int r = (clampByte(rgb[0]) * 31 + 127) / 255;
+        const int g = (clampByte(rgb[1]) * 63 + 127) / 255;
+        const int b = (clampByte(rgb[2]) * 31 + 127) / 255;
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    inline void unpackRgb565(uint16_t color, int* rgb) {
+        const int r = (color >> 11) & 31;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    inline void storeLe(uint8_t* destination, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            destination[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    /// Концы BC7 режима 6: по 7 бит на канал и общий младший p-бит на конец
+    struct Bc7Endpoints {
+        int quantized[2][4];
+        int pBit[2];
+
+        int value(int endpoint, int channel) const { return (quantized[endpoint][channel] << 1) | pBit[endpoint]; }
+    };
+
+    /// Ближайшие к value 7-битные значения при p-бите 0 и 1; выбирается p-бит с меньшей ошибкой
+    void quantizeBc7Endpoint(const float* value, int* quantized, int& pBit) {
+        int bestError = std::numeric_limits<int>::max();
+        for (int p = 0; p < 2; ++p) {
+            int candidate[4];
+            int error = 0;
+            for (int c = 0; c < 4; ++c) {
+                const int v = clampByte(value[c]);
+                candidate[c] = std::min(127, std::max(0, (v - p + 1) >> 1));
+                const int difference = ((candidate[c] << 1) | p) - v;
+                error += difference * difference;
+            }
+            if (error < bestError) {
+                bestError = error;
+                pBit = p;
+                std::copy(candidate, candidate + 4, quantized);
+            }
+        }
+    }
+
+    /// Индексы пикселей по палитре концов; возвращает суммарную квадратичную ошибку
+    int64_t bc7Indices(const uint8_t* pixels, const Bc7Endpoints& endpoints, int* indices) {
+        int palette[16][4];
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                palette[i][c] = ((64 - BC7_WEIGHTS[i]) * endpoints.value(0, c) +
+                                 BC7_WEIGHTS[i] * endpoints.value(1, c) + 32) >> 6;
+            }
+        }
+        int64_t total = 0;
+        for (int i = 0; i < PIXELS; ++i) {
+            int bestError = std::numeric_limits<int>::max();
+            for (int entry = 0; entry < 16; ++entry) {
+                int error = 0;
+                for (int c = 0; c < 4; ++c) {
+                    const int difference = palette[entry][c] - pixels[i * 4 + c];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    indices[i] = entry;
+                }
+            }
+            total += bestError;
+        }
+        return total;
+    }
+
+    /// Концы, наилучшие в смысле наименьших квадратов при фиксированных индексах
+    bool fitBc7Endpoints(const uint8_t* pixels, const int* indices, float* low, float* high) {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        float lowSum[4] = {}, highSum[4] = {};
+        for (int i = 0; i < PIXELS; ++i) {
+            const float w = BC7_WEIGHTS[indices[i]] / 64.0f;
+            a += (1.0f - w) * (1.0f - w);
+            b += (1.0f - w) * w;
+            c += w * w;
+            for (int channel = 0; channel < 4; ++channel) {
+                lowSum[channel] += (1.0f - w) * pixels[i * 4 + channel];
+                highSum[channel] += w * pixels[i * 4 + channel];
+            }
+        }
+        const float determinant = a * c - b * b;
+        if (std::fabs(determinant) < 1e-6f) {
+            return false; // Все пиксели на одном индексе: система вырождена
+        }
+        for (int channel = 0; channel < 4; ++channel) {
+            low[channel] = (c * lowSum[channel] - b * highSum[channel]) / determinant;
+            high[channel] = (a * highSum[channel] - b * lowSum[channel]) / determinant;
+        }
+        return true;
+    }
+
+    /// Запись битового потока BC7 от младшего бита к старшему
+    class Bc7Writer {
+    public:
+        explicit Bc7Writer(uint8_t* block) : block_(block) { std::memset(block_, 0, 16); }
+
+        void put(uint32_t value, int bits) {
+            for (int i = 0; i < bits; ++i, ++position_) {
+                if ((value >> i) & 1u) {
+                    block_[position_ >> 3] |= static_cast<uint8_t>(1u << (position_ & 7));
+                }
+            }
+        }
+
+    private:
+        uint8_t* block_;
+        int position_ = 0;
+    };
+}
+
+namespace BlockCompression {
+
+    size_t blockBytes(Format format) {
+        switch (format) {
+            case Format::BC1: return 8;
+            case Format::BC5: return 16;
+            case Format::BC7: return 16;
+        }
+        throw std::invalid_argument("BlockCompression: unknown format");
+    }
+
+    size_t encodedSize(Format format, uint32_t width, uint32_t height) {
+        return size_t{(width + 3) / 4} * ((height + 3) / 4) * blockBytes(format);
+    }
+
+    void encodeBc1Block(const uint8_t* pixels, uint8_t* block) {
+        float points[PIXELS][4] = {};
+        bool opaque[PIXELS];
+        bool transparent = false;
+        for (int i = 0; i < PIXELS; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                points[i][c] = pixels[i * 4 + c];
+            }
+            opaque[i] = pixels[i * 4 + 3] >= 128;
+            transparent |= !opaque[i];
+        }
+        if (std::none_of(opaque, opaque + PIXELS, [](bool value) { return value; })) {
+            storeLe(block, 0, 4);
+            storeLe(block + 4, 0xFFFFFFFFu, 4); // Все пиксели — индекс 3 трёхцветного режима
+            return;
+        }
+
+        float low[4], high[4];
+        axisEndpoints(points, opaque, 3, low, high);
+        uint16_t color0 = packRgb565(high);
+        uint16_t color1 = packRgb565(low);
+        // Четырёхцветный режим задаётся color0 > color1, трёхцветный с прозрачностью — color0 <= color1
+        if (transparent ? color0 > color1 : color0 < color1) {
+            std::swap(color0, color1);
+        }
+
+        int palette[4][3];
+        unpackRgb565(color0, palette[0]);
+        unpackRgb565(color1, palette[1]);
+        const bool fourColors = color0 > color1;
+        for (int c = 0; c < 3; ++c) {
+            if (fourColors) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            } else {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+
+        uint32_t indices = 0;
+        for (int i = 0; i < PIXELS; ++i) {
+            uint32_t best = 3;
+            if (opaque[i]) {
+                int bestError = std::numeric_limits<int>::max();
+                for (uint32_t entry = 0; entry < (fourColors ? 4u : 3u); ++entry) {
+                    int error = 0;
+                    for (int c = 0; c < 3; ++c) {
+                        const int difference = palette[entry][c] - pixels[i * 4 + c];
+                        error += difference * difference;
+                    }
+                    if (error < bestError) {
+                        bestError = error;
+                        best = entry;
+                    }
+                }
+            }
+            indices |= best << (2 * i);
+        }
+        storeLe(block, color0, 2);
+        storeLe(block + 2, color1, 2);
+        storeLe(block + 4, indices, 4);
+    }
+
+    void encodeBc4Block(const uint8_t* values, uint8_t* block) {
+        const auto range = std::minmax_element(values, values + PIXELS);
+        const int low = *range.first;
+        const int high = *range.second;
+        block[0] = static_cast<uint8_t>(high);
+        block[1] = static_cast<uint8_t>(low);
+
+        uint64_t indices = 0;
+        if (high > low) {
+            // Восьмизначный режим (alpha0 > alpha1): индексы 0 и 1 — концы, 2..7 — шесть промежуточных
+            int palette[8] = {high, low};
+            for (int i = 1; i < 7; ++i) {
+                palette[i + 1] = ((7 - i) * high + i * low) / 7;
+            }
+            for (int i = 0; i < PIXELS; ++i) {
+                uint64_t best = 0;
+                int bestError = std::numeric_limits<int>::max();
+                for (int entry = 0; entry < 8; ++entry) {
+                    const int error = std::abs(palette[entry] - values[i]);
+                    if (error < bestError) {
+                        bestError = error;
+                        best = static_cast<uint64_t>(entry);
+                    }
+                }
+                indices |= best << (3 * i);
+            }
+        }
+        storeLe(block + 2, indices, 6);
+    }
+
+    void encodeBc5Block(const uint8_t* pixels, uint8_t* block) {
+        uint8_t red[PIXELS], green[PIXELS];
+        for (int i = 0; i < PIXELS; ++i) {
+            red[i] = pixels[i * 4];
+            green[i] = pixels[i * 4 + 1];
+        }
+        encodeBc4Block(red, block);
+        encodeBc4Block(green, block + 8);
+    }
+
+    void encodeBc7Block(const uint8_t* pixels, uint8_t* block) {
+        float points[PIXELS][4];
+        bool used[PIXELS];
+        for (int i = 0; i < PIXELS; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                points[i][c] = pixels[i * 4 + c];
+            }
+            used[i] = true;
+        }
+
+        float low[4], high[4];
+        axisEndpoints(points, used, 4, low, high);
+        Bc7Endpoints endpoints;
+        quantizeBc7Endpoint(low, endpoints.quantized[0], endpoints.pBit[0]);
+        quantizeBc7Endpoint(high, endpoints.quantized[1], endpoints.pBit[1]);
+        int indices[PIXELS];
+        int64_t error = bc7Indices(pixels, endpoints, indices);
+
+        // Концы по крайним проекциям не лучшие для выбранных индексов: одно уточнение обычно снижает ошибку
+        if (error > 0 && fitBc7Endpoints(pixels, indices, low, high)) {
+            Bc7Endpoints refined;
+            quantizeBc7Endpoint(low, refined.quantized[0], refined.pBit[0]);
+            quantizeBc7Endpoint(high, refined.quantized[1], refined.pBit[1]);
+            int refinedIndices[PIXELS];
+            const int64_t refinedError = bc7Indices(pixels, refined, refinedIndices);
+            if (refinedError < error) {
+                endpoints = refined;
+                std::copy(refinedIndices, refinedIndices + PIXELS, indices);
+            }
+        }
+
+        // Старший бит индекса первого пикселя не хранится и должен быть нулём: иначе концы меняются местами.
+        // Веса симметричны (w[15 - i] = 64 - w[i]), поэтому палитра остаётся той же
+        if (indices[0] >= 8) {
+            std::swap(endpoints.quantized[0], endpoints.quantized[1]);
+            std::swap(endpoints.pBit[0], endpoints.pBit[1]);
+            for (int& index : indices) {
+                index = 15 - index;
+            }
+        }
+
+        Bc7Writer writer(block);
+        writer.put(1u << 6, 7); // Режим 6: шесть нулевых бит и единица
+        for (int c = 0; c < 4; ++c) {
+            writer.put(static_cast<uint32_t>(endpoints.quantized[0][c]), 7);
+            writer.put(static_cast<uint32_t>(endpoints.quantized[1][c]), 7);
+        }
+        writer.put(static_cast<uint32_t>(endpoints.pBit[0]), 1);
+        writer.put(static_cast<uint32_t>(endpoints.pBit[1]), 1);
+        writer.put(static_cast<uint32_t>(indices[0]), 3);
+        for (int i = 1; i < PIXELS; ++i) {
+            writer.put(static_cast<uint32_t>(indices[i]), 4);
+        }
+    }
+
+    std::vector<uint8_t> encode(const uint8_t* pixels, uint32_t width, uint32_t height, Format format,
+                                unsigned threadCount) {
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const size_t bytes = blockBytes(format);
+        std::vector<uint8_t> result(encodedSize(format, width, height));
+        Parallel::forEach(blocksY, [&](size_t blockY) {
+            uint8_t tile[PIXELS * 4];
+            for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+                for (uint32_t y = 0; y < 4; ++y) {
+                    const uint32_t sourceY = std::min(static_cast<uint32_t>(blockY) * 4 + y, height - 1);
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                        std::memcpy(tile + (y * 4 + x) * 4, pixels + (size_t{sourceY} * width + sourceX) * 4, 4);
+                    }
+                }
+                uint8_t* block = result.data() + (blockY * blocksX + blockX) * bytes;
+                switch (format) {
+                    case Format::BC1: encodeBc1Block(tile, block); break;
+                    case Format::BC5: encodeBc5Block(tile, block); break;
+                    case Format::BC7: encodeBc7Block(tile, block); break;
+                }
+            }
+        }, threadCount);
+        return result;
+    }
+}
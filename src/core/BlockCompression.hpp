@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Сжатие RGBA8 изображений в блочные форматы BC1, BC5 и BC7
+ *
+ * Изображение режется на блоки 4x4; каждый блок кодируется независимо,
+ * поэтому строки блоков делятся между потоками. Блоки у края, выходящие за
+ * изображение, дополняются повтором крайних пикселей. Кодировщик работает
+ * с сохранёнными значениями: для sRGB текстур это значения в sRGB.
+ *
+ *  - BC1: 8 байт на блок (4 бита на пиксель), RGB и однобитная альфа;
+ *  - BC5: 16 байт, два независимых канала R и G (карты нормалей);
+ *  - BC7: 16 байт, RGBA; используется только режим 6 (одна пара концов на блок).
+ */
+namespace BlockCompression {
+    enum class Format {
+        BC1,
+        BC5,
+        BC7
+    };
+
+    /// Байт на блок 4x4
+    size_t blockBytes(Format format);
+
+    /// Размер сжатого изображения: блоки с округлением сторон вверх до 4
+    size_t encodedSize(Format format, uint32_t width, uint32_t height);
+
+    /**
+     * @brief Кодирует блок BC1
+     *
+     * Пиксели с альфой меньше 128 переводят блок в трёхцветный режим, где
+     * индекс 3 означает прозрачный чёрный.
+     * @param pixels 16 пикселей RGBA8 построчно
+     */
+    void encodeBc1Block(const uint8_t* pixels, uint8_t* block);
+
+    /**
+     * @brief Кодирует один канал блоком BC4 (из двух таких блоков состоит BC5)
+     * @param values 16 значений построчно
+     */
+    void encodeBc4Block(const uint8_t* values, uint8_t* block);
+
+    /// Блок BC5: каналы R и G 16 пикселей RGBA8
+    void encodeBc5Block(const uint8_t* pixels, uint8_t* block);
+
+    /// Блок BC7 в режиме 6: концы по главной оси цвета, затем уточнение методом наименьших квадратов
+    void encodeBc7Block(const uint8_t* pixels, uint8_t* block);
+
+    /**
+     * @brief Кодирует всё изображение
+     * @param threadCount 0 — по числу ядер; результат от числа потоков не зависит
+     */
+    std::vector<uint8_t> encode(const uint8_t* pixels, uint32_t width, uint32_t height, Format format,
+                                unsigned threadCount = 0);
+}
@@ -1,29 +1,433 @@
 #include "BufferManager.hpp"
+#include "GltfLoader.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "Meshlet.hpp"
+#include "ObjStreamReader.hpp"
+#include "TangentSpace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    /// Шаг динамических смещений uniform-буфера
+    VkDeviceSize uniformAlignment(VkPhysicalDevice physicalDevice) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        return properties.limits.minUniformBufferOffsetAlignment;
+    }
+
+    /// Есть ли вершина не белого цвета (цвета PLY или COLOR_0 из glTF)
+    bool hasVertexColors(const Vertex* vertices, size_t count) {
+        return std::any_of(vertices, vertices + count,
+                           [](const Vertex& vertex) { return vertex.color != glm::vec3(1.0f); });
+    }
+}
+
+BufferManager::BufferManager(DeviceManager& deviceManager,
+                             VkCommandPool commandPool,
+                             SwapChainManager& swapChainManager,
+                             const Options& options) 
+: BufferManager(deviceManager, commandPool, swapChainManager)
+{
+    primaryMesh_ = loadMesh(options);
+    createUniformArena();
+}
+
+BufferManager::BufferManager(DeviceManager& deviceManager,
+                             VkCommandPool commandPool,
+                             SwapChainManager& swapChainManager,
+                             PlaceholderGeometry)
+: BufferManager(deviceManager, commandPool, swapChainManager)
+{
+    primaryMesh_ = meshes_.add(createPlaceholderGeometry());
+    createUniformArena();
+}
 
 BufferManager::BufferManager(DeviceManager& deviceManager,
                              VkCommandPool commandPool,
-                             SwapChainManager& swapChainManager) 
+                             SwapChainManager& swapChainManager)
 : deviceManager_(deviceManager),
 commandPool_(commandPool),
 swapChainManager_(swapChainManager),
-indexBuffer(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
-indexBufferMemory(nullptr, VulkanDeleter<VkDeviceMemory_T, vkFreeMemory, VkDevice>(nullptr)),
-vertexBuffer(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
-vertexBufferMemory(nullptr, VulkanDeleter<VkDeviceMemory_T, vkFreeMemory, VkDevice>(nullptr))
+uniformBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
+// Один fence и один буфер команд: в полёте не больше одного кадра, и области на кадр хватает
+uniformArena_(UNIFORM_FRAME_BYTES, uniformAlignment(deviceManager.physicalDevice()), 1)
 {
-    loadModel();
-    createVertexBuffer();
-    createIndexBuffer();
-    createUniformBuffers();
 }
 
-const std::vector<VkBufferPtr>& BufferManager::getUniformBuffers() const {
-    return uniformBuffers; }
-const std::vector<void*>& BufferManager::getUniformBuffersMapped() const {
-     return uniformBuffersMapped; }
+MeshId BufferManager::loadMesh(const Options& options) {
+    auto mesh = std::make_unique<Mesh>();
+    mesh->name_ = modelPath(options);
+    mesh->vertexFormat_ = options.vertexFormat;
+    loadGeometry(options, *mesh);
+    const MeshId id = meshes_.add(std::move(mesh));
+    std::cout << meshes_.size() << " meshes resident, " << meshes_.gpuBytes() / (1024.0 * 1024.0) << " MB of buffers"
+              << std::endl;
+    return id;
+}
+
+std::unique_ptr<Mesh> BufferManager::createPlaceholderGeometry() {
+    // Куб с ребром 1 вокруг начала координат; грани разного оттенка, чтобы без освещения читался объём
+    static const glm::vec3 NORMALS[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    static const float SHADES[6] = {0.8f, 0.45f, 0.7f, 0.55f, 0.95f, 0.35f};
+    std::vector<Vertex> box;
+    std::vector<uint32_t> boxIndices;
+    for (int face = 0; face < 6; ++face) {
+        const glm::vec3 normal = NORMALS[face];
+        // Две оси грани, образующие с нормалью правую тройку: обход против часовой стрелки снаружи
+        const glm::vec3 u = std::fabs(normal.z) > 0.5f ? glm::vec3(normal.z, 0, 0) : glm::vec3(-normal.y, normal.x, 0);
+        const glm::vec3 v = glm::cross(normal, u);
+        const uint32_t base = static_cast<uint32_t>(box.size());
+        for (int corner = 0; corner < 4; ++corner) {
+            const float su = (corner == 1 || corner == 2) ? 0.5f : -0.5f;
+            const float sv = corner >= 2 ? 0.5f : -0.5f;
+            Vertex vertex{};
+            vertex.pos = normal * 0.5f + u * su + v * sv;
+            vertex.color = glm::vec3(SHADES[face]);
+            vertex.normal = normal;
+            vertex.tangent = glm::vec4(u, 1.0f);
+            box.push_back(vertex);
+        }
+        boxIndices.insert(boxIndices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    auto mesh = std::make_unique<Mesh>();
+    mesh->name_ = "placeholder";
+    Material white; // Без текстуры: TextureManager создаст для заглушки только белую 1x1
+    white.resolved = true;
+    mesh->materials_ = {white};
+    mesh->boundingSphere_ = Mesh::computeBoundingSphere(box.data(), box.size());
+    createVertexBuffer(*mesh, box.data(), box.size());
+    createIndexBuffer(*mesh, boxIndices.data(), boxIndices.size());
+    mesh->lods_ = {LodLevel{0, mesh->indexCount_, 0.0f}};
+    resolveMaterials(*mesh);
+    return mesh;
+}
+
+void BufferManager::loadGeometry(const Options& options, Mesh& mesh) {
+    const std::string path = modelPath(options);
+    const std::string format = modelFormat(path);
+    if (format == ".glb" || format == ".gltf") {
+        if (options.streamMemoryLimitMB > 0) {
+            std::cerr << "--stream reads only OBJ, loading the glTF file whole" << std::endl;
+        }
+        loadGltf(path, options, mesh);
+        return;
+    }
+    const bool untextured = format == ".ply" || format == ".stl";
+    if (options.streamMemoryLimitMB > 0 && untextured) {
+        std::cerr << "--stream reads only OBJ, loading the " << format << " file whole" << std::endl;
+    } else if (options.streamMemoryLimitMB > 0) {
+        if (mesh.vertexFormat_ == VertexFormat::PACKED) {
+            // Квантование требует габаритов всей сетки, а при потоковой загрузке они известны только в конце
+            std::cerr << "Packed vertex format is not supported with --stream, using full vertices" << std::endl;
+            mesh.vertexFormat_ = VertexFormat::FULL;
+        }
+        if ((geometryProcessing(options) & ~MeshCache::PROCESS_LOD) != 0) {
+            std::cerr << "Mesh optimization passes need the whole mesh, skipped with --stream" << std::endl;
+        }
+        if (options.buildLods || options.buildMeshlets) {
+            std::cerr << "LOD and meshlet generation need the whole mesh, skipped with --stream" << std::endl;
+        }
+        std::cout << "Normals and tangents are not generated with --stream" << std::endl;
+        std::cout << "Materials are not read with --stream, using the default texture" << std::endl;
+        streamGeometry(options, mesh); // Кэш не используется: он требует всей геометрии в памяти сразу
+        mesh.lods_ = {LodLevel{0, mesh.indexCount_, 0.0f}};
+        resolveMaterials(mesh);
+        return;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const char* source = "mesh cache disabled";
+
+    const uint32_t processing = geometryProcessing(options);
+
+    MeshCache meshCache;
+    if (options.useMeshCache && meshCache.open(path, options.weldEpsilon, processing)) {
+        // Тёплый старт: данные копируются из отображённого файла прямо в staging-буферы
+        source = "mesh cache hit";
+        mesh.lods_ = meshCache.lods();
+        mesh.meshMaterials_ = meshCache.materials();
+        mesh.boundingSphere_ = Mesh::computeBoundingSphere(meshCache.vertices(), meshCache.vertexCount());
+        mesh.uvDensity_ = Mesh::computeUvDensity(meshCache.vertices(), meshCache.indices(),
+                                                 mesh.lods_.empty() ? meshCache.indexCount() : mesh.lods_[0].indexCount,
+                                                 mesh.meshMaterials_.submeshes);
+        createVertexBuffer(mesh, meshCache.vertices(), meshCache.vertexCount());
+        createIndexBuffer(mesh, meshCache.indices(), meshCache.indexCount());
+        if (options.buildMeshlets) {
+            buildMeshlets(mesh, meshCache.vertices(), meshCache.vertexCount(), meshCache.indices(),
+                          mesh.lods_.empty() ? meshCache.indexCount() : mesh.lods_[0].indexCount);
+        }
+    } else {
+        MeshData data = loadModel(options);
+        mesh.meshMaterials_ = data.meshMaterials;
+        prepareGeometry(data, processing, mesh);
+        if (options.useMeshCache) {
+            source = "mesh cache miss";
+            MeshCache::store(path, options.weldEpsilon, data.vertices, data.indices, processing, mesh.lods_,
+                             mesh.meshMaterials_);
+        }
+        uploadGeometry(data, options, mesh);
+    }
+    if (mesh.lods_.empty()) {
+        mesh.lods_ = {LodLevel{0, mesh.indexCount_, 0.0f}};
+    }
+    if (untextured) {
+        // В PLY и STL нет материалов и UV: модель рисуется белой текстурой, оттенок дают цвета вершин
+        Material white;
+        white.resolved = true;
+        mesh.materials_ = {white};
+    }
+    resolveMaterials(mesh);
+
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Model geometry ready in " << elapsed << " ms (" << source << ")" << std::endl;
+}
+
+void BufferManager::loadGltf(const std::string& path, const Options& options, Mesh& mesh) {
+    const auto startTime = std::chrono::steady_clock::now();
+    GltfLoader gltf(path);
+    mesh.meshMaterials_ = gltf.getMeshMaterials();
+    mesh.materials_ = gltf.getMaterials();
+    mesh.embeddedImages_ = gltf.copyEmbeddedImages();
+
+    // Без обработки и с готовым касательным базисом сетку не нужно держать в памяти:
+    // атрибуты пишутся из отображённого файла прямо в staging-буферы
+    const uint32_t processing = geometryProcessing(options);
+    const bool direct = gltf.hasNormals() && gltf.hasTangents() && processing == 0 && !options.buildMeshlets &&
+                        mesh.vertexFormat_ == VertexFormat::FULL;
+    if (direct) {
+        mesh.boundingSphere_ = gltf.getBoundingSphere();
+        mesh.vertexCount_ = static_cast<uint32_t>(gltf.vertexCount());
+        createDeviceVertexBuffer(mesh, sizeof(Vertex) * gltf.vertexCount(),
+                                 [&](void* staging) { gltf.writeVertices(static_cast<Vertex*>(staging)); });
+        createIndexBuffer(mesh, gltf.indexCount(),
+                          [&](void* staging) { gltf.writeIndices(static_cast<uint32_t*>(staging)); });
+    } else {
+        MeshData data;
+        data.vertices.resize(gltf.vertexCount());
+        data.indices.resize(gltf.indexCount());
+        data.meshMaterials = mesh.meshMaterials_;
+        gltf.writeVertices(data.vertices.data());
+        gltf.writeIndices(data.indices.data());
+        if (!gltf.hasNormals()) {
+            TangentSpace::generateNormals(data.vertices, data.indices);
+        }
+        if (!gltf.hasTangents()) {
+            TangentSpace::generateTangents(data.vertices, data.indices);
+        }
+        prepareGeometry(data, processing, mesh);
+        uploadGeometry(data, options, mesh);
+    }
+    if (mesh.lods_.empty()) {
+        mesh.lods_ = {LodLevel{0, mesh.indexCount_, 0.0f}};
+    }
+    resolveMaterials(mesh);
+
+    const GltfLoader::Stats& stats = gltf.getStats();
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "glTF loaded: " << stats.fileSize / (1024.0 * 1024.0) << " MB, " << gltf.vertexCount()
+              << " vertices, " << gltf.indexCount() / 3 << " triangles, " << mesh.embeddedImages_.size()
+              << " embedded images; JSON and accessors " << stats.parseSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Model geometry ready in " << elapsed << " ms ("
+              << (direct ? "glTF, direct to staging" : "glTF, decoded for processing") << ")" << std::endl;
+}
+
+void BufferManager::prepareGeometry(MeshData& data, uint32_t processing, Mesh& mesh) {
+    optimizeGeometry(data, processing);
+    if (processing & MeshCache::PROCESS_LOD) {
+        buildLods(data, mesh);
+    }
+}
+
+void BufferManager::uploadGeometry(MeshData& data, const Options& options, Mesh& mesh) {
+    mesh.boundingSphere_ = Mesh::computeBoundingSphere(data.vertices.data(), data.vertices.size());
+    mesh.uvDensity_ = Mesh::computeUvDensity(data.vertices.data(), data.indices.data(),
+                                             mesh.lods_.empty() ? data.indices.size() : mesh.lods_[0].indexCount,
+                                             mesh.meshMaterials_.submeshes);
+    createVertexBuffer(mesh, data.vertices.data(), data.vertices.size());
+    createIndexBuffer(mesh, data.indices.data(), data.indices.size());
+    if (options.buildMeshlets) {
+        buildMeshlets(mesh, data.vertices.data(), data.vertices.size(), data.indices.data(),
+                      mesh.lods_.empty() ? data.indices.size() : mesh.lods_[0].indexCount);
+    }
 
-void BufferManager::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-    VkBuffer& buffer, VkDeviceMemory& bufferMemory) {
+    // Всё нужное для отрисовки уже в буферах устройства: копия в памяти CPU больше не нужна
+    std::cout << "Released " << data.byteSize() / (1024.0 * 1024.0) << " MB of CPU-side geometry after upload"
+              << std::endl;
+    data.release();
+}
+
+uint32_t BufferManager::geometryProcessing(const Options& options) {
+    uint32_t processing = 0;
+    if (options.optimizeVertexCache || options.optimizeOverdraw) {
+        processing |= MeshCache::PROCESS_VERTEX_CACHE; // Кластеры перерисовки нарезаются по порядку кэша
+    }
+    if (options.optimizeOverdraw) {
+        processing |= MeshCache::PROCESS_OVERDRAW;
+    }
+    if (options.optimizeVertexFetch) {
+        processing |= MeshCache::PROCESS_VERTEX_FETCH;
+    }
+    if (options.buildLods) {
+        processing |= MeshCache::PROCESS_LOD;
+    }
+    return processing;
+}
+
+void BufferManager::optimizeGeometry(MeshData& data, uint32_t processing) {
+    using Clock = std::chrono::steady_clock;
+    auto milliseconds = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+    std::vector<Vertex>& vertices = data.vertices;
+    std::vector<uint32_t>& indices = data.indices;
+
+    // Треугольники переставляются только внутри материала, иначе диапазоны Submesh перемешаются
+    auto perSubmesh = [&](auto pass) {
+        if (data.meshMaterials.submeshes.size() <= 1) {
+            pass(indices);
+            return;
+        }
+        std::vector<uint32_t> range;
+        for (const Submesh& submesh : data.meshMaterials.submeshes) {
+            const auto first = indices.begin() + submesh.firstIndex;
+            range.assign(first, first + submesh.indexCount);
+            pass(range);
+            std::copy(range.begin(), range.end(), first);
+        }
+    };
+    // Порядок важен: кэш вершин -> перерисовка (кластеры по порядку кэша) -> выборка (по итоговому порядку)
+    if (processing & MeshCache::PROCESS_VERTEX_CACHE) {
+        const auto startTime = Clock::now();
+        const MeshOptimizer::VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+        perSubmesh([&](std::vector<uint32_t>& range) { MeshOptimizer::optimizeVertexCache(range, vertices.size()); });
+        const MeshOptimizer::VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+
+        std::cout << "Vertex cache optimized in " << milliseconds(startTime) << " ms: ACMR " << before.acmr() << " -> "
+                  << after.acmr() << ", ATVR " << before.atvr() << " -> " << after.atvr()
+                  << " (FIFO " << MeshOptimizer::ANALYZE_CACHE_SIZE << ")" << std::endl;
+    }
+    if (processing & MeshCache::PROCESS_OVERDRAW) {
+        const auto startTime = Clock::now();
+        const MeshOptimizer::OverdrawStats before = MeshOptimizer::analyzeOverdraw(vertices, indices);
+        perSubmesh([&](std::vector<uint32_t>& range) { MeshOptimizer::optimizeOverdraw(range, vertices); });
+        const MeshOptimizer::OverdrawStats after = MeshOptimizer::analyzeOverdraw(vertices, indices);
+
+        std::cout << "Overdraw optimized in " << milliseconds(startTime) << " ms: overdraw " << before.overdraw()
+                  << " -> " << after.overdraw() << ", ACMR "
+                  << MeshOptimizer::analyzeVertexCache(indices, vertices.size()).acmr() << std::endl;
+    }
+    if (processing & MeshCache::PROCESS_VERTEX_FETCH) {
+        const auto startTime = Clock::now();
+        MeshOptimizer::optimizeVertexFetch(vertices, indices);
+        std::cout << "Vertex fetch order optimized in " << milliseconds(startTime) << " ms" << std::endl;
+    }
+}
+
+void BufferManager::resolveMaterials(Mesh& mesh) {
+    MeshMaterials& meshMaterials = mesh.meshMaterials_;
+    if (meshMaterials.submeshes.empty()) {
+        meshMaterials.submeshes = {Submesh{0, mesh.lods_[0].indexCount, 0}};
+    }
+    if (meshMaterials.materialNames.empty()) {
+        meshMaterials.materialNames = {std::string()};
+    }
+    if (mesh.materials_.empty()) { // Материалы glTF уже известны загрузчику
+        mesh.materials_ = MaterialLibrary::resolve(meshMaterials);
+    }
+
+    const size_t resolved = std::count_if(mesh.materials_.begin(), mesh.materials_.end(),
+                                          [](const Material& material) { return material.resolved; });
+    std::cout << mesh.materials_.size() << " materials (" << resolved << " found in "
+              << meshMaterials.libraries.size() << " libraries), " << meshMaterials.submeshes.size()
+              << " submeshes" << std::endl;
+}
+
+void BufferManager::buildLods(MeshData& data, Mesh& mesh) {
+    if (data.meshMaterials.submeshes.size() > 1) {
+        // Упрощение не знает о границах материалов и перемешало бы диапазоны Submesh
+        std::cerr << "LOD generation needs a single material, skipped for "
+                  << data.meshMaterials.submeshes.size() << " submeshes" << std::endl;
+        return;
+    }
+    const auto startTime = std::chrono::steady_clock::now();
+    mesh.lods_ = MeshSimplifier::buildLodChain(data.vertices, data.indices); // Уровни строятся на всех ядрах
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Built " << mesh.lods_.size() << " LOD levels in " << elapsed << " ms:";
+    for (const LodLevel& lod : mesh.lods_) {
+        std::cout << ' ' << lod.indexCount / 3 << " tris (error " << lod.error << ")";
+    }
+    std::cout << std::endl;
+}
+
+void BufferManager::buildMeshlets(Mesh& mesh, const Vertex* vertexData, size_t vertexCount, const uint32_t* indexData,
+                                  size_t indexCount) {
+    if (mesh.meshMaterials_.submeshes.size() > 1) {
+        std::cerr << "Meshlet culling needs a single material, skipped for "
+                  << mesh.meshMaterials_.submeshes.size() << " submeshes" << std::endl;
+        return;
+    }
+    const auto startTime = std::chrono::steady_clock::now();
+    MeshletMesh& meshlets = mesh.meshlets_;
+    meshlets = MeshletBuilder::build(vertexData, vertexCount, indexData, indexCount);
+    if (meshlets.meshlets.empty()) {
+        return;
+    }
+
+    size_t vertexBase = 0;
+    size_t triangleBase = 0;
+    const std::vector<uint8_t> packed = MeshletBuilder::pack(meshlets, vertexBase, triangleBase);
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Built " << meshlets.meshlets.size() << " meshlets in " << elapsed << " ms: "
+              << static_cast<double>(meshlets.vertices.size()) / meshlets.meshlets.size() << " vertices and "
+              << static_cast<double>(meshlets.triangleCount()) / meshlets.meshlets.size()
+              << " triangles per meshlet, " << packed.size() / 1024.0 << " KB" << std::endl;
+
+    // Буфер мешлетов для будущего mesh-шейдера: device-local storage-буфер
+    {
+        MemoryAllocation stagingBufferMemory;
+        VkBufferPtr stagingBuffer = createBuffer(packed.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBufferMemory);
+        memcpy(stagingBufferMemory.mapped(), packed.data(), packed.size());
+
+        mesh.meshletBuffer_ = createBuffer(packed.size(),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mesh.meshletBufferMemory_);
+        copyBuffer(stagingBuffer.get(), mesh.meshletBuffer_.get(), packed.size());
+        mesh.gpuBytes_ += packed.size();
+    }
+
+    // Индексы, оставшиеся после отсечения на CPU, пишутся каждый кадр в постоянно отображённый буфер.
+    // Кадр в полёте один (один fence), поэтому одного буфера хватает
+    const VkDeviceSize culledSize = sizeof(uint32_t) * meshlets.triangleCount() * 3;
+    mesh.culledIndexBuffer_ = createBuffer(culledSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, mesh.culledIndexBufferMemory_);
+    mesh.gpuBytes_ += culledSize;
+}
+
+void BufferManager::beginUniformFrame() {
+    uniformArena_.begin(0);
+}
+
+BufferManager::UniformSlice BufferManager::allocateUniform(VkDeviceSize size) {
+    const uint64_t offset = uniformArena_.allocate(size);
+    if (offset == FrameArena::NO_SPACE) {
+        throw std::runtime_error("Per-frame uniform arena is full (" + std::to_string(uniformArena_.frameCapacity()) +
+                                 " bytes)");
+    }
+    UniformSlice slice;
+    slice.data = static_cast<char*>(uniformMemory_.mapped()) + offset;
+    slice.offset = static_cast<uint32_t>(offset);
+    return slice;
+}
+
+VkBufferPtr BufferManager::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+    MemoryAllocation& bufferMemory) {
 
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -31,164 +435,235 @@ void BufferManager::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, Vk
     bufferInfo.usage = usage; // Используем переданные флаги
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // Только для одной очереди
 
-    if (vkCreateBuffer(deviceManager_.device(), &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+    VkBuffer rawBuffer;
+    if (vkCreateBuffer(deviceManager_.device(), &bufferInfo, nullptr, &rawBuffer) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create buffer!");
     }
+    VkBufferPtr buffer(rawBuffer, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(deviceManager_.device()));
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(deviceManager_.device(), buffer, &memRequirements); //  Определение требований к памяти
-
-    VkMemoryAllocateInfo allocInfo{}; // Выделение видеопамяти
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = VulkanUtils::findMemoryType(
-        deviceManager_.physicalDevice(),
-        memRequirements.memoryTypeBits,
-        properties // Используем переданные свойства памяти
-    );
-
-    if (vkAllocateMemory(deviceManager_.device(), &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate buffer memory!");
-    }
+    // Место в общем блоке памяти нужного типа (MemoryAllocator), а не своё vkAllocateMemory
+    bufferMemory = deviceManager_.allocator().allocateBuffer(rawBuffer, properties);
+    return buffer;
+}
 
-    vkBindBufferMemory(deviceManager_.device(), buffer, bufferMemory, 0);
+void BufferManager::createIndexBuffer(Mesh& mesh, const uint32_t* indexData, size_t count) {
+    createIndexBuffer(mesh, count, [&](void* staging) { memcpy(staging, indexData, sizeof(uint32_t) * count); });
 }
 
-void BufferManager::createIndexBuffer() {
-    if (indices.empty()) {
+void BufferManager::createIndexBuffer(Mesh& mesh, size_t count, const std::function<void(void*)>& fill) {
+    if (count == 0) {
         throw std::runtime_error("Index data is empty!");
     }
 
-    VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size(); // Расчет размера буфера
+    VkDeviceSize bufferSize = sizeof(uint32_t) * count; // Расчет размера буфера
+    mesh.indexCount_ = static_cast<uint32_t>(count);
 
-    // Создание staging буфера
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(
+    // Создание staging буфера; память staging-буфера освобождается при выходе из функции
+    MemoryAllocation stagingBufferMemory;
+    VkBufferPtr stagingBuffer = createBuffer(
         bufferSize,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT, // Только для копирования
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | //HOST_VISIBLE: Доступна для CPU
          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, //HOST_COHERENT: Автоматическая синхронизация (без ручного flush)
-        stagingBuffer,
         stagingBufferMemory
     );
 
-    // Заполнение staging буфера
-    void* data;
-    vkMapMemory(deviceManager_.device(), stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, indices.data(), static_cast<size_t>(bufferSize));
-    vkUnmapMemory(deviceManager_.device(), stagingBufferMemory);
+    // Заполнение staging буфера: память блока отображена постоянно
+    fill(stagingBufferMemory.mapped());
 
     // Создание основного индексного буфера
-    VkBuffer rawIndexBuffer;
-    VkDeviceMemory rawIndexBufferMemory;
-    createBuffer(
+    mesh.indexBuffer_ = createBuffer(
         bufferSize,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, //Оптимальная GPU-память
-        rawIndexBuffer,
-        rawIndexBufferMemory
+        mesh.indexBufferMemory_
     );
 
     // Копирование данных из staging в основной буфер
-    copyBuffer(stagingBuffer, rawIndexBuffer, bufferSize);
-
-    // Оборачивание в умные указатели
-    indexBuffer = VkBufferPtr(
-        rawIndexBuffer,
-        VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(deviceManager_.device())
-    );
-    indexBufferMemory = VkDeviceMemoryPtr(
-        rawIndexBufferMemory,
-        VulkanDeleter<VkDeviceMemory_T, vkFreeMemory, VkDevice>(deviceManager_.device())
-    );
-
-    // Очистка staging ресурсов
-    vkDestroyBuffer(deviceManager_.device(), stagingBuffer, nullptr);
-    vkFreeMemory(deviceManager_.device(), stagingBufferMemory, nullptr);
+    copyBuffer(stagingBuffer.get(), mesh.indexBuffer_.get(), bufferSize);
+    mesh.gpuBytes_ += bufferSize;
 }
 
-void BufferManager::createVertexBuffer() {
-    if (vertices.empty()) {
+void BufferManager::createVertexBuffer(Mesh& mesh, const Vertex* vertexData, size_t count) {
+    if (count == 0) {
         throw std::runtime_error("Vertex data is empty!");
     }
+    mesh.vertexCount_ = static_cast<uint32_t>(count);
+
+    if (mesh.vertexFormat_ == VertexFormat::PACKED && hasVertexColors(vertexData, count)) {
+        // PackedVertex не хранит цвет: сетка с цветами вершин остаётся в полном формате
+        std::cerr << "Packed vertex format does not store vertex colors, using full vertices" << std::endl;
+        mesh.vertexFormat_ = VertexFormat::FULL;
+    }
+    if (mesh.vertexFormat_ == VertexFormat::PACKED) {
+        const auto startTime = std::chrono::steady_clock::now();
+        mesh.vertexQuantization_ = VertexPacking::computeQuantization(vertexData, count);
+        std::vector<PackedVertex> packed(count);
+        VertexPacking::encode(vertexData, count, mesh.vertexQuantization_, packed.data());
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+        std::cout << "Vertices packed in " << elapsed << " ms: " << count << " x " << sizeof(PackedVertex)
+                  << " B = " << count * sizeof(PackedVertex) / (1024.0 * 1024.0) << " MB (full format "
+                  << count * sizeof(Vertex) / (1024.0 * 1024.0) << " MB)" << std::endl;
+        createDeviceVertexBuffer(mesh, packed.data(), sizeof(PackedVertex) * count);
+    } else {
+        createDeviceVertexBuffer(mesh, vertexData, sizeof(Vertex) * count);
+    }
+}
 
-    VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+void BufferManager::createDeviceVertexBuffer(Mesh& mesh, const void* vertexData, VkDeviceSize bufferSize) {
+    createDeviceVertexBuffer(mesh, bufferSize, [&](void* staging) { memcpy(staging, vertexData, static_cast<size_t>(bufferSize)); });
+}
 
-    // Создание staging ресурсов
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(
+void BufferManager::createDeviceVertexBuffer(Mesh& mesh, VkDeviceSize bufferSize, const std::function<void(void*)>& fill) {
+    // Создание staging ресурсов; освобождаются при выходе из функции
+    MemoryAllocation stagingBufferMemory;
+    VkBufferPtr stagingBuffer = createBuffer(
         bufferSize,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer,
         stagingBufferMemory
     );
 
     // Заполнение staging буфера
-    void* data;
-    vkMapMemory(deviceManager_.device(), stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, vertices.data(), static_cast<size_t>(bufferSize));
-    vkUnmapMemory(deviceManager_.device(), stagingBufferMemory);
+    fill(stagingBufferMemory.mapped());
 
     // Создание основного буфера
-    VkBuffer rawVertexBuffer;
-    VkDeviceMemory rawVertexBufferMemory;
-    createBuffer(
+    mesh.vertexBuffer_ = createBuffer(
         bufferSize,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        rawVertexBuffer,
-        rawVertexBufferMemory
+        mesh.vertexBufferMemory_
     );
 
     // Копирование данных
-    copyBuffer(stagingBuffer, rawVertexBuffer, bufferSize);
+    copyBuffer(stagingBuffer.get(), mesh.vertexBuffer_.get(), bufferSize);
+    mesh.gpuBytes_ += bufferSize;
+}
+/**
+ * @brief Приёмник потоковой загрузки: порции геометрии идут через staging-буфер
+ * фиксированного размера прямо в device-local буферы
+ *
+ * Итоговый размер заранее неизвестен, поэтому device-local буферы растут
+ * удвоением, а старое содержимое переносится копированием на GPU. Память
+ * хоста ограничена staging-буфером.
+ */
+class BufferManager::StreamingUpload : public MeshSink {
+public:
+    static constexpr VkDeviceSize STAGING_SIZE = 8u << 20;
+
+    explicit StreamingUpload(BufferManager& owner)
+        : owner_(owner),
+          staging_(owner_.createBuffer(STAGING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingMemory_)) {
+        vertices_.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        indices_.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    }
 
-    // Оборачиваем в умные указатели
-    vertexBuffer = VkBufferPtr(
-        rawVertexBuffer,
-        VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(deviceManager_.device())
-    );
-    vertexBufferMemory = VkDeviceMemoryPtr(
-        rawVertexBufferMemory,
-        VulkanDeleter<VkDeviceMemory_T, vkFreeMemory, VkDevice>(deviceManager_.device())
-    );
+    void consume(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) override {
+        append(vertices_, vertices.data(), vertices.size() * sizeof(Vertex));
+        append(indices_, indices.data(), indices.size() * sizeof(uint32_t));
+    }
 
-    // Очистка staging ресурсов
-    vkDestroyBuffer(deviceManager_.device(), stagingBuffer, nullptr);
-    vkFreeMemory(deviceManager_.device(), stagingBufferMemory, nullptr);
-}
-void BufferManager::createUniformBuffers() {
-    VkDeviceSize bufferSize = sizeof(UniformBufferObject);
-
-    uniformBuffersMapped.resize(Constants::MAX_FRAMES_IN_FLIGHT);
-
-    for (size_t i = 0; i < Constants::MAX_FRAMES_IN_FLIGHT; i++) {
-        VkBuffer buffer;
-        VkDeviceMemory memory;
-
-        createBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 
-            buffer, memory);
-
-        uniformBuffers.emplace_back(
-            buffer,
-            VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(deviceManager_.device()));
-    
-        uniformBuffersMemory.emplace_back(
-            memory,
-            VulkanDeleter<VkDeviceMemory_T, vkFreeMemory, VkDevice>(deviceManager_.device()));
-        
-        vkMapMemory(deviceManager_.device(), uniformBuffersMemory.back().get(), 
-            0, bufferSize, 0, &uniformBuffersMapped[i]);
+    /**
+     * @brief Передаёт накопленные буферы во владение сетки
+     */
+    void finish(Mesh& mesh) {
+        if (vertices_.used == 0 || indices_.used == 0) {
+            throw std::runtime_error("Streamed model has no geometry!");
+        }
+        mesh.vertexBufferMemory_ = std::move(vertices_.memory);
+        mesh.vertexBuffer_ = std::move(vertices_.buffer);
+        mesh.indexBufferMemory_ = std::move(indices_.memory);
+        mesh.indexBuffer_ = std::move(indices_.buffer);
+        mesh.vertexCount_ = static_cast<uint32_t>(vertices_.used / sizeof(Vertex));
+        mesh.indexCount_ = static_cast<uint32_t>(indices_.used / sizeof(uint32_t));
+        mesh.gpuBytes_ += vertices_.capacity + indices_.capacity;
+        vertices_ = DeviceArray{};
+        indices_ = DeviceArray{};
+    }
+
+private:
+    struct DeviceArray {
+        MemoryAllocation memory;
+        VkBufferPtr buffer{nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)};
+        VkDeviceSize capacity = 0;
+        VkDeviceSize used = 0;
+        VkBufferUsageFlags usage = 0;
+    };
+
+    void reserve(DeviceArray& array, VkDeviceSize required) {
+        if (required <= array.capacity) {
+            return;
+        }
+        VkDeviceSize capacity = std::max<VkDeviceSize>(array.capacity * 2, STAGING_SIZE);
+        while (capacity < required) {
+            capacity *= 2;
+        }
+
+        DeviceArray grown;
+        grown.capacity = capacity;
+        grown.used = array.used;
+        grown.usage = array.usage;
+        grown.buffer = owner_.createBuffer(capacity,
+            array.usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, grown.memory);
+        if (array.used > 0) {
+            owner_.copyBuffer(array.buffer.get(), grown.buffer.get(), array.used);
+        }
+        array = std::move(grown); // Прежний буфер и его память освобождаются
     }
+
+    void append(DeviceArray& array, const void* data, VkDeviceSize size) {
+        reserve(array, array.used + size);
+        const auto* bytes = static_cast<const char*>(data);
+        for (VkDeviceSize offset = 0; offset < size; offset += STAGING_SIZE) {
+            const VkDeviceSize piece = std::min(STAGING_SIZE, size - offset);
+            memcpy(stagingMemory_.mapped(), bytes + offset, static_cast<size_t>(piece));
+            owner_.copyBuffer(staging_.get(), array.buffer.get(), piece, 0, array.used); // Ждёт завершения копирования
+            array.used += piece;
+        }
+    }
+
+    BufferManager& owner_;
+    MemoryAllocation stagingMemory_;
+    VkBufferPtr staging_;
+    DeviceArray vertices_;
+    DeviceArray indices_;
+};
+
+void BufferManager::streamGeometry(const Options& options, Mesh& mesh) {
+    ObjStreamReader::Settings settings;
+    settings.memoryLimit = options.streamMemoryLimitMB << 20;
+    settings.windowSize = std::min<size_t>(settings.windowSize, settings.memoryLimit / 8);
+    settings.batchVertices = std::max<size_t>(1024, settings.memoryLimit / 8 / sizeof(Vertex));
+    settings.weldEpsilon = options.weldEpsilon;
+
+    StreamingUpload upload(*this);
+    ObjStreamReader reader(settings);
+    reader.read(modelPath(options), upload);
+    upload.finish(mesh);
+
+    const ObjStreamReader::Stats& stats = reader.getStats();
+    std::cout << "OBJ streamed: " << stats.bytesRead / (1024.0 * 1024.0) << " MB in "
+              << stats.seconds * 1000.0 << " ms (" << stats.megabytesPerSecond() << " MB/s, "
+              << stats.batchCount << " batches), peak tracked " << (stats.peakTrackedBytes >> 20)
+              << " MB of " << options.streamMemoryLimitMB << " MB, peak RSS "
+              << (stats.peakResidentBytes >> 20) << " MB" << std::endl;
 }
-void BufferManager::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
+
+void BufferManager::createUniformArena() {
+    // Область кадра в одном буфере; срезы раздаёт uniformArena_, а шейдер видит их через динамическое смещение
+    uniformBuffer_ = createBuffer(uniformArena_.size(), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, uniformMemory_);
+}
+void BufferManager::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size,
+    VkDeviceSize srcOffset, VkDeviceSize dstOffset) {
     VkCommandBuffer commandBuffer = beginSingleTimeCommands();
 
     VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.dstOffset = dstOffset;
     copyRegion.size = size;
     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 
@@ -221,12 +696,30 @@ void BufferManager::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    // Отправка в очередь
-    vkQueueSubmit(swapChainManager_.getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence;
+    if (vkCreateFence(deviceManager_.device(), &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create upload fence!");
+    }
+
+    // Отправка в очередь; очередь занята только на время vkQueueSubmit, а не до конца копирования,
+    // поэтому фоновая загрузка не останавливает кадры, которые в это время рисуются
+    VkResult result;
+    {
+        std::lock_guard<std::mutex> lock(swapChainManager_.getQueueMutex());
+        result = vkQueueSubmit(swapChainManager_.getGraphicsQueue(), 1, &submitInfo, fence);
+    }
     // Ожидание завершения
-    vkQueueWaitIdle(swapChainManager_.getGraphicsQueue());
+    if (result == VK_SUCCESS) {
+        vkWaitForFences(deviceManager_.device(), 1, &fence, VK_TRUE, UINT64_MAX);
+    }
+    vkDestroyFence(deviceManager_.device(), fence, nullptr);
 
     vkFreeCommandBuffers(deviceManager_.device(), commandPool_, 1, &commandBuffer);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit upload command buffer!");
+    }
 }
 void BufferManager::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) {
         VkCommandBuffer commandBuffer = beginSingleTimeCommands();
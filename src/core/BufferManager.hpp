@@ -3,6 +3,16 @@
 #include "SwapChainManager.hpp"
 #include "Vertex.hpp"
 #include "Constants.hpp"
+#include "Options.hpp"
+#include "PackedVertex.hpp"
+#include "MeshSimplifier.hpp"
+#include "Meshlet.hpp"
+#include "Material.hpp"
+#include "Mesh.hpp"
+#include "FrameArena.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -12,47 +22,150 @@
 class BufferManager {
     public:
         friend class TextureManager;
-        BufferManager(DeviceManager& deviceManager, VkCommandPool commandPool, SwapChainManager& swapChainManager);
+        friend class VirtualTextureStreamer;
+        /// Тег конструктора заглушки
+        struct PlaceholderGeometry {};
+
+        /**
+        * @brief Загружает модель из options и создаёт её буферы; может выполняться на фоновом потоке (AssetLoader)
+        *
+        * commandPool используется только потоком, который создаёт объект.
+        */
+        BufferManager(DeviceManager& deviceManager, VkCommandPool commandPool, SwapChainManager& swapChainManager,
+            const Options& options);
+
+        /**
+        * @brief Заглушка, которая рисуется до окончания фоновой загрузки: куб с ребром 1 и белым материалом
+        */
+        BufferManager(DeviceManager& deviceManager, VkCommandPool commandPool, SwapChainManager& swapChainManager,
+            PlaceholderGeometry);
 
-        VkBuffer getIndexBuffer() const {return indexBuffer.get();}
-        VkBuffer getVertexBuffer() const {return vertexBuffer.get();}
+        /**
+        * @brief Загружает модель из options в новую сетку реестра
+        * @return Номер сетки в getMeshes()
+        */
+        MeshId loadMesh(const Options& options);
+
+        /// Сетки в видеопамяти; все рисуются одним конвейером и общими uniform-буферами
+        MeshRegistry& getMeshes() {return meshes_;}
+        const MeshRegistry& getMeshes() const {return meshes_;}
+        /// Сетка, загруженная конструктором (модель или заглушка)
+        Mesh& getMesh() {return meshes_.get(primaryMesh_);}
+        const Mesh& getMesh() const {return meshes_.get(primaryMesh_);}
+
+        /// Байт uniform-данных на кадр: 4096 объектов по 256 байт
+        static constexpr VkDeviceSize UNIFORM_FRAME_BYTES = 1024 * 1024;
 
+        /// Срез uniform-буфера: куда писать данные и динамическое смещение для vkCmdBindDescriptorSets
+        struct UniformSlice {
+            void* data = nullptr;
+            uint32_t offset = 0;
+        };
+
+        /**
+        * @brief Начинает кадр: область uniform-буфера снова свободна
+        *
+        * Вызывается после ожидания fence предыдущего кадра, когда GPU её больше не читает.
+        */
+        void beginUniformFrame();
 
-        const std::vector<void*>& getUniformBuffersMapped() const;
-        const std::vector<VkBufferPtr>& getUniformBuffers() const;
+        /**
+        * @brief Выделяет size байт в области текущего кадра, выровненные по minUniformBufferOffsetAlignment
+        * @throws std::runtime_error если область кадра заполнена
+        */
+        UniformSlice allocateUniform(VkDeviceSize size);
+
+        /// Один постоянно отображённый буфер на все кадры; привязывается как UNIFORM_BUFFER_DYNAMIC
+        VkBuffer getUniformBuffer() const { return uniformBuffer_.get(); }
     private:
         DeviceManager& deviceManager_;
         VkCommandPool commandPool_;
         SwapChainManager& swapChainManager_;
 
-        VkBuffer rawVertexBuffer;
-        VkDeviceMemory rawVertexBufferMemory;
-        
-        VkBufferPtr indexBuffer;
-        VkDeviceMemoryPtr indexBufferMemory;
+        MemoryAllocation uniformMemory_;
+        VkBufferPtr uniformBuffer_;
+        FrameArena uniformArena_;
 
-        VkDeviceMemoryPtr vertexBufferMemory;
-        VkBufferPtr vertexBuffer;  ///< Вершинный буфер
-        
-        
-        std::vector<VkBufferPtr> uniformBuffers;
-        std::vector<VkDeviceMemoryPtr> uniformBuffersMemory;
-        std::vector<void*> uniformBuffersMapped;
+        MeshRegistry meshes_;
+        MeshId primaryMesh_ = MeshRegistry::INVALID_ID;
+
+        class StreamingUpload; ///< MeshSink, дописывающий порции геометрии прямо в device-local буферы
+
+        BufferManager(DeviceManager& deviceManager, VkCommandPool commandPool, SwapChainManager& swapChainManager);
+
+        std::unique_ptr<Mesh> createPlaceholderGeometry();
+
+        /**
+        * @brief Загружает модель (из кэша, если он актуален) и создаёт вершинный и индексный буферы сетки
+        */
+        void loadGeometry(const Options& options, Mesh& mesh);
+        void streamGeometry(const Options& options, Mesh& mesh);
 
         /**
-        * @brief Создает вершинный буфер и выделяет память
+        * @brief Загружает .glb/.gltf; без проходов обработки атрибуты пишутся прямо в staging-буферы
         */
-        void createVertexBuffer();
-        void createIndexBuffer();
-        void createUniformBuffers();
+        void loadGltf(const std::string& path, const Options& options, Mesh& mesh);
+
+        /**
+        * @brief Проходы оптимизации и цепочка LOD над геометрией в памяти CPU
+        */
+        void prepareGeometry(MeshData& data, uint32_t processing, Mesh& mesh);
+
+        /**
+        * @brief Создаёт буферы сетки, при --meshlets строит мешлеты и освобождает data
+        */
+        void uploadGeometry(MeshData& data, const Options& options, Mesh& mesh);
+
+        /**
+        * @brief Проходы MeshOptimizer, включённые в options, в виде флагов MeshCache::PROCESS_*
+        */
+        static uint32_t geometryProcessing(const Options& options);
+
+        /**
+        * @brief Применяет к data выбранные проходы и печатает метрики до и после
+        *
+        * Проходы, переставляющие треугольники, работают внутри диапазона каждого материала.
+        */
+        void optimizeGeometry(MeshData& data, uint32_t processing);
+
+        /**
+        * @brief Читает .mtl и дополняет таблицу материалов до хотя бы одного диапазона на весь LOD0
+        */
+        void resolveMaterials(Mesh& mesh);
+
+        /**
+        * @brief Дописывает в data.indices упрощённые уровни детализации и заполняет уровни сетки
+        */
+        void buildLods(MeshData& data, Mesh& mesh);
+
+        /**
+        * @brief Разбивает LOD0 на мешлеты, загружает их буфер и создаёт индексные буферы для отсечения на CPU
+        */
+        void buildMeshlets(Mesh& mesh, const Vertex* vertexData, size_t vertexCount, const uint32_t* indexData,
+            size_t indexCount);
+
+        /**
+        * @brief Создает вершинный буфер в формате сетки (при необходимости сжимая вершины)
+        */
+        void createVertexBuffer(Mesh& mesh, const Vertex* data, size_t count);
+        void createDeviceVertexBuffer(Mesh& mesh, const void* data, VkDeviceSize bufferSize);
+        /// fill записывает bufferSize байт в отображённый staging-буфер
+        void createDeviceVertexBuffer(Mesh& mesh, VkDeviceSize bufferSize, const std::function<void(void*)>& fill);
+        void createIndexBuffer(Mesh& mesh, const uint32_t* data, size_t count);
+        void createIndexBuffer(Mesh& mesh, size_t count, const std::function<void(void*)>& fill);
+        void createUniformArena();
 
         VkCommandBuffer beginSingleTimeCommands();
         void endSingleTimeCommands(VkCommandBuffer commandBuffer);
         void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
         void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
 
-        void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
-            VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+        /**
+        * @brief Создаёт буфер с памятью из MemoryAllocator; память HOST_VISIBLE уже отображена (bufferMemory.mapped())
+        */
+        VkBufferPtr createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags properties, MemoryAllocation& bufferMemory);
         
-        void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+        void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size,
+            VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
     };
\ No newline at end of file
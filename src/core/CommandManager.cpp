@@ -44,7 +44,8 @@ void CommandManager::createCommandBuffer() {
         throw std::runtime_error("failed to allocate command buffers!");
     }
 }
-void CommandManager::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer) {
+void CommandManager::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer,
+                                         const std::vector<DrawCall>& draws, const VertexQuantization& quantization) {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
@@ -89,11 +90,79 @@ void CommandManager::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 
     vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineManager_.getLayout(), 0, 1, &pipelineManager_.getDescriptorSets()[currentFrame_], 0, nullptr);
-    vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+    vkCmdPushConstants(commandBuffer, pipelineManager_.getLayout(), VK_SHADER_STAGE_VERTEX_BIT,
+                       0, sizeof(VertexQuantization), &quantization);
+    // Срез uniform-буфера выбирается динамическим смещением: у вызовов одного объекта оно общее
+    const VkDescriptorSet uniformSet = pipelineManager_.getUniformSet();
+    uint32_t boundUniform = draws.empty() ? 0 : draws.front().uniformOffset;
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineManager_.getLayout(), 0, 1,
+                            &uniformSet, 1, &boundUniform);
+
+    // Материалы — диапазоны общего индексного буфера; привязки меняются только при смене текстуры или цвета
+    const std::vector<VkDescriptorSet>& textureSets = pipelineManager_.getTextureDescriptorSets();
+    const std::vector<VkDescriptorSet>& virtualTextureSets = pipelineManager_.getVirtualTextureDescriptorSets();
+    VkPipelineLayout layout = pipelineManager_.getLayout();
+    // Общий массив текстур привязывается один раз: материал выбирает текстуру push-константой
+    const bool bindless = pipelineManager_.isBindless();
+    const VkDescriptorSet bindlessSet = pipelineManager_.getBindlessTextureSet();
+    if (bindless) {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &bindlessSet, 0, nullptr);
+    }
+    bool virtualPipeline = false;
+    bool virtualDrawn = false; ///< Был вызов с виртуальной текстурой: шейдер писал обратную связь
+    uint32_t boundTexture = UINT32_MAX;
+    const MaterialConstants* pushedConstants = nullptr;
+    for (const DrawCall& draw : draws) {
+        if ((draw.virtualTexture >= 0) != virtualPipeline) {
+            // Другая раскладка конвейера: набор кадра и push-константы привязываются заново
+            virtualPipeline = draw.virtualTexture >= 0;
+            layout = virtualPipeline ? pipelineManager_.getVirtualLayout() : pipelineManager_.getLayout();
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              virtualPipeline ? pipelineManager_.getVirtualPipeline() : pipelineManager_.getGraphicsPipeline());
+            vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(VertexQuantization), &quantization);
+            boundUniform = draw.uniformOffset;
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1,
+                                    &uniformSet, 1, &boundUniform);
+            if (bindless && !virtualPipeline) {
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &bindlessSet, 0, nullptr);
+            }
+            boundTexture = UINT32_MAX;
+            pushedConstants = nullptr;
+        }
+        if (draw.uniformOffset != boundUniform) {
+            // Другой объект: наборы старших номеров остаются привязанными, раскладка та же
+            boundUniform = draw.uniformOffset;
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1,
+                                    &uniformSet, 1, &boundUniform);
+        }
+        const uint32_t texture = virtualPipeline ? static_cast<uint32_t>(draw.virtualTexture) : draw.texture;
+        if ((virtualPipeline || !bindless) && texture != boundTexture) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1,
+                                    virtualPipeline ? &virtualTextureSets[texture] : &textureSets[texture], 0, nullptr);
+            boundTexture = texture;
+        }
+        if (!pushedConstants || *pushedConstants != draw.constants) {
+            vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_FRAGMENT_BIT,
+                               PipelineManager::MATERIAL_CONSTANTS_OFFSET, sizeof(MaterialConstants), &draw.constants);
+            pushedConstants = &draw.constants;
+        }
+        vkCmdDrawIndexed(commandBuffer, draw.indexCount, 1, draw.firstIndex, 0, 0);
+        virtualDrawn = virtualDrawn || virtualPipeline;
+    }
     
     vkCmdEndRenderPass(commandBuffer);
 
+    if (virtualDrawn) {
+        // Обратную связь виртуальных текстур CPU читает после fence кадра; одного fence мало,
+        // чтобы записи шейдера стали видны хосту
+        VkMemoryBarrier feedbackBarrier{};
+        feedbackBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        feedbackBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        feedbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                             1, &feedbackBarrier, 0, nullptr, 0, nullptr);
+    }
+
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to record command buffer!");
     }
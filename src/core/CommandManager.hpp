@@ -7,6 +7,19 @@
 #include "SwapChainManager.hpp"
 #include "PipelineManager.hpp"
 #include "Constants.hpp"
+#include "Material.hpp"
+
+/**
+ * @brief Один vkCmdDrawIndexed: диапазон индексного буфера и его материал
+ */
+struct DrawCall {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t texture = 0;        ///< Номер набора дескрипторов текстуры (PipelineManager::getTextureDescriptorSets)
+    int32_t virtualTexture = -1; ///< Номер виртуальной текстуры (getVirtualTextureDescriptorSets) или -1
+    MaterialConstants constants; ///< Push-константа фрагментного шейдера
+    uint32_t uniformOffset = 0;  ///< Динамическое смещение UniformBufferObject объекта (BufferManager::allocateUniform)
+};
 
 class CommandManager {
 public:
@@ -18,7 +31,18 @@ public:
     void createCommandPool();
     void createCommandBuffer();
     void createSyncObjects();
-    void recordCommandBuffer(VkCommandBuffer commandBuffer_, uint32_t imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer);
+    /**
+     * @brief Записывает проход рендера с вызовами draws в заданном порядке
+     *
+     * Конвейер привязывается один раз; набор set = 0 с динамическим смещением, набор текстуры
+     * и push-константа материала — только когда меняются по сравнению с предыдущим вызовом, поэтому
+     * draws стоит сортировать по текстуре. С общим массивом текстур
+     * (PipelineManager::isBindless) набор текстур тоже привязывается один раз, а
+     * текстуру выбирает MaterialConstants::texture. Вызовы с виртуальной текстурой рисуются
+     * вторым конвейером; чтобы он переключался один раз, их стоит ставить в конец.
+     */
+    void recordCommandBuffer(VkCommandBuffer commandBuffer_, uint32_t imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer,
+                             const std::vector<DrawCall>& draws, const VertexQuantization& quantization);
     
     
     VkCommandPool commandPool() const { return commandPool_.get(); }
@@ -44,6 +68,5 @@ private:
 
     PipelineManager& pipelineManager_;
 
-    size_t currentFrame_ = 0;
 
 };
\ No newline at end of file
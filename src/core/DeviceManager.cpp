@@ -1,4 +1,5 @@
 #include "DeviceManager.hpp"
+#include <algorithm>
 
 DeviceManager::DeviceManager(InstanceManager& instanceManager,SurfaceManager& surfaceManager) 
     : instanceManager_(instanceManager), surfaceManager_(surfaceManager){
@@ -54,6 +55,24 @@ void DeviceManager::createLogicalDevice() {
     // Определяем функциональность устройства
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // Сжатые текстуры BC1/BC5/BC7 из KTX2; без поддержки TextureManager декодирует исходные изображения
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice_, &supportedFeatures);
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    // Запись обратной связи виртуальных текстур из фрагментного шейдера; без неё они не используются
+    deviceFeatures.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics;
+
+    // Массив текстур материалов в одном наборе; без поддержки у каждой текстуры свой набор
+    VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    bindlessTextureLimit_ = queryBindlessTextureLimit();
+    if (bindlessTextureLimit_ > 0) {
+        deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+        indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+    }
+    enabledFeatures_ = deviceFeatures;
     
     // Информация о создании логического устройства
     VkDeviceCreateInfo createInfo{};
@@ -63,6 +82,7 @@ void DeviceManager::createLogicalDevice() {
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
     createInfo.pEnabledFeatures = &deviceFeatures;
+    createInfo.pNext = bindlessTextureLimit_ > 0 ? &indexingFeatures : nullptr;
 
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions_.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions_.data();
@@ -79,7 +99,38 @@ void DeviceManager::createLogicalDevice() {
         rawDevice,
         VulkanDeleter<VkDevice_T, vkDestroyDevice>()
     );
+    allocator_ = std::make_unique<MemoryAllocator>(device_.get(), physicalDevice_);
+}
+
+uint32_t DeviceManager::queryBindlessTextureLimit() const {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_2) {
+        return 0;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &indexingFeatures;
+    vkGetPhysicalDeviceFeatures2(physicalDevice_, &features);
+    if (!features.features.shaderSampledImageArrayDynamicIndexing || !indexingFeatures.descriptorBindingPartiallyBound ||
+        !indexingFeatures.descriptorBindingSampledImageUpdateAfterBind || !indexingFeatures.runtimeDescriptorArray) {
+        return 0;
+    }
 
+    // Комбинированный сэмплер считается и сэмплером, и изображением
+    VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &indexingProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice_, &properties2);
+    return std::min({indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                     indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                     indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+                     indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages});
 }
 
 QueueFamilyIndices DeviceManager::findQueueFamilies(VkPhysicalDevice device) {
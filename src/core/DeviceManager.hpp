@@ -1,9 +1,11 @@
 #pragma once
+#include <memory>
 #include <optional>
 #include <set>
 #include <vector>
 #include <vulkan/vulkan.h>
 #include "InstanceManager.hpp"
+#include "MemoryAllocator.hpp"
 #include "VulkanTypes.hpp"
 #include "VulkanUtils.hpp"
 #include "SurfaceManager.hpp"
@@ -36,6 +38,18 @@ public:
 
     VkDevice device() const { return device_.get(); }
     VkPhysicalDevice physicalDevice() const { return physicalDevice_; }
+    /// Видеопамять всех буферов и изображений устройства
+    MemoryAllocator& allocator() const { return *allocator_; }
+    /// Возможности, включённые при создании логического устройства
+    const VkPhysicalDeviceFeatures& enabledFeatures() const { return enabledFeatures_; }
+    /**
+     * @brief Включено ли индексирование дескрипторов для массива текстур (Vulkan 1.2)
+     *
+     * Частично заполненный массив с обновлением после привязки и индексом из push-константы.
+     */
+    bool supportsBindlessTextures() const { return bindlessTextureLimit_ > 0; }
+    /// Сколько текстур может быть в таком массиве; 0 — не поддерживается
+    uint32_t bindlessTextureLimit() const { return bindlessTextureLimit_; }
 
 
 
@@ -45,6 +59,9 @@ private:
 
     VkPhysicalDevice physicalDevice_ = VK_NULL_HANDLE;
     VkDevicePtr device_;
+    std::unique_ptr<MemoryAllocator> allocator_; ///< Уничтожается раньше устройства
+    VkPhysicalDeviceFeatures enabledFeatures_{};
+    uint32_t bindlessTextureLimit_ = 0;
 
     const std::vector<const char*> deviceExtensions_ = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
     
@@ -53,5 +70,7 @@ private:
     void createRenderPass();
     
     bool isDeviceSuitable(VkPhysicalDevice device);
+    /// Предел массива текстур с индексированием дескрипторов; 0 — устройство его не поддерживает
+    uint32_t queryBindlessTextureLimit() const;
     bool checkDeviceExtensionSupport(VkPhysicalDevice device);
 };
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "FrameArena.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+FrameArena::FrameArena(uint64_t frameCapacity, uint64_t alignment, uint32_t frameCount)
+    : frameCapacity_(alignUp(frameCapacity, std::max<uint64_t>(alignment, 1))),
+      alignment_(std::max<uint64_t>(alignment, 1)), frameCount_(frameCount), heads_(frameCount, 0) {
+    if ((alignment_ & (alignment_ - 1)) != 0) {
+        throw std::runtime_error("Frame arena alignment must be a power of two");
+    }
+    if (frameCount_ == 0 || frameCapacity_ == 0) {
+        throw std::runtime_error("Frame arena needs at least one non-empty frame");
+    }
+}
+
+void FrameArena::begin(uint32_t frame) {
+    if (frame >= frameCount_) {
+        throw std::runtime_error("Frame arena has no frame " + std::to_string(frame));
+    }
+    frame_ = frame;
+    heads_[frame_] = 0;
+}
+
+uint64_t FrameArena::allocate(uint64_t size) {
+    // Начало области кратно alignment, поэтому выравнивать достаточно смещение внутри неё
+    const uint64_t offset = alignUp(heads_[frame_], alignment_);
+    if (size > frameCapacity_ || offset > frameCapacity_ - size) {
+        return NO_SPACE;
+    }
+    heads_[frame_] = offset + size;
+    peak_ = std::max(peak_, heads_[frame_]);
+    return uint64_t{frame_} * frameCapacity_ + offset;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Линейное размещение данных кадра в одном буфере: у каждого кадра в полёте своя область
+ *
+ * Логика без Vulkan: смещения внутри буфера, который держит BufferManager.
+ * allocate() только сдвигает вершину области текущего кадра, поэтому тысячи
+ * объектов получают свои uniform-данные без выделений и обновлений
+ * дескрипторов. begin() сбрасывает область кадра целиком и вызывается, когда
+ * fence этого кадра сигнализирован и GPU её больше не читает.
+ */
+class FrameArena {
+public:
+    static constexpr uint64_t NO_SPACE = UINT64_MAX;
+
+    /**
+     * @param frameCapacity Байт на кадр; округляется вверх до alignment
+     * @param alignment minUniformBufferOffsetAlignment устройства, степень двойки
+     * @param frameCount Кадров в полёте
+     */
+    FrameArena(uint64_t frameCapacity, uint64_t alignment, uint32_t frameCount);
+
+    /// Делает frame текущим и освобождает всё, что было выделено в его области
+    void begin(uint32_t frame);
+
+    /**
+     * @brief Выделяет size байт в области текущего кадра
+     * @return Смещение от начала буфера, кратное alignment, или NO_SPACE, если область заполнена
+     */
+    uint64_t allocate(uint64_t size);
+
+    uint64_t size() const { return frameCapacity_ * frameCount_; } ///< Размер буфера на все кадры
+    uint64_t frameCapacity() const { return frameCapacity_; }
+    uint64_t alignment() const { return alignment_; }
+    uint32_t frame() const { return frame_; }
+    uint64_t used() const { return heads_[frame_]; }   ///< Байт в области текущего кадра
+    uint64_t peak() const { return peak_; }            ///< Наибольшее used() за всё время
+
+private:
+    uint64_t frameCapacity_;
+    uint64_t alignment_;
+    uint32_t frameCount_;
+    uint32_t frame_ = 0;
+    std::vector<uint64_t> heads_; ///< Вершина каждой области относительно её начала
+    uint64_t peak_ = 0;
+};
@@ -0,0 +1,727 @@
+#include "GltfLoader.hpp"
+#include "Parallel.hpp"
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    constexpr uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+    constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+    constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+
+    constexpr uint32_t BYTE = 5120;
+    constexpr uint32_t UNSIGNED_BYTE = 5121;
+    constexpr uint32_t SHORT = 5122;
+    constexpr uint32_t UNSIGNED_SHORT = 5123;
+    constexpr uint32_t UNSIGNED_INT = 5125;
+    constexpr uint32_t FLOAT = 5126;
+
+    constexpr uint32_t MODE_TRIANGLES = 4;
+    constexpr size_t VERTEX_BLOCK = 16384; ///< Вершин в одной задаче writeVertices
+
+    uint32_t read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value)); // GLB — little-endian, как и все целевые платформы
+        return value;
+    }
+
+    /// Неотрицательное целое поле JSON (индекс, количество, смещение)
+    size_t toIndex(const Json::Value& value, const char* what) {
+        const double number = value.number(-1.0);
+        if (!value.isNumber() || number < 0.0 || number != std::floor(number) || number > 9007199254740992.0) {
+            throw std::runtime_error(std::string("glTF: invalid ") + what);
+        }
+        return static_cast<size_t>(number);
+    }
+
+    size_t componentSize(uint32_t componentType) {
+        switch (componentType) {
+        case BYTE:
+        case UNSIGNED_BYTE: return 1;
+        case SHORT:
+        case UNSIGNED_SHORT: return 2;
+        case UNSIGNED_INT:
+        case FLOAT: return 4;
+        default: throw std::runtime_error("glTF: unknown accessor component type " + std::to_string(componentType));
+        }
+    }
+
+    uint32_t componentCount(const std::string& type) {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4") return 4;
+        throw std::runtime_error("glTF: unsupported accessor type " + type);
+    }
+
+    /// Путь из URI: glTF экранирует пробелы и прочие символы как %XX
+    std::string decodeUri(const std::string& uri) {
+        std::string out;
+        for (size_t i = 0; i < uri.size(); ++i) {
+            if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+                std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+                out += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else {
+                out += uri[i];
+            }
+        }
+        return out;
+    }
+
+    bool isDataUri(const std::string& uri) {
+        return uri.compare(0, 5, "data:") == 0;
+    }
+
+    glm::mat4 nodeTransform(const Json::Value& node) {
+        const Json::Value& matrix = node["matrix"];
+        if (matrix.size() == 16) {
+            float values[16];
+            for (size_t i = 0; i < 16; ++i) {
+                values[i] = static_cast<float>(matrix[i].number());
+            }
+            return glm::make_mat4(values); // Как и в glm, по столбцам
+        }
+
+        glm::mat4 transform(1.0f);
+        const Json::Value& translation = node["translation"];
+        if (translation.size() == 3) {
+            transform[3] = glm::vec4(translation[0].number(), translation[1].number(), translation[2].number(), 1.0f);
+        }
+        const Json::Value& rotation = node["rotation"];
+        if (rotation.size() == 4) {
+            const glm::quat q(static_cast<float>(rotation[3].number(1.0)), static_cast<float>(rotation[0].number()),
+                              static_cast<float>(rotation[1].number()), static_cast<float>(rotation[2].number()));
+            transform = transform * glm::mat4_cast(q);
+        }
+        const Json::Value& scale = node["scale"];
+        if (scale.size() == 3) {
+            transform = transform * glm::mat4(glm::vec4(scale[0].number(1.0), 0.0f, 0.0f, 0.0f),
+                                              glm::vec4(0.0f, scale[1].number(1.0), 0.0f, 0.0f),
+                                              glm::vec4(0.0f, 0.0f, scale[2].number(1.0), 0.0f),
+                                              glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        }
+        return transform;
+    }
+
+    /// Дописывает в json описание массива и выравнивает бинарный буфер до 4 байт
+    template <typename T>
+    size_t appendView(std::vector<uint8_t>& binary, const std::vector<T>& data) {
+        const size_t offset = binary.size();
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+        binary.insert(binary.end(), bytes, bytes + data.size() * sizeof(T));
+        binary.resize((binary.size() + 3) & ~size_t{3}, 0);
+        return offset;
+    }
+}
+
+GltfLoader::GltfLoader(const std::string& path) {
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+
+    if (!std::filesystem::exists(path)) {
+        throw std::runtime_error("glTF file not found: " + path);
+    }
+    directory_ = std::filesystem::path(path).parent_path().string();
+    files_.emplace_back(path);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(files_[0].data());
+    const size_t size = files_[0].size();
+    stats_.fileSize = size;
+
+    const uint8_t* binaryChunk = nullptr;
+    size_t binarySize = 0;
+    if (size >= 12 && read32(data) == GLB_MAGIC) {
+        if (read32(data + 4) != 2) {
+            throw std::runtime_error("Unsupported GLB container version in " + path);
+        }
+        const size_t length = std::min<size_t>(read32(data + 8), size);
+        if (length < 12) {
+            throw std::runtime_error("Truncated GLB header in " + path);
+        }
+        bool hasJson = false;
+        for (size_t offset = 12; length - offset >= 8;) {
+            const size_t chunkLength = read32(data + offset);
+            const uint32_t chunkType = read32(data + offset + 4);
+            offset += 8;
+            if (chunkLength > length - offset) {
+                throw std::runtime_error("Truncated GLB chunk in " + path);
+            }
+            if (chunkType == GLB_CHUNK_JSON && !hasJson) {
+                document_ = Json::parse(reinterpret_cast<const char*>(data + offset), chunkLength);
+                hasJson = true;
+            } else if (chunkType == GLB_CHUNK_BIN && binaryChunk == nullptr) {
+                binaryChunk = data + offset;
+                binarySize = chunkLength;
+            }
+            offset += std::min(length - offset, (chunkLength + 3) & ~size_t{3}); // Чанки выровнены на 4 байта
+        }
+        if (!hasJson) {
+            throw std::runtime_error("GLB has no JSON chunk: " + path);
+        }
+    } else {
+        document_ = Json::parse(reinterpret_cast<const char*>(data), size);
+    }
+
+    if (document_["asset"]["version"].string().compare(0, 2, "2.") != 0) {
+        throw std::runtime_error("Only glTF 2.0 is supported: " + path);
+    }
+    const Json::Value& required = document_["extensionsRequired"];
+    if (required.size() > 0) { // Draco, meshopt и прочие сжатия не поддерживаются
+        throw std::runtime_error("glTF requires unsupported extension " + required[0].string() + ": " + path);
+    }
+
+    loadBuffers(binaryChunk, binarySize);
+    collectPrimitives();
+    stats_.parseSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+}
+
+void GltfLoader::loadBuffers(const uint8_t* binaryChunk, size_t binarySize) {
+    const Json::Value& buffers = document_["buffers"];
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const size_t byteLength = toIndex(buffers[i]["byteLength"], "buffer length");
+        const std::string& uri = buffers[i]["uri"].string();
+
+        if (uri.empty()) { // Буфер без uri — бинарный чанк GLB
+            if (binaryChunk == nullptr || binarySize < byteLength) {
+                throw std::runtime_error("glTF buffer " + std::to_string(i) + " does not fit the GLB binary chunk");
+            }
+            buffers_.push_back(binaryChunk);
+        } else if (isDataUri(uri)) {
+            throw std::runtime_error("glTF buffers in data URIs are not supported, convert the asset to .glb");
+        } else {
+            files_.emplace_back((std::filesystem::path(directory_) / decodeUri(uri)).string());
+            if (files_.back().size() < byteLength) {
+                throw std::runtime_error("glTF buffer file is shorter than its byteLength: " + uri);
+            }
+            stats_.fileSize += files_.back().size();
+            buffers_.push_back(reinterpret_cast<const uint8_t*>(files_.back().data()));
+        }
+        bufferSizes_.push_back(byteLength);
+    }
+}
+
+void GltfLoader::bufferView(size_t index, const uint8_t*& data, size_t& size, size_t& stride) const {
+    const Json::Value& view = document_["bufferViews"][index];
+    if (!view.isObject()) {
+        throw std::runtime_error("glTF: bufferView " + std::to_string(index) + " does not exist");
+    }
+    const size_t buffer = toIndex(view["buffer"], "bufferView buffer");
+    if (buffer >= buffers_.size()) {
+        throw std::runtime_error("glTF: bufferView references a missing buffer");
+    }
+    const size_t offset = view.has("byteOffset") ? toIndex(view["byteOffset"], "bufferView offset") : 0;
+    size = toIndex(view["byteLength"], "bufferView length");
+    if (offset > bufferSizes_[buffer] || size > bufferSizes_[buffer] - offset) {
+        throw std::runtime_error("glTF: bufferView " + std::to_string(index) + " is out of buffer bounds");
+    }
+    stride = view.has("byteStride") ? toIndex(view["byteStride"], "bufferView stride") : 0;
+    data = buffers_[buffer] + offset;
+}
+
+GltfLoader::Accessor GltfLoader::accessor(const Json::Value& index, uint32_t maxComponents) const {
+    Accessor result;
+    if (index.isNull()) {
+        return result;
+    }
+    const Json::Value& json = document_["accessors"][toIndex(index, "accessor index")];
+    if (!json.isObject()) {
+        throw std::runtime_error("glTF: accessor does not exist");
+    }
+    if (json.has("sparse")) {
+        throw std::runtime_error("glTF: sparse accessors are not supported");
+    }
+    if (!json.has("bufferView")) {
+        throw std::runtime_error("glTF: accessors without bufferView are not supported");
+    }
+
+    result.componentType = static_cast<uint32_t>(toIndex(json["componentType"], "accessor component type"));
+    result.components = componentCount(json["type"].string());
+    result.normalized = json["normalized"].boolean();
+    result.count = toIndex(json["count"], "accessor count");
+    if (result.components > maxComponents) {
+        throw std::runtime_error("glTF: accessor has too many components");
+    }
+
+    const uint8_t* viewData = nullptr;
+    size_t viewSize = 0;
+    size_t viewStride = 0;
+    bufferView(toIndex(json["bufferView"], "accessor bufferView"), viewData, viewSize, viewStride);
+
+    const size_t offset = json.has("byteOffset") ? toIndex(json["byteOffset"], "accessor offset") : 0;
+    const size_t elementSize = componentSize(result.componentType) * result.components;
+    result.stride = viewStride != 0 ? viewStride : elementSize;
+    if (result.stride < elementSize) {
+        throw std::runtime_error("glTF: bufferView stride is smaller than the accessor element");
+    }
+    if (result.count > 0) {
+        // Проверка через деление: count и stride приходят из файла и могут переполнить произведение
+        if (offset > viewSize || elementSize > viewSize - offset ||
+            result.count - 1 > (viewSize - offset - elementSize) / result.stride) {
+            throw std::runtime_error("glTF: accessor is out of bufferView bounds");
+        }
+    }
+    result.data = viewData + offset;
+    return result;
+}
+
+void GltfLoader::collectPrimitives() {
+    std::vector<int> materialOfPrimitive;
+    const Json::Value& scenes = document_["scenes"];
+    const Json::Value& nodes = document_["nodes"];
+
+    if (scenes.size() == 0) {
+        // Без сцен показываем каждую сетку один раз
+        for (size_t mesh = 0; mesh < document_["meshes"].size(); ++mesh) {
+            addMesh(mesh, glm::mat4(1.0f), materialOfPrimitive);
+        }
+    } else {
+        const size_t sceneIndex = document_.has("scene") ? toIndex(document_["scene"], "scene index") : 0;
+        const Json::Value& roots = scenes[sceneIndex]["nodes"];
+
+        // Глубина ограничена числом узлов: цикл в иерархии — ошибка файла, а не бесконечная рекурсия
+        std::function<void(size_t, const glm::mat4&, size_t)> visit = [&](size_t index, const glm::mat4& parent,
+                                                                           size_t depth) {
+            const Json::Value& node = nodes[index];
+            if (!node.isObject() || depth > nodes.size()) {
+                throw std::runtime_error("glTF: invalid node hierarchy");
+            }
+            const glm::mat4 transform = parent * nodeTransform(node);
+            if (node.has("mesh")) {
+                addMesh(toIndex(node["mesh"], "node mesh"), transform, materialOfPrimitive);
+            }
+            const Json::Value& children = node["children"];
+            for (size_t i = 0; i < children.size(); ++i) {
+                visit(toIndex(children[i], "node child"), transform, depth + 1);
+            }
+        };
+        for (size_t i = 0; i < roots.size(); ++i) {
+            visit(toIndex(roots[i], "scene node"), glm::mat4(1.0f), 0);
+        }
+    }
+
+    if (primitives_.empty()) {
+        throw std::runtime_error("glTF scene has no triangle geometry");
+    }
+    buildMaterials(materialOfPrimitive);
+    computeBoundingSphere();
+}
+
+void GltfLoader::addMesh(size_t meshIndex, const glm::mat4& transform, std::vector<int>& materialOfPrimitive) {
+    const Json::Value& mesh = document_["meshes"][meshIndex];
+    if (!mesh.isObject()) {
+        throw std::runtime_error("glTF: mesh " + std::to_string(meshIndex) + " does not exist");
+    }
+    const Json::Value& primitives = mesh["primitives"];
+    for (size_t i = 0; i < primitives.size(); ++i) {
+        const Json::Value& json = primitives[i];
+        const Json::Value& attributes = json["attributes"];
+        if (json["mode"].number(MODE_TRIANGLES) != MODE_TRIANGLES || !attributes.has("POSITION")) {
+            std::cerr << "glTF: skipping a non-triangle primitive of mesh " << meshIndex << std::endl;
+            continue;
+        }
+
+        Primitive primitive;
+        primitive.position = accessor(attributes["POSITION"], 3);
+        primitive.normal = accessor(attributes["NORMAL"], 3);
+        primitive.tangent = accessor(attributes["TANGENT"], 4);
+        primitive.texCoord = accessor(attributes["TEXCOORD_0"], 2);
+        primitive.color = accessor(attributes["COLOR_0"], 4);
+        primitive.indices = accessor(json["indices"], 1);
+
+        const size_t vertexCount = primitive.position.count;
+        if (primitive.position.componentType != FLOAT || primitive.position.components != 3) {
+            throw std::runtime_error("glTF: POSITION must be a float VEC3");
+        }
+        for (const Accessor* attribute : {&primitive.normal, &primitive.tangent, &primitive.texCoord, &primitive.color}) {
+            if (attribute->present() && attribute->count != vertexCount) {
+                throw std::runtime_error("glTF: vertex attributes of a primitive have different counts");
+            }
+        }
+        if ((primitive.normal.present() && (primitive.normal.componentType != FLOAT || primitive.normal.components != 3)) ||
+            (primitive.tangent.present() && (primitive.tangent.componentType != FLOAT || primitive.tangent.components != 4))) {
+            throw std::runtime_error("glTF: NORMAL and TANGENT must be float VEC3 and VEC4");
+        }
+        if ((primitive.texCoord.present() && primitive.texCoord.components != 2) ||
+            (primitive.color.present() && primitive.color.components < 3)) {
+            throw std::runtime_error("glTF: TEXCOORD_0 must be VEC2 and COLOR_0 VEC3 or VEC4");
+        }
+        if (primitive.indices.present() && primitive.indices.componentType != UNSIGNED_BYTE &&
+            primitive.indices.componentType != UNSIGNED_SHORT && primitive.indices.componentType != UNSIGNED_INT) {
+            throw std::runtime_error("glTF: indices must be unsigned integers");
+        }
+        primitive.indexCount = primitive.indices.present() ? primitive.indices.count : vertexCount;
+        if (primitive.indexCount % 3 != 0) {
+            throw std::runtime_error("glTF: triangle primitive index count is not a multiple of 3");
+        }
+
+        primitive.transform = transform;
+        primitive.identity = transform == glm::mat4(1.0f);
+        primitive.flipWinding = glm::determinant(glm::mat3(transform)) < 0.0f;
+
+        const Json::Value& positionJson = document_["accessors"][toIndex(attributes["POSITION"], "accessor index")];
+        const Json::Value& minimum = positionJson["min"];
+        const Json::Value& maximum = positionJson["max"];
+        if (minimum.size() == 3 && maximum.size() == 3) {
+            primitive.boundsMin = {minimum[0].number(), minimum[1].number(), minimum[2].number()};
+            primitive.boundsMax = {maximum[0].number(), maximum[1].number(), maximum[2].number()};
+        } else { // min/max обязательны по спецификации, но экспортёры иногда их пропускают
+            primitive.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+            primitive.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+            for (size_t v = 0; v < vertexCount; ++v) {
+                glm::vec3 position;
+                std::memcpy(&position, primitive.position.data + v * primitive.position.stride, sizeof(position));
+                primitive.boundsMin = glm::min(primitive.boundsMin, position);
+                primitive.boundsMax = glm::max(primitive.boundsMax, position);
+            }
+        }
+
+        hasNormals_ = hasNormals_ && primitive.normal.present();
+        hasTangents_ = hasTangents_ && primitive.tangent.present();
+        materialOfPrimitive.push_back(json.has("material") ? static_cast<int>(toIndex(json["material"], "material index")) : -1);
+        primitives_.push_back(primitive);
+    }
+}
+
+void GltfLoader::buildMaterials(const std::vector<int>& materialOfPrimitive) {
+    // Материалы в порядке первого появления; -1 — примитивы без материала
+    std::vector<int> order;
+    std::vector<uint32_t> rank(primitives_.size());
+    for (size_t i = 0; i < primitives_.size(); ++i) {
+        auto found = std::find(order.begin(), order.end(), materialOfPrimitive[i]);
+        if (found == order.end()) {
+            found = order.insert(order.end(), materialOfPrimitive[i]);
+        }
+        rank[i] = static_cast<uint32_t>(found - order.begin());
+        primitives_[i].material = rank[i];
+    }
+    std::stable_sort(primitives_.begin(), primitives_.end(),
+                     [](const Primitive& a, const Primitive& b) { return a.material < b.material; });
+
+    for (Primitive& primitive : primitives_) {
+        primitive.firstVertex = vertexCount_;
+        primitive.firstIndex = indexCount_;
+        vertexCount_ += primitive.position.count;
+        indexCount_ += primitive.indexCount;
+        if (meshMaterials_.submeshes.empty() || meshMaterials_.submeshes.back().material != primitive.material) {
+            meshMaterials_.submeshes.push_back({static_cast<uint32_t>(primitive.firstIndex), 0, primitive.material});
+        }
+        meshMaterials_.submeshes.back().indexCount += static_cast<uint32_t>(primitive.indexCount);
+    }
+    if (vertexCount_ > std::numeric_limits<uint32_t>::max() || indexCount_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("glTF scene is too large for 32-bit indices");
+    }
+
+    const Json::Value& materials = document_["materials"];
+    std::unordered_map<size_t, int32_t> embeddedOfImage;
+    for (int id : order) {
+        Material material;
+        material.resolved = true; // У glTF нет внешних библиотек: материал без текстуры — просто белый
+        if (id >= 0) {
+            const Json::Value& json = materials[static_cast<size_t>(id)];
+            if (!json.isObject()) {
+                throw std::runtime_error("glTF: material " + std::to_string(id) + " does not exist");
+            }
+            material.name = json.has("name") ? json["name"].string() : "material" + std::to_string(id);
+
+            const Json::Value& pbr = json["pbrMetallicRoughness"];
+            const Json::Value& factor = pbr["baseColorFactor"];
+            if (factor.size() >= 3) {
+                material.diffuse = glm::vec3(factor[0].number(1.0), factor[1].number(1.0), factor[2].number(1.0));
+            }
+            const Json::Value& textureIndex = pbr["baseColorTexture"]["index"];
+            const Json::Value& source = textureIndex.isNull()
+                ? textureIndex
+                : document_["textures"][toIndex(textureIndex, "texture index")]["source"];
+            if (!source.isNull()) { // Без source — текстура только из расширения (например, KTX2)
+                const size_t imageIndex = toIndex(source, "image index");
+                const Json::Value& image = document_["images"][imageIndex];
+                const std::string& uri = image["uri"].string();
+                if (image.has("bufferView")) {
+                    const auto inserted = embeddedOfImage.emplace(imageIndex, static_cast<int32_t>(embeddedImageViews_.size()));
+                    if (inserted.second) {
+                        embeddedImageViews_.push_back(toIndex(image["bufferView"], "image bufferView"));
+                    }
+                    material.embeddedImage = inserted.first->second;
+                } else if (!uri.empty() && !isDataUri(uri)) {
+                    material.diffuseTexture = (std::filesystem::path(directory_) / decodeUri(uri)).generic_string();
+                } else {
+                    std::cerr << "glTF: image " << imageIndex << " of material " << material.name
+                              << " is not supported, using white" << std::endl;
+                }
+            }
+        }
+        meshMaterials_.materialNames.push_back(material.name);
+        materials_.push_back(std::move(material));
+    }
+}
+
+void GltfLoader::computeBoundingSphere() {
+    // Углы габаритов каждого примитива в координатах сцены; сфера вокруг общего параллелепипеда
+    std::vector<glm::vec3> corners;
+    for (const Primitive& primitive : primitives_) {
+        for (int corner = 0; corner < 8; ++corner) {
+            const glm::vec3 local((corner & 1) ? primitive.boundsMax.x : primitive.boundsMin.x,
+                                  (corner & 2) ? primitive.boundsMax.y : primitive.boundsMin.y,
+                                  (corner & 4) ? primitive.boundsMax.z : primitive.boundsMin.z);
+            corners.push_back(glm::vec3(primitive.transform * glm::vec4(local, 1.0f)));
+        }
+    }
+    glm::vec3 minimum = corners[0];
+    glm::vec3 maximum = corners[0];
+    for (const glm::vec3& corner : corners) {
+        minimum = glm::min(minimum, corner);
+        maximum = glm::max(maximum, corner);
+    }
+    const glm::vec3 center = (minimum + maximum) * 0.5f;
+    float radius = 0.0f;
+    for (const glm::vec3& corner : corners) {
+        radius = std::max(radius, glm::length(corner - center));
+    }
+    boundingSphere_ = glm::vec4(center, radius);
+}
+
+namespace {
+    /// Элемент аксессора в float с учётом normalized (правила glTF для целых компонент)
+    void readFloats(const uint8_t* source, uint32_t componentType, uint32_t components, bool normalized, float* out) {
+        for (uint32_t c = 0; c < components; ++c) {
+            switch (componentType) {
+            case FLOAT:
+                std::memcpy(&out[c], source + c * 4, 4);
+                break;
+            case UNSIGNED_BYTE:
+                out[c] = normalized ? source[c] / 255.0f : source[c];
+                break;
+            case BYTE: {
+                const float value = static_cast<int8_t>(source[c]);
+                out[c] = normalized ? std::max(value / 127.0f, -1.0f) : value;
+                break;
+            }
+            case UNSIGNED_SHORT: {
+                uint16_t value;
+                std::memcpy(&value, source + c * 2, 2);
+                out[c] = normalized ? value / 65535.0f : value;
+                break;
+            }
+            case SHORT: {
+                int16_t value;
+                std::memcpy(&value, source + c * 2, 2);
+                out[c] = normalized ? std::max(value / 32767.0f, -1.0f) : value;
+                break;
+            }
+            default: {
+                uint32_t value;
+                std::memcpy(&value, source + c * 4, 4);
+                out[c] = static_cast<float>(value);
+                break;
+            }
+            }
+        }
+    }
+
+    uint32_t readIndex(const uint8_t* source, uint32_t componentType) {
+        if (componentType == UNSIGNED_BYTE) {
+            return *source;
+        }
+        if (componentType == UNSIGNED_SHORT) {
+            uint16_t value;
+            std::memcpy(&value, source, 2);
+            return value;
+        }
+        uint32_t value;
+        std::memcpy(&value, source, 4);
+        return value;
+    }
+}
+
+void GltfLoader::writeVertices(Vertex* out, unsigned threadCount) const {
+    // Задачи — блоки вершин примитивов, чтобы одна большая сетка тоже делилась между потоками
+    struct Block {
+        const Primitive* primitive;
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Block> blocks;
+    for (const Primitive& primitive : primitives_) {
+        for (size_t begin = 0; begin < primitive.position.count; begin += VERTEX_BLOCK) {
+            blocks.push_back({&primitive, begin, std::min(primitive.position.count, begin + VERTEX_BLOCK)});
+        }
+    }
+
+    Parallel::forEach(blocks.size(), [&](size_t b) {
+        const Primitive& p = *blocks[b].primitive;
+        const glm::mat3 linear(p.transform);
+        const glm::mat3 normalMatrix = glm::transpose(glm::inverse(linear));
+
+        for (size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            Vertex vertex{};
+            std::memcpy(&vertex.pos, p.position.data + i * p.position.stride, sizeof(vertex.pos));
+            if (p.normal.present()) {
+                std::memcpy(&vertex.normal, p.normal.data + i * p.normal.stride, sizeof(vertex.normal));
+            }
+            if (p.tangent.present()) {
+                std::memcpy(&vertex.tangent, p.tangent.data + i * p.tangent.stride, sizeof(vertex.tangent));
+            }
+            if (p.texCoord.present()) {
+                readFloats(p.texCoord.data + i * p.texCoord.stride, p.texCoord.componentType, 2,
+                           p.texCoord.normalized, &vertex.texCoord.x);
+                vertex.texCoord.y = 1.0f - vertex.texCoord.y;
+            } else {
+                vertex.texCoord = {0.0f, 1.0f};
+            }
+            vertex.color = glm::vec3(1.0f);
+            if (p.color.present()) {
+                float color[4];
+                readFloats(p.color.data + i * p.color.stride, p.color.componentType, p.color.components,
+                           p.color.normalized, color);
+                vertex.color = glm::vec3(color[0], color[1], color[2]);
+            }
+
+            if (!p.identity) {
+                vertex.pos = glm::vec3(p.transform * glm::vec4(vertex.pos, 1.0f));
+                if (vertex.normal != glm::vec3(0.0f)) {
+                    vertex.normal = glm::normalize(normalMatrix * vertex.normal);
+                }
+                const glm::vec3 tangent = linear * glm::vec3(vertex.tangent);
+                if (tangent != glm::vec3(0.0f)) {
+                    vertex.tangent = glm::vec4(glm::normalize(tangent), vertex.tangent.w);
+                }
+            }
+            out[p.firstVertex + i] = vertex; // Целиком и по порядку: годится для write-combined памяти
+        }
+    }, threadCount);
+}
+
+void GltfLoader::writeIndices(uint32_t* out) const {
+    for (const Primitive& p : primitives_) {
+        uint32_t* target = out + p.firstIndex;
+        const uint32_t base = static_cast<uint32_t>(p.firstVertex);
+        const size_t vertexCount = p.position.count;
+
+        if (!p.indices.present()) {
+            for (size_t i = 0; i < p.indexCount; i += 3) {
+                const uint32_t first = base + static_cast<uint32_t>(i);
+                target[i] = first;
+                target[i + 1] = p.flipWinding ? first + 2 : first + 1;
+                target[i + 2] = p.flipWinding ? first + 1 : first + 2;
+            }
+            continue;
+        }
+
+        const Accessor& indices = p.indices;
+        if (indices.componentType == UNSIGNED_INT && indices.stride == 4 && base == 0 && !p.flipWinding) {
+            // Раскладка совпадает с индексным буфером: проверяем диапазон по отображённому файлу и копируем целиком
+            for (size_t i = 0; i < indices.count; ++i) {
+                if (readIndex(indices.data + i * 4, UNSIGNED_INT) >= vertexCount) {
+                    throw std::runtime_error("glTF: vertex index out of range");
+                }
+            }
+            std::memcpy(target, indices.data, indices.count * sizeof(uint32_t));
+            continue;
+        }
+
+        for (size_t i = 0; i < indices.count; i += 3) {
+            uint32_t corner[3];
+            for (int k = 0; k < 3; ++k) {
+                corner[k] = readIndex(indices.data + (i + k) * indices.stride, indices.componentType);
+                if (corner[k] >= vertexCount) {
+                    throw std::runtime_error("glTF: vertex index out of range");
+                }
+            }
+            target[i] = base + corner[0];
+            target[i + 1] = base + corner[p.flipWinding ? 2 : 1];
+            target[i + 2] = base + corner[p.flipWinding ? 1 : 2];
+        }
+    }
+}
+
+std::vector<std::vector<uint8_t>> GltfLoader::copyEmbeddedImages() const {
+    std::vector<std::vector<uint8_t>> images;
+    for (size_t view : embeddedImageViews_) {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        size_t stride = 0;
+        bufferView(view, data, size, stride);
+        images.emplace_back(data, data + size);
+    }
+    return images;
+}
+
+void GltfLoader::writeGlb(const std::string& path, const std::vector<Vertex>& vertices,
+                          const std::vector<uint32_t>& indices) {
+    std::vector<glm::vec3> positions(vertices.size());
+    std::vector<glm::vec3> normals(vertices.size());
+    std::vector<glm::vec2> texCoords(vertices.size());
+    std::vector<glm::vec4> tangents(vertices.size());
+    glm::vec3 minimum(std::numeric_limits<float>::max());
+    glm::vec3 maximum(-std::numeric_limits<float>::max());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        positions[i] = vertices[i].pos;
+        normals[i] = vertices[i].normal;
+        texCoords[i] = {vertices[i].texCoord.x, 1.0f - vertices[i].texCoord.y};
+        tangents[i] = vertices[i].tangent;
+        minimum = glm::min(minimum, positions[i]);
+        maximum = glm::max(maximum, positions[i]);
+    }
+
+    std::vector<uint8_t> binary;
+    const size_t offsets[] = {appendView(binary, positions), appendView(binary, normals), appendView(binary, texCoords),
+                              appendView(binary, tangents), appendView(binary, indices)};
+    const size_t lengths[] = {positions.size() * sizeof(glm::vec3), normals.size() * sizeof(glm::vec3),
+                              texCoords.size() * sizeof(glm::vec2), tangents.size() * sizeof(glm::vec4),
+                              indices.size() * sizeof(uint32_t)};
+    const char* types[] = {"VEC3", "VEC3", "VEC2", "VEC4", "SCALAR"};
+
+    std::ostringstream json;
+    json << std::setprecision(9)
+         << R"({"asset":{"version":"2.0","generator":"3d-Viewer"},"scene":0,"scenes":[{"nodes":[0]}],"nodes":[{"mesh":0}],)"
+         << R"("meshes":[{"primitives":[{"attributes":{"POSITION":0,"NORMAL":1,"TEXCOORD_0":2,"TANGENT":3},"indices":4}]}],)"
+         << R"("buffers":[{"byteLength":)" << binary.size() << "}],\"bufferViews\":[";
+    for (int i = 0; i < 5; ++i) {
+        json << (i ? "," : "") << R"({"buffer":0,"byteOffset":)" << offsets[i] << R"(,"byteLength":)" << lengths[i]
+             << R"(,"target":)" << (i < 4 ? 34962 : 34963) << "}";
+    }
+    json << "],\"accessors\":[";
+    for (int i = 0; i < 5; ++i) {
+        json << (i ? "," : "") << R"({"bufferView":)" << i << R"(,"componentType":)" << (i < 4 ? FLOAT : UNSIGNED_INT)
+             << R"(,"count":)" << (i < 4 ? vertices.size() : indices.size()) << R"(,"type":")" << types[i] << "\"";
+        if (i == 0 && !vertices.empty()) {
+            json << R"(,"min":[)" << minimum.x << "," << minimum.y << "," << minimum.z << R"(],"max":[)"
+                 << maximum.x << "," << maximum.y << "," << maximum.z << "]";
+        }
+        json << "}";
+    }
+    json << "]}";
+
+    std::string text = json.str();
+    text.resize((text.size() + 3) & ~size_t{3}, ' '); // JSON-чанк дополняется пробелами
+
+    auto word = [](std::ofstream& file, uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    word(file, GLB_MAGIC);
+    word(file, 2);
+    word(file, static_cast<uint32_t>(12 + 8 + text.size() + 8 + binary.size()));
+    word(file, static_cast<uint32_t>(text.size()));
+    word(file, GLB_CHUNK_JSON);
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    word(file, static_cast<uint32_t>(binary.size()));
+    word(file, GLB_CHUNK_BIN);
+    file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to write GLB: " + path);
+    }
+}
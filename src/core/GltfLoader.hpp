@@ -0,0 +1,129 @@
+#pragma once
+#include "Json.hpp"
+#include "MappedFile.hpp"
+#include "Material.hpp"
+#include "Vertex.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Загрузчик glTF 2.0 (.glb и .gltf с внешними .bin)
+ *
+ * Файл и его буферы отображаются в память; конструктор разбирает только JSON
+ * и проверяет границы аксессоров, а сами атрибуты читаются из отображения
+ * прямо в память назначения (writeVertices/writeIndices), которой обычно
+ * служит staging-буфер. Промежуточных std::vector нет, а индексы uint32 без
+ * смещения копируются одним memcpy.
+ *
+ * Примитивы всех узлов сцены собираются в одну сетку с учётом преобразований
+ * узлов и упорядочиваются по материалам, так что каждый материал занимает один
+ * непрерывный диапазон индексов. Поддерживаются треугольные примитивы с
+ * атрибутами POSITION, NORMAL, TANGENT, TEXCOORD_0 и COLOR_0.
+ */
+class GltfLoader {
+public:
+    struct Stats {
+        size_t fileSize = 0;       ///< Размер .glb/.gltf и внешних буферов в байтах
+        double parseSeconds = 0.0; ///< Отображение файлов, разбор JSON и проверка аксессоров
+    };
+
+    /**
+     * @throws std::runtime_error если файл не открывается, повреждён или использует неподдерживаемые возможности
+     */
+    explicit GltfLoader(const std::string& path);
+
+    size_t vertexCount() const { return vertexCount_; }
+    size_t indexCount() const { return indexCount_; }
+    /// Есть ли у всех примитивов нормали / касательные (иначе их нужно строить)
+    bool hasNormals() const { return hasNormals_; }
+    bool hasTangents() const { return hasTangents_; }
+    /// Описанная сфера по min/max аксессоров POSITION: xyz — центр, w — радиус
+    const glm::vec4& getBoundingSphere() const { return boundingSphere_; }
+
+    /**
+     * @brief Записывает vertexCount() вершин в out, обходя отображённые буферы на нескольких потоках
+     *
+     * Каждая вершина пишется целиком и по порядку, поэтому out может указывать
+     * на write-combined память staging-буфера. Текстурные координаты
+     * переводятся в соглашение OBJ-загрузчика (v = 1 - v).
+     */
+    void writeVertices(Vertex* out, unsigned threadCount = 0) const;
+
+    /**
+     * @brief Записывает indexCount() индексов в out с учётом смещений примитивов
+     * @throws std::runtime_error если индекс выходит за вершины своего примитива
+     */
+    void writeIndices(uint32_t* out) const;
+
+    /// Диапазоны индексов по материалам (библиотек mtllib у glTF нет)
+    const MeshMaterials& getMeshMaterials() const { return meshMaterials_; }
+    /// Материалы в порядке MeshMaterials::materialNames, все resolved
+    const std::vector<Material>& getMaterials() const { return materials_; }
+    /// Копии встроенных в буферы изображений (PNG/JPEG), на которые ссылается Material::embeddedImage
+    std::vector<std::vector<uint8_t>> copyEmbeddedImages() const;
+
+    const Stats& getStats() const { return stats_; }
+
+    /**
+     * @brief Сохраняет сетку в .glb (один примитив без материала) — для конвертации OBJ и тестов
+     * @throws std::runtime_error если файл не удаётся записать
+     */
+    static void writeGlb(const std::string& path, const std::vector<Vertex>& vertices,
+                         const std::vector<uint32_t>& indices);
+
+private:
+    /// Проверенный аксессор: элемент i начинается с data + i * stride
+    struct Accessor {
+        const uint8_t* data = nullptr;
+        size_t count = 0;
+        size_t stride = 0;
+        uint32_t componentType = 0;
+        uint32_t components = 0;
+        bool normalized = false;
+
+        bool present() const { return data != nullptr; }
+    };
+
+    struct Primitive {
+        Accessor position;
+        Accessor normal;
+        Accessor tangent;
+        Accessor texCoord;
+        Accessor color;
+        Accessor indices;        ///< Отсутствует у неиндексированных примитивов
+        glm::vec3 boundsMin{0.0f}; ///< Габариты POSITION в координатах примитива
+        glm::vec3 boundsMax{0.0f};
+        glm::mat4 transform{1.0f};
+        bool identity = true;    ///< transform — единичная матрица
+        bool flipWinding = false; ///< Отрицательный определитель: порядок обхода меняется
+        uint32_t material = 0;   ///< Номер в materials_
+        size_t firstVertex = 0;
+        size_t firstIndex = 0;
+        size_t indexCount = 0;
+    };
+
+    std::vector<MappedFile> files_;           ///< Сам файл и внешние .bin
+    std::vector<const uint8_t*> buffers_;     ///< Начало каждого буфера glTF
+    std::vector<size_t> bufferSizes_;
+    std::vector<Primitive> primitives_;
+    std::vector<size_t> embeddedImageViews_;  ///< bufferView каждого встроенного изображения
+    Json::Value document_;
+    std::string directory_;
+    size_t vertexCount_ = 0;
+    size_t indexCount_ = 0;
+    bool hasNormals_ = true;
+    bool hasTangents_ = true;
+    glm::vec4 boundingSphere_{0.0f};
+    MeshMaterials meshMaterials_;
+    std::vector<Material> materials_;
+    Stats stats_;
+
+    void loadBuffers(const uint8_t* binaryChunk, size_t binarySize);
+    Accessor accessor(const Json::Value& index, uint32_t maxComponents) const;
+    void bufferView(size_t index, const uint8_t*& data, size_t& size, size_t& stride) const;
+    void collectPrimitives();
+    void addMesh(size_t meshIndex, const glm::mat4& transform, std::vector<int>& materialOfPrimitive);
+    void buildMaterials(const std::vector<int>& materialOfPrimitive);
+    void computeBoundingSphere();
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Hash {
+    inline uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    /**
+     * @brief Финальное перемешивание MurmurHash3: каждый бит входа влияет на все биты выхода
+     */
+    inline uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /**
+     * @brief 64-битный хеш произвольных байтов, обрабатывает по 8 байт за шаг
+     *
+     * Не криптографический; подходит для ключей кэша и хеш-таблиц.
+     */
+    inline uint64_t bytes(const void* data, size_t size) {
+        const uint64_t k1 = 0x87c37b91114253d5ULL;
+        const uint64_t k2 = 0x4cf5ad432745937fULL;
+        const auto* p = static_cast<const unsigned char*>(data);
+        uint64_t h = 0x9e3779b97f4a7c15ULL ^ (size * k1);
+
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, p + i, sizeof(word)); // Без требований к выравниванию
+            word *= k1;
+            word = rotl(word, 31);
+            word *= k2;
+            h ^= word;
+            h = rotl(h, 27) * 5 + 0x52dce729;
+        }
+
+        uint64_t tail = 0;
+        for (size_t shift = 0; i < size; ++i, shift += 8) {
+            tail |= static_cast<uint64_t>(p[i]) << shift;
+        }
+        h ^= rotl(tail * k2, 33) * k1;
+        return mix(h);
+    }
+}
@@ -0,0 +1,97 @@
+#include "ImageDecoder.hpp"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    /// Назначение текущего decode() на этом потоке: выдаётся stb_image вместо malloc нужного размера
+    struct DecodeTarget {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        bool taken = false;
+    };
+    thread_local DecodeTarget target;
+
+    void* allocate(size_t size) {
+        if (target.data && !target.taken && size >= target.size &&
+            size <= target.size + ImageDecoder::DESTINATION_PADDING) {
+            target.taken = true;
+            return target.data;
+        }
+        return std::malloc(size);
+    }
+
+    void release(void* pointer) {
+        if (pointer && pointer == target.data) {
+            target.taken = false; // Назначение освободилось и может достаться следующему выделению
+            return;
+        }
+        std::free(pointer);
+    }
+
+    void* reallocate(void* pointer, size_t oldSize, size_t newSize) {
+        if (!pointer || pointer != target.data) {
+            return std::realloc(pointer, newSize);
+        }
+        // Буфер в назначении растёт: переносится в кучу, назначение снова свободно
+        void* moved = std::malloc(newSize);
+        if (moved) {
+            std::memcpy(moved, pointer, oldSize < newSize ? oldSize : newSize);
+            target.taken = false;
+        }
+        return moved;
+    }
+}
+
+#define STBI_MALLOC(size) allocate(size)
+#define STBI_REALLOC_SIZED(pointer, oldSize, newSize) reallocate(pointer, oldSize, newSize)
+#define STBI_FREE(pointer) release(pointer)
+#define STB_IMAGE_IMPLEMENTATION
+// Сторонний код: тесты собираются с /W4 /WX, а предупреждения stb_image к проекту не относятся
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <stb_image.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace ImageDecoder {
+    bool probe(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height) {
+        int x, y, channels;
+        if (size > INT_MAX || !stbi_info_from_memory(data, static_cast<int>(size), &x, &y, &channels) ||
+            x <= 0 || y <= 0) {
+            return false;
+        }
+        width = static_cast<uint32_t>(x);
+        height = static_cast<uint32_t>(y);
+        return true;
+    }
+
+    bool decode(const uint8_t* data, size_t size, uint8_t* destination, uint32_t width, uint32_t height) {
+        if (size > INT_MAX) {
+            return false;
+        }
+        const size_t imageSize = size_t{width} * height * 4;
+        target = DecodeTarget{destination, imageSize, false};
+        int x, y, channels;
+        // Флаг переворота — свой у каждого потока: декодирование идёт параллельно и рядом с заглушкой
+        stbi_set_flip_vertically_on_load_thread(true);
+        stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &x, &y, &channels, STBI_rgb_alpha);
+        stbi_set_flip_vertically_on_load_thread(false);
+        target = DecodeTarget{};
+
+        if (!pixels) {
+            return false;
+        }
+        const bool matches = static_cast<uint32_t>(x) == width && static_cast<uint32_t>(y) == height;
+        if (pixels == destination) {
+            return matches;
+        }
+        if (matches) {
+            std::memcpy(destination, pixels, imageSize);
+        }
+        std::free(pixels);
+        return matches;
+    }
+}
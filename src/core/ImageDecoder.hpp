@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Декодирование PNG/JPG (stb_image) в заранее выделенную память
+ *
+ * stb_image сам выделяет буфер результата, и обычно его приходится копировать
+ * в staging-буфер. Здесь stb_image собран с собственными STBI_MALLOC/STBI_FREE:
+ * на время decode() выделение под результат (width * height * 4 байт, у JPEG
+ * на байт больше) на этом потоке получает указатель назначения, поэтому
+ * пиксели пишутся сразу туда.
+ * Промежуточные буферы (распакованный zlib, 16-битные каналы) остаются в куче;
+ * если результат всё же оказался в куче, он копируется в назначение.
+ *
+ * Строки результата идут снизу вверх, как ожидает TextureManager. Реализация
+ * stb_image в программе одна — в ImageDecoder.cpp.
+ */
+namespace ImageDecoder {
+    /// Сколько байт после width * height * 4 должно быть доступно в назначении: JPEG выделяется с запасом в байт
+    constexpr size_t DESTINATION_PADDING = 1;
+
+    /**
+     * @brief Размеры изображения по заголовку, без декодирования
+     * @return false, если формат не распознан
+     */
+    bool probe(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height);
+
+    /**
+     * @brief Декодирует изображение в RGBA8
+     * @param destination width * height * 4 + DESTINATION_PADDING байт; размеры должны совпадать с probe()
+     * @return false, если изображение повреждено или его размеры не совпали
+     */
+    bool decode(const uint8_t* data, size_t size, uint8_t* destination, uint32_t width, uint32_t height);
+}
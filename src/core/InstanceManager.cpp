@@ -75,7 +75,7 @@ void InstanceManager::createInstance() {
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = VK_API_VERSION_1_2; // Индексирование дескрипторов; DeviceManager проверяет версию устройства
 
     // Информация о создании экземпляра
     VkInstanceCreateInfo createInfo{};
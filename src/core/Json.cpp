@@ -0,0 +1,289 @@
+#include "Json.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace Json {
+
+    const Value& Value::operator[](size_t index) const {
+        static const Value null;
+        return type_ == Type::ARRAY && index < items_.size() ? items_[index] : null;
+    }
+
+    const Value& Value::operator[](const std::string& key) const {
+        static const Value null;
+        if (type_ != Type::OBJECT) {
+            return null;
+        }
+        // Объекты glTF маленькие: линейный поиск дешевле хеш-таблицы на каждый узел
+        for (size_t i = 0; i < keys_.size(); ++i) {
+            if (keys_[i] == key) {
+                return items_[i];
+            }
+        }
+        return null;
+    }
+
+    /**
+     * @brief Рекурсивный спуск по тексту; глубина вложенности ограничена, чтобы
+     * испорченный файл не переполнил стек
+     */
+    class Parser {
+    public:
+        static constexpr int MAX_DEPTH = 256;
+
+        Parser(const char* data, size_t size) : p_(data), begin_(data), end_(data + size) {}
+
+        Value document() {
+            Value root = value(0);
+            skipSpace();
+            if (p_ != end_) {
+                fail("unexpected data after the document");
+            }
+            return root;
+        }
+
+    private:
+        const char* p_;
+        const char* begin_;
+        const char* end_;
+
+        [[noreturn]] void fail(const char* message) const {
+            throw std::runtime_error(std::string("JSON error at offset ") + std::to_string(p_ - begin_) + ": " + message);
+        }
+
+        void skipSpace() {
+            while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+                ++p_;
+            }
+        }
+
+        void expect(char c) {
+            skipSpace();
+            if (p_ >= end_ || *p_ != c) {
+                fail(std::string("expected '").append(1, c).append("'").c_str());
+            }
+            ++p_;
+        }
+
+        bool literal(const char* word) {
+            const size_t length = std::strlen(word);
+            if (static_cast<size_t>(end_ - p_) >= length && std::memcmp(p_, word, length) == 0) {
+                p_ += length;
+                return true;
+            }
+            return false;
+        }
+
+        Value value(int depth) {
+            if (depth > MAX_DEPTH) {
+                fail("nesting is too deep");
+            }
+            skipSpace();
+            if (p_ >= end_) {
+                fail("unexpected end of data");
+            }
+
+            Value result;
+            switch (*p_) {
+            case '{':
+                result.type_ = Value::Type::OBJECT;
+                ++p_;
+                skipSpace();
+                if (p_ < end_ && *p_ == '}') {
+                    ++p_;
+                    break;
+                }
+                for (;;) {
+                    skipSpace();
+                    if (p_ >= end_ || *p_ != '"') {
+                        fail("expected an object key");
+                    }
+                    result.keys_.push_back(string());
+                    expect(':');
+                    result.items_.push_back(value(depth + 1));
+                    skipSpace();
+                    if (p_ < end_ && *p_ == ',') {
+                        ++p_;
+                        continue;
+                    }
+                    expect('}');
+                    break;
+                }
+                break;
+            case '[':
+                result.type_ = Value::Type::ARRAY;
+                ++p_;
+                skipSpace();
+                if (p_ < end_ && *p_ == ']') {
+                    ++p_;
+                    break;
+                }
+                for (;;) {
+                    result.items_.push_back(value(depth + 1));
+                    skipSpace();
+                    if (p_ < end_ && *p_ == ',') {
+                        ++p_;
+                        continue;
+                    }
+                    expect(']');
+                    break;
+                }
+                break;
+            case '"':
+                result.type_ = Value::Type::STRING;
+                result.string_ = string();
+                break;
+            case 't':
+            case 'f':
+                result.type_ = Value::Type::BOOLEAN;
+                if (literal("true")) {
+                    result.boolean_ = true;
+                } else if (!literal("false")) {
+                    fail("invalid literal");
+                }
+                break;
+            case 'n':
+                if (!literal("null")) {
+                    fail("invalid literal");
+                }
+                break;
+            default:
+                result.type_ = Value::Type::NUMBER;
+                result.number_ = number();
+                break;
+            }
+            return result;
+        }
+
+        double number() {
+            // Проверяем грамматику JSON, а само значение считает strtod
+            const char* start = p_;
+            auto digits = [&]() {
+                const char* first = p_;
+                while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+                    ++p_;
+                }
+                if (p_ == first) {
+                    fail("invalid number");
+                }
+            };
+            if (p_ < end_ && *p_ == '-') {
+                ++p_;
+            }
+            digits();
+            if (p_ < end_ && *p_ == '.') {
+                ++p_;
+                digits();
+            }
+            if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+                ++p_;
+                if (p_ < end_ && (*p_ == '+' || *p_ == '-')) {
+                    ++p_;
+                }
+                digits();
+            }
+            const std::string token(start, p_);
+            return std::strtod(token.c_str(), nullptr);
+        }
+
+        unsigned hexQuad() {
+            if (end_ - p_ < 4) {
+                fail("truncated \\u escape");
+            }
+            unsigned code = 0;
+            for (int i = 0; i < 4; ++i, ++p_) {
+                const char c = *p_;
+                code <<= 4;
+                if (c >= '0' && c <= '9') {
+                    code |= static_cast<unsigned>(c - '0');
+                } else if (c >= 'a' && c <= 'f') {
+                    code |= static_cast<unsigned>(c - 'a' + 10);
+                } else if (c >= 'A' && c <= 'F') {
+                    code |= static_cast<unsigned>(c - 'A' + 10);
+                } else {
+                    fail("invalid \\u escape");
+                }
+            }
+            return code;
+        }
+
+        static void appendUtf8(std::string& out, unsigned code) {
+            if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else if (code < 0x800) {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        std::string string() {
+            ++p_; // Открывающая кавычка
+            std::string out;
+            for (;;) {
+                // Участок без экранирования копируется целиком
+                const char* run = p_;
+                while (p_ < end_ && *p_ != '"' && *p_ != '\\' && static_cast<unsigned char>(*p_) >= 0x20) {
+                    ++p_;
+                }
+                out.append(run, p_);
+                if (p_ >= end_) {
+                    fail("unterminated string");
+                }
+                if (*p_ == '"') {
+                    ++p_;
+                    return out;
+                }
+                if (*p_ != '\\') {
+                    fail("control character in string");
+                }
+                if (++p_ >= end_) {
+                    fail("unterminated string");
+                }
+                const char escape = *p_++;
+                switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned code = hexQuad();
+                    if (code >= 0xD800 && code < 0xDC00) { // Суррогатная пара
+                        if (!literal("\\u")) {
+                            fail("unpaired surrogate");
+                        }
+                        const unsigned low = hexQuad();
+                        if (low < 0xDC00 || low >= 0xE000) {
+                            fail("unpaired surrogate");
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (code >= 0xDC00 && code < 0xE000) {
+                        fail("unpaired surrogate");
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    fail("invalid escape");
+                }
+            }
+        }
+    };
+
+    Value parse(const char* data, size_t size) {
+        return Parser(data, size).document();
+    }
+}
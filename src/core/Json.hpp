@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Узел разобранного JSON-документа
+     *
+     * Нужен загрузчику glTF, поэтому только чтение: обращение к отсутствующему
+     * ключу или индексу возвращает null-узел, а не бросает исключение, чтобы
+     * необязательные поля спецификации читались без лишних проверок.
+     */
+    class Value {
+    public:
+        enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+        Type type() const { return type_; }
+        bool isNull() const { return type_ == Type::NUL; }
+        bool isNumber() const { return type_ == Type::NUMBER; }
+        bool isString() const { return type_ == Type::STRING; }
+        bool isArray() const { return type_ == Type::ARRAY; }
+        bool isObject() const { return type_ == Type::OBJECT; }
+
+        double number(double fallback = 0.0) const { return type_ == Type::NUMBER ? number_ : fallback; }
+        bool boolean(bool fallback = false) const { return type_ == Type::BOOLEAN ? boolean_ : fallback; }
+        /// Строка; пустая для узлов других типов
+        const std::string& string() const { return string_; }
+
+        /// Число элементов массива или полей объекта
+        size_t size() const { return items_.size(); }
+        /// Элемент массива; null-узел за пределами массива
+        const Value& operator[](size_t index) const;
+        const Value& operator[](int index) const { return (*this)[static_cast<size_t>(index)]; }
+        /// Поле объекта; null-узел, если поля нет
+        const Value& operator[](const std::string& key) const;
+        const Value& operator[](const char* key) const { return (*this)[std::string(key)]; }
+        bool has(const std::string& key) const { return !(*this)[key].isNull(); }
+
+        /// Имена полей объекта в порядке документа (значения — items())
+        const std::vector<std::string>& keys() const { return keys_; }
+        const std::vector<Value>& items() const { return items_; }
+
+    private:
+        friend class Parser;
+
+        Type type_ = Type::NUL;
+        bool boolean_ = false;
+        double number_ = 0.0;
+        std::string string_;
+        std::vector<std::string> keys_; ///< Только у объектов, параллельно items_
+        std::vector<Value> items_;
+    };
+
+    /**
+     * @brief Разбирает JSON (RFC 8259) из буфера в памяти
+     * @throws std::runtime_error с позицией ошибки, если текст не является корректным JSON
+     */
+    Value parse(const char* data, size_t size);
+}
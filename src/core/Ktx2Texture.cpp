@@ -0,0 +1,323 @@
+#include "Ktx2Texture.hpp"
+#include "MipChain.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    const uint8_t IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    struct Header {
+        uint8_t identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+    static_assert(sizeof(Header) == 80, "KTX2 header is 80 bytes");
+
+    struct LevelIndex {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+    static_assert(sizeof(LevelIndex) == 24, "KTX2 level index entry is 24 bytes");
+
+    /// Поддерживаемый формат и поля его Data Format Descriptor
+    struct FormatInfo {
+        VkFormat format;
+        uint32_t blockBytes;  ///< Байт на блок 4x4 или на пиксель
+        bool blockCompressed;
+        bool srgb;
+        uint8_t colorModel;   ///< KHR_DF_MODEL_*
+    };
+
+    constexpr uint8_t MODEL_RGBSDA = 1;
+    constexpr uint8_t MODEL_BC1A = 128;
+    constexpr uint8_t MODEL_BC5 = 132;
+    constexpr uint8_t MODEL_BC7 = 134;
+
+    const FormatInfo FORMATS[] = {
+        {VK_FORMAT_R8G8B8A8_UNORM, 4, false, false, MODEL_RGBSDA},
+        {VK_FORMAT_R8G8B8A8_SRGB, 4, false, true, MODEL_RGBSDA},
+        {VK_FORMAT_BC1_RGB_UNORM_BLOCK, 8, true, false, MODEL_BC1A},
+        {VK_FORMAT_BC1_RGB_SRGB_BLOCK, 8, true, true, MODEL_BC1A},
+        {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 8, true, false, MODEL_BC1A},
+        {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, true, true, MODEL_BC1A},
+        {VK_FORMAT_BC5_UNORM_BLOCK, 16, true, false, MODEL_BC5},
+        {VK_FORMAT_BC7_UNORM_BLOCK, 16, true, false, MODEL_BC7},
+        {VK_FORMAT_BC7_SRGB_BLOCK, 16, true, true, MODEL_BC7},
+    };
+
+    const FormatInfo* findFormat(VkFormat format) {
+        for (const FormatInfo& info : FORMATS) {
+            if (info.format == format) {
+                return &info;
+            }
+        }
+        return nullptr;
+    }
+
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    template <typename T>
+    void append(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    /// Отсчёт Data Format Descriptor: bitLength хранится как длина минус один
+    void appendSample(std::vector<uint8_t>& out, uint32_t bitOffset, uint32_t bitLength, uint32_t channel,
+                      uint32_t upper) {
+        append(out, bitOffset | ((bitLength - 1) << 16) | (channel << 24));
+        append(out, uint32_t{0}); // samplePosition
+        append(out, uint32_t{0}); // sampleLower
+        append(out, upper);
+    }
+
+    /// Базовый Data Format Descriptor (KDF 1.3): без него файл не примут другие инструменты
+    std::vector<uint8_t> dataFormatDescriptor(const FormatInfo& info) {
+        std::vector<uint8_t> samples;
+        switch (info.colorModel) {
+            case MODEL_BC1A: {
+                const bool alpha = info.format == VK_FORMAT_BC1_RGBA_UNORM_BLOCK ||
+                                   info.format == VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+                appendSample(samples, 0, 64, alpha ? 1u : 0u, UINT32_MAX); // BC1A_COLOR или BC1A_ALPHAPRESENT
+                break;
+            }
+            case MODEL_BC5:
+                appendSample(samples, 0, 64, 0, UINT32_MAX);  // RED
+                appendSample(samples, 64, 64, 1, UINT32_MAX); // GREEN
+                break;
+            case MODEL_BC7:
+                appendSample(samples, 0, 128, 0, UINT32_MAX);
+                break;
+            default:
+                for (uint32_t channel = 0; channel < 3; ++channel) {
+                    appendSample(samples, channel * 8, 8, channel, 255);
+                }
+                appendSample(samples, 24, 8, 15 | 0x10, 255); // Альфа всегда линейна (флаг LINEAR)
+                break;
+        }
+
+        const uint32_t blockSize = 24 + static_cast<uint32_t>(samples.size());
+        std::vector<uint8_t> out;
+        append(out, uint32_t{4 + blockSize}); // dfdTotalSize
+        append(out, uint32_t{0});             // vendorId KHRONOS, descriptorType BASICFORMAT
+        append(out, uint32_t{2} | (blockSize << 16));
+        const uint32_t transfer = info.srgb ? 2 : 1; // SRGB или LINEAR
+        append(out, uint32_t{info.colorModel} | (uint32_t{1} << 8) | (transfer << 16)); // Первичные цвета BT709
+        append(out, info.blockCompressed ? uint32_t{3 | (3 << 8)} : uint32_t{0}); // Размер блока минус один
+        append(out, info.blockBytes); // bytesPlane0
+        append(out, uint32_t{0});
+        out.insert(out.end(), samples.begin(), samples.end());
+        return out;
+    }
+
+    void appendKeyValue(std::vector<uint8_t>& out, const std::string& key, const std::string& value) {
+        append(out, static_cast<uint32_t>(key.size() + 1 + value.size() + 1));
+        out.insert(out.end(), key.begin(), key.end());
+        out.push_back(0);
+        out.insert(out.end(), value.begin(), value.end());
+        out.push_back(0);
+        out.resize(alignUp(out.size(), 4), 0);
+    }
+
+    /// Длина строки до нуля, но не больше limit байт
+    size_t boundedLength(const char* text, size_t limit) {
+        const void* terminator = std::memchr(text, 0, limit);
+        return terminator ? static_cast<size_t>(static_cast<const char*>(terminator) - text) : limit;
+    }
+}
+
+Ktx2Texture::Ktx2Texture(const std::string& path) : file_(path) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file_.data());
+    const size_t size = file_.size();
+    Header header;
+    if (size < sizeof(Header)) {
+        throw std::runtime_error("Not a KTX2 file: " + path);
+    }
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0) {
+        throw std::runtime_error("Not a KTX2 file: " + path);
+    }
+
+    format_ = static_cast<VkFormat>(header.vkFormat);
+    if (!isSupportedFormat(format_)) {
+        throw std::runtime_error("Unsupported KTX2 format " + std::to_string(header.vkFormat) + ": " + path);
+    }
+    if (header.supercompressionScheme != 0) {
+        throw std::runtime_error("KTX2 supercompression is not supported: " + path);
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 ||
+        header.layerCount > 1 || header.faceCount != 1) {
+        throw std::runtime_error("Only 2D KTX2 textures are supported: " + path);
+    }
+    width_ = header.pixelWidth;
+    height_ = header.pixelHeight;
+
+    // levelCount 0 просит построить уровни при загрузке; здесь цепочка не строится, берётся уровень 0
+    const uint32_t levelCount = std::max(1u, header.levelCount);
+    if (levelCount > MipChain::levelCount(width_, height_) ||
+        sizeof(Header) + uint64_t{levelCount} * sizeof(LevelIndex) > size) {
+        throw std::runtime_error("Corrupt KTX2 level index: " + path);
+    }
+    levels_.resize(levelCount);
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        LevelIndex index;
+        std::memcpy(&index, data + sizeof(Header) + level * sizeof(LevelIndex), sizeof(LevelIndex));
+        const size_t expected = levelSize(format_, std::max(1u, width_ >> level), std::max(1u, height_ >> level));
+        if (index.byteLength != expected || index.byteOffset > size || index.byteLength > size - index.byteOffset) {
+            throw std::runtime_error("Corrupt KTX2 level " + std::to_string(level) + ": " + path);
+        }
+        levels_[level] = {static_cast<size_t>(index.byteOffset), static_cast<size_t>(index.byteLength)};
+    }
+
+    // Из пар ключ-значение нужна только ориентация
+    if (uint64_t{header.kvdByteOffset} + header.kvdByteLength > size) {
+        throw std::runtime_error("Corrupt KTX2 key/value data: " + path);
+    }
+    const uint8_t* entry = data + header.kvdByteOffset;
+    const uint8_t* end = entry + header.kvdByteLength;
+    while (end - entry >= 4) {
+        uint32_t length;
+        std::memcpy(&length, entry, 4);
+        entry += 4;
+        if (length > static_cast<size_t>(end - entry)) {
+            break;
+        }
+        const char* pair = reinterpret_cast<const char*>(entry);
+        const size_t keyLength = boundedLength(pair, length);
+        if (std::string(pair, keyLength) == "KTXorientation" && keyLength < length) {
+            const char* value = pair + keyLength + 1;
+            orientation_.assign(value, boundedLength(value, length - keyLength - 1));
+        }
+        entry += alignUp(length, 4);
+    }
+}
+
+const uint8_t* Ktx2Texture::getLevelData(uint32_t level) const {
+    return reinterpret_cast<const uint8_t*>(file_.data()) + levels_[level].offset;
+}
+
+size_t Ktx2Texture::getDataSize() const {
+    size_t total = 0;
+    for (const Level& level : levels_) {
+        total += level.size;
+    }
+    return total;
+}
+
+bool Ktx2Texture::isSupportedFormat(VkFormat format) {
+    return findFormat(format) != nullptr;
+}
+
+bool Ktx2Texture::isBlockCompressed(VkFormat format) {
+    const FormatInfo* info = findFormat(format);
+    return info && info->blockCompressed;
+}
+
+size_t Ktx2Texture::levelSize(VkFormat format, uint32_t width, uint32_t height) {
+    const FormatInfo* info = findFormat(format);
+    if (!info) {
+        throw std::runtime_error("Unsupported KTX2 format " + std::to_string(format));
+    }
+    if (info->blockCompressed) {
+        return size_t{(width + 3) / 4} * ((height + 3) / 4) * info->blockBytes;
+    }
+    return size_t{width} * height * info->blockBytes;
+}
+
+void Ktx2Texture::write(const std::string& path, VkFormat format, uint32_t width, uint32_t height,
+                        const std::vector<std::vector<uint8_t>>& levels, const std::string& orientation) {
+    const FormatInfo* info = findFormat(format);
+    if (!info) {
+        throw std::runtime_error("Unsupported KTX2 format " + std::to_string(format));
+    }
+    if (width == 0 || height == 0 || levels.empty() || levels.size() > MipChain::levelCount(width, height)) {
+        throw std::runtime_error("Invalid KTX2 level chain for " + path);
+    }
+    for (uint32_t level = 0; level < levels.size(); ++level) {
+        if (levels[level].size() != levelSize(format, std::max(1u, width >> level), std::max(1u, height >> level))) {
+            throw std::runtime_error("KTX2 level " + std::to_string(level) + " has wrong size for " + path);
+        }
+    }
+
+    const std::vector<uint8_t> dfd = dataFormatDescriptor(*info);
+    std::vector<uint8_t> kvd;
+    appendKeyValue(kvd, "KTXorientation", orientation);
+    appendKeyValue(kvd, "KTXwriter", "VulkanApp TextureEncoder");
+
+    Header header{};
+    std::memcpy(header.identifier, IDENTIFIER, sizeof(IDENTIFIER));
+    header.vkFormat = static_cast<uint32_t>(format);
+    header.typeSize = 1;
+    header.pixelWidth = width;
+    header.pixelHeight = height;
+    header.faceCount = 1;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(Header) + levels.size() * sizeof(LevelIndex));
+    header.dfdByteLength = static_cast<uint32_t>(dfd.size());
+    header.kvdByteOffset = header.dfdByteOffset + header.dfdByteLength;
+    header.kvdByteLength = static_cast<uint32_t>(kvd.size());
+
+    // Уровни лежат от меньшего к большему, каждый выровнен по lcm(размер блока, 4)
+    const uint64_t alignment = info->blockBytes;
+    std::vector<LevelIndex> index(levels.size());
+    uint64_t offset = uint64_t{header.kvdByteOffset} + header.kvdByteLength;
+    for (size_t level = levels.size(); level-- > 0;) {
+        offset = alignUp(offset, alignment);
+        index[level] = {offset, levels[level].size(), levels[level].size()};
+        offset += levels[level].size();
+    }
+
+    std::vector<uint8_t> metadata;
+    append(metadata, header);
+    for (const LevelIndex& entry : index) {
+        append(metadata, entry);
+    }
+    metadata.insert(metadata.end(), dfd.begin(), dfd.end());
+    metadata.insert(metadata.end(), kvd.begin(), kvd.end());
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to write KTX2 file: " + tmpPath);
+        }
+        out.write(reinterpret_cast<const char*>(metadata.data()), static_cast<std::streamsize>(metadata.size()));
+        uint64_t position = metadata.size();
+        const char padding[16] = {};
+        for (size_t level = levels.size(); level-- > 0;) {
+            out.write(padding, static_cast<std::streamsize>(index[level].byteOffset - position));
+            out.write(reinterpret_cast<const char*>(levels[level].data()),
+                      static_cast<std::streamsize>(levels[level].size()));
+            position = index[level].byteOffset + levels[level].size();
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write KTX2 file: " + tmpPath);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        std::filesystem::remove(tmpPath, error);
+        throw std::runtime_error("Failed to write KTX2 file: " + path);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Текстура в контейнере KTX2 с готовой цепочкой мип-уровней
+ *
+ * Файл отображается в память, а уровни отдаются как есть: блоки BCn
+ * копируются в staging-буфер без декодирования. Поддерживаются двумерные
+ * текстуры без массивов, граней куба и суперсжатия в форматах BC1, BC5,
+ * BC7 и RGBA8. Уровень 0 — самый большой; в файле уровни лежат от
+ * меньшего к большему, как требует спецификация.
+ *
+ * Ориентация хранится в ключе KTXorientation. Текстуры загружаются с
+ * переворотом по вертикали (первая строка — нижняя, "ru"), и кодировщик
+ * пишет их в том же виде.
+ */
+class Ktx2Texture {
+public:
+    /// Ориентация, в которой TextureManager ожидает строки текстуры
+    static constexpr const char* ORIENTATION = "ru";
+
+    /**
+     * @brief Отображает файл и проверяет заголовок и индекс уровней
+     * @throws std::runtime_error если файл не KTX2, повреждён или его формат не поддерживается
+     */
+    explicit Ktx2Texture(const std::string& path);
+
+    VkFormat getFormat() const { return format_; }
+    uint32_t getWidth() const { return width_; }
+    uint32_t getHeight() const { return height_; }
+    uint32_t getLevelCount() const { return static_cast<uint32_t>(levels_.size()); }
+    const std::string& getOrientation() const { return orientation_; }
+
+    /// Байты уровня level (0 — полный размер) прямо в отображённом файле
+    const uint8_t* getLevelData(uint32_t level) const;
+    size_t getLevelSize(uint32_t level) const { return levels_[level].size; }
+    /// Все уровни вместе
+    size_t getDataSize() const;
+
+    /// Поддерживается ли формат; для блочных форматов блок — 4x4
+    static bool isSupportedFormat(VkFormat format);
+    static bool isBlockCompressed(VkFormat format);
+    /// Размер уровня width x height в байтах (блоки с округлением сторон вверх)
+    static size_t levelSize(VkFormat format, uint32_t width, uint32_t height);
+
+    /**
+     * @brief Записывает KTX2 (через временный файл)
+     * @param levels Уровни от 0 (width x height) до последнего; размеры должны совпадать с levelSize()
+     * @throws std::runtime_error если формат не поддерживается, размеры не сходятся или файл не записать
+     */
+    static void write(const std::string& path, VkFormat format, uint32_t width, uint32_t height,
+                      const std::vector<std::vector<uint8_t>>& levels, const std::string& orientation = ORIENTATION);
+
+private:
+    struct Level {
+        size_t offset;
+        size_t size;
+    };
+
+    MappedFile file_;
+    VkFormat format_ = VK_FORMAT_UNDEFINED;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<Level> levels_;
+    std::string orientation_;
+};
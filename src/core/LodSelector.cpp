@@ -0,0 +1,34 @@
+#include "LodSelector.hpp"
+#include <stdexcept>
+#include <utility>
+
+LodSelector::LodSelector(std::vector<LodLevel> levels, float meshRadius, float pixelError)
+    : levels_(std::move(levels)), meshRadius_(meshRadius), pixelError_(pixelError) {
+    if (levels_.empty()) {
+        throw std::runtime_error("LOD selector needs at least one level");
+    }
+}
+
+float LodSelector::pixelError(size_t index, float projectedRadius) const {
+    if (meshRadius_ <= 0.0f) {
+        return 0.0f;
+    }
+    return levels_[index].error * projectedRadius / meshRadius_;
+}
+
+size_t LodSelector::select(float projectedRadius) {
+    if (levels_.empty()) {
+        return 0;
+    }
+
+    // Текущий уровень стал заметен — переходим на более подробный
+    while (current_ > 0 && pixelError(current_, projectedRadius) > pixelError_) {
+        --current_;
+    }
+
+    // Более грубый уровень берём, только если он заметно ниже порога
+    while (current_ + 1 < levels_.size() && pixelError(current_ + 1, projectedRadius) <= pixelError_ * HYSTERESIS) {
+        ++current_;
+    }
+    return current_;
+}
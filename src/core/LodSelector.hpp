@@ -0,0 +1,41 @@
+#pragma once
+#include "MeshSimplifier.hpp"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Выбирает уровень детализации по размеру описанной сферы сетки на экране
+ *
+ * Ошибка уровня переводится в пиксели пропорционально экранному радиусу сферы.
+ * Берётся самый грубый уровень, ошибка которого не заметна (не больше порога).
+ * Чтобы уровень не «дрожал» на границе, на более грубый уровень переход идёт,
+ * только когда его ошибка заметно меньше порога (гистерезис).
+ */
+class LodSelector {
+public:
+    static constexpr float DEFAULT_PIXEL_ERROR = 1.0f; ///< Допустимое отклонение в пикселях
+    static constexpr float HYSTERESIS = 0.8f;          ///< Доля порога для перехода на более грубый уровень
+
+    LodSelector() = default;
+    LodSelector(std::vector<LodLevel> levels, float meshRadius, float pixelError = DEFAULT_PIXEL_ERROR);
+
+    /**
+     * @brief Выбирает уровень для текущего кадра
+     * @param projectedRadius Радиус описанной сферы на экране в пикселях
+     * @return Номер уровня (0 — исходная сетка)
+     */
+    size_t select(float projectedRadius);
+
+    const LodLevel& level(size_t index) const { return levels_[index]; }
+    size_t levelCount() const { return levels_.size(); }
+    size_t current() const { return current_; }
+
+private:
+    /// Ошибка уровня в пикселях при данном экранном радиусе
+    float pixelError(size_t index, float projectedRadius) const;
+
+    std::vector<LodLevel> levels_;
+    float meshRadius_ = 0.0f;
+    float pixelError_ = DEFAULT_PIXEL_ERROR;
+    size_t current_ = 0;
+};
@@ -0,0 +1,121 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) : path_(path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    file_ = file;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize)) {
+        close();
+        throw std::runtime_error("Failed to query file size: " + path);
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ == 0) {
+        return; // Пустой файл отобразить нельзя, но это не ошибка
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        throw std::runtime_error("Failed to create file mapping: " + path);
+    }
+    mapping_ = mapping;
+
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        close();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat st{};
+    if (fstat(fd_, &st) != 0) {
+        close();
+        throw std::runtime_error("Failed to query file size: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        return;
+    }
+
+    void* ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (ptr == MAP_FAILED) {
+        close();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+    madvise(ptr, size_, MADV_SEQUENTIAL); // Подсказка ОС: читаем файл подряд
+    data_ = static_cast<const char*>(ptr);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        path_ = std::move(other.path_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        file_ = std::exchange(other.file_, nullptr);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+#else
+        fd_ = std::exchange(other.fd_, -1);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+    if (file_) {
+        CloseHandle(static_cast<HANDLE>(file_));
+    }
+    mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Файл, отображённый в память только для чтения (RAII)
+ *
+ * Используется загрузчиками геометрии: вместо чтения через iostream
+ * ОС сама подкачивает страницы файла по мере обращения к ним,
+ * а несколько потоков могут разбирать разные участки одновременно.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+private:
+    void close();
+
+    std::string path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;     ///< HANDLE файла
+    void* mapping_ = nullptr;  ///< HANDLE объекта отображения
+#else
+    int fd_ = -1;
+#endif
+};
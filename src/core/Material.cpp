@@ -0,0 +1,151 @@
+#include "Material.hpp"
+#include "MappedFile.hpp"
+#include "ObjSyntax.hpp"
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+    /// Если строка начинается с ключевого слова keyword и пробела, сдвигает p на аргументы
+    bool directive(const char*& p, const char* lineEnd, const char* keyword) {
+        const char* token = p;
+        while (token < lineEnd && isSpace(*token)) {
+            ++token;
+        }
+        const char* k = keyword;
+        while (*k && token < lineEnd && *token == *k) {
+            ++token;
+            ++k;
+        }
+        if (*k || token >= lineEnd || !isSpace(*token)) {
+            return false;
+        }
+        p = token;
+        return true;
+    }
+
+    /// Последний токен строки: у map_Kd перед именем файла могут идти опции (-s, -o, -bm ...)
+    std::string lastToken(const char* begin, const char* end) {
+        while (end > begin && isSpace(end[-1])) {
+            --end;
+        }
+        const char* start = end;
+        while (start > begin && !isSpace(start[-1])) {
+            --start;
+        }
+        return std::string(start, end);
+    }
+}
+
+namespace MaterialLibrary {
+
+    std::vector<Material> parse(const char* data, size_t size, const std::string& directory) {
+        std::vector<Material> materials;
+        const char* p = data;
+        const char* end = data + size;
+        while (p < end) {
+            const char* lineEnd = nullptr;
+            const char* next = ObjSyntax::nextLine(p, end, lineEnd);
+
+            if (directive(p, lineEnd, "newmtl")) {
+                Material material;
+                material.name = ObjSyntax::argument(p, lineEnd);
+                material.resolved = true;
+                materials.push_back(std::move(material));
+            } else if (!materials.empty() && directive(p, lineEnd, "Kd")) {
+                glm::vec3& diffuse = materials.back().diffuse;
+                diffuse.r = ObjSyntax::parseReal(p, lineEnd, 1.0);
+                diffuse.g = ObjSyntax::parseReal(p, lineEnd, diffuse.r); // "Kd 0.5" — оттенок серого
+                diffuse.b = ObjSyntax::parseReal(p, lineEnd, diffuse.r);
+            } else if (!materials.empty() && directive(p, lineEnd, "map_Kd")) {
+                const std::string file = lastToken(p, lineEnd);
+                if (!file.empty()) {
+                    materials.back().diffuseTexture = (std::filesystem::path(directory) / file).generic_string();
+                }
+            }
+
+            p = next;
+        }
+        return materials;
+    }
+
+    std::vector<Material> load(const std::string& path) {
+        if (!std::filesystem::exists(path)) {
+            throw std::runtime_error("Material library not found: " + path);
+        }
+        if (std::filesystem::file_size(path) == 0) {
+            return {};
+        }
+        MappedFile file(path);
+        return parse(file.data(), file.size(), std::filesystem::path(path).parent_path().generic_string());
+    }
+
+    std::vector<Material> resolve(const MeshMaterials& meshMaterials) {
+        std::unordered_map<std::string, Material> known;
+        for (const std::string& library : meshMaterials.libraries) {
+            try {
+                for (Material& material : load(library)) {
+                    known.emplace(material.name, std::move(material)); // Первое определение имени побеждает
+                }
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+
+        std::vector<Material> materials;
+        materials.reserve(meshMaterials.materialNames.size());
+        for (const std::string& name : meshMaterials.materialNames) {
+            const auto found = known.find(name);
+            if (found != known.end()) {
+                materials.push_back(found->second);
+            } else {
+                Material material;
+                material.name = name;
+                materials.push_back(std::move(material));
+            }
+        }
+        return materials;
+    }
+
+    std::vector<Submesh> groupByMaterial(std::vector<uint32_t>& indices, size_t firstIndex,
+                                         const std::vector<uint32_t>& triangleMaterials, size_t materialCount) {
+        const size_t triangleCount = (indices.size() - firstIndex) / 3;
+        if (triangleMaterials.size() != triangleCount) {
+            throw std::runtime_error("Triangle material count does not match the index range");
+        }
+
+        std::vector<size_t> starts(materialCount + 1, 0); // Сначала размеры, затем начала участков
+        for (uint32_t material : triangleMaterials) {
+            if (material >= materialCount) {
+                throw std::runtime_error("Triangle material index out of range");
+            }
+            ++starts[material + 1];
+        }
+        for (size_t i = 1; i <= materialCount; ++i) {
+            starts[i] += starts[i - 1];
+        }
+
+        std::vector<Submesh> submeshes;
+        for (uint32_t material = 0; material < materialCount; ++material) {
+            if (starts[material + 1] > starts[material]) {
+                submeshes.push_back({static_cast<uint32_t>(firstIndex + starts[material] * 3),
+                                     static_cast<uint32_t>((starts[material + 1] - starts[material]) * 3), material});
+            }
+        }
+        if (submeshes.size() <= 1) {
+            return submeshes; // Один материал: переставлять нечего
+        }
+
+        const std::vector<uint32_t> source(indices.begin() + static_cast<std::ptrdiff_t>(firstIndex), indices.end());
+        for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+            uint32_t* target = &indices[firstIndex + starts[triangleMaterials[triangle]]++ * 3];
+            target[0] = source[triangle * 3 + 0];
+            target[1] = source[triangle * 3 + 1];
+            target[2] = source[triangle * 3 + 2];
+        }
+        return submeshes;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#ifndef GLM_ENABLE_EXPERIMENTAL
+#define GLM_ENABLE_EXPERIMENTAL
+#endif
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Материал из .mtl или glTF: то, что сейчас умеет рисовать фрагментный шейдер
+ */
+struct Material {
+    std::string name;
+    glm::vec3 diffuse{1.0f};    ///< Kd
+    std::string diffuseTexture; ///< map_Kd относительно рабочего каталога; пусто — без текстуры
+    int32_t embeddedImage = -1; ///< Изображение, встроенное в буфер glTF (BufferManager::getEmbeddedImages); -1 — нет
+    bool resolved = false;      ///< Найден ли материал в библиотеках; иначе рисуется текстурой по умолчанию
+};
+
+/**
+ * @brief Непрерывный диапазон индексного буфера, нарисованный одним материалом
+ */
+struct Submesh {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t material = 0; ///< Номер в MeshMaterials::materialNames
+
+    bool operator==(const Submesh& other) const {
+        return firstIndex == other.firstIndex && indexCount == other.indexCount && material == other.material;
+    }
+};
+
+/**
+ * @brief Разбиение сетки по материалам в том виде, в каком оно хранится в MeshCache
+ *
+ * Сами материалы не кэшируются: .mtl маленький и читается заново при каждом
+ * запуске, поэтому правка материалов не требует пересборки кэша геометрии.
+ */
+struct MeshMaterials {
+    std::vector<Submesh> submeshes;         ///< Диапазоны LOD0 по одному на материал, в порядке индексного буфера
+    std::vector<std::string> materialNames; ///< Имена из usemtl в порядке первого появления ("" — грани до первого usemtl)
+    std::vector<std::string> libraries;     ///< Пути к файлам из mtllib
+};
+
+/// Push-константа фрагментного шейдера; лежит сразу после VertexQuantization вершинного
+struct MaterialConstants {
+    glm::vec4 diffuse{1.0f};
+    uint32_t texture = 0;       ///< Номер текстуры в массиве набора set = 1, если он общий (PipelineManager::isBindless)
+    uint32_t padding[3] = {};
+
+    bool operator==(const MaterialConstants& other) const {
+        return diffuse == other.diffuse && texture == other.texture;
+    }
+    bool operator!=(const MaterialConstants& other) const { return !(*this == other); }
+};
+static_assert(sizeof(MaterialConstants) == 32, "MaterialConstants is a push constant block");
+
+namespace MaterialLibrary {
+    /**
+     * @brief Разбирает текст .mtl: newmtl, Kd и map_Kd (опции map_Kd пропускаются)
+     * @param directory Каталог .mtl: пути текстур в файле заданы относительно него
+     */
+    std::vector<Material> parse(const char* data, size_t size, const std::string& directory);
+
+    /**
+     * @brief Читает .mtl с диска
+     * @throws std::runtime_error если файл не открывается
+     */
+    std::vector<Material> load(const std::string& path);
+
+    /**
+     * @brief Материалы для meshMaterials.materialNames, по одному на имя
+     *
+     * Имя ищется в библиотеках по порядку; отсутствующая библиотека или имя не
+     * ошибка — такой материал остаётся с resolved = false.
+     */
+    std::vector<Material> resolve(const MeshMaterials& meshMaterials);
+
+    /**
+     * @brief Переставляет треугольники диапазона [firstIndex, indices.size()) так, чтобы каждый материал
+     * занимал один непрерывный участок
+     *
+     * Сортировка подсчётом и устойчивая: внутри материала порядок треугольников сохраняется,
+     * а материалы идут в порядке номеров.
+     * @param triangleMaterials Материал каждого треугольника диапазона
+     * @return Непустые диапазоны по возрастанию номера материала
+     */
+    std::vector<Submesh> groupByMaterial(std::vector<uint32_t>& indices, size_t firstIndex,
+                                         const std::vector<uint32_t>& triangleMaterials, size_t materialCount);
+}
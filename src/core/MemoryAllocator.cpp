@@ -0,0 +1,197 @@
+#include "MemoryAllocator.hpp"
+#include "VulkanUtils.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+MemoryAllocation::MemoryAllocation(MemoryAllocation&& other) noexcept {
+    *this = std::move(other);
+}
+
+MemoryAllocation& MemoryAllocation::operator=(MemoryAllocation&& other) noexcept {
+    if (this != &other) {
+        reset();
+        allocator_ = other.allocator_;
+        memoryType_ = other.memoryType_;
+        placement_ = other.placement_;
+        memory_ = other.memory_;
+        offset_ = other.offset_;
+        size_ = other.size_;
+        mapped_ = other.mapped_;
+        other.allocator_ = nullptr;
+        other.reset();
+    }
+    return *this;
+}
+
+void MemoryAllocation::reset() {
+    if (allocator_) {
+        allocator_->release(*this);
+    }
+    allocator_ = nullptr;
+    placement_ = SubAllocator::Allocation{};
+    memory_ = VK_NULL_HANDLE;
+    offset_ = 0;
+    size_ = 0;
+    mapped_ = nullptr;
+}
+
+MemoryAllocator::MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice)
+    : device_(device), physicalDevice_(physicalDevice) {
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice_, &memoryProperties_);
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+    granularity_ = properties.limits.bufferImageGranularity;
+    maxDeviceAllocations_ = properties.limits.maxMemoryAllocationCount;
+    pools_.resize(memoryProperties_.memoryTypeCount);
+}
+
+MemoryAllocator::~MemoryAllocator() {
+    for (const Pool& pool : pools_) {
+        for (const Block& block : pool.blocks) {
+            if (block.memory != VK_NULL_HANDLE) {
+                freeDeviceMemory(block);
+            }
+        }
+    }
+}
+
+MemoryAllocation MemoryAllocator::allocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties) {
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+    MemoryAllocation allocation = allocate(requirements, properties, SubAllocator::Kind::LINEAR);
+    if (vkBindBufferMemory(device_, buffer, allocation.memory(), allocation.offset()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to bind buffer memory!");
+    }
+    return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocateImage(VkImage image, VkMemoryPropertyFlags properties, VkImageTiling tiling) {
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device_, image, &requirements);
+    MemoryAllocation allocation = allocate(requirements, properties, tiling == VK_IMAGE_TILING_OPTIMAL
+                                                                     ? SubAllocator::Kind::OPTIMAL
+                                                                     : SubAllocator::Kind::LINEAR);
+    if (vkBindImageMemory(device_, image, allocation.memory(), allocation.offset()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to bind image memory!");
+    }
+    return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                                           SubAllocator::Kind kind) {
+    const uint32_t memoryType = VulkanUtils::findMemoryType(physicalDevice_, requirements.memoryTypeBits, properties);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Pool& pool = pools_[memoryType];
+    if (!pool.placement) {
+        // На небольших кучах (встроенная графика, BAR без ReBAR) блок — не больше восьмой части кучи
+        const VkDeviceSize heapSize = memoryProperties_.memoryHeaps[memoryProperties_.memoryTypes[memoryType].heapIndex].size;
+        pool.placement = std::make_unique<SubAllocator>(std::min(BLOCK_SIZE, heapSize / 8), granularity_);
+    }
+
+    // allocator_ задаётся только вместе с полученной памятью: исключение до этого не вызовет release()
+    MemoryAllocation allocation;
+    allocation.memoryType_ = memoryType;
+    allocation.size_ = requirements.size;
+
+    if (requirements.size <= pool.placement->blockSize() / 2) {
+        SubAllocator::Allocation placement = pool.placement->allocate(requirements.size, requirements.alignment, kind);
+        if (!placement.valid()) {
+            const Block block = allocateDeviceMemory(memoryType, pool.placement->blockSize());
+            if (block.memory != VK_NULL_HANDLE) {
+                const uint32_t id = pool.placement->addBlock();
+                pool.blocks.resize(std::max<size_t>(pool.blocks.size(), id + 1));
+                pool.blocks[id] = block;
+                placement = pool.placement->allocate(requirements.size, requirements.alignment, kind);
+            }
+        }
+        if (placement.valid()) {
+            const Block& block = pool.blocks[placement.block];
+            allocation.allocator_ = this;
+            allocation.placement_ = placement;
+            allocation.memory_ = block.memory;
+            allocation.offset_ = placement.offset;
+            allocation.mapped_ = block.mapped ? static_cast<char*>(block.mapped) + placement.offset : nullptr;
+            return allocation;
+        }
+    }
+
+    // Крупный ресурс или блок уже не выделить: своё выделение точного размера
+    const Block dedicated = allocateDeviceMemory(memoryType, requirements.size);
+    if (dedicated.memory == VK_NULL_HANDLE) {
+        throw std::runtime_error("Failed to allocate device memory!");
+    }
+    allocation.allocator_ = this;
+    allocation.memory_ = dedicated.memory;
+    allocation.mapped_ = dedicated.mapped;
+    ++dedicatedCount_;
+    dedicatedBytes_ += requirements.size;
+    return allocation;
+}
+
+MemoryAllocator::Block MemoryAllocator::allocateDeviceMemory(uint32_t memoryType, VkDeviceSize size) {
+    Block block;
+    if (maxDeviceAllocations_ != 0 && deviceAllocations_ >= maxDeviceAllocations_) {
+        return block;
+    }
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+    if (vkAllocateMemory(device_, &allocInfo, nullptr, &block.memory) != VK_SUCCESS) {
+        block.memory = VK_NULL_HANDLE;
+        return block;
+    }
+    ++deviceAllocations_;
+    if (memoryProperties_.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(device_, block.memory, 0, VK_WHOLE_SIZE, 0, &block.mapped) != VK_SUCCESS) {
+            freeDeviceMemory(block);
+            throw std::runtime_error("Failed to map host-visible memory!");
+        }
+    }
+    return block;
+}
+
+void MemoryAllocator::freeDeviceMemory(const Block& block) {
+    if (block.mapped) {
+        vkUnmapMemory(device_, block.memory);
+    }
+    vkFreeMemory(device_, block.memory, nullptr);
+    --deviceAllocations_;
+}
+
+void MemoryAllocator::release(MemoryAllocation& allocation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (allocation.isDedicated()) {
+        freeDeviceMemory(Block{allocation.memory_, allocation.mapped_});
+        --dedicatedCount_;
+        dedicatedBytes_ -= allocation.size_;
+        return;
+    }
+    Pool& pool = pools_[allocation.memoryType_];
+    const uint32_t emptied = pool.placement->free(allocation.placement_);
+    if (emptied != SubAllocator::NO_BLOCK) {
+        freeDeviceMemory(pool.blocks[emptied]);
+        pool.blocks[emptied] = Block{};
+    }
+}
+
+MemoryAllocator::Stats MemoryAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    for (const Pool& pool : pools_) {
+        if (!pool.placement) {
+            continue;
+        }
+        const SubAllocator::Stats placement = pool.placement->stats();
+        stats.blockCount += placement.blockCount;
+        stats.blockBytes += placement.blockBytes;
+        stats.allocationCount += placement.allocationCount;
+        stats.allocatedBytes += placement.allocatedBytes;
+    }
+    stats.dedicatedCount = dedicatedCount_;
+    stats.dedicatedBytes = dedicatedBytes_;
+    stats.deviceAllocations = deviceAllocations_;
+    stats.maxDeviceAllocations = maxDeviceAllocations_;
+    return stats;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "SubAllocator.hpp"
+
+class MemoryAllocator;
+
+/**
+ * @brief Память одного буфера или изображения; при уничтожении возвращается в MemoryAllocator
+ *
+ * Только перемещается. Объявляется перед своим буфером или изображением,
+ * чтобы освобождаться после него.
+ */
+class MemoryAllocation {
+public:
+    MemoryAllocation() = default;
+    ~MemoryAllocation() { reset(); }
+    MemoryAllocation(MemoryAllocation&& other) noexcept;
+    MemoryAllocation& operator=(MemoryAllocation&& other) noexcept;
+    MemoryAllocation(const MemoryAllocation&) = delete;
+    MemoryAllocation& operator=(const MemoryAllocation&) = delete;
+
+    void reset();
+
+    explicit operator bool() const { return allocator_ != nullptr; }
+    VkDeviceMemory memory() const { return memory_; }
+    VkDeviceSize offset() const { return offset_; }
+    VkDeviceSize size() const { return size_; }
+    /// Начало ресурса в постоянно отображённой памяти; nullptr, если тип памяти не HOST_VISIBLE
+    void* mapped() const { return mapped_; }
+    /// Своё VkDeviceMemory, а не место в общем блоке
+    bool isDedicated() const { return !placement_.valid(); }
+
+private:
+    friend class MemoryAllocator;
+
+    MemoryAllocator* allocator_ = nullptr;
+    uint32_t memoryType_ = 0;
+    SubAllocator::Allocation placement_;
+    VkDeviceMemory memory_ = VK_NULL_HANDLE;
+    VkDeviceSize offset_ = 0;
+    VkDeviceSize size_ = 0;
+    void* mapped_ = nullptr;
+};
+
+/**
+ * @brief Видеопамять для всех буферов и изображений: крупные блоки вместо vkAllocateMemory на ресурс
+ *
+ * На каждый тип памяти — блоки по BLOCK_SIZE (не больше восьмой части кучи),
+ * внутри которых места раздаёт SubAllocator: мелкие ресурсы — слотами классов
+ * размеров, остальные — диапазонами с учётом bufferImageGranularity. Ресурс
+ * больше половины блока получает отдельное выделение, как и любой ресурс,
+ * если новый блок уже не выделить. Блоки в памяти хоста отображаются один
+ * раз при создании, поэтому staging- и uniform-буферы не вызывают vkMapMemory.
+ *
+ * Потокобезопасен: ресурсы создаются и освобождаются и потоком загрузки.
+ */
+class MemoryAllocator {
+public:
+    static constexpr VkDeviceSize BLOCK_SIZE = VkDeviceSize{64} << 20;
+
+    struct Stats {
+        uint32_t blockCount = 0;
+        VkDeviceSize blockBytes = 0;
+        size_t allocationCount = 0;        ///< Ресурсов в блоках
+        VkDeviceSize allocatedBytes = 0;
+        size_t dedicatedCount = 0;
+        VkDeviceSize dedicatedBytes = 0;
+        uint32_t deviceAllocations = 0;    ///< Живых VkDeviceMemory: блоки и отдельные выделения
+        uint32_t maxDeviceAllocations = 0; ///< maxMemoryAllocationCount устройства
+    };
+
+    MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice);
+    /// Освобождает блоки; все MemoryAllocation к этому времени должны быть уничтожены
+    ~MemoryAllocator();
+
+    MemoryAllocator(const MemoryAllocator&) = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+    /**
+     * @brief Выделяет память под буфер и привязывает её
+     * @throws std::runtime_error если нет типа памяти с properties или память кончилась
+     */
+    MemoryAllocation allocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties);
+    /// То же для изображения; tiling определяет, с какими ресурсами оно может делить страницу
+    MemoryAllocation allocateImage(VkImage image, VkMemoryPropertyFlags properties,
+                                   VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL);
+
+    Stats stats() const;
+
+private:
+    friend class MemoryAllocation;
+
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+    };
+
+    /// Блоки одного типа памяти; SubAllocator создаётся при первом ресурсе
+    struct Pool {
+        std::unique_ptr<SubAllocator> placement;
+        std::vector<Block> blocks; ///< По номерам блоков SubAllocator
+    };
+
+    MemoryAllocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                              SubAllocator::Kind kind);
+    /// vkAllocateMemory и отображение для HOST_VISIBLE; VK_NULL_HANDLE, если памяти не хватило
+    Block allocateDeviceMemory(uint32_t memoryType, VkDeviceSize size);
+    void freeDeviceMemory(const Block& block);
+    void release(MemoryAllocation& allocation);
+
+    VkDevice device_;
+    VkPhysicalDevice physicalDevice_;
+    VkPhysicalDeviceMemoryProperties memoryProperties_{};
+    VkDeviceSize granularity_ = 1;
+    uint32_t maxDeviceAllocations_ = 0;
+
+    mutable std::mutex mutex_;
+    std::vector<Pool> pools_; ///< По типам памяти
+    uint32_t deviceAllocations_ = 0;
+    size_t dedicatedCount_ = 0;
+    VkDeviceSize dedicatedBytes_ = 0;
+};
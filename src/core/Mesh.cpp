@@ -0,0 +1,100 @@
+#include "Mesh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+Mesh::Mesh()
+: vertexBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
+indexBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
+meshletBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
+culledIndexBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr))
+{
+}
+
+glm::vec4 Mesh::computeBoundingSphere(const Vertex* vertices, size_t count) {
+    if (count == 0) {
+        return glm::vec4(0.0f);
+    }
+    // Центр габаритного параллелепипеда: сфера чуть больше минимальной, зато за два прохода
+    glm::vec3 minimum = vertices[0].pos;
+    glm::vec3 maximum = vertices[0].pos;
+    for (size_t i = 1; i < count; ++i) {
+        minimum = glm::min(minimum, vertices[i].pos);
+        maximum = glm::max(maximum, vertices[i].pos);
+    }
+    const glm::vec3 center = (minimum + maximum) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec3 offset = vertices[i].pos - center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    return glm::vec4(center, std::sqrt(radiusSquared));
+}
+
+std::vector<float> Mesh::computeUvDensity(const Vertex* vertices, const uint32_t* indices, size_t indexCount,
+                                          const std::vector<Submesh>& submeshes) {
+    const std::vector<Submesh> whole = {Submesh{0, static_cast<uint32_t>(indexCount), 0}};
+    std::vector<float> density;
+    for (const Submesh& submesh : submeshes.empty() ? whole : submeshes) {
+        // Удвоенные площади: множитель 1/2 в отношении сокращается
+        double modelArea = 0.0;
+        double uvArea = 0.0;
+        const uint32_t end = submesh.firstIndex + submesh.indexCount;
+        for (uint32_t i = submesh.firstIndex; i + 2 < end; i += 3) {
+            const Vertex& a = vertices[indices[i]];
+            const Vertex& b = vertices[indices[i + 1]];
+            const Vertex& c = vertices[indices[i + 2]];
+            modelArea += glm::length(glm::cross(b.pos - a.pos, c.pos - a.pos));
+            const glm::vec2 u = b.texCoord - a.texCoord;
+            const glm::vec2 v = c.texCoord - a.texCoord;
+            uvArea += std::fabs(u.x * v.y - u.y * v.x);
+        }
+        density.push_back(modelArea > 0.0 && uvArea > 0.0 ? static_cast<float>(std::sqrt(uvArea / modelArea)) : 0.0f);
+    }
+    return density;
+}
+
+MeshId MeshRegistry::add(std::unique_ptr<Mesh> mesh) {
+    if (!mesh) {
+        throw std::invalid_argument("MeshRegistry: null mesh");
+    }
+    if (meshes_.size() >= INVALID_ID) {
+        throw std::length_error("MeshRegistry: mesh ids exhausted");
+    }
+    meshes_.push_back(std::move(mesh));
+    ++size_;
+    return static_cast<MeshId>(meshes_.size() - 1);
+}
+
+Mesh& MeshRegistry::get(MeshId id) {
+    return const_cast<Mesh&>(static_cast<const MeshRegistry&>(*this).get(id));
+}
+
+const Mesh& MeshRegistry::get(MeshId id) const {
+    if (!contains(id)) {
+        throw std::out_of_range("MeshRegistry: unknown mesh id " + std::to_string(id));
+    }
+    return *meshes_[id];
+}
+
+bool MeshRegistry::contains(MeshId id) const {
+    return id < meshes_.size() && meshes_[id] != nullptr;
+}
+
+void MeshRegistry::remove(MeshId id) {
+    if (!contains(id)) {
+        throw std::out_of_range("MeshRegistry: unknown mesh id " + std::to_string(id));
+    }
+    meshes_[id].reset();
+    --size_;
+}
+
+VkDeviceSize MeshRegistry::gpuBytes() const {
+    VkDeviceSize total = 0;
+    for (const std::unique_ptr<Mesh>& mesh : meshes_) {
+        if (mesh) {
+            total += mesh->getGpuBytes();
+        }
+    }
+    return total;
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include "Material.hpp"
+#include "MemoryAllocator.hpp"
+#include "MeshSimplifier.hpp"
+#include "Meshlet.hpp"
+#include "PackedVertex.hpp"
+#include "Vertex.hpp"
+#include "VulkanTypes.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Сетка, загруженная в GPU: буферы и всё, что нужно для её отрисовки
+ *
+ * Вершины и индексы в памяти CPU (MeshData) после загрузки не хранятся:
+ * объект держит только буферы устройства и метаданные — число вершин и
+ * индексов, описанную сферу, уровни детализации, мешлеты и материалы.
+ * Заполняет объект BufferManager, хранит — MeshRegistry.
+ */
+class Mesh {
+public:
+    Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    /// Путь к файлу модели или имя встроенной сетки
+    const std::string& getName() const {return name_;}
+
+    VkBuffer getVertexBuffer() const {return vertexBuffer_.get();}
+    VkBuffer getIndexBuffer() const {return indexBuffer_.get();}
+    uint32_t getVertexCount() const {return vertexCount_;}
+    /// Индексы всех уровней детализации вместе
+    uint32_t getIndexCount() const {return indexCount_;}
+    VertexFormat getVertexFormat() const {return vertexFormat_;}
+    const VertexQuantization& getVertexQuantization() const {return vertexQuantization_;}
+    /// Уровни детализации в индексном буфере; без --lod — один уровень на весь буфер
+    const std::vector<LodLevel>& getLodLevels() const {return lods_;}
+    /// Описанная сфера: xyz — центр, w — радиус (0, если неизвестна)
+    const glm::vec4& getBoundingSphere() const {return boundingSphere_;}
+    /// Мешлеты LOD0; пусто без --meshlets
+    const MeshletMesh& getMeshlets() const {return meshlets_;}
+    VkBuffer getMeshletBuffer() const {return meshletBuffer_.get();}
+    /// Индексный буфер для треугольников, переживших отсечение мешлетов
+    VkBuffer getCulledIndexBuffer() const {return culledIndexBuffer_.get();}
+    void* getCulledIndexBufferMapped() const {return culledIndexBufferMemory_.mapped();}
+    /// Диапазоны LOD0 по материалам, в порядке индексного буфера; хотя бы один
+    const std::vector<Submesh>& getSubmeshes() const {return meshMaterials_.submeshes;}
+    const MeshMaterials& getMeshMaterials() const {return meshMaterials_;}
+    /// Материалы сетки; Submesh::material — номер в этом массиве
+    const std::vector<Material>& getMaterials() const {return materials_;}
+    /// Сжатые изображения, встроенные в glTF (Material::embeddedImage); пусто после releaseEmbeddedImages()
+    const std::vector<std::vector<uint8_t>>& getEmbeddedImages() const {return embeddedImages_;}
+    void releaseEmbeddedImages() {embeddedImages_ = {};}
+
+    /**
+     * @brief Плотность UV по диапазонам getSubmeshes(): UV-единиц на единицу длины в пространстве модели
+     *
+     * Пусто или 0, если неизвестна (glTF без обработки и --stream не держат вершины в памяти)
+     */
+    const std::vector<float>& getUvDensity() const {return uvDensity_;}
+
+    /// Видеопамять всех буферов сетки в байтах
+    VkDeviceSize getGpuBytes() const {return gpuBytes_;}
+
+    /**
+     * @brief Описанная сфера точек: центр габаритного параллелепипеда и наибольшее расстояние до него
+     * @return xyz — центр, w — радиус; нули для пустого массива
+     */
+    static glm::vec4 computeBoundingSphere(const Vertex* vertices, size_t count);
+
+    /**
+     * @brief Плотность UV каждого диапазона: корень из отношения площади треугольников в UV к их площади
+     *
+     * По ней видно, сколько текселей приходится на пиксель экрана на данном расстоянии.
+     * @param indexCount Индексы LOD0; по ним считается единственный диапазон, если submeshes пуст
+     * @return По значению на диапазон; 0 — у диапазона нет площади или развёртки
+     */
+    static std::vector<float> computeUvDensity(const Vertex* vertices, const uint32_t* indices, size_t indexCount,
+                                               const std::vector<Submesh>& submeshes);
+
+private:
+    friend class BufferManager;
+
+    std::string name_;
+
+    // Память (MemoryAllocator) объявлена перед буфером: буфер уничтожается первым
+    MemoryAllocation vertexBufferMemory_;
+    VkBufferPtr vertexBuffer_;
+    MemoryAllocation indexBufferMemory_;
+    VkBufferPtr indexBuffer_;
+    MemoryAllocation meshletBufferMemory_;
+    VkBufferPtr meshletBuffer_; ///< MeshletBuilder::pack(): мешлеты, их вершины и треугольники
+    MemoryAllocation culledIndexBufferMemory_;
+    VkBufferPtr culledIndexBuffer_;
+
+    uint32_t vertexCount_ = 0;
+    uint32_t indexCount_ = 0;
+    VkDeviceSize gpuBytes_ = 0;
+    VertexFormat vertexFormat_ = VertexFormat::FULL;
+    VertexQuantization vertexQuantization_; ///< Для VertexFormat::PACKED: параметры восстановления в шейдере
+    std::vector<LodLevel> lods_;
+    glm::vec4 boundingSphere_{0.0f};
+    std::vector<float> uvDensity_;
+    MeshletMesh meshlets_;
+    MeshMaterials meshMaterials_;
+    std::vector<Material> materials_;
+    std::vector<std::vector<uint8_t>> embeddedImages_;
+};
+
+/// Номер сетки в MeshRegistry; не переиспользуется после удаления
+using MeshId = uint32_t;
+
+/**
+ * @brief Хранилище сеток, одновременно находящихся в видеопамяти
+ *
+ * Сетки адресуются номерами, выданными add(); удалённый номер больше не
+ * выдаётся, поэтому устаревший MeshId не указывает на чужую сетку.
+ */
+class MeshRegistry {
+public:
+    static constexpr MeshId INVALID_ID = UINT32_MAX;
+
+    /// Забирает сетку во владение
+    MeshId add(std::unique_ptr<Mesh> mesh);
+
+    /// @throws std::out_of_range, если такой сетки нет
+    Mesh& get(MeshId id);
+    const Mesh& get(MeshId id) const;
+
+    bool contains(MeshId id) const;
+
+    /// Освобождает буферы сетки; GPU не должен больше их читать
+    void remove(MeshId id);
+
+    /// Число загруженных сеток
+    size_t size() const {return size_;}
+
+    /// Видеопамять всех сеток в байтах
+    VkDeviceSize gpuBytes() const;
+
+private:
+    std::vector<std::unique_ptr<Mesh>> meshes_; ///< Индекс — MeshId; nullptr на месте удалённых
+    size_t size_ = 0;
+};
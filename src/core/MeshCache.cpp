@@ -0,0 +1,271 @@
+#include "MeshCache.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    const char CACHE_MAGIC[8] = {'V', 'K', 'M', 'E', 'S', 'H', 0, 0};
+
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool validLods(const MeshCache::Header& header) {
+        if (header.lodCount > MeshSimplifier::MAX_LOD_LEVELS) {
+            return false;
+        }
+        for (uint32_t i = 0; i < header.lodCount; ++i) {
+            const LodLevel& lod = header.lods[i];
+            if (static_cast<uint64_t>(lod.firstIndex) + lod.indexCount > header.indexCount) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Все индексы ссылаются на сохранённые вершины: хеш покрывает только исходную модель, а не данные кэша
+    bool validIndices(const MeshCache::Header& header, const char* data) {
+        const auto* indices = reinterpret_cast<const uint32_t*>(data + header.indexOffset);
+        return std::all_of(indices, indices + header.indexCount,
+                           [&](uint32_t index) { return index < header.vertexCount; });
+    }
+
+    void writeCount(std::vector<char>& out, size_t count) {
+        const uint32_t value = static_cast<uint32_t>(count);
+        out.insert(out.end(), reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + sizeof(value));
+    }
+
+    void writeString(std::vector<char>& out, const std::string& text) {
+        writeCount(out, text.size());
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    /// Таблица материалов: число диапазонов и сами Submesh, затем строки (длина + байты) имён и библиотек
+    std::vector<char> serializeMaterials(const MeshMaterials& materials) {
+        std::vector<char> out;
+        writeCount(out, materials.submeshes.size());
+        out.insert(out.end(), reinterpret_cast<const char*>(materials.submeshes.data()),
+                   reinterpret_cast<const char*>(materials.submeshes.data() + materials.submeshes.size()));
+        writeCount(out, materials.materialNames.size());
+        for (const std::string& name : materials.materialNames) {
+            writeString(out, name);
+        }
+        writeCount(out, materials.libraries.size());
+        for (const std::string& library : materials.libraries) {
+            writeString(out, library);
+        }
+        return out;
+    }
+
+    /// Разбирает таблицу материалов, проверяя каждую длину и диапазон
+    bool deserializeMaterials(const char* data, size_t size, uint64_t indexCount, MeshMaterials& materials) {
+        size_t position = 0;
+        auto readCount = [&](uint32_t& value) {
+            if (size - position < sizeof(value)) {
+                return false;
+            }
+            std::memcpy(&value, data + position, sizeof(value));
+            position += sizeof(value);
+            return true;
+        };
+        auto readStrings = [&](std::vector<std::string>& strings) {
+            uint32_t count = 0;
+            if (!readCount(count)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t length = 0;
+                if (!readCount(length) || size - position < length) {
+                    return false;
+                }
+                strings.emplace_back(data + position, length);
+                position += length;
+            }
+            return true;
+        };
+
+        uint32_t submeshCount = 0;
+        if (!readCount(submeshCount) || (size - position) / sizeof(Submesh) < submeshCount) {
+            return false;
+        }
+        materials.submeshes.resize(submeshCount);
+        std::memcpy(materials.submeshes.data(), data + position, submeshCount * sizeof(Submesh));
+        position += submeshCount * sizeof(Submesh);
+        if (!readStrings(materials.materialNames) || !readStrings(materials.libraries) || position != size) {
+            return false;
+        }
+        for (const Submesh& submesh : materials.submeshes) {
+            if (static_cast<uint64_t>(submesh.firstIndex) + submesh.indexCount > indexCount ||
+                submesh.material >= materials.materialNames.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool hashSource(const std::string& modelPath, uint64_t& size, uint64_t& hash) {
+        try {
+            MappedFile source(modelPath);
+            size = source.size();
+            hash = Hash::bytes(source.data(), source.size());
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+}
+
+std::string MeshCache::cachePath(const std::string& modelPath) {
+    return modelPath + ".meshcache";
+}
+
+uint32_t MeshCache::vertexLayoutHash() {
+    const uint64_t layout[] = {
+        sizeof(Vertex), alignof(Vertex),
+        offsetof(Vertex, pos), offsetof(Vertex, color),
+        offsetof(Vertex, texCoord), offsetof(Vertex, normal),
+        offsetof(Vertex, tangent),
+    };
+    return static_cast<uint32_t>(Hash::bytes(layout, sizeof(layout)));
+}
+
+bool MeshCache::open(const std::string& modelPath, float weldEpsilon, uint32_t processing) {
+    file_.reset();
+    header_ = nullptr;
+    materials_ = MeshMaterials{};
+
+    const std::string path = cachePath(modelPath);
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+
+    try {
+        file_.emplace(path);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    if (file_->size() < sizeof(Header)) {
+        file_.reset();
+        return false;
+    }
+    const auto* header = reinterpret_cast<const Header*>(file_->data());
+
+    uint64_t sourceSize = 0;
+    uint64_t sourceHash = 0;
+    const bool valid =
+        std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+        header->version == VERSION &&
+        header->vertexLayout == vertexLayoutHash() &&
+        header->weldEpsilon == weldEpsilon &&
+        header->processing == processing &&
+        header->vertexOffset % PAGE_SIZE == 0 &&
+        header->indexOffset % PAGE_SIZE == 0 &&
+        // Вычитание вместо сложения: испорченные счётчики не переполнят проверку
+        header->vertexOffset <= file_->size() &&
+        header->vertexCount <= (file_->size() - header->vertexOffset) / sizeof(Vertex) &&
+        header->indexOffset <= file_->size() &&
+        header->indexCount <= (file_->size() - header->indexOffset) / sizeof(uint32_t) &&
+        validLods(*header) &&
+        header->materialOffset <= file_->size() &&
+        header->materialSize <= file_->size() - header->materialOffset &&
+        deserializeMaterials(file_->data() + header->materialOffset, static_cast<size_t>(header->materialSize),
+                             header->indexCount, materials_) &&
+        hashSource(modelPath, sourceSize, sourceHash) &&
+        header->sourceSize == sourceSize &&
+        header->sourceHash == sourceHash &&
+        validIndices(*header, file_->data());
+
+    if (!valid) {
+        file_.reset();
+        materials_ = MeshMaterials{};
+        return false;
+    }
+    header_ = header;
+    return true;
+}
+
+bool MeshCache::store(const std::string& modelPath, float weldEpsilon, const std::vector<Vertex>& vertices,
+                      const std::vector<uint32_t>& indices, uint32_t processing,
+                      const std::vector<LodLevel>& lods, const MeshMaterials& materials) {
+    if (lods.size() > MeshSimplifier::MAX_LOD_LEVELS) {
+        return false;
+    }
+    Header header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.vertexLayout = vertexLayoutHash();
+    header.weldEpsilon = weldEpsilon;
+    header.processing = processing;
+    if (!hashSource(modelPath, header.sourceSize, header.sourceHash)) {
+        return false;
+    }
+    header.vertexCount = vertices.size();
+    header.indexCount = indices.size();
+    header.lodCount = static_cast<uint32_t>(lods.size());
+    std::copy(lods.begin(), lods.end(), header.lods);
+    header.vertexOffset = alignUp(sizeof(Header), PAGE_SIZE);
+    header.indexOffset = alignUp(header.vertexOffset + vertices.size() * sizeof(Vertex), PAGE_SIZE);
+    const std::vector<char> materialTable = serializeMaterials(materials);
+    header.materialOffset = header.indexOffset + indices.size() * sizeof(uint32_t);
+    header.materialSize = materialTable.size();
+
+    const std::string path = cachePath(modelPath);
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Failed to write mesh cache: " << tmpPath << std::endl;
+            return false;
+        }
+
+        // Выравнивающие промежутки заполняем нулями, чтобы файл был детерминированным
+        std::vector<char> padding(PAGE_SIZE, 0);
+        auto pad = [&](uint64_t position, uint64_t target) {
+            out.write(padding.data(), static_cast<std::streamsize>(target - position));
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad(sizeof(header), header.vertexOffset);
+        out.write(reinterpret_cast<const char*>(vertices.data()),
+                  static_cast<std::streamsize>(vertices.size() * sizeof(Vertex)));
+        pad(header.vertexOffset + vertices.size() * sizeof(Vertex), header.indexOffset);
+        out.write(reinterpret_cast<const char*>(indices.data()),
+                  static_cast<std::streamsize>(indices.size() * sizeof(uint32_t)));
+        out.write(materialTable.data(), static_cast<std::streamsize>(materialTable.size()));
+
+        if (!out) {
+            std::cerr << "Failed to write mesh cache: " << tmpPath << std::endl;
+            return false;
+        }
+    }
+
+    // Переименование атомарно: другой процесс не увидит наполовину записанный кэш
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        std::filesystem::remove(tmpPath, error);
+        std::cerr << "Failed to write mesh cache: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const Vertex* MeshCache::vertices() const {
+    return header_ ? reinterpret_cast<const Vertex*>(file_->data() + header_->vertexOffset) : nullptr;
+}
+
+const uint32_t* MeshCache::indices() const {
+    return header_ ? reinterpret_cast<const uint32_t*>(file_->data() + header_->indexOffset) : nullptr;
+}
+
+std::vector<LodLevel> MeshCache::lods() const {
+    if (!header_) {
+        return {};
+    }
+    return std::vector<LodLevel>(header_->lods, header_->lods + header_->lodCount);
+}
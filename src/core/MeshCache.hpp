@@ -0,0 +1,88 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "Material.hpp"
+#include "MeshSimplifier.hpp"
+#include "Vertex.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Двоичный кэш готовой (уже без дубликатов) геометрии модели
+ *
+ * Файл лежит рядом с моделью (<model>.meshcache) и содержит заголовок и
+ * массивы вершин и индексов, выровненные по границе страницы. При попадании
+ * файл отображается в память, и данные копируются прямо в staging-буфер
+ * без разбора OBJ и без хеш-таблицы дубликатов.
+ *
+ * Кэш считается актуальным, только если совпадают версия формата,
+ * раскладка Vertex, параметры склейки вершин, набор проходов оптимизации
+ * (флаги PROCESS_*), а также размер и хеш содержимого исходного файла.
+ *
+ * С флагом PROCESS_LOD индексный массив содержит все уровни детализации подряд,
+ * а их таблица хранится в заголовке. За индексами лежит таблица материалов
+ * (MeshMaterials): диапазоны индексов, имена из usemtl и пути mtllib.
+ */
+class MeshCache {
+public:
+    static constexpr uint32_t VERSION = 4;
+    static constexpr uint64_t PAGE_SIZE = 4096;
+
+    /// Флаги проходов оптимизации, уже применённых к сохранённой геометрии
+    static constexpr uint32_t PROCESS_VERTEX_CACHE = 1u << 0; ///< MeshOptimizer::optimizeVertexCache
+    static constexpr uint32_t PROCESS_OVERDRAW = 1u << 1;     ///< MeshOptimizer::optimizeOverdraw
+    static constexpr uint32_t PROCESS_VERTEX_FETCH = 1u << 2; ///< MeshOptimizer::optimizeVertexFetch
+    static constexpr uint32_t PROCESS_LOD = 1u << 3;          ///< MeshSimplifier::buildLodChain
+
+    struct Header {
+        char magic[8];          ///< "VKMESH\0\0"
+        uint32_t version;       ///< VERSION
+        uint32_t vertexLayout;  ///< vertexLayoutHash() на момент записи
+        uint64_t sourceSize;    ///< Размер исходной модели в байтах
+        uint64_t sourceHash;    ///< Hash::bytes() содержимого исходной модели
+        float weldEpsilon;      ///< С каким шагом склеивались вершины
+        uint32_t processing;    ///< Флаги PROCESS_*, с которыми обработана геометрия
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint64_t vertexOffset;  ///< Кратно PAGE_SIZE
+        uint64_t indexOffset;   ///< Кратно PAGE_SIZE
+        uint32_t lodCount;      ///< Сколько элементов lods заполнено (0 — только исходная сетка)
+        LodLevel lods[MeshSimplifier::MAX_LOD_LEVELS];
+        uint64_t materialOffset; ///< Таблица материалов сразу за индексами
+        uint64_t materialSize;   ///< Её размер в байтах
+    };
+
+    static std::string cachePath(const std::string& modelPath);
+
+    /**
+     * @brief Отображает кэш модели в память
+     * @return false, если кэша нет, он повреждён или устарел
+     */
+    bool open(const std::string& modelPath, float weldEpsilon = 0.0f, uint32_t processing = 0);
+
+    /**
+     * @brief Записывает кэш для модели (через временный файл)
+     * @return false, если записать не удалось; это не ошибка загрузки
+     */
+    static bool store(const std::string& modelPath, float weldEpsilon, const std::vector<Vertex>& vertices,
+                      const std::vector<uint32_t>& indices, uint32_t processing = 0,
+                      const std::vector<LodLevel>& lods = {}, const MeshMaterials& materials = {});
+
+    const Vertex* vertices() const;
+    size_t vertexCount() const { return header_ ? static_cast<size_t>(header_->vertexCount) : 0; }
+    const uint32_t* indices() const;
+    size_t indexCount() const { return header_ ? static_cast<size_t>(header_->indexCount) : 0; }
+    /// Таблица уровней детализации; пустая, если кэш записан без них
+    std::vector<LodLevel> lods() const;
+    /// Разбиение по материалам; без материалов в исходной модели submeshes пуст
+    const MeshMaterials& materials() const { return materials_; }
+
+    /// Хеш раскладки Vertex: размер, выравнивание и смещения полей
+    static uint32_t vertexLayoutHash();
+
+private:
+    std::optional<MappedFile> file_;
+    const Header* header_ = nullptr;
+    MeshMaterials materials_;
+};
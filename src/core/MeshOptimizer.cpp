@@ -0,0 +1,442 @@
+#include "MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+    // Параметры оценки из статьи Т. Форсайта "Linear-Speed Vertex Cache Optimisation"
+    constexpr int CACHE_SIZE = 32;                 ///< Моделируемый LRU-кэш
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;   ///< Вершины только что выданного треугольника
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+    constexpr uint32_t VALENCE_TABLE_SIZE = 32;
+    constexpr size_t NO_TRIANGLE = std::numeric_limits<size_t>::max();
+
+    /// Ракурсы оценки перерисовки: вдоль осей и по диагоналям габаритного куба
+    const glm::vec3 OVERDRAW_VIEWS[] = {
+        {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+        {1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1}, {-1, 1, 1}, {-1, 1, -1}, {-1, -1, 1}, {-1, -1, -1},
+    };
+
+    /**
+     * @brief FIFO-кэш вершин для нарезки кластеров; сбрасывается без обнуления массива
+     */
+    class FifoCache {
+    public:
+        FifoCache(size_t vertexCount, unsigned cacheSize) : loadedAt_(vertexCount, 0), cacheSize_(cacheSize) {
+            reset();
+        }
+
+        void reset() { clock_ += cacheSize_ + 1; }
+
+        /// Сколько вершин треугольника пришлось загрузить
+        unsigned touch(const uint32_t* corner) {
+            unsigned misses = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (clock_ - loadedAt_[corner[k]] > cacheSize_) {
+                    loadedAt_[corner[k]] = clock_++;
+                    ++misses;
+                }
+            }
+            return misses;
+        }
+
+    private:
+        std::vector<uint64_t> loadedAt_;
+        uint64_t clock_ = 0;
+        unsigned cacheSize_;
+    };
+
+    /**
+     * @brief Границы кластеров: жёсткие (все три вершины треугольника — промахи) и мягкие внутри них
+     */
+    std::vector<size_t> clusterBoundaries(const std::vector<uint32_t>& indices, size_t vertexCount, float threshold) {
+        const size_t triangleCount = indices.size() / 3;
+        FifoCache cache(vertexCount, MeshOptimizer::ANALYZE_CACHE_SIZE);
+
+        std::vector<size_t> hard;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            if (cache.touch(&indices[t * 3]) == 3 || t == 0) {
+                hard.push_back(t);
+            }
+        }
+        hard.push_back(triangleCount);
+
+        std::vector<size_t> boundaries;
+        for (size_t h = 0; h + 1 < hard.size(); ++h) {
+            const size_t begin = hard[h];
+            const size_t end = hard[h + 1];
+
+            cache.reset();
+            size_t clusterMisses = 0;
+            for (size_t t = begin; t < end; ++t) {
+                clusterMisses += cache.touch(&indices[t * 3]);
+            }
+            const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+            // Режем там, где ACMR с начала кусочка уже не хуже ACMR всего кластера (с допуском)
+            cache.reset();
+            boundaries.push_back(begin);
+            size_t start = begin;
+            size_t misses = 0;
+            for (size_t t = begin; t < end; ++t) {
+                misses += cache.touch(&indices[t * 3]);
+                const float acmr = static_cast<float>(misses) / static_cast<float>(t - start + 1);
+                if (acmr <= clusterThreshold && t + 1 < end) {
+                    boundaries.push_back(t + 1);
+                    cache.reset();
+                    start = t + 1;
+                    misses = 0;
+                }
+            }
+        }
+        boundaries.push_back(triangleCount);
+        return boundaries;
+    }
+
+    float edgeFunction(const glm::vec2& a, const glm::vec2& b, const glm::vec2& p) {
+        return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+    }
+
+    /**
+     * @brief Оценки заранее посчитаны для всех позиций в кэше и типичных валентностей
+     */
+    struct ScoreTables {
+        float cache[CACHE_SIZE];
+        float valence[VALENCE_TABLE_SIZE];
+
+        ScoreTables() {
+            for (int i = 0; i < CACHE_SIZE; ++i) {
+                if (i < 3) {
+                    cache[i] = LAST_TRIANGLE_SCORE; // Не поощряем повтор того же треугольника
+                } else {
+                    const float scaler = 1.0f / static_cast<float>(CACHE_SIZE - 3);
+                    cache[i] = std::pow(1.0f - static_cast<float>(i - 3) * scaler, CACHE_DECAY_POWER);
+                }
+            }
+            valence[0] = 0.0f;
+            for (uint32_t i = 1; i < VALENCE_TABLE_SIZE; ++i) {
+                valence[i] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -VALENCE_BOOST_POWER);
+            }
+        }
+
+        float vertexScore(int cachePosition, uint32_t remainingTriangles) const {
+            if (remainingTriangles == 0) {
+                return -1.0f; // Вершина больше не нужна
+            }
+            float score = cachePosition < 0 ? 0.0f : cache[cachePosition];
+            // Вершины с малым числом оставшихся треугольников стоит закрыть поскорее
+            score += remainingTriangles < VALENCE_TABLE_SIZE
+                ? valence[remainingTriangles]
+                : VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+            return score;
+        }
+    };
+}
+
+namespace MeshOptimizer {
+
+    double VertexCacheStats::acmr() const {
+        return triangleCount == 0 ? 0.0 : static_cast<double>(vertexTransforms) / static_cast<double>(triangleCount);
+    }
+
+    double VertexCacheStats::atvr() const {
+        return vertexCount == 0 ? 0.0 : static_cast<double>(vertexTransforms) / static_cast<double>(vertexCount);
+    }
+
+    VertexCacheStats analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, unsigned cacheSize) {
+        VertexCacheStats stats;
+        stats.triangleCount = indices.size() / 3;
+
+        // Вершина в кэше, если с момента её загрузки было не больше cacheSize других загрузок
+        std::vector<uint64_t> loadedAt(vertexCount, 0);
+        uint64_t clock = static_cast<uint64_t>(cacheSize) + 1;
+        for (uint32_t index : indices) {
+            if (index >= vertexCount) {
+                throw std::runtime_error("Vertex index out of range in vertex cache analysis");
+            }
+            if (loadedAt[index] == 0) {
+                ++stats.vertexCount;
+            }
+            if (clock - loadedAt[index] > cacheSize) {
+                loadedAt[index] = clock++;
+                ++stats.vertexTransforms;
+            }
+        }
+        return stats;
+    }
+
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0) {
+            return;
+        }
+        static const ScoreTables tables;
+
+        // Смежность вершина -> треугольники; первые remaining[v] элементов — ещё не выданные
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            if (indices[i] >= vertexCount) {
+                throw std::runtime_error("Vertex index out of range in vertex cache optimization");
+            }
+            ++remaining[indices[i]];
+        }
+        std::vector<size_t> adjacencyOffset(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+        }
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        {
+            std::vector<size_t> cursor(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+            for (size_t i = 0; i < triangleCount * 3; ++i) {
+                adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            vertexScores[v] = tables.vertexScore(-1, remaining[v]);
+        }
+        auto triangleScore = [&](size_t triangle) {
+            const uint32_t* corner = &indices[triangle * 3];
+            return vertexScores[corner[0]] + vertexScores[corner[1]] + vertexScores[corner[2]];
+        };
+
+        // Первый треугольник — лучший по всей сетке
+        size_t bestTriangle = 0;
+        float bestScore = triangleScore(0);
+        for (size_t t = 1; t < triangleCount; ++t) {
+            const float score = triangleScore(t);
+            if (score > bestScore) {
+                bestScore = score;
+                bestTriangle = t;
+            }
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(triangleCount * 3);
+        std::vector<char> emitted(triangleCount, 0);
+        uint32_t cache[CACHE_SIZE + 3];
+        size_t cacheCount = 0;
+        size_t nextUnemitted = 0;
+
+        while (result.size() < triangleCount * 3) {
+            if (bestTriangle == NO_TRIANGLE) {
+                // У вершин в кэше не осталось треугольников: берём первый невыданный по порядку
+                while (emitted[nextUnemitted]) {
+                    ++nextUnemitted;
+                }
+                bestTriangle = nextUnemitted;
+            }
+
+            const uint32_t* corner = &indices[bestTriangle * 3];
+            emitted[bestTriangle] = 1;
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t v = corner[k];
+                result.push_back(v);
+
+                uint32_t* begin = adjacency.data() + adjacencyOffset[v];
+                uint32_t* end = begin + remaining[v];
+                uint32_t* found = std::find(begin, end, static_cast<uint32_t>(bestTriangle));
+                if (found != end) { // Вырожденный треугольник упоминает вершину дважды
+                    std::swap(*found, *(end - 1));
+                    --remaining[v];
+                }
+            }
+
+            // LRU: вершины треугольника в начало, остальные сдвигаются, лишние вытесняются
+            uint32_t newCache[CACHE_SIZE + 3];
+            size_t newCount = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (std::find(newCache, newCache + newCount, corner[k]) == newCache + newCount) {
+                    newCache[newCount++] = corner[k];
+                }
+            }
+            for (size_t i = 0; i < cacheCount; ++i) {
+                if (cache[i] != corner[0] && cache[i] != corner[1] && cache[i] != corner[2]) {
+                    newCache[newCount++] = cache[i];
+                }
+            }
+
+            for (size_t i = 0; i < newCount; ++i) {
+                const uint32_t v = newCache[i];
+                cachePosition[v] = i < CACHE_SIZE ? static_cast<int>(i) : -1;
+                vertexScores[v] = tables.vertexScore(cachePosition[v], remaining[v]);
+            }
+            cacheCount = std::min<size_t>(newCount, CACHE_SIZE);
+            std::copy(newCache, newCache + cacheCount, cache);
+
+            // Следующий треугольник ищется только среди смежных с кэшем
+            bestTriangle = NO_TRIANGLE;
+            bestScore = -std::numeric_limits<float>::max();
+            for (size_t i = 0; i < cacheCount; ++i) {
+                const uint32_t v = cache[i];
+                const uint32_t* begin = adjacency.data() + adjacencyOffset[v];
+                for (const uint32_t* t = begin; t != begin + remaining[v]; ++t) {
+                    const float score = triangleScore(*t);
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestTriangle = *t;
+                    }
+                }
+            }
+        }
+
+        std::copy(result.begin(), result.end(), indices.begin());
+    }
+
+    double OverdrawStats::overdraw() const {
+        return pixelsCovered == 0 ? 0.0 : static_cast<double>(pixelsShaded) / static_cast<double>(pixelsCovered);
+    }
+
+    OverdrawStats analyzeOverdraw(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                  unsigned resolution) {
+        OverdrawStats stats;
+        if (vertices.empty() || indices.size() < 3) {
+            return stats;
+        }
+
+        glm::vec3 minimum(std::numeric_limits<float>::max());
+        glm::vec3 maximum(std::numeric_limits<float>::lowest());
+        for (const Vertex& vertex : vertices) {
+            minimum = glm::min(minimum, vertex.pos);
+            maximum = glm::max(maximum, vertex.pos);
+        }
+        const glm::vec3 center = (minimum + maximum) * 0.5f;
+        const float radius = std::max(glm::length(maximum - minimum) * 0.5f, std::numeric_limits<float>::min());
+        const float scale = static_cast<float>(resolution) / (2.0f * radius);
+
+        std::vector<glm::vec3> projected(vertices.size());
+        std::vector<float> depth(static_cast<size_t>(resolution) * resolution);
+
+        for (const glm::vec3& view : OVERDRAW_VIEWS) {
+            // Камера стоит на стороне view и смотрит к центру; right x up == direction
+            const glm::vec3 direction = glm::normalize(view);
+            const glm::vec3 axis = std::fabs(direction.z) < 0.9f ? glm::vec3(0, 0, 1) : glm::vec3(1, 0, 0);
+            const glm::vec3 right = glm::normalize(glm::cross(axis, direction));
+            const glm::vec3 up = glm::cross(direction, right);
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                const glm::vec3 p = vertices[i].pos - center;
+                projected[i] = glm::vec3((glm::dot(p, right) + radius) * scale, (glm::dot(p, up) + radius) * scale,
+                                         glm::dot(p, direction)); // Больше z — ближе к камере
+            }
+
+            std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::lowest());
+            for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+                const glm::vec3& a = projected[indices[t]];
+                const glm::vec3& b = projected[indices[t + 1]];
+                const glm::vec3& c = projected[indices[t + 2]];
+                const float area = edgeFunction(a, b, c);
+                if (area <= 0.0f) {
+                    continue; // Задняя или вырожденная грань отсекается до растеризации
+                }
+
+                const int x0 = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+                const int y0 = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+                const int x1 = std::min(static_cast<int>(resolution) - 1, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+                const int y1 = std::min(static_cast<int>(resolution) - 1, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+                for (int y = y0; y <= y1; ++y) {
+                    for (int x = x0; x <= x1; ++x) {
+                        const glm::vec2 sample(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f);
+                        const float wa = edgeFunction(b, c, sample);
+                        const float wb = edgeFunction(c, a, sample);
+                        const float wc = edgeFunction(a, b, sample);
+                        if (wa < 0.0f || wb < 0.0f || wc < 0.0f) {
+                            continue;
+                        }
+                        const float z = (wa * a.z + wb * b.z + wc * c.z) / area;
+                        float& stored = depth[static_cast<size_t>(y) * resolution + x];
+                        if (z > stored) {
+                            stored = z;
+                            ++stats.pixelsShaded;
+                        }
+                    }
+                }
+            }
+            stats.pixelsCovered += static_cast<size_t>(std::count_if(depth.begin(), depth.end(),
+                [](float z) { return z != std::numeric_limits<float>::lowest(); }));
+        }
+        return stats;
+    }
+
+    void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold) {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0) {
+            return;
+        }
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            if (indices[i] >= vertices.size()) {
+                throw std::runtime_error("Vertex index out of range in overdraw optimization");
+            }
+        }
+
+        const std::vector<size_t> boundaries = clusterBoundaries(indices, vertices.size(), threshold);
+        const size_t clusterCount = boundaries.size() - 1;
+
+        // Центр и суммарная (взвешенная площадью) нормаль каждого кластера и всей сетки
+        std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+        std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t k = 0; k < clusterCount; ++k) {
+            float clusterArea = 0.0f;
+            for (size_t t = boundaries[k]; t < boundaries[k + 1]; ++t) {
+                const glm::vec3& a = vertices[indices[t * 3]].pos;
+                const glm::vec3& b = vertices[indices[t * 3 + 1]].pos;
+                const glm::vec3& c = vertices[indices[t * 3 + 2]].pos;
+                const glm::vec3 normal = glm::cross(b - a, c - a); // Длина — удвоенная площадь
+                const float area = glm::length(normal);
+                clusterCentroid[k] += (a + b + c) * (area / 3.0f);
+                clusterNormal[k] += normal;
+                clusterArea += area;
+            }
+            meshCentroid += clusterCentroid[k];
+            meshArea += clusterArea;
+            clusterCentroid[k] = clusterArea > 0.0f ? clusterCentroid[k] / clusterArea : vertices[indices[boundaries[k] * 3]].pos;
+        }
+        if (meshArea > 0.0f) {
+            meshCentroid /= meshArea;
+        }
+
+        std::vector<float> sortKey(clusterCount);
+        for (size_t k = 0; k < clusterCount; ++k) {
+            const float length = glm::length(clusterNormal[k]);
+            sortKey[k] = length > 0.0f ? glm::dot(clusterCentroid[k] - meshCentroid, clusterNormal[k] / length) : 0.0f;
+        }
+
+        // Выдвинутые наружу кластеры первыми; stable_sort сохраняет детерминизм при равных ключах
+        std::vector<size_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (size_t k : order) {
+            result.insert(result.end(), indices.begin() + boundaries[k] * 3, indices.begin() + boundaries[k + 1] * 3);
+        }
+        std::copy(result.begin(), result.end(), indices.begin());
+    }
+
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(vertices.size(), UNUSED);
+        std::vector<Vertex> reordered;
+        reordered.reserve(vertices.size());
+
+        for (uint32_t& index : indices) {
+            if (index >= vertices.size()) {
+                throw std::runtime_error("Vertex index out of range in vertex fetch optimization");
+            }
+            if (remap[index] == UNUSED) {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices.swap(reordered);
+    }
+}
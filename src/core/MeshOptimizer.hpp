@@ -0,0 +1,90 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Проходы оптимизации проиндексированной сетки (после устранения дубликатов)
+ *
+ * Все проходы детерминированы: одна и та же сетка всегда даёт один и тот же результат,
+ * поэтому их вывод можно сохранять в MeshCache.
+ */
+namespace MeshOptimizer {
+    /**
+     * @brief Эффективность кэша вершин после трансформации для заданного порядка индексов
+     */
+    struct VertexCacheStats {
+        size_t triangleCount = 0;
+        size_t vertexCount = 0;      ///< Сколько разных вершин упоминается в индексах
+        size_t vertexTransforms = 0; ///< Промахи кэша: сколько раз вершинный шейдер вызывается на самом деле
+
+        /// Average cache miss ratio: вызовов шейдера на треугольник (от 0.5 у идеальной сетки до 3)
+        double acmr() const;
+        /// Average transform to vertex ratio: вызовов шейдера на вершину (идеал — 1)
+        double atvr() const;
+    };
+
+    /// Размер FIFO-кэша при оценке: порядок величины кэша вершин у современных GPU
+    constexpr unsigned ANALYZE_CACHE_SIZE = 16;
+
+    /**
+     * @brief Моделирует FIFO-кэш вершин на списке треугольников
+     */
+    VertexCacheStats analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                        unsigned cacheSize = ANALYZE_CACHE_SIZE);
+
+    /**
+     * @brief Переупорядочивает треугольники для повторного использования кэша вершин (алгоритм Форсайта)
+     *
+     * Треугольники выбираются жадно по оценке их вершин: недавно использованные
+     * вершины и вершины, у которых осталось мало треугольников, ценятся выше.
+     * Порядок вершин внутри треугольника (и значит обход граней) сохраняется.
+     */
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+    /**
+     * @brief Оценка перерисовки, полученная программной растеризацией
+     */
+    struct OverdrawStats {
+        size_t pixelsCovered = 0; ///< Пикселей, закрытых сеткой (сумма по всем ракурсам)
+        size_t pixelsShaded = 0;  ///< Вызовов фрагментного шейдера, прошедших тест глубины
+
+        /// Вызовов фрагментного шейдера на видимый пиксель (1 — без перерисовки)
+        double overdraw() const;
+    };
+
+    /// Сторона квадратного буфера глубины для одного ракурса
+    constexpr unsigned OVERDRAW_RESOLUTION = 256;
+
+    /**
+     * @brief Растеризует треугольники в заданном порядке с разных сторон и считает перерисовку
+     *
+     * Ортографические ракурсы вдоль осей и диагоналей габаритного куба, отсечение
+     * задних граней и тест глубины LESS, как в основном конвейере. Заменяет
+     * профилировщик GPU, когда надо сравнить два порядка индексов.
+     */
+    OverdrawStats analyzeOverdraw(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                  unsigned resolution = OVERDRAW_RESOLUTION);
+
+    /**
+     * @brief Переставляет кластеры треугольников так, чтобы ближние к наблюдателю рисовались раньше
+     *
+     * Вызывается после optimizeVertexCache(): порядок режется на кластеры там, где кэш
+     * вершин и так начинается заново (или почти заново, в пределах threshold от ACMR
+     * кластера). Кластеры сортируются по тому, насколько они выдвинуты наружу вдоль
+     * своей средней нормали: такие грани чаще других оказываются впереди при любом
+     * ракурсе (Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality
+     * and Reduced Overdraw").
+     */
+    void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold = 1.05f);
+
+    /**
+     * @brief Переупорядочивает вершины в порядке первого использования индексами
+     *
+     * Выборка вершин идёт почти последовательно по памяти. Вызывается последним:
+     * порядок треугольников после него не должен меняться. Вершины, на которые нет
+     * ни одного индекса, отбрасываются.
+     */
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+}
@@ -0,0 +1,456 @@
+#include "MeshSimplifier.hpp"
+#include "MeshOptimizer.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+    constexpr double MIN_COS_AFTER_COLLAPSE = 0.25; ///< Грань не должна поворачиваться сильнее ~75°
+    constexpr double NEXT_LEVEL_MIN_SHRINK = 0.9;   ///< Уровень, уменьшившийся меньше чем на 10%, бесполезен
+
+    /**
+     * @brief Квадрика ошибки: взвешенная сумма квадратов расстояний до плоскостей граней
+     */
+    struct Quadric {
+        double a2 = 0, b2 = 0, c2 = 0, ab = 0, ac = 0, bc = 0, ad = 0, bd = 0, cd = 0, d2 = 0;
+        double weight = 0;
+
+        void addPlane(const glm::dvec3& n, double d, double w) {
+            a2 += w * n.x * n.x; b2 += w * n.y * n.y; c2 += w * n.z * n.z;
+            ab += w * n.x * n.y; ac += w * n.x * n.z; bc += w * n.y * n.z;
+            ad += w * n.x * d;   bd += w * n.y * d;   cd += w * n.z * d;
+            d2 += w * d * d;
+            weight += w;
+        }
+
+        Quadric& operator+=(const Quadric& o) {
+            a2 += o.a2; b2 += o.b2; c2 += o.c2; ab += o.ab; ac += o.ac; bc += o.bc;
+            ad += o.ad; bd += o.bd; cd += o.cd; d2 += o.d2; weight += o.weight;
+            return *this;
+        }
+
+        /// Средний квадрат расстояния от p до плоскостей
+        double error(const glm::dvec3& p) const {
+            const double e = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z
+                           + 2.0 * (ab * p.x * p.y + ac * p.x * p.z + bc * p.y * p.z)
+                           + 2.0 * (ad * p.x + bd * p.y + cd * p.z) + d2;
+            return weight > 0.0 ? std::max(e, 0.0) / weight : 0.0;
+        }
+    };
+
+    struct Collapse {
+        double cost;
+        uint32_t from;
+        uint32_t to;
+
+        bool operator<(const Collapse& o) const {
+            return std::tie(cost, from, to) < std::tie(o.cost, o.from, o.to);
+        }
+    };
+
+    /**
+     * @brief Состояние упрощения одной сетки
+     *
+     * Узлы графа — уникальные позиции (position), вершины с одинаковой позицией —
+     * их «клинья» (wedge). Стягивание позиции from в позицию to переназначает
+     * каждый клин from на клин to, соединённый с ним ребром в какой-нибудь грани.
+     */
+    class Simplifier {
+    public:
+        Simplifier(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+            : triangles_(indices.begin(), indices.begin() + indices.size() / 3 * 3) {
+            for (uint32_t index : triangles_) {
+                if (index >= vertices.size()) {
+                    throw std::runtime_error("Vertex index out of range in mesh simplification");
+                }
+            }
+
+            // Вершины с побитово равной позицией — одна позиция
+            std::unordered_map<glm::vec3, uint32_t> positionIds;
+            positionOf_.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                const auto inserted = positionIds.emplace(vertices[i].pos, static_cast<uint32_t>(positions_.size()));
+                if (inserted.second) {
+                    positions_.push_back(glm::dvec3(vertices[i].pos));
+                }
+                positionOf_[i] = inserted.first->second;
+            }
+
+            wedgeRemap_.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                wedgeRemap_[i] = static_cast<uint32_t>(i);
+            }
+
+            glm::dvec3 minimum(std::numeric_limits<double>::max());
+            glm::dvec3 maximum(std::numeric_limits<double>::lowest());
+            for (const glm::dvec3& p : positions_) {
+                minimum = glm::min(minimum, p);
+                maximum = glm::max(maximum, p);
+            }
+            radius_ = positions_.empty() ? 0.0 : glm::length(maximum - minimum) * 0.5;
+
+            computeQuadrics();
+            lockBorders();
+        }
+
+        double radius() const { return radius_; }
+
+        std::vector<uint32_t> run(size_t targetIndexCount, double maxError, double& resultError) {
+            const double maxCost = maxError * maxError;
+            resultError = 0.0;
+
+            for (;;) {
+                compact();
+                size_t triangleCount = triangles_.size() / 3;
+                if (triangleCount * 3 <= targetIndexCount) {
+                    break;
+                }
+                buildAdjacency();
+
+                std::vector<Collapse> candidates = collectCandidates();
+                std::sort(candidates.begin(), candidates.end());
+
+                std::vector<char> touched(positions_.size(), 0);
+                size_t collapsed = 0;
+                for (const Collapse& collapse : candidates) {
+                    if (collapse.cost > maxCost || triangleCount * 3 <= targetIndexCount) {
+                        break;
+                    }
+                    if (touched[collapse.from] || touched[collapse.to]) {
+                        continue;
+                    }
+                    size_t removedTriangles = 0;
+                    if (!tryCollapse(collapse.from, collapse.to, removedTriangles)) {
+                        continue;
+                    }
+                    touched[collapse.from] = 1;
+                    touched[collapse.to] = 1;
+                    triangleCount -= std::min(triangleCount, removedTriangles);
+                    resultError = std::max(resultError, collapse.cost);
+                    ++collapsed;
+                }
+                if (collapsed == 0) {
+                    break; // Дешёвых допустимых стягиваний больше нет
+                }
+            }
+
+            compact();
+            resultError = std::sqrt(resultError);
+            return triangles_;
+        }
+
+    private:
+        uint32_t resolve(uint32_t wedge) {
+            uint32_t root = wedge;
+            while (wedgeRemap_[root] != root) {
+                root = wedgeRemap_[root];
+            }
+            while (wedgeRemap_[wedge] != root) { // Сжатие пути
+                const uint32_t next = wedgeRemap_[wedge];
+                wedgeRemap_[wedge] = root;
+                wedge = next;
+            }
+            return root;
+        }
+
+        void computeQuadrics() {
+            quadrics_.assign(positions_.size(), Quadric{});
+            for (size_t t = 0; t < triangles_.size(); t += 3) {
+                const uint32_t p0 = positionOf_[triangles_[t]];
+                const uint32_t p1 = positionOf_[triangles_[t + 1]];
+                const uint32_t p2 = positionOf_[triangles_[t + 2]];
+                const glm::dvec3 normal = glm::cross(positions_[p1] - positions_[p0], positions_[p2] - positions_[p0]);
+                const double length = glm::length(normal);
+                if (length <= 0.0) {
+                    continue;
+                }
+                const glm::dvec3 n = normal / length;
+                const double d = -glm::dot(n, positions_[p0]);
+                const double area = length * 0.5;
+                quadrics_[p0].addPlane(n, d, area);
+                quadrics_[p1].addPlane(n, d, area);
+                quadrics_[p2].addPlane(n, d, area);
+            }
+        }
+
+        /**
+         * @brief Вершины на открытой или неманифолдной кромке не двигаются, иначе сетка «съёживается»
+         */
+        void lockBorders() {
+            std::vector<uint64_t> edges;
+            edges.reserve(triangles_.size());
+            for (size_t t = 0; t < triangles_.size(); t += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    const uint32_t a = positionOf_[triangles_[t + k]];
+                    const uint32_t b = positionOf_[triangles_[t + (k + 1) % 3]];
+                    if (a != b) {
+                        edges.push_back(static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b));
+                    }
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+
+            locked_.assign(positions_.size(), 0);
+            for (size_t i = 0; i < edges.size();) {
+                size_t j = i;
+                while (j < edges.size() && edges[j] == edges[i]) {
+                    ++j;
+                }
+                if (j - i != 2) {
+                    locked_[edges[i] >> 32] = 1;
+                    locked_[edges[i] & 0xFFFFFFFFu] = 1;
+                }
+                i = j;
+            }
+        }
+
+        /// Переводит индексы на текущие клинья и выбрасывает вырожденные грани
+        void compact() {
+            size_t out = 0;
+            for (size_t t = 0; t < triangles_.size(); t += 3) {
+                const uint32_t a = resolve(triangles_[t]);
+                const uint32_t b = resolve(triangles_[t + 1]);
+                const uint32_t c = resolve(triangles_[t + 2]);
+                const uint32_t pa = positionOf_[a];
+                const uint32_t pb = positionOf_[b];
+                const uint32_t pc = positionOf_[c];
+                if (pa == pb || pb == pc || pa == pc) {
+                    continue;
+                }
+                triangles_[out++] = a;
+                triangles_[out++] = b;
+                triangles_[out++] = c;
+            }
+            triangles_.resize(out);
+        }
+
+        void buildAdjacency() {
+            adjacencyOffset_.assign(positions_.size() + 1, 0);
+            for (uint32_t wedge : triangles_) {
+                ++adjacencyOffset_[positionOf_[wedge] + 1];
+            }
+            for (size_t i = 0; i < positions_.size(); ++i) {
+                adjacencyOffset_[i + 1] += adjacencyOffset_[i];
+            }
+            adjacency_.resize(triangles_.size());
+            std::vector<size_t> cursor(adjacencyOffset_.begin(), adjacencyOffset_.end() - 1);
+            for (size_t i = 0; i < triangles_.size(); ++i) {
+                adjacency_[cursor[positionOf_[triangles_[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<Collapse> collectCandidates() const {
+            std::vector<uint64_t> edges;
+            edges.reserve(triangles_.size());
+            for (size_t t = 0; t < triangles_.size(); t += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    const uint32_t a = positionOf_[triangles_[t + k]];
+                    const uint32_t b = positionOf_[triangles_[t + (k + 1) % 3]];
+                    edges.push_back(static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+            std::vector<Collapse> candidates;
+            candidates.reserve(edges.size());
+            for (uint64_t edge : edges) {
+                const uint32_t a = static_cast<uint32_t>(edge >> 32);
+                const uint32_t b = static_cast<uint32_t>(edge & 0xFFFFFFFFu);
+                Quadric sum = quadrics_[a];
+                sum += quadrics_[b];
+                const double costAB = locked_[a] ? std::numeric_limits<double>::max() : sum.error(positions_[b]);
+                const double costBA = locked_[b] ? std::numeric_limits<double>::max() : sum.error(positions_[a]);
+                if (locked_[a] && locked_[b]) {
+                    continue;
+                }
+                candidates.push_back(costAB <= costBA ? Collapse{costAB, a, b} : Collapse{costBA, b, a});
+            }
+            return candidates;
+        }
+
+        void collectNeighbours(uint32_t position, std::vector<uint32_t>& neighbours) {
+            neighbours.clear();
+            for (size_t i = adjacencyOffset_[position]; i < adjacencyOffset_[position + 1]; ++i) {
+                const size_t t = adjacency_[i] * size_t{3};
+                for (int k = 0; k < 3; ++k) {
+                    const uint32_t neighbour = positionOf_[resolve(triangles_[t + k])];
+                    if (neighbour != position) {
+                        neighbours.push_back(neighbour);
+                    }
+                }
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        }
+
+        /**
+         * @brief Проверяет и выполняет стягивание позиции from в позицию to
+         *
+         * Отказ, если какой-то клин from не соединён ребром ни с одним клином to
+         * (стягивание поперёк шва исказило бы UV), если два клина from попадают
+         * в один клин to, или если какая-то оставшаяся грань перевернётся.
+         */
+        bool tryCollapse(uint32_t from, uint32_t to, size_t& removedTriangles) {
+            wedgePairs_.clear();
+            fromWedges_.clear();
+            removedTriangles = 0;
+
+            // Условие связности: у концов ребра ровно две общие соседние позиции,
+            // иначе стягивание склеит сетку в неманифолдную
+            collectNeighbours(from, fromNeighbours_);
+            collectNeighbours(to, toNeighbours_);
+            size_t commonNeighbours = 0;
+            for (auto a = fromNeighbours_.begin(), b = toNeighbours_.begin();
+                 a != fromNeighbours_.end() && b != toNeighbours_.end();) {
+                if (*a < *b) {
+                    ++a;
+                } else if (*b < *a) {
+                    ++b;
+                } else {
+                    ++commonNeighbours;
+                    ++a;
+                    ++b;
+                }
+            }
+            if (commonNeighbours > 2) {
+                return false;
+            }
+
+            for (size_t i = adjacencyOffset_[from]; i < adjacencyOffset_[from + 1]; ++i) {
+                const size_t t = adjacency_[i] * size_t{3};
+                uint32_t wedges[3];
+                uint32_t position[3];
+                for (int k = 0; k < 3; ++k) {
+                    wedges[k] = resolve(triangles_[t + k]);
+                    position[k] = positionOf_[wedges[k]];
+                }
+                if (position[0] == position[1] || position[1] == position[2] || position[0] == position[2]) {
+                    continue; // Грань уже выродилась в этом проходе
+                }
+
+                int fromCorner = -1;
+                int toCorner = -1;
+                for (int k = 0; k < 3; ++k) {
+                    if (position[k] == from) fromCorner = k;
+                    if (position[k] == to) toCorner = k;
+                }
+                if (fromCorner < 0) {
+                    continue;
+                }
+                fromWedges_.push_back(wedges[fromCorner]);
+
+                if (toCorner >= 0) {
+                    ++removedTriangles;
+                    wedgePairs_.emplace_back(wedges[fromCorner], wedges[toCorner]);
+                    continue;
+                }
+
+                const glm::dvec3& p0 = positions_[position[0]];
+                const glm::dvec3& p1 = positions_[position[1]];
+                const glm::dvec3& p2 = positions_[position[2]];
+                const glm::dvec3 before = glm::cross(p1 - p0, p2 - p0);
+                glm::dvec3 moved[3] = {p0, p1, p2};
+                moved[fromCorner] = positions_[to];
+                const glm::dvec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+                const double lengths = glm::length(before) * glm::length(after);
+                if (lengths <= 0.0 || glm::dot(before, after) < MIN_COS_AFTER_COLLAPSE * lengths) {
+                    return false;
+                }
+            }
+
+            // Каждому клину from — ровно один клин to, разным клиньям — разные
+            std::sort(wedgePairs_.begin(), wedgePairs_.end());
+            wedgePairs_.erase(std::unique(wedgePairs_.begin(), wedgePairs_.end()), wedgePairs_.end());
+            std::sort(fromWedges_.begin(), fromWedges_.end());
+            fromWedges_.erase(std::unique(fromWedges_.begin(), fromWedges_.end()), fromWedges_.end());
+            if (wedgePairs_.size() != fromWedges_.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < wedgePairs_.size(); ++i) {
+                if (wedgePairs_[i].first != fromWedges_[i]) {
+                    return false;
+                }
+                for (size_t j = 0; j < i; ++j) {
+                    if (wedgePairs_[j].second == wedgePairs_[i].second) {
+                        return false;
+                    }
+                }
+            }
+
+            for (const auto& pair : wedgePairs_) {
+                wedgeRemap_[pair.first] = pair.second;
+            }
+            quadrics_[to] += quadrics_[from];
+            return true;
+        }
+
+        std::vector<uint32_t> triangles_;
+        std::vector<uint32_t> positionOf_;
+        std::vector<glm::dvec3> positions_;
+        std::vector<uint32_t> wedgeRemap_;
+        std::vector<Quadric> quadrics_;
+        std::vector<char> locked_;
+        std::vector<size_t> adjacencyOffset_;
+        std::vector<uint32_t> adjacency_;
+        std::vector<std::pair<uint32_t, uint32_t>> wedgePairs_;
+        std::vector<uint32_t> fromWedges_;
+        std::vector<uint32_t> fromNeighbours_;
+        std::vector<uint32_t> toNeighbours_;
+        double radius_ = 0.0;
+    };
+}
+
+namespace MeshSimplifier {
+
+    std::vector<uint32_t> simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                   size_t targetIndexCount, float targetError, float* resultError) {
+        Simplifier simplifier(vertices, indices);
+        double error = 0.0;
+        std::vector<uint32_t> result = simplifier.run(targetIndexCount, targetError * simplifier.radius(), error);
+        if (resultError) {
+            *resultError = static_cast<float>(error);
+        }
+        return result;
+    }
+
+    std::vector<LodLevel> buildLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                        unsigned threadCount) {
+        std::vector<LodLevel> levels(1);
+        levels[0].indexCount = static_cast<uint32_t>(indices.size());
+        if (indices.size() < 3) {
+            return levels;
+        }
+
+        // Уровни независимы: каждый упрощается из LOD0, поэтому строятся одновременно
+        struct Level {
+            std::vector<uint32_t> indices;
+            float error = 0.0f;
+        };
+        std::vector<Level> built(MAX_LOD_LEVELS - 1);
+        Parallel::forEach(built.size(), [&](size_t i) {
+            const size_t target = indices.size() >> (i + 1);
+            built[i].indices = simplify(vertices, indices, target, LOD_TARGET_ERROR, &built[i].error);
+            MeshOptimizer::optimizeVertexCache(built[i].indices, vertices.size());
+        }, threadCount);
+
+        size_t previousCount = indices.size();
+        for (Level& level : built) {
+            if (level.indices.empty() || static_cast<double>(level.indices.size()) > NEXT_LEVEL_MIN_SHRINK * previousCount) {
+                break;
+            }
+            LodLevel lod;
+            lod.firstIndex = static_cast<uint32_t>(indices.size());
+            lod.indexCount = static_cast<uint32_t>(level.indices.size());
+            lod.error = std::max(level.error, levels.back().error); // Ошибка не убывает с номером уровня
+            levels.push_back(lod);
+            previousCount = level.indices.size();
+            indices.insert(indices.end(), level.indices.begin(), level.indices.end());
+        }
+        return levels;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Уровень детализации внутри общего индексного буфера
+ */
+struct LodLevel {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f; ///< Геометрическое отклонение от LOD0 в единицах модели
+};
+
+/**
+ * @brief Упрощение сетки стягиванием рёбер по квадрикам ошибки (Garland, Heckbert)
+ *
+ * Вершины не создаются и не сдвигаются: ребро стягивается в одну из своих
+ * вершин, поэтому все уровни детализации ссылаются на исходный вершинный буфер.
+ * Вершины с одинаковой позицией (швы UV и нормалей) стягиваются согласованно
+ * и только вдоль шва; вершины на открытой границе сетки не двигаются.
+ */
+namespace MeshSimplifier {
+    constexpr size_t MAX_LOD_LEVELS = 5;      ///< Включая исходный LOD0
+    constexpr float LOD_TARGET_ERROR = 0.05f; ///< Предел отклонения относительно радиуса сетки
+
+    /**
+     * @brief Упрощает сетку, пока индексов больше targetIndexCount и ошибка не превышает targetError
+     * @param targetError Предел отклонения относительно радиуса описанной сферы сетки
+     * @param resultError Если не nullptr — достигнутое отклонение в единицах модели
+     * @return Индексы упрощённой сетки (в тот же массив вершин)
+     */
+    std::vector<uint32_t> simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                   size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+    /**
+     * @brief Строит до MAX_LOD_LEVELS уровней и дописывает их индексы после исходных
+     *
+     * Каждый уровень упрощается из исходной сетки вдвое сильнее предыдущего, уровни
+     * строятся параллельно. Построение останавливается, когда уровень почти не
+     * меньше предыдущего.
+     *
+     * @param indices На входе — LOD0, на выходе — все уровни подряд
+     * @return Таблица уровней; первый элемент описывает LOD0
+     */
+    std::vector<LodLevel> buildLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                        unsigned threadCount = 0);
+}
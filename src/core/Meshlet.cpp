@@ -0,0 +1,210 @@
+#include "Meshlet.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    constexpr float CONE_DISABLED = 1.0f;
+    constexpr float MIN_CONE_SPREAD = 0.1f; ///< Шире ~84° от оси конус ничего не отсекает
+
+    inline size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Сфера вокруг центра габаритов и конус нормалей одного мешлета
+     */
+    void computeBounds(const Vertex* vertices, const MeshletMesh& mesh, Meshlet& meshlet) {
+        const uint32_t* local = &mesh.vertices[meshlet.vertexOffset];
+
+        glm::vec3 minimum = vertices[local[0]].pos;
+        glm::vec3 maximum = minimum;
+        for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+            minimum = glm::min(minimum, vertices[local[i]].pos);
+            maximum = glm::max(maximum, vertices[local[i]].pos);
+        }
+        const glm::vec3 center = (minimum + maximum) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            const glm::vec3 offset = vertices[local[i]].pos - center;
+            radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+        }
+        meshlet.sphere = glm::vec4(center, std::sqrt(radiusSquared));
+
+        // Ось — средняя нормаль граней, раствор — самая отклонившаяся от неё грань
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 axis(0.0f);
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            const uint8_t* corner = &mesh.triangles[meshlet.triangleOffset + t * 3];
+            const glm::vec3& a = vertices[local[corner[0]]].pos;
+            const glm::vec3& b = vertices[local[corner[1]]].pos;
+            const glm::vec3& c = vertices[local[corner[2]]].pos;
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            const float length = glm::length(normal);
+            if (length <= 0.0f) {
+                continue;
+            }
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+
+        meshlet.cone = glm::vec4(0.0f, 0.0f, 0.0f, CONE_DISABLED);
+        const float axisLength = glm::length(axis);
+        if (normals.empty() || axisLength <= 0.0f) {
+            return;
+        }
+        axis /= axisLength;
+        float minDot = 1.0f;
+        for (const glm::vec3& normal : normals) {
+            minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+        if (minDot <= MIN_CONE_SPREAD) {
+            return;
+        }
+        // Порог — синус половины раствора: мешлет невидим, если камера за конусом,
+        // расширенным на радиус сферы (см. cull())
+        meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - minDot * minDot));
+    }
+
+    bool outsideFrustum(const MeshletBuilder::Frustum& frustum, const glm::vec4& sphere) {
+        for (const glm::vec4& plane : frustum.planes) {
+            if (glm::dot(glm::vec3(plane), glm::vec3(sphere)) + plane.w < -sphere.w) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool backfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition) {
+        if (meshlet.cone.w >= CONE_DISABLED) {
+            return false;
+        }
+        const glm::vec3 toCenter = glm::vec3(meshlet.sphere) - cameraPosition;
+        return glm::dot(toCenter, glm::vec3(meshlet.cone)) >= meshlet.cone.w * glm::length(toCenter) + meshlet.sphere.w;
+    }
+}
+
+size_t MeshletMesh::triangleCount() const {
+    size_t count = 0;
+    for (const Meshlet& meshlet : meshlets) {
+        count += meshlet.triangleCount;
+    }
+    return count;
+}
+
+namespace MeshletBuilder {
+
+    MeshletMesh build(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+        MeshletMesh mesh;
+        if (indexCount < 3) {
+            return mesh;
+        }
+        mesh.meshlets.reserve(indexCount / 3 / MAX_TRIANGLES + 1);
+        mesh.vertices.reserve(indexCount / 3);
+        mesh.triangles.reserve(indexCount + indexCount / 3 / MAX_TRIANGLES * 4);
+
+        // Локальный номер вершины в текущем мешлете; 0xFF — вершины в нём ещё нет
+        std::vector<uint8_t> localIndex(vertexCount, 0xFF);
+        Meshlet current{};
+
+        auto finish = [&]() {
+            if (current.triangleCount == 0) {
+                return;
+            }
+            computeBounds(vertices, mesh, current);
+            for (uint32_t i = 0; i < current.vertexCount; ++i) {
+                localIndex[mesh.vertices[current.vertexOffset + i]] = 0xFF;
+            }
+            mesh.triangles.resize(alignUp(mesh.triangles.size(), 4), 0);
+            mesh.meshlets.push_back(current);
+
+            current = Meshlet{};
+            current.vertexOffset = static_cast<uint32_t>(mesh.vertices.size());
+            current.triangleOffset = static_cast<uint32_t>(mesh.triangles.size());
+        };
+
+        for (size_t t = 0; t + 2 < indexCount; t += 3) {
+            const uint32_t corner[3] = {indices[t], indices[t + 1], indices[t + 2]};
+            if (corner[0] >= vertexCount || corner[1] >= vertexCount || corner[2] >= vertexCount) {
+                throw std::runtime_error("Vertex index out of range in meshlet build");
+            }
+
+            size_t newVertices = 0;
+            for (int k = 0; k < 3; ++k) {
+                const bool repeated = (k > 0 && corner[k] == corner[0]) || (k > 1 && corner[k] == corner[1]);
+                if (localIndex[corner[k]] == 0xFF && !repeated) {
+                    ++newVertices;
+                }
+            }
+            if (current.vertexCount + newVertices > MAX_VERTICES || current.triangleCount + 1 > MAX_TRIANGLES) {
+                finish();
+            }
+
+            for (uint32_t index : corner) {
+                if (localIndex[index] == 0xFF) {
+                    localIndex[index] = static_cast<uint8_t>(current.vertexCount++);
+                    mesh.vertices.push_back(index);
+                }
+                mesh.triangles.push_back(localIndex[index]);
+            }
+            ++current.triangleCount;
+        }
+        finish();
+        return mesh;
+    }
+
+    std::vector<uint8_t> pack(const MeshletMesh& mesh, size_t& vertexBase, size_t& triangleBase) {
+        const size_t meshletBytes = mesh.meshlets.size() * sizeof(Meshlet);
+        vertexBase = alignUp(meshletBytes, 16);
+        triangleBase = alignUp(vertexBase + mesh.vertices.size() * sizeof(uint32_t), 16);
+
+        std::vector<uint8_t> buffer(alignUp(triangleBase + mesh.triangles.size(), 16), 0);
+        if (!mesh.meshlets.empty()) {
+            std::memcpy(buffer.data(), mesh.meshlets.data(), meshletBytes);
+        }
+        if (!mesh.vertices.empty()) {
+            std::memcpy(buffer.data() + vertexBase, mesh.vertices.data(), mesh.vertices.size() * sizeof(uint32_t));
+        }
+        if (!mesh.triangles.empty()) {
+            std::memcpy(buffer.data() + triangleBase, mesh.triangles.data(), mesh.triangles.size());
+        }
+        return buffer;
+    }
+
+    Frustum Frustum::fromMatrix(const glm::mat4& m) {
+        // Строки матрицы (Gribb, Hartmann); GLM хранит матрицу по столбцам
+        auto row = [&m](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+
+        Frustum frustum;
+        frustum.planes[0] = row(3) + row(0); // Левая
+        frustum.planes[1] = row(3) - row(0); // Правая
+        frustum.planes[2] = row(3) + row(1); // Нижняя
+        frustum.planes[3] = row(3) - row(1); // Верхняя
+        frustum.planes[4] = row(2);          // Ближняя: z >= 0
+        frustum.planes[5] = row(3) - row(2); // Дальняя
+        for (glm::vec4& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    size_t cull(const MeshletMesh& mesh, const Frustum& frustum, const glm::vec3& cameraPosition,
+                std::vector<uint32_t>& indices) {
+        indices.clear();
+        size_t visible = 0;
+        for (const Meshlet& meshlet : mesh.meshlets) {
+            if (outsideFrustum(frustum, meshlet.sphere) || backfacing(meshlet, cameraPosition)) {
+                continue;
+            }
+            ++visible;
+            const uint32_t* local = &mesh.vertices[meshlet.vertexOffset];
+            const uint8_t* corner = &mesh.triangles[meshlet.triangleOffset];
+            for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+                indices.push_back(local[corner[i]]);
+            }
+        }
+        return visible;
+    }
+}
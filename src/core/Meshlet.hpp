@@ -0,0 +1,83 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Кластер треугольников с границами для отсечения
+ *
+ * Раскладка совпадает с std430 (48 байт), поэтому массив мешлетов можно
+ * копировать в storage-буфер без преобразований.
+ */
+struct Meshlet {
+    glm::vec4 sphere;        ///< xyz — центр, w — радиус описанной сферы (в пространстве модели)
+    glm::vec4 cone;          ///< xyz — ось конуса нормалей, w — порог отсечения (1 — не отсекать по конусу)
+    uint32_t vertexOffset;   ///< Начало в MeshletMesh::vertices
+    uint32_t triangleOffset; ///< Начало в MeshletMesh::triangles (в байтах, кратно 4)
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+static_assert(sizeof(Meshlet) == 48, "Meshlet must match the std430 layout");
+
+/**
+ * @brief Сетка, разбитая на мешлеты
+ *
+ * Индексы внутри мешлета локальные (байт на угол), глобальный номер вершины
+ * берётся из vertices[vertexOffset + local].
+ */
+struct MeshletMesh {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+
+    size_t triangleCount() const;
+};
+
+/**
+ * @brief Разбиение сетки на мешлеты и их отсечение на CPU
+ */
+namespace MeshletBuilder {
+    constexpr size_t MAX_VERTICES = 64;   ///< Вершин в мешлете (предел выхода mesh-шейдера на одну группу)
+    constexpr size_t MAX_TRIANGLES = 124; ///< Треугольников в мешлете: 124 * 3 = 372 байта, кратно 4
+
+    /**
+     * @brief Нарезает треугольники на мешлеты в порядке индексов
+     *
+     * Мешлет закрывается, когда следующий треугольник не помещается в лимиты.
+     * Локальность мешлетов определяется порядком треугольников, поэтому сетку
+     * стоит сначала пропустить через MeshOptimizer::optimizeVertexCache().
+     */
+    MeshletMesh build(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+
+    /**
+     * @brief Упаковывает мешлеты, их вершины и треугольники в один буфер для загрузки на GPU
+     *
+     * Порядок: массив Meshlet, затем vertices (uint32), затем triangles; каждая часть
+     * начинается с границы 16 байт.
+     * @param vertexBase Смещение массива вершин мешлетов в байтах от начала буфера
+     * @param triangleBase Смещение массива треугольников в байтах от начала буфера
+     */
+    std::vector<uint8_t> pack(const MeshletMesh& mesh, size_t& vertexBase, size_t& triangleBase);
+
+    /**
+     * @brief Плоскости пирамиды видимости в пространстве модели
+     *
+     * Извлекаются из матрицы proj * view * model; нормали смотрят внутрь,
+     * глубина в диапазоне [0, 1] (GLM_FORCE_DEPTH_ZERO_TO_ONE).
+     */
+    struct Frustum {
+        glm::vec4 planes[6];
+
+        static Frustum fromMatrix(const glm::mat4& modelViewProjection);
+    };
+
+    /**
+     * @brief Отсекает мешлеты вне пирамиды видимости и целиком повёрнутые задом к камере
+     * @param cameraPosition Позиция камеры в пространстве модели
+     * @param indices Сюда записываются глобальные индексы видимых треугольников (массив очищается)
+     * @return Число видимых мешлетов
+     */
+    size_t cull(const MeshletMesh& mesh, const Frustum& frustum, const glm::vec3& cameraPosition,
+                std::vector<uint32_t>& indices);
+}
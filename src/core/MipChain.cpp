@@ -0,0 +1,131 @@
+#include "MipChain.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    constexpr uint32_t LINEAR_MAX = 65535;    // Линейная яркость хранится в 16 битах: шаги тоньше шагов sRGB у нуля
+    constexpr uint32_t ROWS_PER_TASK = 16;    // Строк результата на одну задачу потока
+
+    struct SrgbTables {
+        std::array<uint16_t, 256> toLinear;
+        std::array<uint8_t, LINEAR_MAX + 1> toSrgb;
+
+        SrgbTables() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                const double c = i / 255.0;
+                const double linear = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+                toLinear[i] = static_cast<uint16_t>(std::lround(linear * LINEAR_MAX));
+            }
+            for (uint32_t i = 0; i <= LINEAR_MAX; ++i) {
+                const double linear = static_cast<double>(i) / LINEAR_MAX;
+                const double c = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+                toSrgb[i] = static_cast<uint8_t>(std::lround(std::min(std::max(c, 0.0), 1.0) * 255.0));
+            }
+        }
+    };
+
+    const SrgbTables& srgbTables() {
+        static const SrgbTables tables; // Инициализация локальной статической переменной потокобезопасна
+        return tables;
+    }
+
+    /// Исходный диапазон [first, last) для пикселя index результата размера target
+    inline void footprint(uint32_t index, uint32_t source, uint32_t target, uint32_t& first, uint32_t& last) {
+        first = static_cast<uint32_t>(uint64_t{index} * source / target);
+        last = std::max(first + 1, static_cast<uint32_t>(uint64_t{index + 1} * source / target));
+    }
+
+    void downsampleRows(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination,
+                        uint32_t targetWidth, uint32_t targetHeight, uint32_t firstRow, uint32_t lastRow, bool srgb) {
+        const SrgbTables* tables = srgb ? &srgbTables() : nullptr;
+        for (uint32_t y = firstRow; y < lastRow; ++y) {
+            uint32_t y0, y1;
+            footprint(y, height, targetHeight, y0, y1);
+            uint8_t* out = destination + size_t{y} * targetWidth * 4;
+            for (uint32_t x = 0; x < targetWidth; ++x) {
+                uint32_t x0, x1;
+                footprint(x, width, targetWidth, x0, x1);
+                uint32_t sum[4] = {0, 0, 0, 0};
+                for (uint32_t sy = y0; sy < y1; ++sy) {
+                    const uint8_t* row = source + (size_t{sy} * width + x0) * 4;
+                    for (uint32_t sx = x0; sx < x1; ++sx, row += 4) {
+                        if (tables) {
+                            sum[0] += tables->toLinear[row[0]];
+                            sum[1] += tables->toLinear[row[1]];
+                            sum[2] += tables->toLinear[row[2]];
+                        } else {
+                            sum[0] += row[0];
+                            sum[1] += row[1];
+                            sum[2] += row[2];
+                        }
+                        sum[3] += row[3];
+                    }
+                }
+                const uint32_t count = (x1 - x0) * (y1 - y0);
+                for (int c = 0; c < 4; ++c) {
+                    const uint32_t average = (sum[c] + count / 2) / count;
+                    out[x * 4 + c] = (tables && c < 3) ? tables->toSrgb[average] : static_cast<uint8_t>(average);
+                }
+            }
+        }
+    }
+}
+
+namespace MipChain {
+
+    uint32_t levelCount(uint32_t width, uint32_t height) {
+        uint32_t size = std::max(width, height);
+        uint32_t count = 1;
+        while (size > 1) {
+            size >>= 1;
+            ++count;
+        }
+        return count;
+    }
+
+    std::vector<Level> levels(uint32_t width, uint32_t height) {
+        std::vector<Level> result(levelCount(width, height));
+        size_t offset = 0;
+        for (Level& level : result) {
+            level.width = width;
+            level.height = height;
+            level.offset = offset;
+            offset += level.size();
+            width = std::max(1u, width / 2);
+            height = std::max(1u, height / 2);
+        }
+        return result;
+    }
+
+    size_t chainSize(uint32_t width, uint32_t height) {
+        const Level last = levels(width, height).back();
+        return last.offset + last.size();
+    }
+
+    void downsample(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination, bool srgb) {
+        const uint32_t targetWidth = std::max(1u, width / 2);
+        const uint32_t targetHeight = std::max(1u, height / 2);
+        downsampleRows(source, width, height, destination, targetWidth, targetHeight, 0, targetHeight, srgb);
+    }
+
+    void generate(const uint8_t* base, uint32_t width, uint32_t height, uint8_t* tail, bool srgb, unsigned threadCount) {
+        const std::vector<Level> chain = levels(width, height);
+        const size_t tailOffset = chain[0].size();
+        for (size_t i = 1; i < chain.size(); ++i) {
+            const Level& source = chain[i - 1];
+            const Level& target = chain[i];
+            const uint8_t* sourcePixels = i == 1 ? base : tail + (source.offset - tailOffset);
+            uint8_t* targetPixels = tail + (target.offset - tailOffset);
+            // Уровень читает только предыдущий, поэтому параллелятся строки внутри уровня
+            const size_t taskCount = (target.height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+            Parallel::forEach(taskCount, [&](size_t task) {
+                const uint32_t firstRow = static_cast<uint32_t>(task * ROWS_PER_TASK);
+                const uint32_t lastRow = std::min(target.height, firstRow + ROWS_PER_TASK);
+                downsampleRows(sourcePixels, source.width, source.height, targetPixels, target.width, target.height,
+                               firstRow, lastRow, srgb);
+            }, threadCount);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Цепочка мип-уровней RGBA8 изображения
+ *
+ * Уровни плотно уложены друг за другом, начиная с уровня 0; каждый следующий
+ * вдвое меньше по обеим осям (округление вниз, не меньше 1). На GPU цепочка
+ * строится vkCmdBlitImage, а здесь — запасной путь для форматов без
+ * линейной фильтрации при blit.
+ */
+namespace MipChain {
+    struct Level {
+        uint32_t width = 1;
+        uint32_t height = 1;
+        size_t offset = 0; ///< Байты от начала уровня 0
+
+        size_t size() const { return size_t{width} * height * 4; }
+    };
+
+    /// Число уровней до 1x1 включительно: floor(log2(max(width, height))) + 1
+    uint32_t levelCount(uint32_t width, uint32_t height);
+
+    /// Размеры и смещения всех уровней
+    std::vector<Level> levels(uint32_t width, uint32_t height);
+
+    /// Размер всей цепочки в байтах
+    size_t chainSize(uint32_t width, uint32_t height);
+
+    /**
+     * @brief Уменьшает RGBA8 изображение до размеров следующего уровня усреднением
+     *
+     * Каждый пиксель результата — среднее прямоугольника исходных пикселей,
+     * который он покрывает (2x2, у нечётных сторон — 2x3 или 3x3), поэтому
+     * крайние строки и столбцы не теряются. Для sRGB цвет усредняется в
+     * линейном пространстве, альфа — всегда линейно. Вычисления целочисленные:
+     * результат не зависит от числа потоков и компилятора.
+     */
+    void downsample(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination, bool srgb);
+
+    /**
+     * @brief Строит уровни 1..n-1 по уровню 0
+     * @param base Уровень 0 (width x height)
+     * @param tail Буфер на chainSize() - levels()[0].size() байт: уровни с 1-го подряд
+     * @param threadCount 0 — по числу ядер; строки уровня делятся между потоками
+     */
+    void generate(const uint8_t* base, uint32_t width, uint32_t height, uint8_t* tail, bool srgb,
+                  unsigned threadCount = 0);
+}
@@ -0,0 +1,108 @@
+#include "MipResidency.hpp"
+#include <algorithm>
+#include <cmath>
+
+MipResidency::MipResidency(uint64_t budgetBytes, uint64_t uploadBytesPerUpdate)
+    : budget_(budgetBytes), uploadLimit_(uploadBytesPerUpdate) {
+}
+
+uint32_t MipResidency::add(uint32_t width, uint32_t height, const std::vector<uint64_t>& levelBytes) {
+    Texture texture;
+    const uint32_t levelCount = static_cast<uint32_t>(std::max<size_t>(1, levelBytes.size()));
+    texture.suffixBytes.assign(levelCount + 1, 0);
+    for (uint32_t level = static_cast<uint32_t>(levelBytes.size()); level-- > 0;) {
+        texture.suffixBytes[level] = texture.suffixBytes[level + 1] + levelBytes[level];
+    }
+    while (texture.tail + 1 < levelCount &&
+           std::max(width >> texture.tail, height >> texture.tail) > MIN_RESIDENT_EXTENT) {
+        ++texture.tail;
+    }
+    texture.base = texture.tail;
+    resident_ += texture.suffixBytes[texture.base];
+    textures_.push_back(std::move(texture));
+    return static_cast<uint32_t>(textures_.size() - 1);
+}
+
+void MipResidency::request(uint32_t texture, uint32_t level) {
+    Texture& entry = textures_[texture];
+    entry.wanted = std::min(entry.wanted, level);
+    entry.lastUse = frame_;
+}
+
+uint32_t MipResidency::evictionLevel(const Texture& texture) const {
+    // Не нужная в этом кадре текстура сжимается до хвоста, нужная — до заявленного уровня
+    return texture.lastUse == frame_ ? std::min(texture.wanted, texture.tail) : texture.tail;
+}
+
+std::vector<MipResidency::Change> MipResidency::update() {
+    std::vector<Change> changes;
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < textures_.size(); ++i) {
+        if (textures_[i].lastUse == frame_ && textures_[i].wanted < textures_[i].base) {
+            candidates.push_back(i);
+        }
+    }
+    // Сначала самые размытые относительно нужного
+    std::stable_sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        return textures_[a].base - textures_[a].wanted > textures_[b].base - textures_[b].wanted;
+    });
+
+    std::vector<Change> upgrades;
+    uint64_t uploadLeft = uploadLimit_;
+    for (uint32_t index : candidates) {
+        Texture& texture = textures_[index];
+        auto extraBytes = [&](uint32_t level) { return texture.suffixBytes[level] - texture.suffixBytes[texture.base]; };
+        uint32_t target = std::min(texture.wanted, texture.base);
+        while (target < texture.base && extraBytes(target) > uploadLeft) {
+            ++target;
+        }
+        if (target == texture.base && uploadLeft == uploadLimit_) {
+            target = texture.base - 1; // Уровень крупнее предела загружается один за update(), иначе — никогда
+        }
+
+        // Место освобождают сначала давно не нужные текстуры, затем те, что держат лишние детали
+        while (target < texture.base && resident_ + extraBytes(target) > budget_) {
+            Texture* victim = nullptr;
+            uint32_t victimIndex = 0;
+            for (uint32_t i = 0; i < textures_.size(); ++i) {
+                Texture& other = textures_[i];
+                if (i != index && other.base < evictionLevel(other) && (!victim || other.lastUse < victim->lastUse)) {
+                    victim = &other;
+                    victimIndex = i;
+                }
+            }
+            if (!victim) {
+                break;
+            }
+            const uint32_t level = evictionLevel(*victim);
+            resident_ -= victim->suffixBytes[victim->base] - victim->suffixBytes[level];
+            changes.push_back(Change{victimIndex, victim->base, level});
+            victim->base = level;
+        }
+        while (target < texture.base && resident_ + extraBytes(target) > budget_) {
+            ++target;
+        }
+        if (target == texture.base) {
+            continue;
+        }
+        resident_ += extraBytes(target);
+        uploadLeft -= std::min(uploadLeft, extraBytes(target));
+        upgrades.push_back(Change{index, texture.base, target});
+        texture.base = target;
+    }
+    changes.insert(changes.end(), upgrades.begin(), upgrades.end());
+
+    for (Texture& texture : textures_) {
+        texture.wanted = NO_REQUEST;
+    }
+    ++frame_;
+    return changes;
+}
+
+uint32_t MipResidency::levelForFootprint(float texelsPerPixel, uint32_t levelCount) {
+    if (!(texelsPerPixel > 1.0f) || levelCount == 0) {
+        return 0;
+    }
+    const uint32_t level = static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel)));
+    return std::min(level, levelCount - 1);
+}
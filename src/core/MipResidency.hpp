@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Какие мип-уровни текстур держать в видеопамяти при ограниченном бюджете
+ *
+ * Логика без Vulkan: каждый кадр рендер сообщает request(), какой уровень
+ * текстуры нужен на экране, а update() решает, каким текстурам догрузить
+ * уровни и у каких отобрать память. Текстура резидентна от базового уровня
+ * до 1x1 — изображение пересоздаётся с нового базового уровня. Хвост цепочки
+ * (уровни не больше MIN_RESIDENT_EXTENT) загружается сразу и не вытесняется,
+ * поэтому текстура никогда не пропадает, а только становится размытее.
+ *
+ * Если догрузка не помещается в бюджет, вытесняются текстуры, которые дольше
+ * всех не были нужны на экране (LRU), — до хвоста; затем те, что держат больше
+ * деталей, чем нужно сейчас, — до нужного уровня. Если места не хватает и так,
+ * догрузка останавливается на более грубом уровне. Объём загрузки за один
+ * update() ограничен, чтобы подгрузка не вызывала длинных кадров; уровень
+ * крупнее предела загружается в update() один.
+ */
+class MipResidency {
+public:
+    static constexpr uint32_t MIN_RESIDENT_EXTENT = 64; ///< Уровни не больше этого размера резидентны всегда
+    static constexpr uint32_t NO_REQUEST = UINT32_MAX;
+
+    /// Новый базовый уровень текстуры
+    struct Change {
+        uint32_t texture = 0;
+        uint32_t previousBase = 0;
+        uint32_t base = 0;
+    };
+
+    /**
+     * @param budgetBytes Предел суммарного размера резидентных уровней
+     * @param uploadBytesPerUpdate Сколько байт новых уровней можно загрузить за один update()
+     */
+    MipResidency(uint64_t budgetBytes, uint64_t uploadBytesPerUpdate);
+
+    /**
+     * @brief Регистрирует текстуру; сразу резидентен только хвост цепочки
+     * @param levelBytes Размер каждого уровня, от 0 до 1x1
+     * @return Номер текстуры (по порядку добавления)
+     */
+    uint32_t add(uint32_t width, uint32_t height, const std::vector<uint64_t>& levelBytes);
+
+    /// Заявка текущего кадра: на экране нужен уровень level (меньше — детальнее)
+    void request(uint32_t texture, uint32_t level);
+
+    /**
+     * @brief Применяет заявки кадра и начинает следующий кадр
+     * @return Текстуры, у которых сменился базовый уровень; вытеснения идут раньше догрузок
+     */
+    std::vector<Change> update();
+
+    uint32_t baseLevel(uint32_t texture) const { return textures_[texture].base; }
+    /// Первый уровень хвоста, который резидентен всегда
+    uint32_t tailLevel(uint32_t texture) const { return textures_[texture].tail; }
+    size_t textureCount() const { return textures_.size(); }
+    uint64_t residentBytes() const { return resident_; }
+    uint64_t budgetBytes() const { return budget_; }
+
+    /**
+     * @brief Уровень, на котором один тексель приходится примерно на один пиксель экрана
+     * @param texelsPerPixel Сколько текселей уровня 0 приходится на пиксель вдоль стороны
+     */
+    static uint32_t levelForFootprint(float texelsPerPixel, uint32_t levelCount);
+
+private:
+    struct Texture {
+        std::vector<uint64_t> suffixBytes; ///< suffixBytes[l] — размер уровней l..n-1
+        uint32_t base = 0;
+        uint32_t tail = 0;
+        uint32_t wanted = NO_REQUEST;      ///< Самый детальный уровень из заявок кадра
+        uint64_t lastUse = 0;              ///< Кадр последней заявки; 0 — ещё не было
+    };
+
+    /// До какого уровня можно вытеснить текстуру: нужного ей в этом кадре или до хвоста
+    uint32_t evictionLevel(const Texture& texture) const;
+
+    std::vector<Texture> textures_;
+    uint64_t budget_;
+    uint64_t uploadLimit_;
+    uint64_t resident_ = 0;
+    uint64_t frame_ = 1;
+};
@@ -0,0 +1,337 @@
+#include "ObjParser.hpp"
+#include "MappedFile.hpp"
+#include "Material.hpp"
+#include "ObjSyntax.hpp"
+#include "Parallel.hpp"
+#include "VertexWelder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+    constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;             // Меньшие участки не окупают запуск потока
+    constexpr size_t CHUNKS_PER_THREAD = 4;                   // Запас для балансировки неравных участков
+    constexpr size_t PARALLEL_WELD_MIN_CORNERS = 256 * 1024; // Меньшие сетки выгоднее склеивать одним потоком
+
+    using ObjSyntax::Corner;
+    using ObjSyntax::AttributeKind;
+    using ObjSyntax::ATTRIBUTE_KINDS;
+    using ObjSyntax::ATTRIBUTE_WIDTH;
+    using ObjSyntax::POSITION;
+    using ObjSyntax::TEXCOORD;
+    using ObjSyntax::NORMAL;
+
+    /**
+     * @brief Результат разбора одного участка файла
+     *
+     * Отрицательные (относительные) индексы можно разрешить только зная,
+     * сколько атрибутов было в предыдущих участках, поэтому такие углы
+     * запоминаются в relativeCorners и исправляются после склейки.
+     */
+    struct ObjChunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+
+        std::vector<float> attributes[ATTRIBUTE_KINDS];
+        std::vector<Corner> corners;
+        std::vector<uint32_t> faceSizes;
+        std::vector<uint32_t> relativeCorners[ATTRIBUTE_KINDS];
+
+        size_t attributeBase[ATTRIBUTE_KINDS] = {}; // Смещение (в элементах) в общих массивах
+        std::vector<Corner> triangles;              // Углы после триангуляции, по 3 на треугольник
+
+        // Материал, действующий на участке, известен только после просмотра предыдущих участков
+        std::vector<std::pair<uint32_t, std::string>> materialSwitches; // (номер грани участка, имя из usemtl)
+        std::vector<std::string> libraries;                             // Имена файлов из mtllib
+        std::vector<std::pair<uint32_t, uint32_t>> materialRuns;        // (первая грань, номер материала)
+        std::vector<uint32_t> triangleMaterials;                        // Материал каждого треугольника
+    };
+
+    void parseChunk(ObjChunk& chunk) {
+        using ObjSyntax::LineType;
+
+        auto parseAttribute = [&](const char*& p, const char* lineEnd, AttributeKind kind) {
+            auto& values = chunk.attributes[kind];
+            for (size_t i = 0; i < ATTRIBUTE_WIDTH[kind]; ++i) {
+                values.push_back(ObjSyntax::parseReal(p, lineEnd));
+            }
+        };
+
+        const char* p = chunk.begin;
+        while (p < chunk.end) {
+            const char* lineEnd = nullptr;
+            const char* next = ObjSyntax::nextLine(p, chunk.end, lineEnd);
+
+            switch (ObjSyntax::classify(p, lineEnd)) {
+            case LineType::POSITION_LINE:
+                parseAttribute(p, lineEnd, POSITION);
+                break;
+            case LineType::TEXCOORD_LINE:
+                parseAttribute(p, lineEnd, TEXCOORD);
+                break;
+            case LineType::NORMAL_LINE:
+                parseAttribute(p, lineEnd, NORMAL);
+                break;
+            case LineType::FACE_LINE: {
+                // Отрицательные индексы пока считаются от начала участка, базу добавим после склейки
+                size_t localCounts[ATTRIBUTE_KINDS];
+                for (int kind = 0; kind < ATTRIBUTE_KINDS; ++kind) {
+                    localCounts[kind] = chunk.attributes[kind].size() / ATTRIBUTE_WIDTH[kind];
+                }
+                const size_t faceSize = ObjSyntax::parseFace(p, lineEnd, localCounts, chunk.corners, chunk.relativeCorners);
+                chunk.faceSizes.push_back(static_cast<uint32_t>(faceSize));
+                break;
+            }
+            case LineType::USEMTL_LINE:
+                chunk.materialSwitches.emplace_back(static_cast<uint32_t>(chunk.faceSizes.size()),
+                                                    ObjSyntax::argument(p, lineEnd));
+                break;
+            case LineType::MTLLIB_LINE:
+                // Несколько файлов через пробел, как в tinyobj
+                while (p < lineEnd) {
+                    while (p < lineEnd && (*p == ' ' || *p == '\t')) {
+                        ++p;
+                    }
+                    const char* nameEnd = p;
+                    while (nameEnd < lineEnd && *nameEnd != ' ' && *nameEnd != '\t') {
+                        ++nameEnd;
+                    }
+                    if (nameEnd > p) {
+                        chunk.libraries.emplace_back(p, nameEnd);
+                    }
+                    p = nameEnd;
+                }
+                break;
+            case LineType::OTHER_LINE:
+                break; // На геометрию не влияют
+            }
+
+            p = next;
+        }
+    }
+
+    /**
+     * @brief Последовательно проходит usemtl всех участков и нумерует материалы в порядке первого использования
+     *
+     * Номер получают только материалы, у которых есть хотя бы одна грань; грани до
+     * первого usemtl относятся к материалу с пустым именем.
+     */
+    void resolveMaterialRuns(std::vector<ObjChunk>& chunks, const std::string& objPath, MeshMaterials& materials) {
+        std::unordered_map<std::string, uint32_t> ids;
+        auto materialId = [&](const std::string& name) {
+            const auto inserted = ids.emplace(name, static_cast<uint32_t>(materials.materialNames.size()));
+            if (inserted.second) {
+                materials.materialNames.push_back(name);
+            }
+            return inserted.first->second;
+        };
+
+        const std::filesystem::path directory = std::filesystem::path(objPath).parent_path();
+        std::string current; // До первого usemtl — пустое имя
+        for (ObjChunk& chunk : chunks) {
+            for (const std::string& library : chunk.libraries) {
+                const std::string path = (directory / library).generic_string();
+                if (std::find(materials.libraries.begin(), materials.libraries.end(), path) == materials.libraries.end()) {
+                    materials.libraries.push_back(path);
+                }
+            }
+
+            const uint32_t faceCount = static_cast<uint32_t>(chunk.faceSizes.size());
+            uint32_t runStart = 0;
+            auto closeRun = [&](uint32_t runEnd) {
+                if (runEnd > runStart) {
+                    chunk.materialRuns.emplace_back(runStart, materialId(current));
+                }
+                runStart = runEnd;
+            };
+            for (const auto& materialSwitch : chunk.materialSwitches) {
+                closeRun(materialSwitch.first);
+                current = materialSwitch.second;
+            }
+            closeRun(faceCount);
+            chunk.materialSwitches = {};
+            chunk.libraries = {};
+        }
+    }
+
+    /**
+     * @brief Режет файл на участки, каждый из которых заканчивается на '\n'
+     */
+    std::vector<ObjChunk> splitIntoChunks(const char* data, size_t size, size_t chunkCount) {
+        std::vector<ObjChunk> chunks;
+        const char* end = data + size;
+        const char* begin = data;
+        for (size_t i = 1; i <= chunkCount && begin < end; ++i) {
+            const char* chunkEnd = (i == chunkCount) ? end : data + size * i / chunkCount;
+            if (chunkEnd < begin) {
+                chunkEnd = begin;
+            }
+            const char* newline = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline ? newline + 1 : end;
+
+            ObjChunk chunk;
+            chunk.begin = begin;
+            chunk.end = chunkEnd;
+            chunks.push_back(std::move(chunk));
+            begin = chunkEnd;
+        }
+        return chunks;
+    }
+}
+
+double ObjParser::Stats::megabytesPerSecond() const {
+    if (parseSeconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(fileSize) / (1024.0 * 1024.0) / parseSeconds;
+}
+
+ObjParser::ObjParser(unsigned threadCount, float weldEpsilon)
+    : threadCount_(Parallel::workerCount(threadCount)), weldEpsilon_(weldEpsilon) {}
+
+void ObjParser::load(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+
+    MappedFile file(path);
+    stats_ = Stats{};
+    stats_.fileSize = file.size();
+    stats_.threadCount = threadCount_;
+
+    const size_t chunkCount = std::max<size_t>(1,
+        std::min(threadCount_ * CHUNKS_PER_THREAD, file.size() / MIN_CHUNK_SIZE));
+    std::vector<ObjChunk> chunks = splitIntoChunks(file.data(), file.size(), chunkCount);
+    stats_.chunkCount = chunks.size();
+
+    // 1. Токенизация участков
+    Parallel::forEach(chunks.size(), [&](size_t i) { parseChunk(chunks[i]); }, threadCount_);
+
+    // 2. Префиксные суммы: где каждый участок лежит в общих массивах атрибутов
+    size_t totals[ATTRIBUTE_KINDS] = {};
+    for (auto& chunk : chunks) {
+        for (int kind = 0; kind < ATTRIBUTE_KINDS; ++kind) {
+            chunk.attributeBase[kind] = totals[kind] / ATTRIBUTE_WIDTH[kind];
+            totals[kind] += chunk.attributes[kind].size();
+        }
+    }
+
+    std::vector<float> attributes[ATTRIBUTE_KINDS];
+    for (int kind = 0; kind < ATTRIBUTE_KINDS; ++kind) {
+        attributes[kind].resize(totals[kind]);
+    }
+
+    Parallel::forEach(chunks.size(), [&](size_t i) {
+        ObjChunk& chunk = chunks[i];
+        for (int kind = 0; kind < ATTRIBUTE_KINDS; ++kind) {
+            std::copy(chunk.attributes[kind].begin(), chunk.attributes[kind].end(),
+                      attributes[kind].begin() + chunk.attributeBase[kind] * ATTRIBUTE_WIDTH[kind]);
+            std::vector<float>().swap(chunk.attributes[kind]);
+        }
+
+        // Относительные индексы теперь можно перевести в абсолютные
+        for (uint32_t cornerIndex : chunk.relativeCorners[POSITION]) {
+            chunk.corners[cornerIndex].v += static_cast<int32_t>(chunk.attributeBase[POSITION]);
+        }
+        for (uint32_t cornerIndex : chunk.relativeCorners[TEXCOORD]) {
+            chunk.corners[cornerIndex].vt += static_cast<int32_t>(chunk.attributeBase[TEXCOORD]);
+        }
+        for (uint32_t cornerIndex : chunk.relativeCorners[NORMAL]) {
+            chunk.corners[cornerIndex].vn += static_cast<int32_t>(chunk.attributeBase[NORMAL]);
+        }
+    }, threadCount_);
+    stats_.parseSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    for (const auto& chunk : chunks) {
+        for (const auto& corner : chunk.corners) {
+            if (corner.v < 0) {
+                throw std::runtime_error("Invalid relative vertex index in " + path);
+            }
+        }
+    }
+
+    // 3. Материалы граней (последовательно: usemtl действует и на следующие участки) и триангуляция
+    materials_ = MeshMaterials{};
+    resolveMaterialRuns(chunks, path, materials_);
+    const bool multiMaterial = materials_.materialNames.size() > 1;
+
+    const std::vector<float>& positions = attributes[POSITION];
+    const std::vector<float>& texcoords = attributes[TEXCOORD];
+    Parallel::forEach(chunks.size(), [&](size_t i) {
+        ObjChunk& chunk = chunks[i];
+        chunk.triangles.reserve(chunk.corners.size());
+        size_t offset = 0;
+        size_t run = 0;
+        for (uint32_t face = 0; face < chunk.faceSizes.size(); ++face) {
+            const size_t before = chunk.triangles.size();
+            ObjSyntax::triangulate(chunk.corners.data() + offset, chunk.faceSizes[face], positions, chunk.triangles);
+            offset += chunk.faceSizes[face];
+
+            if (multiMaterial) {
+                while (run + 1 < chunk.materialRuns.size() && chunk.materialRuns[run + 1].first <= face) {
+                    ++run;
+                }
+                chunk.triangleMaterials.insert(chunk.triangleMaterials.end(), (chunk.triangles.size() - before) / 3,
+                                               chunk.materialRuns[run].second);
+            }
+        }
+        std::vector<Corner>().swap(chunk.corners);
+    }, threadCount_);
+
+    // 4. Устранение дубликатов в порядке файла и запись в итоговые массивы
+    std::vector<size_t> chunkCornerBase(chunks.size() + 1, 0);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunkCornerBase[i + 1] = chunkCornerBase[i] + chunks[i].triangles.size();
+    }
+    const size_t cornerTotal = chunkCornerBase[chunks.size()];
+    const size_t indexBase = indices.size();
+    const size_t positionCount = positions.size() / 3;
+    const size_t texcoordCount = texcoords.size() / 2;
+
+    auto makeVertex = [&](const Corner& corner) {
+        return ObjSyntax::makeVertex(corner, positions, texcoords);
+    };
+
+    if (threadCount_ > 1 && cornerTotal >= PARALLEL_WELD_MIN_CORNERS) {
+        // Большая сетка: склейка по шардам на всех потоках, результат тот же, что и последовательно
+        std::vector<Vertex> cornerVertices(cornerTotal);
+        Parallel::forEach(chunks.size(), [&](size_t i) {
+            Vertex* out = cornerVertices.data() + chunkCornerBase[i];
+            for (const auto& corner : chunks[i].triangles) {
+                *out++ = makeVertex(corner);
+            }
+            std::vector<Corner>().swap(chunks[i].triangles);
+        }, threadCount_);
+
+        VertexWelder::weldAll(cornerVertices, vertices, indices, weldEpsilon_, threadCount_);
+    } else {
+        // Уникальных вершин обычно не меньше, чем позиций или UV в файле
+        VertexWelder welder(vertices, std::min(cornerTotal, std::max(positionCount, texcoordCount)), weldEpsilon_);
+        indices.reserve(indices.size() + cornerTotal);
+        for (const auto& chunk : chunks) {
+            for (const auto& corner : chunk.triangles) {
+                indices.push_back(welder.weld(makeVertex(corner)));
+            }
+        }
+    }
+
+    // 5. Треугольники одного материала — в один непрерывный диапазон
+    if (multiMaterial) {
+        std::vector<uint32_t> triangleMaterials;
+        triangleMaterials.reserve(cornerTotal / 3);
+        for (const auto& chunk : chunks) {
+            triangleMaterials.insert(triangleMaterials.end(), chunk.triangleMaterials.begin(), chunk.triangleMaterials.end());
+        }
+        materials_.submeshes = MaterialLibrary::groupByMaterial(indices, indexBase, triangleMaterials,
+                                                                materials_.materialNames.size());
+    } else if (cornerTotal > 0) {
+        materials_.submeshes = {Submesh{static_cast<uint32_t>(indexBase), static_cast<uint32_t>(cornerTotal), 0}};
+    }
+
+    stats_.totalSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Material.hpp"
+#include "Vertex.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Многопоточный загрузчик Wavefront OBJ
+ *
+ * Файл отображается в память и режется на участки по границам строк.
+ * Каждый участок токенизируется на своём потоке, после чего атрибуты
+ * склеиваются по префиксным суммам, а грани триангулируются и
+ * записываются сразу в итоговые массивы вершин и индексов.
+ *
+ * Разбор чисел и триангуляция повторяют tinyobj бит в бит, поэтому
+ * результат совпадает с прежним путём через tinyobj::LoadObj.
+ *
+ * Если в файле больше одного материала (usemtl), треугольники после склейки
+ * группируются по материалам в непрерывные диапазоны индексов; внутри материала
+ * порядок файла сохраняется.
+ */
+class ObjParser {
+public:
+    struct Stats {
+        size_t fileSize = 0;       ///< Размер файла в байтах
+        unsigned threadCount = 0;  ///< Сколько потоков разбирало файл
+        size_t chunkCount = 0;     ///< На сколько участков разрезан файл
+        double parseSeconds = 0.0; ///< Токенизация и разбор чисел
+        double totalSeconds = 0.0; ///< Весь load(), включая устранение дубликатов
+
+        double megabytesPerSecond() const;
+    };
+
+    /**
+     * @param threadCount Число потоков; 0 — по числу ядер
+     * @param weldEpsilon Шаг сетки для склейки вершин по позиции (см. VertexWelder); 0 — точное сравнение
+     */
+    explicit ObjParser(unsigned threadCount = 0, float weldEpsilon = 0.0f);
+
+    /**
+     * @brief Загружает OBJ и дописывает результат в vertices/indices
+     * @throws std::runtime_error при ошибке открытия или разбора файла
+     */
+    void load(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    const Stats& getStats() const { return stats_; }
+    /// Диапазоны по материалам, имена материалов и библиотеки mtllib последнего load()
+    const MeshMaterials& getMaterials() const { return materials_; }
+
+private:
+    unsigned threadCount_;
+    float weldEpsilon_;
+    Stats stats_;
+    MeshMaterials materials_;
+};
@@ -0,0 +1,198 @@
+#include "ObjStreamReader.hpp"
+#include "ObjSyntax.hpp"
+#include "ProcessMemory.hpp"
+#include "VertexWelder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+    constexpr size_t MIN_WINDOW_SIZE = 4096;
+    constexpr size_t INDICES_PER_VERTEX = 8; // Запас: в замкнутой сетке на вершину приходится около 6 углов
+
+    template <typename T>
+    size_t capacityBytes(const std::vector<T>& values) {
+        return values.capacity() * sizeof(T);
+    }
+}
+
+double ObjStreamReader::Stats::megabytesPerSecond() const {
+    if (seconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(bytesRead) / (1024.0 * 1024.0) / seconds;
+}
+
+ObjStreamReader::ObjStreamReader(const Settings& settings) : settings_(settings) {
+    settings_.windowSize = std::max(settings_.windowSize, MIN_WINDOW_SIZE);
+    settings_.batchVertices = std::max<size_t>(settings_.batchVertices, 3);
+}
+
+void ObjStreamReader::read(const std::string& path, MeshSink& sink) {
+    using Clock = std::chrono::steady_clock;
+    using ObjSyntax::LineType;
+    const auto startTime = Clock::now();
+    stats_ = Stats{};
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    std::vector<char> window(settings_.windowSize);
+    std::vector<float> positions;
+    std::vector<float> texcoords;
+    size_t counts[ObjSyntax::ATTRIBUTE_KINDS] = {};
+
+    std::vector<ObjSyntax::Corner> face;
+    std::vector<ObjSyntax::Corner> triangles;
+    std::vector<Vertex> batchVertices;
+    std::vector<uint32_t> batchIndices;
+    std::optional<VertexWelder> welder;
+    size_t vertexBase = 0;
+
+    auto trackedBytes = [&]() {
+        return capacityBytes(window) + capacityBytes(positions) + capacityBytes(texcoords) +
+               capacityBytes(face) + capacityBytes(triangles) +
+               capacityBytes(batchVertices) + capacityBytes(batchIndices) +
+               (welder ? welder->memoryBytes() : 0);
+    };
+
+    auto flush = [&]() {
+        if (!batchIndices.empty()) {
+            sink.consume(batchVertices, batchIndices);
+            vertexBase += batchVertices.size();
+            stats_.vertexCount += batchVertices.size();
+            stats_.indexCount += batchIndices.size();
+            ++stats_.batchCount;
+        }
+        batchVertices.clear();
+        batchIndices.clear();
+        welder.reset();
+    };
+
+    auto checkMemory = [&]() {
+        size_t tracked = trackedBytes();
+        if (tracked > settings_.memoryLimit && !batchIndices.empty()) {
+            flush(); // Сначала освобождаем порцию, потом проверяем снова
+            batchVertices.shrink_to_fit();
+            batchIndices.shrink_to_fit();
+            tracked = trackedBytes();
+        }
+        stats_.peakTrackedBytes = std::max(stats_.peakTrackedBytes, tracked);
+        if (tracked > settings_.memoryLimit) {
+            throw std::runtime_error("OBJ streaming needs " + std::to_string(tracked >> 20) +
+                                     " MB, more than the memory limit of " +
+                                     std::to_string(settings_.memoryLimit >> 20) + " MB: " + path);
+        }
+    };
+
+    auto processFace = [&](const char* p, const char* lineEnd) {
+        face.clear();
+        ObjSyntax::parseFace(p, lineEnd, counts, face, nullptr);
+        for (const auto& corner : face) {
+            if (static_cast<size_t>(corner.v) >= counts[ObjSyntax::POSITION]) {
+                throw std::runtime_error("Face references a vertex declared later in the file, "
+                                         "which streaming mode does not support: " + path);
+            }
+        }
+
+        triangles.clear();
+        ObjSyntax::triangulate(face.data(), face.size(), positions, triangles);
+
+        // Треугольник целиком попадает в одну порцию
+        if (batchVertices.size() + triangles.size() > settings_.batchVertices ||
+            batchIndices.size() + triangles.size() > settings_.batchVertices * INDICES_PER_VERTEX) {
+            flush();
+        }
+        if (!welder) {
+            welder.emplace(batchVertices, std::min<size_t>(settings_.batchVertices, 1u << 16), settings_.weldEpsilon);
+        }
+        for (const auto& corner : triangles) {
+            const uint32_t local = welder->weld(ObjSyntax::makeVertex(corner, positions, texcoords));
+            if (vertexBase + local >= UINT32_MAX) {
+                throw std::runtime_error("Too many vertices for 32-bit indices: " + path);
+            }
+            batchIndices.push_back(static_cast<uint32_t>(vertexBase + local));
+        }
+    };
+
+    auto processLines = [&](const char* p, const char* end) {
+        while (p < end) {
+            const char* lineEnd = nullptr;
+            const char* next = ObjSyntax::nextLine(p, end, lineEnd);
+
+            switch (ObjSyntax::classify(p, lineEnd)) {
+            case LineType::POSITION_LINE:
+                for (int i = 0; i < 3; ++i) {
+                    positions.push_back(ObjSyntax::parseReal(p, lineEnd));
+                }
+                ++counts[ObjSyntax::POSITION];
+                break;
+            case LineType::TEXCOORD_LINE:
+                for (int i = 0; i < 2; ++i) {
+                    texcoords.push_back(ObjSyntax::parseReal(p, lineEnd));
+                }
+                ++counts[ObjSyntax::TEXCOORD];
+                break;
+            case LineType::NORMAL_LINE:
+                ++counts[ObjSyntax::NORMAL]; // Только для разрешения относительных индексов
+                break;
+            case LineType::FACE_LINE:
+                processFace(p, lineEnd);
+                break;
+            case LineType::USEMTL_LINE:
+            case LineType::MTLLIB_LINE:
+            case LineType::OTHER_LINE:
+                break; // Материалы при потоковой загрузке не поддерживаются
+            }
+
+            p = next;
+        }
+    };
+
+    size_t carried = 0; // Недочитанная строка из предыдущего окна
+    while (true) {
+        file.read(window.data() + carried, static_cast<std::streamsize>(window.size() - carried));
+        const size_t got = static_cast<size_t>(file.gcount());
+        stats_.bytesRead += got;
+        const bool endOfFile = got < window.size() - carried;
+        if (!endOfFile && file.bad()) {
+            throw std::runtime_error("Failed to read file: " + path);
+        }
+
+        const char* begin = window.data();
+        const char* end = begin + carried + got;
+        const char* parseEnd = end;
+        if (!endOfFile) {
+            // Разбираем только целые строки, хвост переносим в следующее окно
+            const char* lastNewline = end;
+            while (lastNewline > begin && lastNewline[-1] != '\n') {
+                --lastNewline;
+            }
+            if (lastNewline == begin) {
+                window.resize(window.size() * 2); // Строка длиннее окна
+                carried += got;
+                checkMemory();
+                continue;
+            }
+            parseEnd = lastNewline;
+        }
+
+        processLines(begin, parseEnd);
+        checkMemory();
+
+        if (endOfFile) {
+            break;
+        }
+        carried = static_cast<size_t>(end - parseEnd);
+        std::memmove(window.data(), parseEnd, carried);
+    }
+
+    flush();
+    stats_.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+    stats_.peakResidentBytes = ProcessMemory::peakResidentBytes();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Получатель геометрии от ObjStreamReader
+ */
+class MeshSink {
+public:
+    virtual ~MeshSink() = default;
+
+    /**
+     * @brief Принимает очередную порцию вершин и индексов
+     *
+     * Индексы глобальные: вершины всех порций нумеруются подряд, поэтому
+     * порции можно просто дописывать в конец общих буферов.
+     */
+    virtual void consume(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) = 0;
+};
+
+/**
+ * @brief Потоковое чтение OBJ с ограничением памяти
+ *
+ * Файл читается окнами фиксированного размера, грани триангулируются и
+ * склеиваются сразу, а готовые вершины и индексы отдаются в MeshSink
+ * порциями. В памяти постоянно находятся только окно, текущая порция с
+ * таблицей склейки и массивы позиций и UV (на них могут ссылаться любые
+ * последующие грани); нормали только подсчитываются, т.к. Vertex их не
+ * заполняет.
+ *
+ * Отличия от ObjParser: дубликаты устраняются в пределах порции, поэтому
+ * вершины на границах порций могут повторяться; грани должны ссылаться
+ * только на уже объявленные вершины (так устроены практически все файлы).
+ */
+class ObjStreamReader {
+public:
+    struct Settings {
+        size_t windowSize = 16u << 20;          ///< Размер окна чтения в байтах
+        size_t memoryLimit = 1024u << 20;       ///< Потолок учитываемой памяти в байтах
+        size_t batchVertices = 1u << 20;        ///< Максимум уникальных вершин в порции
+        float weldEpsilon = 0.0f;               ///< См. VertexWelder
+    };
+
+    struct Stats {
+        size_t bytesRead = 0;
+        size_t batchCount = 0;
+        size_t vertexCount = 0;        ///< Сколько вершин отдано в MeshSink
+        size_t indexCount = 0;
+        size_t peakTrackedBytes = 0;   ///< Пик памяти, учитываемой потолком
+        size_t peakResidentBytes = 0;  ///< Пиковый RSS всего процесса после чтения
+        double seconds = 0.0;
+
+        double megabytesPerSecond() const;
+    };
+
+    explicit ObjStreamReader(const Settings& settings);
+
+    /**
+     * @throws std::runtime_error при ошибке чтения или разбора, а также если
+     *         массивы позиций и UV сами по себе не помещаются в memoryLimit
+     */
+    void read(const std::string& path, MeshSink& sink);
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    Settings settings_;
+    Stats stats_;
+};
@@ -0,0 +1,444 @@
+#include "ObjSyntax.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    inline bool isTokenEnd(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    inline const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    /**
+     * @brief Копия tryParseDouble из tinyobj
+     *
+     * Алгоритм не даёт корректного округления, но именно он определяет
+     * результат старого пути, поэтому повторяем его операция в операцию.
+     */
+    bool tryParseDouble(const char* s, const char* sEnd, double* result) {
+        if (s >= sEnd) {
+            return false;
+        }
+
+        double mantissa = 0.0;
+        int exponent = 0;
+        char sign = '+';
+        char expSign = '+';
+        const char* curr = s;
+        int read = 0;
+        bool endNotReached = false;
+        bool leadingDecimalDots = false;
+
+        if (*curr == '+' || *curr == '-') {
+            sign = *curr;
+            curr++;
+            if (curr != sEnd && *curr == '.') {
+                leadingDecimalDots = true;
+            }
+        } else if (isDigit(*curr)) {
+        } else if (*curr == '.') {
+            leadingDecimalDots = true;
+        } else {
+            return false;
+        }
+
+        endNotReached = (curr != sEnd);
+        if (!leadingDecimalDots) {
+            while (endNotReached && isDigit(*curr)) {
+                mantissa *= 10;
+                mantissa += static_cast<int>(*curr - 0x30);
+                curr++;
+                read++;
+                endNotReached = (curr != sEnd);
+            }
+            if (read == 0) {
+                return false;
+            }
+        }
+
+        if (endNotReached) {
+            if (*curr == '.') {
+                curr++;
+                read = 1;
+                endNotReached = (curr != sEnd);
+                while (endNotReached && isDigit(*curr)) {
+                    static const double powLut[] = {
+                        1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001,
+                    };
+                    const int lutEntries = sizeof powLut / sizeof powLut[0];
+                    mantissa += static_cast<int>(*curr - 0x30) *
+                                (read < lutEntries ? powLut[read] : std::pow(10.0, -read));
+                    read++;
+                    curr++;
+                    endNotReached = (curr != sEnd);
+                }
+            }
+
+            if (endNotReached && (*curr == 'e' || *curr == 'E')) {
+                curr++;
+                endNotReached = (curr != sEnd);
+                if (endNotReached && (*curr == '+' || *curr == '-')) {
+                    expSign = *curr;
+                    curr++;
+                } else if (endNotReached && isDigit(*curr)) {
+                } else {
+                    return false; // Пустая экспонента недопустима
+                }
+
+                read = 0;
+                endNotReached = (curr != sEnd);
+                while (endNotReached && isDigit(*curr)) {
+                    if (exponent > (2147483647 / 10)) {
+                        return false;
+                    }
+                    exponent *= 10;
+                    exponent += static_cast<int>(*curr - 0x30);
+                    curr++;
+                    read++;
+                    endNotReached = (curr != sEnd);
+                }
+                exponent *= (expSign == '+' ? 1 : -1);
+                if (read == 0) {
+                    return false;
+                }
+            }
+        }
+
+        *result = (sign == '+' ? 1 : -1) *
+                  (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+        return true;
+    }
+
+    // atoi() без выхода за конец строки
+    inline int parseInt(const char*& p, const char* end) {
+        const char* s = skipSpaces(p, end);
+        bool negative = false;
+        if (s < end && (*s == '+' || *s == '-')) {
+            negative = (*s == '-');
+            ++s;
+        }
+        long long value = 0;
+        while (s < end && isDigit(*s)) {
+            value = value * 10 + (*s - '0');
+            if (value > std::numeric_limits<int>::max()) {
+                value = std::numeric_limits<int>::max();
+            }
+            ++s;
+        }
+        return static_cast<int>(negative ? -value : value);
+    }
+
+    inline const char* skipIndexToken(const char* p, const char* end) {
+        while (p < end && *p != '/' && !isTokenEnd(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    template <typename T>
+    int pointInTriangle(const T* vertx, const T* verty, T testx, T testy) {
+        int c = 0;
+        for (int i = 0, j = 2; i < 3; j = i++) {
+            if (((verty[i] > testy) != (verty[j] > testy)) &&
+                (testx < (vertx[j] - vertx[i]) * (testy - verty[i]) / (verty[j] - verty[i]) + vertx[i])) {
+                c = !c;
+            }
+        }
+        return c;
+    }
+
+}
+
+namespace ObjSyntax {
+    float parseReal(const char*& p, const char* end, double defaultValue) {
+        p = skipSpaces(p, end);
+        const char* tokenEnd = p;
+        while (tokenEnd < end && !isTokenEnd(*tokenEnd)) {
+            ++tokenEnd;
+        }
+        double value = defaultValue;
+        tryParseDouble(p, tokenEnd, &value);
+        p = tokenEnd;
+        return static_cast<float>(value);
+    }
+
+    const char* nextLine(const char* p, const char* end, const char*& lineEnd) {
+        lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+        if (lineEnd > p && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        return next;
+    }
+
+    LineType classify(const char*& p, const char* lineEnd) {
+        const char* token = skipSpaces(p, lineEnd);
+        const size_t length = lineEnd - token;
+
+        if (length >= 2 && token[0] == 'v' && isSpace(token[1])) {
+            p = token + 2;
+            return LineType::POSITION_LINE;
+        }
+        if (length >= 3 && token[0] == 'v' && token[1] == 't' && isSpace(token[2])) {
+            p = token + 3;
+            return LineType::TEXCOORD_LINE;
+        }
+        if (length >= 3 && token[0] == 'v' && token[1] == 'n' && isSpace(token[2])) {
+            p = token + 3;
+            return LineType::NORMAL_LINE;
+        }
+        if (length >= 2 && token[0] == 'f' && isSpace(token[1])) {
+            p = token + 2;
+            return LineType::FACE_LINE;
+        }
+        if (length >= 7 && std::memcmp(token, "usemtl", 6) == 0 && isSpace(token[6])) {
+            p = token + 7;
+            return LineType::USEMTL_LINE;
+        }
+        if (length >= 7 && std::memcmp(token, "mtllib", 6) == 0 && isSpace(token[6])) {
+            p = token + 7;
+            return LineType::MTLLIB_LINE;
+        }
+        p = token;
+        return LineType::OTHER_LINE; // o, g, s, комментарии
+    }
+
+    std::string argument(const char* p, const char* lineEnd) {
+        p = skipSpaces(p, lineEnd);
+        while (lineEnd > p && isSpace(lineEnd[-1])) {
+            --lineEnd;
+        }
+        return std::string(p, lineEnd);
+    }
+
+    /**
+     * @brief Разрешает индекс OBJ так же, как tinyobj::fixIndex
+     * @return false для недопустимого нулевого индекса позиции
+     */
+    static bool resolveIndex(int raw, bool allowZero, AttributeKind kind, const size_t counts[ATTRIBUTE_KINDS],
+                             const std::vector<Corner>& corners, std::vector<uint32_t>* relative, int32_t& out) {
+        if (raw > 0) {
+            out = raw - 1;
+            return true;
+        }
+        if (raw == 0) {
+            out = -1;
+            return allowZero;
+        }
+        out = static_cast<int32_t>(static_cast<int64_t>(counts[kind]) + raw);
+        if (relative) {
+            relative[kind].push_back(static_cast<uint32_t>(corners.size())); // База станет известна позже
+        } else if (out < 0) {
+            throw std::runtime_error("Failed to parse `f' line (relative index out of range)");
+        }
+        return true;
+    }
+
+    size_t parseFace(const char* p, const char* end, const size_t counts[ATTRIBUTE_KINDS],
+                     std::vector<Corner>& corners, std::vector<uint32_t>* relative) {
+        p = skipSpaces(p, end);
+        size_t faceSize = 0;
+
+        while (p < end && *p != '\r' && *p != '#') {
+            Corner corner{};
+
+            if (!resolveIndex(parseInt(p, end), false, POSITION, counts, corners, relative, corner.v)) {
+                throw std::runtime_error("Failed to parse `f' line (zero vertex index)");
+            }
+            p = skipIndexToken(p, end);
+
+            if (p < end && *p == '/') {
+                ++p;
+                if (p < end && *p == '/') { // i//k
+                    ++p;
+                    resolveIndex(parseInt(p, end), true, NORMAL, counts, corners, relative, corner.vn);
+                    p = skipIndexToken(p, end);
+                } else {                    // i/j или i/j/k
+                    resolveIndex(parseInt(p, end), true, TEXCOORD, counts, corners, relative, corner.vt);
+                    p = skipIndexToken(p, end);
+                    if (p < end && *p == '/') {
+                        ++p;
+                        resolveIndex(parseInt(p, end), true, NORMAL, counts, corners, relative, corner.vn);
+                        p = skipIndexToken(p, end);
+                    }
+                }
+            }
+
+            corners.push_back(corner);
+            ++faceSize;
+
+            while (p < end && isTokenEnd(*p)) {
+                ++p;
+            }
+        }
+        return faceSize;
+    }
+
+    void triangulate(const Corner* face, size_t count, const std::vector<float>& v, std::vector<Corner>& out) {
+        if (count < 3) {
+            return; // Вырожденная грань
+        }
+        if (count == 3) {
+            out.insert(out.end(), face, face + 3);
+            return;
+        }
+
+        if (count == 4) {
+            size_t vi[4];
+            for (size_t k = 0; k < 4; ++k) {
+                vi[k] = static_cast<size_t>(face[k].v);
+                if (3 * vi[k] + 2 >= v.size()) {
+                    return; // tinyobj молча пропускает такую грань
+                }
+            }
+            float e02x = v[vi[2] * 3 + 0] - v[vi[0] * 3 + 0];
+            float e02y = v[vi[2] * 3 + 1] - v[vi[0] * 3 + 1];
+            float e02z = v[vi[2] * 3 + 2] - v[vi[0] * 3 + 2];
+            float e13x = v[vi[3] * 3 + 0] - v[vi[1] * 3 + 0];
+            float e13y = v[vi[3] * 3 + 1] - v[vi[1] * 3 + 1];
+            float e13z = v[vi[3] * 3 + 2] - v[vi[1] * 3 + 2];
+            float sqr02 = e02x * e02x + e02y * e02y + e02z * e02z;
+            float sqr13 = e13x * e13x + e13y * e13y + e13z * e13z;
+
+            if (sqr02 < sqr13) {
+                out.insert(out.end(), {face[0], face[1], face[2], face[0], face[2], face[3]});
+            } else {
+                out.insert(out.end(), {face[0], face[1], face[3], face[1], face[2], face[3]});
+            }
+            return;
+        }
+
+        // Выбираем две оси проекции по первому невырожденному углу
+        size_t axes[2] = {1, 2};
+        for (size_t k = 0; k < count; ++k) {
+            size_t vi0 = static_cast<size_t>(face[(k + 0) % count].v);
+            size_t vi1 = static_cast<size_t>(face[(k + 1) % count].v);
+            size_t vi2 = static_cast<size_t>(face[(k + 2) % count].v);
+            if (3 * vi0 + 2 >= v.size() || 3 * vi1 + 2 >= v.size() || 3 * vi2 + 2 >= v.size()) {
+                continue;
+            }
+            float e0x = v[vi1 * 3 + 0] - v[vi0 * 3 + 0];
+            float e0y = v[vi1 * 3 + 1] - v[vi0 * 3 + 1];
+            float e0z = v[vi1 * 3 + 2] - v[vi0 * 3 + 2];
+            float e1x = v[vi2 * 3 + 0] - v[vi1 * 3 + 0];
+            float e1y = v[vi2 * 3 + 1] - v[vi1 * 3 + 1];
+            float e1z = v[vi2 * 3 + 2] - v[vi1 * 3 + 2];
+            float cx = std::fabs(e0y * e1z - e0z * e1y);
+            float cy = std::fabs(e0z * e1x - e0x * e1z);
+            float cz = std::fabs(e0x * e1y - e0y * e1x);
+            const float epsilon = std::numeric_limits<float>::epsilon();
+            if (cx > epsilon || cy > epsilon || cz > epsilon) {
+                if (!(cx > cy && cx > cz)) {
+                    axes[0] = 0;
+                    if (cz > cx && cz > cy) {
+                        axes[1] = 1;
+                    }
+                }
+                break;
+            }
+        }
+
+        std::vector<Corner> remaining(face, face + count);
+        size_t guessVert = 0;
+        Corner ind[3];
+        float vx[3];
+        float vy[3];
+        size_t remainingIterations = count;
+        size_t previousRemaining = count;
+
+        while (remaining.size() > 3 && remainingIterations > 0) {
+            size_t npolys = remaining.size();
+            if (guessVert >= npolys) {
+                guessVert -= npolys;
+            }
+            if (previousRemaining != npolys) {
+                previousRemaining = npolys;
+                remainingIterations = npolys;
+            } else {
+                remainingIterations--;
+            }
+
+            for (size_t k = 0; k < 3; ++k) {
+                ind[k] = remaining[(guessVert + k) % npolys];
+                size_t vi = static_cast<size_t>(ind[k].v);
+                if (vi * 3 + axes[0] >= v.size() || vi * 3 + axes[1] >= v.size()) {
+                    vx[k] = 0.0f;
+                    vy[k] = 0.0f;
+                } else {
+                    vx[k] = v[vi * 3 + axes[0]];
+                    vy[k] = v[vi * 3 + axes[1]];
+                }
+            }
+
+            float e0x = vx[1] - vx[0];
+            float e0y = vy[1] - vy[0];
+            float e1x = vx[2] - vx[1];
+            float e1y = vy[2] - vy[1];
+            float cross = e0x * e1y - e0y * e1x;
+            float area = (vx[0] * vy[1] - vy[0] * vx[1]) * 0.5f;
+            if (cross * area < 0.0f) { // Внутренний угол
+                guessVert += 1;
+                continue;
+            }
+
+            bool overlap = false;
+            for (size_t otherVert = 3; otherVert < npolys; ++otherVert) {
+                size_t idx = (guessVert + otherVert) % npolys;
+                size_t ovi = static_cast<size_t>(remaining[idx].v);
+                if (ovi * 3 + axes[0] >= v.size() || ovi * 3 + axes[1] >= v.size()) {
+                    continue;
+                }
+                if (pointInTriangle(vx, vy, v[ovi * 3 + axes[0]], v[ovi * 3 + axes[1]])) {
+                    overlap = true;
+                    break;
+                }
+            }
+            if (overlap) {
+                guessVert += 1;
+                continue;
+            }
+
+            out.insert(out.end(), {ind[0], ind[1], ind[2]}); // Нашли ухо
+
+            remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>((guessVert + 1) % npolys));
+        }
+
+        if (remaining.size() == 3) {
+            out.insert(out.end(), remaining.begin(), remaining.end());
+        }
+    }
+
+
+    Vertex makeVertex(const Corner& corner, const std::vector<float>& positions, const std::vector<float>& texcoords) {
+        if (corner.v < 0 || 3 * static_cast<size_t>(corner.v) + 2 >= positions.size()) {
+            throw std::runtime_error("Vertex index out of range");
+        }
+
+        Vertex vertex{};
+        vertex.pos = {
+            positions[3 * corner.v + 0],
+            positions[3 * corner.v + 1],
+            positions[3 * corner.v + 2]
+        };
+        if (corner.vt >= 0 && 2 * static_cast<size_t>(corner.vt) + 1 < texcoords.size()) {
+            vertex.texCoord = {
+                texcoords[2 * corner.vt + 0],
+                1.0f - texcoords[2 * corner.vt + 1]
+            };
+        } else {
+            vertex.texCoord = {0.0f, 1.0f};
+        }
+        vertex.color = {1.0f, 1.0f, 1.0f};
+        return vertex;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Разбор строк Wavefront OBJ, общий для ObjParser и ObjStreamReader
+ *
+ * Разбор чисел, индексов граней и триангуляция повторяют tinyobj бит в бит.
+ */
+namespace ObjSyntax {
+    struct Corner {
+        int32_t v = -1;
+        int32_t vt = -1;
+        int32_t vn = -1;
+    };
+
+    enum AttributeKind { POSITION = 0, TEXCOORD = 1, NORMAL = 2, ATTRIBUTE_KINDS = 3 };
+
+    /// Число float на один атрибут каждого вида
+    constexpr size_t ATTRIBUTE_WIDTH[ATTRIBUTE_KINDS] = {3, 2, 3};
+
+    enum class LineType { POSITION_LINE, TEXCOORD_LINE, NORMAL_LINE, FACE_LINE, USEMTL_LINE, MTLLIB_LINE, OTHER_LINE };
+
+    /**
+     * @brief Находит конец строки, начинающейся с p
+     * @param lineEnd Конец строки без "\n" и "\r"
+     * @return Начало следующей строки
+     */
+    const char* nextLine(const char* p, const char* end, const char*& lineEnd);
+
+    /**
+     * @brief Определяет директиву строки и сдвигает p на её аргументы
+     */
+    LineType classify(const char*& p, const char* lineEnd);
+
+    /// Аргументы директивы целиком (имя материала, файла) без пробелов по краям
+    std::string argument(const char* p, const char* lineEnd);
+
+    /// Аналог tinyobj::parseReal: токен до пробела/табуляции/\r, при ошибке — значение по умолчанию
+    float parseReal(const char*& p, const char* end, double defaultValue = 0.0);
+
+    /**
+     * @brief Разбирает углы грани (аргументы строки "f") и дописывает их в corners
+     *
+     * @param counts Сколько атрибутов каждого вида известно на этот момент
+     * @param relative Если не nullptr, отрицательные индексы считаются от counts,
+     *        а номера таких углов дописываются в relative[вид] для последующего сдвига.
+     *        Иначе отрицательный индекс, указывающий до начала файла, — ошибка.
+     * @return Число углов грани
+     * @throws std::runtime_error при нулевом или недопустимом индексе позиции
+     */
+    size_t parseFace(const char* p, const char* end, const size_t counts[ATTRIBUTE_KINDS],
+                     std::vector<Corner>& corners, std::vector<uint32_t>* relative);
+
+    /**
+     * @brief Триангуляция многоугольника по правилам tinyobj
+     *
+     * Четырёхугольник режется по короткой диагонали, остальные
+     * многоугольники — встроенным в tinyobj отсечением ушей.
+     * Грани с недопустимыми индексами позиций пропускаются, как в tinyobj.
+     */
+    void triangulate(const Corner* face, size_t count, const std::vector<float>& positions, std::vector<Corner>& out);
+
+    /**
+     * @brief Собирает вершину угла так же, как прежний loadModel() (V отражается, цвет белый)
+     * @throws std::runtime_error если индекс позиции вне массива
+     */
+    Vertex makeVertex(const Corner& corner, const std::vector<float>& positions, const std::vector<float>& texcoords);
+}
@@ -0,0 +1,51 @@
+#include "Options.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+Options Options::parse(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--no-mesh-cache") {
+            options.useMeshCache = false;
+        } else if (arg == "--optimize-vertex-cache") {
+            options.optimizeVertexCache = true;
+        } else if (arg == "--optimize-overdraw") {
+            options.optimizeOverdraw = true;
+        } else if (arg == "--optimize-vertex-fetch") {
+            options.optimizeVertexFetch = true;
+        } else if (arg == "--lod") {
+            options.buildLods = true;
+        } else if (arg == "--meshlets") {
+            options.buildMeshlets = true;
+        } else if (arg == "--no-texture-cache") {
+            options.useTextureCache = false;
+        } else if (arg == "--no-bindless") {
+            options.bindlessTextures = false;
+        } else if (arg == "--model" && i + 1 < argc) {
+            options.modelPath = argv[++i];
+        } else if (arg == "--weld-epsilon" && i + 1 < argc) {
+            options.weldEpsilon = std::max(0.0f, std::strtof(argv[++i], nullptr));
+        } else if (arg == "--stream" && i + 1 < argc) {
+            options.streamMemoryLimitMB = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--texture-cache-mb" && i + 1 < argc) {
+            options.textureCacheLimitMB = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--texture-budget" && i + 1 < argc) {
+            options.textureBudgetMB = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--vertex-format" && i + 1 < argc) {
+            const std::string format = argv[++i];
+            if (format == "packed") {
+                options.vertexFormat = VertexFormat::PACKED;
+            } else if (format == "full") {
+                options.vertexFormat = VertexFormat::FULL;
+            } else {
+                std::cerr << "Unknown vertex format: " << format << std::endl;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+        }
+    }
+    return options;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Формат вершин в вершинном буфере
+ */
+enum class VertexFormat {
+    FULL,   ///< Vertex, 60 байт: float-позиция, цвет, UV, нормаль и касательная
+    PACKED  ///< PackedVertex, 16 байт: квантованные позиция и UV, октаэдрическая нормаль (без касательной)
+};
+
+/**
+ * @brief Параметры запуска, задаваемые из командной строки
+ */
+struct Options {
+    std::string modelPath;    ///< --model <path>: .obj, .glb или .gltf; пусто — MODEL_PATH
+    bool useMeshCache = true; ///< --no-mesh-cache: всегда разбирать OBJ (замер холодного старта)
+    float weldEpsilon = 0.0f; ///< --weld-epsilon <e>: склеивать вершины, чьи позиции ближе шага сетки e
+    size_t streamMemoryLimitMB = 0; ///< --stream <MB>: потоковая загрузка OBJ с потолком памяти; 0 — выключена
+    bool optimizeVertexCache = false; ///< --optimize-vertex-cache: переупорядочить треугольники под кэш вершин GPU
+    bool optimizeOverdraw = false;    ///< --optimize-overdraw: кластеры треугольников от внешних к внутренним (включает предыдущий)
+    bool optimizeVertexFetch = false; ///< --optimize-vertex-fetch: вершины в порядке первого использования
+    VertexFormat vertexFormat = VertexFormat::FULL; ///< --vertex-format full|packed: формат вершинного буфера
+    bool buildLods = false;           ///< --lod: построить цепочку уровней детализации и выбирать уровень по размеру на экране
+    bool buildMeshlets = false;       ///< --meshlets: разбить сетку на мешлеты и отсекать их на CPU каждый кадр
+    bool useTextureCache = true;      ///< --no-texture-cache: всегда декодировать PNG/JPG (замер холодного старта)
+    size_t textureCacheLimitMB = 1024; ///< --texture-cache-mb <MB>: предел размера кэша декодированных текстур
+    size_t textureBudgetMB = 0;        ///< --texture-budget <MB>: подгружать мип-уровни по мере надобности в пределах бюджета; 0 — все сразу
+    bool bindlessTextures = true;      ///< --no-bindless: набор дескрипторов на каждую текстуру вместо общего массива
+
+    /**
+     * @brief Разбирает аргументы main(); неизвестные флаги игнорируются с предупреждением
+     */
+    static Options parse(int argc, char** argv);
+};
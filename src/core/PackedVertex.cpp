@@ -0,0 +1,272 @@
+#include "PackedVertex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VERTEX_PACKING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr float UNORM16_MAX = 65535.0f;
+    constexpr float SNORM16_MAX = 32767.0f;
+
+    /**
+     * @brief Множитель перевода [offset, offset + scale] в [0, 65535]; 0 для вырожденного диапазона
+     */
+    float unormFactor(float scale) {
+        return scale > 0.0f ? UNORM16_MAX / scale : 0.0f;
+    }
+
+    /**
+     * @brief Параметры кодирования, общие для скалярного и SIMD-пути
+     *
+     * Оба пути выполняют одни и те же операции в одном порядке, поэтому
+     * результат совпадает бит в бит.
+     */
+    struct EncodeFactors {
+        float positionOffset[3];
+        float positionFactor[3];
+        float texCoordOffset[2];
+        float texCoordFactor[2];
+
+        explicit EncodeFactors(const VertexQuantization& quantization) {
+            for (int i = 0; i < 3; ++i) {
+                positionOffset[i] = quantization.positionOffset[i];
+                positionFactor[i] = unormFactor(quantization.positionScale[i]);
+            }
+            for (int i = 0; i < 2; ++i) {
+                texCoordOffset[i] = quantization.texCoordScaleOffset[2 + i];
+                texCoordFactor[i] = unormFactor(quantization.texCoordScaleOffset[i]);
+            }
+        }
+    };
+
+    uint16_t quantizeUnorm(float value, float offset, float factor) {
+        const float q = std::min(std::max((value - offset) * factor, 0.0f), UNORM16_MAX);
+        return static_cast<uint16_t>(std::nearbyint(q));
+    }
+
+    int16_t quantizeSnorm(float value) {
+        const float q = std::min(std::max(value * SNORM16_MAX, -SNORM16_MAX), SNORM16_MAX);
+        return static_cast<int16_t>(std::nearbyint(q));
+    }
+
+    /**
+     * @brief Октаэдрическая развёртка: проекция на |x| + |y| + |z| = 1, нижняя полусфера отражается наружу
+     */
+    void octEncode(const glm::vec3& n, float& x, float& y) {
+        const float sum = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+        const float inv = sum > 0.0f ? 1.0f / sum : 0.0f; // Нулевая нормаль (в OBJ её не было) кодируется как (0, 0)
+        x = n.x * inv;
+        y = n.y * inv;
+        if (n.z < 0.0f) {
+            const float foldedX = (1.0f - std::fabs(y)) * std::copysign(1.0f, x);
+            const float foldedY = (1.0f - std::fabs(x)) * std::copysign(1.0f, y);
+            x = foldedX;
+            y = foldedY;
+        }
+    }
+
+    void encodeOne(const Vertex& vertex, const EncodeFactors& factors, PackedVertex& out) {
+        for (int i = 0; i < 3; ++i) {
+            out.position[i] = quantizeUnorm(vertex.pos[i], factors.positionOffset[i], factors.positionFactor[i]);
+        }
+        out.position[3] = 0;
+        for (int i = 0; i < 2; ++i) {
+            out.texCoord[i] = quantizeUnorm(vertex.texCoord[i], factors.texCoordOffset[i], factors.texCoordFactor[i]);
+        }
+        float x = 0.0f;
+        float y = 0.0f;
+        octEncode(vertex.normal, x, y);
+        out.normal[0] = quantizeSnorm(x);
+        out.normal[1] = quantizeSnorm(y);
+    }
+
+#ifdef VERTEX_PACKING_SSE2
+    __m128i quantizeUnorm4(__m128 value, float offset, float factor) {
+        const __m128 q = _mm_mul_ps(_mm_sub_ps(value, _mm_set1_ps(offset)), _mm_set1_ps(factor));
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(q, _mm_setzero_ps()), _mm_set1_ps(UNORM16_MAX));
+        // packs_epi32 насыщает со знаком, поэтому беззнаковые значения сдвигаются на 32768
+        return _mm_sub_epi32(_mm_cvtps_epi32(clamped), _mm_set1_epi32(32768));
+    }
+
+    __m128i quantizeSnorm4(__m128 value) {
+        const __m128 q = _mm_mul_ps(value, _mm_set1_ps(SNORM16_MAX));
+        return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(q, _mm_set1_ps(-SNORM16_MAX)), _mm_set1_ps(SNORM16_MAX)));
+    }
+
+    /**
+     * @brief Четыре вершины за раз: AoS -> SoA транспонированием, кодирование, обратно в AoS
+     */
+    void encodeFour(const Vertex* vertices, const EncodeFactors& factors, PackedVertex* out) {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        // pos.xyz + color.r и texCoord.uv + normal.xy лежат подряд: по одной загрузке на вершину
+        __m128 px = _mm_loadu_ps(&vertices[0].pos.x);
+        __m128 py = _mm_loadu_ps(&vertices[1].pos.x);
+        __m128 pz = _mm_loadu_ps(&vertices[2].pos.x);
+        __m128 pw = _mm_loadu_ps(&vertices[3].pos.x);
+        _MM_TRANSPOSE4_PS(px, py, pz, pw);
+
+        __m128 u = _mm_loadu_ps(&vertices[0].texCoord.x);
+        __m128 v = _mm_loadu_ps(&vertices[1].texCoord.x);
+        __m128 nx = _mm_loadu_ps(&vertices[2].texCoord.x);
+        __m128 ny = _mm_loadu_ps(&vertices[3].texCoord.x);
+        _MM_TRANSPOSE4_PS(u, v, nx, ny);
+        const __m128 nz = _mm_setr_ps(vertices[0].normal.z, vertices[1].normal.z,
+                                      vertices[2].normal.z, vertices[3].normal.z);
+
+        // Октаэдрическая развёртка, как в octEncode()
+        const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, nx), _mm_andnot_ps(signMask, ny)),
+                                      _mm_andnot_ps(signMask, nz));
+        const __m128 inv = _mm_and_ps(_mm_div_ps(one, sum), _mm_cmpgt_ps(sum, _mm_setzero_ps()));
+        __m128 ox = _mm_mul_ps(nx, inv);
+        __m128 oy = _mm_mul_ps(ny, inv);
+        const __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, oy)), _mm_or_ps(one, _mm_and_ps(signMask, ox)));
+        const __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, ox)), _mm_or_ps(one, _mm_and_ps(signMask, oy)));
+        const __m128 lower = _mm_cmplt_ps(nz, _mm_setzero_ps());
+        ox = _mm_or_ps(_mm_and_ps(lower, foldedX), _mm_andnot_ps(lower, ox));
+        oy = _mm_or_ps(_mm_and_ps(lower, foldedY), _mm_andnot_ps(lower, oy));
+
+        const __m128i unsignedBias = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i xy = _mm_xor_si128(unsignedBias, _mm_packs_epi32(
+            quantizeUnorm4(px, factors.positionOffset[0], factors.positionFactor[0]),
+            quantizeUnorm4(py, factors.positionOffset[1], factors.positionFactor[1])));
+        const __m128i zw = _mm_xor_si128(unsignedBias, _mm_packs_epi32(
+            quantizeUnorm4(pz, factors.positionOffset[2], factors.positionFactor[2]),
+            _mm_set1_epi32(-32768)));
+        const __m128i uv = _mm_xor_si128(unsignedBias, _mm_packs_epi32(
+            quantizeUnorm4(u, factors.texCoordOffset[0], factors.texCoordFactor[0]),
+            quantizeUnorm4(v, factors.texCoordOffset[1], factors.texCoordFactor[1])));
+        const __m128i oct = _mm_packs_epi32(quantizeSnorm4(ox), quantizeSnorm4(oy));
+
+        // [x0..x3 y0..y3] -> [x0 y0 x1 y1 ...] и т.д., затем сборка строк по 8 компонентов
+        const __m128i xyPairs = _mm_unpacklo_epi16(xy, _mm_unpackhi_epi64(xy, xy));
+        const __m128i zwPairs = _mm_unpacklo_epi16(zw, _mm_unpackhi_epi64(zw, zw));
+        const __m128i uvPairs = _mm_unpacklo_epi16(uv, _mm_unpackhi_epi64(uv, uv));
+        const __m128i octPairs = _mm_unpacklo_epi16(oct, _mm_unpackhi_epi64(oct, oct));
+
+        const __m128i positionLo = _mm_unpacklo_epi32(xyPairs, zwPairs);
+        const __m128i positionHi = _mm_unpackhi_epi32(xyPairs, zwPairs);
+        const __m128i restLo = _mm_unpacklo_epi32(uvPairs, octPairs);
+        const __m128i restHi = _mm_unpackhi_epi32(uvPairs, octPairs);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0), _mm_unpacklo_epi64(positionLo, restLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 1), _mm_unpackhi_epi64(positionLo, restLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2), _mm_unpacklo_epi64(positionHi, restHi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3), _mm_unpackhi_epi64(positionHi, restHi));
+    }
+#endif
+}
+
+VkVertexInputBindingDescription PackedVertex::getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(PackedVertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 3> PackedVertex::getAttributeDescriptions() {
+    // UNORM/SNORM-форматы: вершинный блок сам переводит целые в [0, 1] и [-1, 1]
+    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+    // Position (Location 0)
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+    attributeDescriptions[0].offset = offsetof(PackedVertex, position);
+
+    // Octahedral normal (Location 1)
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+    attributeDescriptions[1].offset = offsetof(PackedVertex, normal);
+
+    // Texture Coordinates (Location 2)
+    attributeDescriptions[2].binding = 0;
+    attributeDescriptions[2].location = 2;
+    attributeDescriptions[2].format = VK_FORMAT_R16G16_UNORM;
+    attributeDescriptions[2].offset = offsetof(PackedVertex, texCoord);
+
+    return attributeDescriptions;
+}
+
+namespace VertexPacking {
+
+    VertexQuantization computeQuantization(const Vertex* vertices, size_t count) {
+        VertexQuantization quantization;
+        if (count == 0) {
+            return quantization;
+        }
+
+        glm::vec3 positionMin(std::numeric_limits<float>::max());
+        glm::vec3 positionMax(std::numeric_limits<float>::lowest());
+        glm::vec2 texCoordMin(std::numeric_limits<float>::max());
+        glm::vec2 texCoordMax(std::numeric_limits<float>::lowest());
+        for (size_t i = 0; i < count; ++i) {
+            positionMin = glm::min(positionMin, vertices[i].pos);
+            positionMax = glm::max(positionMax, vertices[i].pos);
+            texCoordMin = glm::min(texCoordMin, vertices[i].texCoord);
+            texCoordMax = glm::max(texCoordMax, vertices[i].texCoord);
+        }
+
+        quantization.positionScale = glm::vec4(positionMax - positionMin, 0.0f);
+        quantization.positionOffset = glm::vec4(positionMin, 0.0f);
+        quantization.texCoordScaleOffset = glm::vec4(texCoordMax - texCoordMin, texCoordMin);
+        return quantization;
+    }
+
+    void encodeScalar(const Vertex* vertices, size_t count, const VertexQuantization& quantization, PackedVertex* out) {
+        const EncodeFactors factors(quantization);
+        for (size_t i = 0; i < count; ++i) {
+            encodeOne(vertices[i], factors, out[i]);
+        }
+    }
+
+    void encode(const Vertex* vertices, size_t count, const VertexQuantization& quantization, PackedVertex* out) {
+        const EncodeFactors factors(quantization);
+        size_t i = 0;
+#ifdef VERTEX_PACKING_SSE2
+        for (; i + 4 <= count; i += 4) {
+            encodeFour(vertices + i, factors, out + i);
+        }
+#endif
+        for (; i < count; ++i) {
+            encodeOne(vertices[i], factors, out[i]);
+        }
+    }
+
+    Vertex decode(const PackedVertex& vertex, const VertexQuantization& quantization) {
+        Vertex result{};
+        for (int i = 0; i < 3; ++i) {
+            result.pos[i] = quantization.positionOffset[i]
+                          + vertex.position[i] / UNORM16_MAX * quantization.positionScale[i];
+        }
+        for (int i = 0; i < 2; ++i) {
+            result.texCoord[i] = quantization.texCoordScaleOffset[2 + i]
+                               + vertex.texCoord[i] / UNORM16_MAX * quantization.texCoordScaleOffset[i];
+        }
+        result.color = glm::vec3(1.0f);
+
+        // Обратная октаэдрическая развёртка (как в shader_packed.vert)
+        glm::vec3 n(std::max(vertex.normal[0] / SNORM16_MAX, -1.0f), std::max(vertex.normal[1] / SNORM16_MAX, -1.0f), 0.0f);
+        n.z = 1.0f - std::fabs(n.x) - std::fabs(n.y);
+        const float fold = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -fold : fold;
+        n.y += n.y >= 0.0f ? -fold : fold;
+        result.normal = glm::normalize(n); // |x| + |y| + |z| = 1, длина не бывает нулевой
+        return result;
+    }
+
+    std::vector<PackedVertex> pack(const std::vector<Vertex>& vertices, VertexQuantization& quantization) {
+        quantization = computeQuantization(vertices.data(), vertices.size());
+        std::vector<PackedVertex> packed(vertices.size());
+        encode(vertices.data(), vertices.size(), quantization, packed.data());
+        return packed;
+    }
+}
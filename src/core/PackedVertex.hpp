@@ -0,0 +1,67 @@
+#pragma once
+#include "Vertex.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+/**
+ * @brief Сжатая вершина (16 байт вместо 60 у Vertex)
+ *
+ * Позиция хранится как unorm16 относительно габаритов сетки, UV — как unorm16
+ * относительно диапазона UV, нормаль — октаэдрической развёрткой в snorm16.
+ * Цвет не хранится: сетки с цветами вершин BufferManager оставляет в формате
+ * Vertex. Касательные, сгенерированные при загрузке, при упаковке отбрасываются.
+ * Восстановление — в shader_packed.vert по параметрам VertexQuantization из
+ * push-констант.
+ */
+struct PackedVertex {
+    uint16_t position[4]; ///< x, y, z; w всегда 0 (выравнивание до 8 байт)
+    uint16_t texCoord[2];
+    int16_t normal[2];    ///< Октаэдрическая развёртка единичной нормали
+
+    static VkVertexInputBindingDescription getBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+/**
+ * @brief Параметры восстановления сжатых вершин (блок push-констант вершинного шейдера)
+ *
+ * Исходное значение = offset + q * scale, где q — unorm-значение в [0, 1].
+ */
+struct VertexQuantization {
+    glm::vec4 positionScale{0.0f};       ///< xyz — габариты сетки, w не используется
+    glm::vec4 positionOffset{0.0f};      ///< xyz — минимальный угол габаритов
+    glm::vec4 texCoordScaleOffset{0.0f}; ///< xy — диапазон UV, zw — минимум UV
+};
+static_assert(sizeof(VertexQuantization) == 48, "VertexQuantization is a push constant block");
+
+namespace VertexPacking {
+    /**
+     * @brief Считает габариты позиций и UV, по которым квантуются вершины
+     */
+    VertexQuantization computeQuantization(const Vertex* vertices, size_t count);
+
+    /**
+     * @brief Сжимает вершины; на x86 по четыре за раз через SSE2
+     */
+    void encode(const Vertex* vertices, size_t count, const VertexQuantization& quantization, PackedVertex* out);
+
+    /**
+     * @brief Скалярный вариант encode(): эталон для тестов и платформ без SSE2
+     */
+    void encodeScalar(const Vertex* vertices, size_t count, const VertexQuantization& quantization, PackedVertex* out);
+
+    /**
+     * @brief Восстанавливает вершину так же, как это делает shader_packed.vert
+     */
+    Vertex decode(const PackedVertex& vertex, const VertexQuantization& quantization);
+
+    /**
+     * @brief Сжимает весь массив, заполняя quantization
+     */
+    std::vector<PackedVertex> pack(const std::vector<Vertex>& vertices, VertexQuantization& quantization);
+}
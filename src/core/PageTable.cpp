@@ -0,0 +1,109 @@
+#include "PageTable.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+PageTable::PageTable(std::vector<std::pair<uint32_t, uint32_t>> tilesPerLevel, uint32_t slotCount)
+    : tilesPerLevel_(std::move(tilesPerLevel)) {
+    if (tilesPerLevel_.empty() || slotCount == 0 || slotCount > MAX_SLOTS) {
+        throw std::runtime_error("Invalid page table layout");
+    }
+    levelOffsets_.assign(tilesPerLevel_.size() + 1, 0);
+    for (size_t level = 0; level < tilesPerLevel_.size(); ++level) {
+        if (tilesPerLevel_[level].first == 0 || tilesPerLevel_[level].second == 0 ||
+            tilesPerLevel_[level].first > 0xFFFF || tilesPerLevel_[level].second > 0xFFFF) {
+            throw std::runtime_error("Invalid page table layout");
+        }
+        levelOffsets_[level + 1] = levelOffsets_[level] + size_t{tilesPerLevel_[level].first} * tilesPerLevel_[level].second;
+    }
+    tileSlots_.assign(tileCount(), NO_SLOT);
+    slots_.resize(slotCount);
+    // Свободные слоты берутся с конца: первым выдаётся слот 0
+    for (uint32_t slot = slotCount; slot-- > 0;) {
+        freeSlots_.push_back(slot);
+    }
+}
+
+uint32_t PageTable::levelOf(size_t tile) const {
+    return static_cast<uint32_t>(std::upper_bound(levelOffsets_.begin(), levelOffsets_.end(), tile) -
+                                 levelOffsets_.begin() - 1);
+}
+
+std::vector<size_t> PageTable::touch(const std::vector<size_t>& requested) {
+    std::vector<size_t> missing;
+    for (size_t tile : requested) {
+        if (tile >= tileCount()) {
+            continue;
+        }
+        if (isResident(tile)) {
+            slots_[tileSlots_[tile]].lastUse = frame_;
+        } else {
+            missing.push_back(tile);
+        }
+    }
+    // Грубые страницы первыми: они покрывают больше экрана и быстрее убирают размытость
+    std::sort(missing.begin(), missing.end(), [this](size_t a, size_t b) {
+        const uint32_t levelA = levelOf(a);
+        const uint32_t levelB = levelOf(b);
+        return levelA != levelB ? levelA > levelB : a < b;
+    });
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    return missing;
+}
+
+uint32_t PageTable::map(size_t tile, bool pinned) {
+    if (isResident(tile)) {
+        Slot& slot = slots_[tileSlots_[tile]];
+        slot.lastUse = frame_;
+        slot.pinned = slot.pinned || pinned;
+        return tileSlots_[tile];
+    }
+
+    uint32_t slot = NO_SLOT;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        for (uint32_t i = 0; i < slots_.size(); ++i) {
+            const Slot& candidate = slots_[i];
+            if (!candidate.pinned && candidate.lastUse < frame_ &&
+                (slot == NO_SLOT || candidate.lastUse < slots_[slot].lastUse)) {
+                slot = i;
+            }
+        }
+        if (slot == NO_SLOT) {
+            return NO_SLOT;
+        }
+        tileSlots_[slots_[slot].tile] = NO_SLOT;
+    }
+
+    slots_[slot] = Slot{tile, frame_, pinned};
+    tileSlots_[tile] = slot;
+    dirty_ = true;
+    return slot;
+}
+
+const std::vector<PageTable::Entry>& PageTable::entries() {
+    if (!dirty_) {
+        return entries_;
+    }
+    entries_.assign(tileCount(), Entry{});
+    // От грубого уровня к детальному: нерезидентная страница наследует запись родителя
+    for (uint32_t level = levelCount(); level-- > 0;) {
+        const uint32_t tilesX = tilesPerLevel_[level].first;
+        const uint32_t tilesY = tilesPerLevel_[level].second;
+        for (uint32_t y = 0; y < tilesY; ++y) {
+            for (uint32_t x = 0; x < tilesX; ++x) {
+                const size_t tile = tileIndex(level, x, y);
+                if (isResident(tile)) {
+                    entries_[tile] = Entry{tileSlots_[tile] | (level << 24), x | (y << 16)};
+                } else if (level + 1 < levelCount()) {
+                    const uint32_t parentX = std::min(x / 2, tilesPerLevel_[level + 1].first - 1);
+                    const uint32_t parentY = std::min(y / 2, tilesPerLevel_[level + 1].second - 1);
+                    entries_[tile] = entries_[tileIndex(level + 1, parentX, parentY)];
+                }
+            }
+        }
+    }
+    dirty_ = false;
+    return entries_;
+}
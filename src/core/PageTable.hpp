@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Какие страницы виртуальной текстуры лежат в физическом атласе
+ *
+ * Логика без Vulkan. Страницы всех уровней пронумерованы подряд (уровень 0
+ * построчно, затем уровень 1 и т. д., как в VirtualTexture). Рендер каждый
+ * кадр сообщает touch(), какие страницы нужны на экране, и получает те, что
+ * надо загрузить; загруженная страница получает слот атласа через map(),
+ * который при нехватке места вытесняет страницу, дольше всех не нужную
+ * (LRU). Страницы текущего кадра и закреплённые не вытесняются.
+ *
+ * entries() — таблица для шейдера: у каждой страницы каждого уровня записан
+ * слот её ближайшего резидентного предка (или её самой), поэтому выборка
+ * никогда не промахивается, а лишь берёт более грубый уровень, пока нужная
+ * страница загружается.
+ */
+class PageTable {
+public:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+    static constexpr uint32_t MAX_SLOTS = 1u << 24;
+
+    /// Запись таблицы страниц; раскладка совпадает с uvec2 в шейдере
+    struct Entry {
+        uint32_t slotAndLevel = 0; ///< Слот атласа | (уровень резидентной страницы << 24)
+        uint32_t tile = 0;         ///< x | (y << 16) резидентной страницы на её уровне
+    };
+
+    /**
+     * @param tilesPerLevel Страниц по горизонтали и вертикали на каждом уровне, от 0
+     * @param slotCount Страниц в атласе, не больше MAX_SLOTS
+     */
+    PageTable(std::vector<std::pair<uint32_t, uint32_t>> tilesPerLevel, uint32_t slotCount);
+
+    uint32_t levelCount() const { return static_cast<uint32_t>(tilesPerLevel_.size()); }
+    size_t tileCount() const { return levelOffsets_.back(); }
+    /// Номер первой страницы уровня
+    size_t levelOffset(uint32_t level) const { return levelOffsets_[level]; }
+    size_t tileIndex(uint32_t level, uint32_t x, uint32_t y) const {
+        return levelOffsets_[level] + size_t{y} * tilesPerLevel_[level].first + x;
+    }
+    uint32_t levelOf(size_t tile) const;
+
+    /**
+     * @brief Отмечает страницы, нужные в текущем кадре
+     * @return Нужные, но не резидентные страницы: от грубых уровней к детальным
+     */
+    std::vector<size_t> touch(const std::vector<size_t>& requested);
+
+    /**
+     * @brief Отдаёт странице слот атласа; если свободных нет, вытесняет самую давно не нужную
+     * @param pinned Страница не вытесняется никогда
+     * @return NO_SLOT, если все слоты заняты страницами текущего кадра или закреплёнными
+     */
+    uint32_t map(size_t tile, bool pinned = false);
+
+    bool isResident(size_t tile) const { return tileSlots_[tile] != NO_SLOT; }
+    uint32_t slotOf(size_t tile) const { return tileSlots_[tile]; }
+    size_t residentCount() const { return slots_.size() - freeSlots_.size(); }
+    uint32_t slotCount() const { return static_cast<uint32_t>(slots_.size()); }
+
+    /// Записи всех страниц; пересчитываются, только если резидентность менялась
+    const std::vector<Entry>& entries();
+    /// Менялась ли резидентность со времени последнего entries()
+    bool isDirty() const { return dirty_; }
+
+    /// Начинает следующий кадр
+    void nextFrame() { ++frame_; }
+
+private:
+    struct Slot {
+        size_t tile = SIZE_MAX;
+        uint64_t lastUse = 0;
+        bool pinned = false;
+    };
+
+    std::vector<std::pair<uint32_t, uint32_t>> tilesPerLevel_;
+    std::vector<size_t> levelOffsets_; ///< levelCount() + 1 значений: последнее — число страниц
+    std::vector<uint32_t> tileSlots_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> freeSlots_;
+    std::vector<Entry> entries_;
+    bool dirty_ = true;
+    uint64_t frame_ = 1;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+    /**
+     * @brief Количество рабочих потоков по умолчанию
+     *
+     * hardware_concurrency() может вернуть 0, если число ядер неизвестно
+     */
+    inline unsigned workerCount(unsigned requested = 0) {
+        if (requested != 0) {
+            return requested;
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * @brief Вызывает fn(i) для i в [0, count) на нескольких потоках
+     *
+     * Каждый индекс обрабатывается ровно одним потоком. Первое исключение
+     * из рабочих потоков пробрасывается в вызывающий поток после join().
+     */
+    template <typename Fn>
+    void forEach(size_t count, Fn&& fn, unsigned threads = 0) {
+        threads = static_cast<unsigned>(std::min<size_t>(workerCount(threads), count));
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(threads);
+        workers.reserve(threads);
+
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                try {
+                    // Статическое разбиение: поток t берёт индексы t, t + threads, ...
+                    for (size_t i = t; i < count; i += threads) {
+                        fn(i);
+                    }
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include "PipelineBuilder.hpp"
 #include "VulkanUtils.hpp"
+#include "PackedVertex.hpp"
 
 
 PipelineBuilder::PipelineBuilder(VkDevice device, VkRenderPass renderPass)
@@ -132,9 +133,16 @@ PipelineBuilder& PipelineBuilder::setPipelineLayout(VkPipelineLayout layout) {
     return *this;
 }
 
-PipelineBuilder& PipelineBuilder::setVertexInfo(){
-    bindingDescription_ = Vertex::getBindingDescription();
-    attributeDescriptions_ = Vertex::getAttributeDescriptions();
+PipelineBuilder& PipelineBuilder::setVertexInfo(VertexFormat format){
+    if (format == VertexFormat::PACKED) {
+        bindingDescription_ = PackedVertex::getBindingDescription();
+        const auto attributes = PackedVertex::getAttributeDescriptions();
+        attributeDescriptions_.assign(attributes.begin(), attributes.end());
+    } else {
+        bindingDescription_ = Vertex::getBindingDescription();
+        const auto attributes = Vertex::getAttributeDescriptions();
+        attributeDescriptions_.assign(attributes.begin(), attributes.end());
+    }
 
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputInfo.vertexBindingDescriptionCount = 1;
@@ -42,7 +42,8 @@ public:
 
     PipelineBuilder& setPipelineLayout(VkPipelineLayout layout);
 
-    PipelineBuilder& setVertexInfo();
+    // Описывает вершинный буфер в заданном формате (Vertex или PackedVertex)
+    PipelineBuilder& setVertexInfo(VertexFormat format = VertexFormat::FULL);
 
     PipelineBuilder& setDepth();
 
@@ -52,7 +53,7 @@ public:
 
 private:
     VkVertexInputBindingDescription bindingDescription_; // Store binding
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions_; // Store attributes
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions_; // Store attributes (число зависит от формата вершин)
 
     VkDevice device; 
     VkRenderPass renderPass;
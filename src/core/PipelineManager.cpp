@@ -1,22 +1,41 @@
 #include "PipelineManager.hpp"
+#include <algorithm>
+#include <string>
 
 
-PipelineManager::PipelineManager(DeviceManager& deviceMgr, SwapChainManager& swapMgr)
+PipelineManager::PipelineManager(DeviceManager& deviceMgr, SwapChainManager& swapMgr, bool bindlessTextures)
     : deviceManager_(deviceMgr), swapChainManager_(swapMgr),
     graphicsPipeline_(nullptr, VulkanDeleter<VkPipeline_T, vkDestroyPipeline, VkDevice>(nullptr)),
     pipelineLayout_(nullptr, VulkanDeleter<VkPipelineLayout_T, vkDestroyPipelineLayout, VkDevice>(nullptr)),
     descriptorSetLayout(nullptr, VulkanDeleter<VkDescriptorSetLayout_T, vkDestroyDescriptorSetLayout, VkDevice>(nullptr)),
-    descriptorPool(nullptr, VulkanDeleter<VkDescriptorPool_T, vkDestroyDescriptorPool, VkDevice>(nullptr))
+    textureSetLayout(nullptr, VulkanDeleter<VkDescriptorSetLayout_T, vkDestroyDescriptorSetLayout, VkDevice>(nullptr)),
+    virtualTextureSetLayout(nullptr, VulkanDeleter<VkDescriptorSetLayout_T, vkDestroyDescriptorSetLayout, VkDevice>(nullptr)),
+    descriptorPool(nullptr, VulkanDeleter<VkDescriptorPool_T, vkDestroyDescriptorPool, VkDevice>(nullptr)),
+    virtualPipelineLayout_(nullptr, VulkanDeleter<VkPipelineLayout_T, vkDestroyPipelineLayout, VkDevice>(nullptr)),
+    virtualPipeline_(nullptr, VulkanDeleter<VkPipeline_T, vkDestroyPipeline, VkDevice>(nullptr)),
+    bindless_(bindlessTextures && deviceMgr.supportsBindlessTextures()),
+    bindlessCapacity_(std::min(MAX_BINDLESS_TEXTURES, deviceMgr.bindlessTextureLimit())),
+    bindlessPool_(nullptr, VulkanDeleter<VkDescriptorPool_T, vkDestroyDescriptorPool, VkDevice>(nullptr))
     {}
 
 void PipelineManager::createPipelineLayout() {
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1; 
-    VkDescriptorSetLayout rawDescriptorLayout = descriptorSetLayout.get();
+    std::array<VkDescriptorSetLayout, 2> rawDescriptorLayouts = {descriptorSetLayout.get(), textureSetLayout.get()};
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(rawDescriptorLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = rawDescriptorLayouts.data();
 
-    pipelineLayoutInfo.pSetLayouts = &rawDescriptorLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
+    // Параметры восстановления сжатых вершин; шейдер полного формата их просто не читает
+    std::array<VkPushConstantRange, 2> pushConstantRanges{};
+    pushConstantRanges[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRanges[0].offset = 0;
+    pushConstantRanges[0].size = sizeof(VertexQuantization);
+    // Цвет материала для фрагментного шейдера — сразу за ними
+    pushConstantRanges[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRanges[1].offset = MATERIAL_CONSTANTS_OFFSET;
+    pushConstantRanges[1].size = sizeof(MaterialConstants);
+    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
 
     VkPipelineLayout rawLayout;
     if (vkCreatePipelineLayout(
@@ -34,61 +53,130 @@ void PipelineManager::createPipelineLayout() {
             deviceManager_.device()
         )
     );
+
+    // Та же раскладка, но в set = 1 — ресурсы виртуальной текстуры
+    rawDescriptorLayouts[1] = virtualTextureSetLayout.get();
+    if (vkCreatePipelineLayout(deviceManager_.device(), &pipelineLayoutInfo, nullptr, &rawLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout!");
+    }
+    virtualPipelineLayout_ = VkPipelineLayoutPtr(rawLayout,
+        VulkanDeleter<VkPipelineLayout_T, vkDestroyPipelineLayout, VkDevice>(deviceManager_.device()));
 }
 
-void PipelineManager::createGraphicsPipeline() {
-    BasicTriangleStrategy strategy;
+void PipelineManager::createGraphicsPipeline(VertexFormat vertexFormat, bool virtualTextures) {
+    BasicTriangleStrategy strategy(vertexFormat, bindless_ ? SHADER_DIR "/frag_bindless.spv" : SHADER_DIR "/frag.spv");
     graphicsPipeline_ = strategy.createGraphicsPipeline(
         deviceManager_.device(),
         swapChainManager_.getRenderPass(),
         pipelineLayout_.get()
     );
+
+    virtualPipeline_.reset();
+    if (virtualTextures) {
+        BasicTriangleStrategy virtualStrategy(vertexFormat, SHADER_DIR "/frag_virtual.spv");
+        virtualPipeline_ = virtualStrategy.createGraphicsPipeline(deviceManager_.device(),
+                                                                  swapChainManager_.getRenderPass(),
+                                                                  virtualPipelineLayout_.get());
+    }
 }
 void PipelineManager::createDescriptorSetLayout() {
 
-    // сообщить Vulkan, что в вершинном шейдере будет использоваться один uniform-буфер, привязанный к индексу 0
+    // сообщить Vulkan, что в вершинном шейдере будет использоваться один uniform-буфер, привязанный к индексу 0;
+    // смещение среза в нём задаётся при привязке набора
     VkDescriptorSetLayoutBinding uboLayoutBinding{};
     uboLayoutBinding.binding = 0;
     uboLayoutBinding.descriptorCount = 1;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.pImmutableSamplers = nullptr;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
 
+    // собрать информацию о дескрипторном наборе в одну структуру.
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};   
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &uboLayoutBinding;
+
+    VkDescriptorSetLayout rawDescriptorSetLayout;
+    if (vkCreateDescriptorSetLayout(deviceManager_.device(), &layoutInfo, nullptr, &rawDescriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+    descriptorSetLayout = VkDescriptorSetLayoutPtr(rawDescriptorSetLayout,
+         VulkanDeleter<VkDescriptorSetLayout_T, vkDestroyDescriptorSetLayout, VkDevice>(deviceManager_.device()));
+
+    // Текстура материала — отдельный набор, чтобы смена материала не трогала набор кадра
     VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-    samplerLayoutBinding.binding = 1;
+    samplerLayoutBinding.binding = 0;
     samplerLayoutBinding.descriptorCount = 1;
     samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     samplerLayoutBinding.pImmutableSamplers = nullptr;
     samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    std::array<VkDescriptorSetLayoutBinding, 2> bindings = {uboLayoutBinding, samplerLayoutBinding};
+    layoutInfo.pBindings = &samplerLayoutBinding;
 
-    // собрать информацию о дескрипторном наборе в одну структуру.
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};   
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
+    // Общий массив: заполнены только первые элементы, новые текстуры пишутся, пока набор привязан
+    const VkDescriptorBindingFlags bindlessFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                   VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlags{};
+    bindingFlags.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlags.bindingCount = 1;
+    bindingFlags.pBindingFlags = &bindlessFlags;
+    if (bindless_) {
+        samplerLayoutBinding.descriptorCount = bindlessCapacity_;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutInfo.pNext = &bindingFlags;
+    }
+    VkDescriptorSetLayout rawTextureSetLayout;
+    if (vkCreateDescriptorSetLayout(deviceManager_.device(), &layoutInfo, nullptr, &rawTextureSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+    textureSetLayout = VkDescriptorSetLayoutPtr(rawTextureSetLayout,
+         VulkanDeleter<VkDescriptorSetLayout_T, vkDestroyDescriptorSetLayout, VkDevice>(deviceManager_.device()));
+    layoutInfo.flags = 0;
+    layoutInfo.pNext = nullptr;
+    if (bindless_) {
+        createBindlessTextureSet();
+    }
 
-    VkDescriptorSetLayout rawDescriptorSetLayout;
-    if (vkCreateDescriptorSetLayout(deviceManager_.device(), &layoutInfo, nullptr, &rawDescriptorSetLayout) != VK_SUCCESS) {
+    // Виртуальная текстура: атлас страниц, таблица страниц (чтение) и обратная связь (запись)
+    std::array<VkDescriptorSetLayoutBinding, 3> virtualBindings{};
+    for (uint32_t i = 0; i < virtualBindings.size(); ++i) {
+        virtualBindings[i].binding = i;
+        virtualBindings[i].descriptorCount = 1;
+        virtualBindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                                                   : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        virtualBindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    layoutInfo.bindingCount = static_cast<uint32_t>(virtualBindings.size());
+    layoutInfo.pBindings = virtualBindings.data();
+    VkDescriptorSetLayout rawVirtualTextureSetLayout;
+    if (vkCreateDescriptorSetLayout(deviceManager_.device(), &layoutInfo, nullptr, &rawVirtualTextureSetLayout) != VK_SUCCESS) {
         throw std::runtime_error("failed to create descriptor set layout!");
     }
-    descriptorSetLayout = VkDescriptorSetLayoutPtr(rawDescriptorSetLayout,
+    virtualTextureSetLayout = VkDescriptorSetLayoutPtr(rawVirtualTextureSetLayout,
          VulkanDeleter<VkDescriptorSetLayout_T, vkDestroyDescriptorSetLayout, VkDevice>(deviceManager_.device()));
 }
-void PipelineManager::createDescriptorPool() {
-    std::array<VkDescriptorPoolSize, 2> poolSizes{};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = static_cast<uint32_t>(Constants::MAX_FRAMES_IN_FLIGHT);
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = static_cast<uint32_t>(Constants::MAX_FRAMES_IN_FLIGHT);
+void PipelineManager::createDescriptorPool(size_t textureCount, size_t virtualTextureCount) {
+    // С общим массивом наборы текстур не выделяются: их число не растёт с числом текстур
+    if (bindless_) {
+        textureCount = 0;
+    }
+    std::vector<VkDescriptorPoolSize> poolSizes(1);
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = 1;
+    if (textureCount + virtualTextureCount > 0) {
+        poolSizes.push_back({VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                             static_cast<uint32_t>(textureCount + virtualTextureCount)});
+    }
+    if (virtualTextureCount > 0) {
+        poolSizes.push_back({VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<uint32_t>(2 * virtualTextureCount)});
+    }
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = static_cast<uint32_t>(Constants::MAX_FRAMES_IN_FLIGHT);
+    poolInfo.maxSets = static_cast<uint32_t>(1 + textureCount + virtualTextureCount);
 
     VkDescriptorPool rawDescriptorPool;
     if (vkCreateDescriptorPool(deviceManager_.device(), &poolInfo, nullptr, &rawDescriptorPool) != VK_SUCCESS) {
@@ -99,52 +187,180 @@ void PipelineManager::createDescriptorPool() {
     
 }
 
-void PipelineManager::createDescriptorSets(const std::vector<VkBufferPtr>& uniformBuffers, VkSampler textureSampler, VkImageView textureImageView) {
-    std::vector<VkDescriptorSetLayout> layouts(Constants::MAX_FRAMES_IN_FLIGHT, descriptorSetLayout.get());
+void PipelineManager::createUniformSet(VkBuffer uniformBuffer) {
+        VkDescriptorSetLayout layout = descriptorSetLayout.get();
         VkDescriptorSetAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocInfo.descriptorPool = descriptorPool.get();
-        allocInfo.descriptorSetCount = static_cast<uint32_t>(Constants::MAX_FRAMES_IN_FLIGHT);
-        allocInfo.pSetLayouts = layouts.data();
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
 
-        descriptorSets.resize(Constants::MAX_FRAMES_IN_FLIGHT);
-        if (vkAllocateDescriptorSets(deviceManager_.device(), &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
+        if (vkAllocateDescriptorSets(deviceManager_.device(), &allocInfo, &uniformSet_) != VK_SUCCESS) {
             throw std::runtime_error("failed to allocate descriptor sets!");
         }
 
-        for (size_t i = 0; i < Constants::MAX_FRAMES_IN_FLIGHT; i++) {
-            VkDescriptorBufferInfo bufferInfo{};
-            bufferInfo.buffer = uniformBuffers[i].get();
-            bufferInfo.offset = 0;
-            bufferInfo.range = sizeof(UniformBufferObject);
-
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = textureImageView;
-            imageInfo.sampler = textureSampler;
-
-            std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-            descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrites[0].dstSet = descriptorSets[i];
-            descriptorWrites[0].dstBinding = 0;
-            descriptorWrites[0].dstArrayElement = 0;
-            descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptorWrites[0].descriptorCount = 1;
-            descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-            descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrites[1].dstSet = descriptorSets[i];
-            descriptorWrites[1].dstBinding = 1;
-            descriptorWrites[1].dstArrayElement = 0;
-            descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptorWrites[1].descriptorCount = 1;
-            descriptorWrites[1].pImageInfo = &imageInfo;
-
-            vkUpdateDescriptorSets( deviceManager_.device(),
-                                    static_cast<uint32_t>(descriptorWrites.size()),
-                                    descriptorWrites.data(),
-                                    0,
-                                    nullptr);
+        // Окно в один UniformBufferObject; динамическое смещение двигает его по областям кадров
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = uniformBuffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(UniformBufferObject);
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = uniformSet_;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(deviceManager_.device(), 1, &descriptorWrite, 0, nullptr);
+}
+
+void PipelineManager::createBindlessTextureSet() {
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, bindlessCapacity_};
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+
+    VkDescriptorPool rawPool;
+    if (vkCreateDescriptorPool(deviceManager_.device(), &poolInfo, nullptr, &rawPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create descriptor pool!");
+    }
+    bindlessPool_ = VkDescriptorPoolPtr(rawPool,
+         VulkanDeleter<VkDescriptorPool_T, vkDestroyDescriptorPool, VkDevice>(deviceManager_.device()));
+
+    VkDescriptorSetLayout layout = textureSetLayout.get();
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = rawPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+    if (vkAllocateDescriptorSets(deviceManager_.device(), &allocInfo, &bindlessTextureSet_) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate descriptor sets!");
+    }
+}
+
+void PipelineManager::createTextureDescriptorSets(VkSampler textureSampler, const std::vector<VkImageView>& textureImageViews) {
+    if (bindless_) {
+        if (textureImageViews.size() > bindlessCapacity_) {
+            throw std::runtime_error("Model has " + std::to_string(textureImageViews.size()) +
+                                     " textures, the bindless texture array holds " + std::to_string(bindlessCapacity_));
+        }
+        if (textureImageViews.empty()) {
+            return;
+        }
+        // Элементы прежней модели за пределами n остаются, но материалы на них больше не ссылаются
+        std::vector<VkDescriptorImageInfo> imageInfos(textureImageViews.size());
+        for (size_t i = 0; i < textureImageViews.size(); i++) {
+            imageInfos[i] = {textureSampler, textureImageViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
         }
-}
\ No newline at end of file
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = bindlessTextureSet_;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrite.descriptorCount = static_cast<uint32_t>(imageInfos.size());
+        descriptorWrite.pImageInfo = imageInfos.data();
+        vkUpdateDescriptorSets(deviceManager_.device(), 1, &descriptorWrite, 0, nullptr);
+        return;
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(textureImageViews.size(), textureSetLayout.get());
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = descriptorPool.get();
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocInfo.pSetLayouts = layouts.data();
+
+    textureDescriptorSets.resize(layouts.size());
+    if (vkAllocateDescriptorSets(deviceManager_.device(), &allocInfo, textureDescriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate descriptor sets!");
+    }
+
+    std::vector<VkDescriptorImageInfo> imageInfos(textureImageViews.size());
+    std::vector<VkWriteDescriptorSet> descriptorWrites(textureImageViews.size());
+    for (size_t i = 0; i < textureImageViews.size(); i++) {
+        imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos[i].imageView = textureImageViews[i];
+        imageInfos[i].sampler = textureSampler;
+
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = textureDescriptorSets[i];
+        descriptorWrites[i].dstBinding = 0;
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].pImageInfo = &imageInfos[i];
+    }
+    vkUpdateDescriptorSets(deviceManager_.device(), static_cast<uint32_t>(descriptorWrites.size()),
+                           descriptorWrites.data(), 0, nullptr);
+}
+
+void PipelineManager::updateTextureDescriptorSet(size_t texture, VkSampler textureSampler, VkImageView textureImageView) {
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = textureImageView;
+    imageInfo.sampler = textureSampler;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = bindless_ ? bindlessTextureSet_ : textureDescriptorSets[texture];
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = bindless_ ? static_cast<uint32_t>(texture) : 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(deviceManager_.device(), 1, &descriptorWrite, 0, nullptr);
+}
+
+void PipelineManager::createVirtualTextureDescriptorSets(const std::vector<VirtualTextureBindings>& bindings) {
+    virtualTextureDescriptorSets.clear();
+    if (bindings.empty()) {
+        return;
+    }
+    std::vector<VkDescriptorSetLayout> layouts(bindings.size(), virtualTextureSetLayout.get());
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = descriptorPool.get();
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocInfo.pSetLayouts = layouts.data();
+
+    virtualTextureDescriptorSets.resize(layouts.size());
+    if (vkAllocateDescriptorSets(deviceManager_.device(), &allocInfo, virtualTextureDescriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate descriptor sets!");
+    }
+
+    std::vector<VkDescriptorImageInfo> imageInfos(bindings.size());
+    std::vector<VkDescriptorBufferInfo> bufferInfos(2 * bindings.size());
+    std::vector<VkWriteDescriptorSet> descriptorWrites(3 * bindings.size());
+    for (size_t i = 0; i < bindings.size(); i++) {
+        imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos[i].imageView = bindings[i].atlas;
+        imageInfos[i].sampler = bindings[i].sampler;
+        bufferInfos[2 * i] = {bindings[i].pageTable, 0, bindings[i].pageTableSize};
+        bufferInfos[2 * i + 1] = {bindings[i].feedback, 0, bindings[i].feedbackSize};
+
+        for (uint32_t binding = 0; binding < 3; ++binding) {
+            VkWriteDescriptorSet& write = descriptorWrites[3 * i + binding];
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = virtualTextureDescriptorSets[i];
+            write.dstBinding = binding;
+            write.dstArrayElement = 0;
+            write.descriptorCount = 1;
+            if (binding == 0) {
+                write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                write.pImageInfo = &imageInfos[i];
+            } else {
+                write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                write.pBufferInfo = &bufferInfos[2 * i + binding - 1];
+            }
+        }
+    }
+    vkUpdateDescriptorSets(deviceManager_.device(), static_cast<uint32_t>(descriptorWrites.size()),
+                           descriptorWrites.data(), 0, nullptr);
+}
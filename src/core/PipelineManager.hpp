@@ -4,36 +4,100 @@
 #include "BasicTriangleStrategy.hpp"
 #include "BufferManager.hpp"
 #include "Constants.hpp"
+#include "PackedVertex.hpp"
+#include "Material.hpp"
+#include "VirtualTextureStreamer.hpp"
 
 class PipelineManager {
     public:
-        PipelineManager(DeviceManager& deviceMgr, SwapChainManager& swapMgr);
+        /// Смещение MaterialConstants фрагментного шейдера в блоке push-констант
+        static constexpr uint32_t MATERIAL_CONSTANTS_OFFSET = sizeof(VertexQuantization);
+        /// Потолок массива текстур общего набора; меньше, если так ограничивает устройство
+        static constexpr uint32_t MAX_BINDLESS_TEXTURES = 16384;
+
+        /**
+         * @param bindlessTextures Если устройство умеет индексировать дескрипторы, все текстуры
+         *        лежат в одном массиве set = 1, а номер текстуры материала — в MaterialConstants
+         */
+        PipelineManager(DeviceManager& deviceMgr, SwapChainManager& swapMgr, bool bindlessTextures = true);
         
+        /**
+         * @brief Раскладка обычных материалов и раскладка материалов с виртуальной текстурой
+         *
+         * Отличаются только набором set = 1; push-константы у них общие.
+         */
         void createPipelineLayout();
-        void createGraphicsPipeline();
+        /**
+         * @param virtualTextures Построить и второй конвейер с shader_virtual.frag
+         */
+        void createGraphicsPipeline(VertexFormat vertexFormat = VertexFormat::FULL, bool virtualTextures = false);
 
+        /**
+         * @brief set = 0 — uniform-буфер кадров (динамическое смещение), set = 1 — текстура материала
+         *
+         * Для виртуальной текстуры set = 1 — атлас страниц, таблица страниц и буфер обратной связи.
+         */
         void createDescriptorSetLayout();   
-        void createDescriptorPool(); 
-        void createDescriptorSets(const std::vector<VkBufferPtr>& uniformBuffers,
-                                    VkSampler textureSampler,
-                                    VkImageView textureImageView);
+        void createDescriptorPool(size_t textureCount, size_t virtualTextureCount = 0); 
+        /**
+         * @brief Единственный набор set = 0 на все кадры и объекты
+         *
+         * Срез UniformBufferObject выбирает динамическое смещение при привязке,
+         * поэтому новые объекты и кадры не требуют обновления дескрипторов.
+         */
+        void createUniformSet(VkBuffer uniformBuffer);
+        /**
+         * @brief Набор дескрипторов на каждую текстуру; все выделяются и заполняются одним вызовом
+         *
+         * С общим массивом текстуры пишутся в его элементы 0..n-1, а новые наборы не выделяются.
+         * @throws std::runtime_error если текстур больше, чем помещается в массив
+         */
+        void createTextureDescriptorSets(VkSampler textureSampler, const std::vector<VkImageView>& textureImageViews);
+        /**
+         * @brief Переписывает набор текстуры (или элемент общего массива) на новый вид изображения;
+         * он не должен использоваться GPU
+         */
+        void updateTextureDescriptorSet(size_t texture, VkSampler textureSampler, VkImageView textureImageView);
+        /**
+         * @brief Набор дескрипторов на каждую виртуальную текстуру
+         */
+        void createVirtualTextureDescriptorSets(const std::vector<VirtualTextureBindings>& bindings);
 
         VkPipelineLayout getLayout() const { return pipelineLayout_.get(); }
         VkPipeline getGraphicsPipeline() const { return graphicsPipeline_.get(); }
-        std::vector<VkDescriptorSet> getDescriptorSets() const {return descriptorSets;}
+        /// Все текстуры в одном наборе getBindlessTextureSet(), материал выбирает свою по MaterialConstants::texture
+        bool isBindless() const { return bindless_; }
+        VkDescriptorSet getBindlessTextureSet() const { return bindlessTextureSet_; }
+        VkDescriptorSet getUniformSet() const { return uniformSet_; }
+        const std::vector<VkDescriptorSet>& getTextureDescriptorSets() const {return textureDescriptorSets;}
+        VkPipelineLayout getVirtualLayout() const { return virtualPipelineLayout_.get(); }
+        VkPipeline getVirtualPipeline() const { return virtualPipeline_.get(); }
+        const std::vector<VkDescriptorSet>& getVirtualTextureDescriptorSets() const {return virtualTextureDescriptorSets;}
     
     private:
-
+        /// Пул с обновлением после привязки и единственный набор с массивом текстур
+        void createBindlessTextureSet();
 
         VkDescriptorSetLayoutPtr descriptorSetLayout;
+        VkDescriptorSetLayoutPtr textureSetLayout;
+        VkDescriptorSetLayoutPtr virtualTextureSetLayout;
         VkDescriptorPoolPtr descriptorPool;
 
-        std::vector<VkDescriptorSet> descriptorSets;
+        VkDescriptorSet uniformSet_ = VK_NULL_HANDLE;
+        std::vector<VkDescriptorSet> textureDescriptorSets;
+        std::vector<VkDescriptorSet> virtualTextureDescriptorSets;
 
         DeviceManager& deviceManager_;
         SwapChainManager& swapChainManager_;
 
         VkPipelineLayoutPtr pipelineLayout_;
         VkPipelinePtr graphicsPipeline_;
+        VkPipelineLayoutPtr virtualPipelineLayout_;
+        VkPipelinePtr virtualPipeline_;
+
+        bool bindless_ = false;
+        uint32_t bindlessCapacity_ = 0;
+        VkDescriptorPoolPtr bindlessPool_; ///< Живёт всё время: набор не пересоздаётся при смене модели
+        VkDescriptorSet bindlessTextureSet_ = VK_NULL_HANDLE;
     };
 
@@ -0,0 +1,524 @@
+#include "PlyParser.hpp"
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+    constexpr size_t RECORDS_PER_BLOCK = 64 * 1024; // Записей на одну задачу потока
+
+    enum class ScalarType : uint8_t { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+    size_t typeSize(ScalarType type) {
+        switch (type) {
+            case ScalarType::INT8: case ScalarType::UINT8: return 1;
+            case ScalarType::INT16: case ScalarType::UINT16: return 2;
+            case ScalarType::INT32: case ScalarType::UINT32: case ScalarType::FLOAT32: return 4;
+            case ScalarType::FLOAT64: return 8;
+        }
+        return 0;
+    }
+
+    bool isInteger(ScalarType type) {
+        return type != ScalarType::FLOAT32 && type != ScalarType::FLOAT64;
+    }
+
+    /// Имена типов из спецификации PLY и их синонимы с размером в имени
+    bool parseType(const std::string& name, ScalarType& type) {
+        static const std::pair<const char*, ScalarType> TYPES[] = {
+            {"char", ScalarType::INT8},     {"int8", ScalarType::INT8},
+            {"uchar", ScalarType::UINT8},   {"uint8", ScalarType::UINT8},
+            {"short", ScalarType::INT16},   {"int16", ScalarType::INT16},
+            {"ushort", ScalarType::UINT16}, {"uint16", ScalarType::UINT16},
+            {"int", ScalarType::INT32},     {"int32", ScalarType::INT32},
+            {"uint", ScalarType::UINT32},   {"uint32", ScalarType::UINT32},
+            {"float", ScalarType::FLOAT32}, {"float32", ScalarType::FLOAT32},
+            {"double", ScalarType::FLOAT64}, {"float64", ScalarType::FLOAT64},
+        };
+        for (const auto& entry : TYPES) {
+            if (name == entry.first) {
+                type = entry.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct Property {
+        std::string name;
+        ScalarType type = ScalarType::FLOAT32; ///< Тип значения или элемента списка
+        bool list = false;
+        ScalarType countType = ScalarType::UINT8; ///< Тип длины списка
+    };
+
+    struct Element {
+        std::string name;
+        size_t count = 0;
+        std::vector<Property> properties;
+    };
+
+    struct Header {
+        bool bigEndian = false;
+        std::vector<Element> elements;
+        size_t dataOffset = 0; ///< Первый байт после end_header
+    };
+
+    Header parseHeader(const char* data, size_t size, const std::string& path) {
+        auto fail = [&](const std::string& message) {
+            return std::runtime_error("Invalid PLY header in " + path + ": " + message);
+        };
+        if (size < 4 || std::memcmp(data, "ply", 3) != 0 || (data[3] != '\n' && data[3] != '\r')) {
+            throw fail("missing 'ply' magic");
+        }
+
+        Header header;
+        bool hasFormat = false;
+        size_t position = 0;
+        while (true) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(data + position, '\n', size - position));
+            if (!lineEnd) {
+                throw fail("no end_header");
+            }
+            std::istringstream line(std::string(data + position, lineEnd));
+            position = static_cast<size_t>(lineEnd - data) + 1;
+
+            std::string keyword;
+            line >> keyword;
+            if (keyword == "end_header") {
+                break;
+            }
+            if (keyword == "format") {
+                std::string format;
+                line >> format;
+                if (format == "ascii") {
+                    throw std::runtime_error("ASCII PLY is not supported, save " + path + " as binary");
+                }
+                if (format != "binary_little_endian" && format != "binary_big_endian") {
+                    throw fail("unknown format '" + format + "'");
+                }
+                header.bigEndian = format == "binary_big_endian";
+                hasFormat = true;
+            } else if (keyword == "element") {
+                Element element;
+                long long count = -1;
+                line >> element.name >> count;
+                if (!line || count < 0) {
+                    throw fail("bad element line");
+                }
+                element.count = static_cast<size_t>(count);
+                header.elements.push_back(std::move(element));
+            } else if (keyword == "property") {
+                if (header.elements.empty()) {
+                    throw fail("property before element");
+                }
+                Property property;
+                std::string type;
+                line >> type;
+                if (type == "list") {
+                    std::string countType;
+                    line >> countType >> type;
+                    property.list = true;
+                    if (!parseType(countType, property.countType) || !isInteger(property.countType)) {
+                        throw fail("bad list count type '" + countType + "'");
+                    }
+                }
+                line >> property.name;
+                if (!line || !parseType(type, property.type)) {
+                    throw fail("bad property type '" + type + "'");
+                }
+                header.elements.back().properties.push_back(std::move(property));
+            } else if (keyword != "comment" && keyword != "obj_info" && !keyword.empty() && keyword != "ply") {
+                throw fail("unknown keyword '" + keyword + "'");
+            }
+        }
+        if (!hasFormat) {
+            throw fail("no format line");
+        }
+        header.dataOffset = position;
+        return header;
+    }
+
+    bool hostIsBigEndian() {
+        const uint16_t probe = 1;
+        uint8_t first = 0;
+        std::memcpy(&first, &probe, 1);
+        return first == 0;
+    }
+
+    /// Значение из невыровненной памяти с переворотом байтов для чужого порядка
+    template <typename T>
+    T loadScalar(const uint8_t* data, bool swap) {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, data, sizeof(T));
+        if (swap) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    double readReal(const uint8_t* data, ScalarType type, bool swap) {
+        switch (type) {
+            case ScalarType::INT8: return loadScalar<int8_t>(data, swap);
+            case ScalarType::UINT8: return loadScalar<uint8_t>(data, swap);
+            case ScalarType::INT16: return loadScalar<int16_t>(data, swap);
+            case ScalarType::UINT16: return loadScalar<uint16_t>(data, swap);
+            case ScalarType::INT32: return loadScalar<int32_t>(data, swap);
+            case ScalarType::UINT32: return loadScalar<uint32_t>(data, swap);
+            case ScalarType::FLOAT32: return loadScalar<float>(data, swap);
+            case ScalarType::FLOAT64: return loadScalar<double>(data, swap);
+        }
+        return 0.0;
+    }
+
+    /// Целое значение; типы индексов и длин списков проверены при разборе заголовка
+    int64_t readInteger(const uint8_t* data, ScalarType type, bool swap) {
+        switch (type) {
+            case ScalarType::INT8: return loadScalar<int8_t>(data, swap);
+            case ScalarType::UINT8: return loadScalar<uint8_t>(data, swap);
+            case ScalarType::INT16: return loadScalar<int16_t>(data, swap);
+            case ScalarType::UINT16: return loadScalar<uint16_t>(data, swap);
+            case ScalarType::INT32: return loadScalar<int32_t>(data, swap);
+            case ScalarType::UINT32: return loadScalar<uint32_t>(data, swap);
+            default: return static_cast<int64_t>(readReal(data, type, swap));
+        }
+    }
+
+    /// Длина записи, начинающейся с record; 0, если запись выходит за end или длина списка отрицательна
+    size_t recordSize(const Element& element, const uint8_t* record, const uint8_t* end, bool swap) {
+        const size_t available = static_cast<size_t>(end - record);
+        size_t size = 0;
+        for (const Property& property : element.properties) {
+            if (!property.list) {
+                size += typeSize(property.type);
+                continue;
+            }
+            const size_t countSize = typeSize(property.countType);
+            if (size + countSize > available) {
+                return 0;
+            }
+            const int64_t count = readInteger(record + size, property.countType, swap);
+            size += countSize;
+            if (count < 0 || static_cast<uint64_t>(count) > (available - size) / typeSize(property.type)) {
+                return 0;
+            }
+            size += static_cast<size_t>(count) * typeSize(property.type);
+        }
+        return size <= available ? size : 0;
+    }
+
+    /// Где лежат записи элемента: через равный шаг или по таблице начал
+    struct Layout {
+        const uint8_t* begin = nullptr;
+        size_t stride = 0;           ///< 0 — записи разной длины, см. offsets
+        std::vector<size_t> offsets; ///< Начала записей относительно begin
+        size_t bytes = 0;            ///< Размер всех записей
+
+        const uint8_t* record(size_t i) const { return begin + (stride != 0 ? i * stride : offsets[i]); }
+    };
+
+    bool hasLists(const Element& element) {
+        return std::any_of(element.properties.begin(), element.properties.end(),
+                           [](const Property& property) { return property.list; });
+    }
+
+    Layout locate(const Element& element, const uint8_t* begin, const uint8_t* end, bool swap,
+                  unsigned threadCount, const std::string& path) {
+        Layout layout;
+        layout.begin = begin;
+        if (element.count == 0) {
+            return layout;
+        }
+        auto truncated = [&]() {
+            return std::runtime_error("PLY element '" + element.name + "' runs past the end of " + path);
+        };
+        const size_t available = static_cast<size_t>(end - begin);
+        const size_t first = recordSize(element, begin, end, swap);
+        if (first == 0) {
+            throw truncated();
+        }
+
+        // Предположение о равной длине верно, если каждая запись на шаге first имеет длину first
+        bool uniform = element.count <= available / first;
+        if (uniform && hasLists(element)) {
+            std::atomic<bool> mismatch{false};
+            const size_t blockCount = (element.count + RECORDS_PER_BLOCK - 1) / RECORDS_PER_BLOCK;
+            Parallel::forEach(blockCount, [&](size_t block) {
+                const size_t last = std::min(element.count, (block + 1) * RECORDS_PER_BLOCK);
+                for (size_t i = block * RECORDS_PER_BLOCK; i < last && !mismatch.load(std::memory_order_relaxed); ++i) {
+                    if (recordSize(element, begin + i * first, end, swap) != first) {
+                        mismatch = true;
+                    }
+                }
+            }, threadCount);
+            uniform = !mismatch;
+        }
+        if (uniform) {
+            layout.stride = first;
+            layout.bytes = element.count * first;
+            return layout;
+        }
+        if (!hasLists(element)) {
+            throw truncated();
+        }
+
+        layout.offsets.resize(element.count);
+        size_t offset = 0;
+        for (size_t i = 0; i < element.count; ++i) {
+            layout.offsets[i] = offset;
+            const size_t size = recordSize(element, begin + offset, end, swap);
+            if (size == 0) {
+                throw truncated();
+            }
+            offset += size;
+        }
+        layout.bytes = offset;
+        return layout;
+    }
+
+    enum Role { X, Y, Z, NX, NY, NZ, U, V, RED, GREEN, BLUE, ROLE_COUNT, NONE = ROLE_COUNT };
+
+    Role roleOf(const std::string& name) {
+        static const std::pair<const char*, Role> ROLES[] = {
+            {"x", X}, {"y", Y}, {"z", Z}, {"nx", NX}, {"ny", NY}, {"nz", NZ},
+            {"u", U}, {"s", U}, {"texture_u", U}, {"texture_s", U},
+            {"v", V}, {"t", V}, {"texture_v", V}, {"texture_t", V},
+            {"red", RED}, {"green", GREEN}, {"blue", BLUE},
+            {"diffuse_red", RED}, {"diffuse_green", GREEN}, {"diffuse_blue", BLUE},
+        };
+        for (const auto& entry : ROLES) {
+            if (name == entry.first) {
+                return entry.second;
+            }
+        }
+        return NONE;
+    }
+
+    /// Множитель, переводящий целый цвет в [0, 1]; вещественный цвет уже в нём
+    double colorScale(ScalarType type) {
+        switch (type) {
+            case ScalarType::INT8: return 1.0 / 127.0;
+            case ScalarType::UINT8: return 1.0 / 255.0;
+            case ScalarType::INT16: return 1.0 / 32767.0;
+            case ScalarType::UINT16: return 1.0 / 65535.0;
+            case ScalarType::INT32: return 1.0 / 2147483647.0;
+            case ScalarType::UINT32: return 1.0 / 4294967295.0;
+            default: return 1.0;
+        }
+    }
+
+    const Element* findElement(const std::vector<Element>& elements, const char* name) {
+        for (const Element& element : elements) {
+            if (element.name == name) {
+                return &element;
+            }
+        }
+        return nullptr;
+    }
+}
+
+double PlyParser::Stats::megabytesPerSecond() const {
+    if (totalSeconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(fileSize) / (1024.0 * 1024.0) / totalSeconds;
+}
+
+PlyParser::PlyParser(unsigned threadCount)
+    : threadCount_(Parallel::workerCount(threadCount)) {}
+
+void PlyParser::load(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+
+    MappedFile file(path);
+    stats_ = Stats{};
+    stats_.fileSize = file.size();
+    stats_.threadCount = threadCount_;
+
+    const Header header = parseHeader(file.data(), file.size(), path);
+    const bool swap = header.bigEndian != hostIsBigEndian();
+    const Element* vertexElement = findElement(header.elements, "vertex");
+    const Element* faceElement = findElement(header.elements, "face");
+    if (!vertexElement) {
+        throw std::runtime_error("PLY has no vertex element: " + path);
+    }
+    if (!faceElement || faceElement->count == 0) {
+        throw std::runtime_error("PLY has no faces (point clouds are not supported): " + path);
+    }
+
+    // 1. Расположение элементов: каждый начинается там, где закончился предыдущий
+    const uint8_t* const end = reinterpret_cast<const uint8_t*>(file.data()) + file.size();
+    const uint8_t* position = reinterpret_cast<const uint8_t*>(file.data()) + header.dataOffset;
+    Layout vertexLayout;
+    Layout faceLayout;
+    for (const Element& element : header.elements) {
+        Layout layout = locate(element, position, end, swap, threadCount_, path);
+        position += layout.bytes;
+        if (&element == vertexElement) {
+            vertexLayout = std::move(layout);
+        } else if (&element == faceElement) {
+            faceLayout = std::move(layout);
+            stats_.uniformFaces = faceLayout.stride != 0;
+        }
+        if (vertexLayout.begin && faceLayout.begin) {
+            break; // Элементы после нужных не читаются
+        }
+    }
+
+    // 2. Вершины: роль и масштаб каждого свойства
+    std::vector<Role> roles;
+    std::vector<double> scales;
+    bool present[ROLE_COUNT] = {};
+    for (const Property& property : vertexElement->properties) {
+        const Role role = property.list ? NONE : roleOf(property.name);
+        roles.push_back(role);
+        scales.push_back(role == RED || role == GREEN || role == BLUE ? colorScale(property.type) : 1.0);
+        if (role != NONE) {
+            present[role] = true;
+        }
+    }
+    if (!present[X] || !present[Y] || !present[Z]) {
+        throw std::runtime_error("PLY vertices have no x/y/z: " + path);
+    }
+    hasNormals_ = present[NX] && present[NY] && present[NZ];
+    hasColors_ = present[RED] && present[GREEN] && present[BLUE];
+    const bool hasTexCoords = present[U] && present[V];
+
+    const size_t vertexBase = vertices.size();
+    const size_t vertexCount = vertexElement->count;
+    if (vertexBase + vertexCount > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Too many vertices for 32-bit indices in " + path);
+    }
+    vertices.resize(vertexBase + vertexCount);
+    const size_t vertexBlocks = (vertexCount + RECORDS_PER_BLOCK - 1) / RECORDS_PER_BLOCK;
+    Parallel::forEach(vertexBlocks, [&](size_t block) {
+        const size_t last = std::min(vertexCount, (block + 1) * RECORDS_PER_BLOCK);
+        for (size_t i = block * RECORDS_PER_BLOCK; i < last; ++i) {
+            double values[ROLE_COUNT] = {};
+            const uint8_t* data = vertexLayout.record(i);
+            for (size_t p = 0; p < roles.size(); ++p) {
+                const Property& property = vertexElement->properties[p];
+                if (property.list) {
+                    const int64_t count = readInteger(data, property.countType, swap);
+                    data += typeSize(property.countType) + static_cast<size_t>(count) * typeSize(property.type);
+                    continue;
+                }
+                if (roles[p] != NONE) {
+                    values[roles[p]] = readReal(data, property.type, swap) * scales[p];
+                }
+                data += typeSize(property.type);
+            }
+
+            Vertex& vertex = vertices[vertexBase + i];
+            vertex.pos = {values[X], values[Y], values[Z]};
+            vertex.color = hasColors_ ? glm::vec3(values[RED], values[GREEN], values[BLUE]) : glm::vec3(1.0f);
+            vertex.texCoord = hasTexCoords ? glm::vec2(values[U], 1.0 - values[V]) : glm::vec2(0.0f); // Как у OBJ
+            vertex.normal = hasNormals_ ? glm::vec3(values[NX], values[NY], values[NZ]) : glm::vec3(0.0f);
+            vertex.tangent = glm::vec4(0.0f);
+        }
+    }, threadCount_);
+
+    // 3. Грани: число треугольников по блокам, затем веерная триангуляция по префиксным суммам
+    size_t indexProperty = faceElement->properties.size();
+    for (size_t p = 0; p < faceElement->properties.size(); ++p) {
+        const Property& property = faceElement->properties[p];
+        if (property.list && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+            indexProperty = p;
+            break;
+        }
+    }
+    if (indexProperty == faceElement->properties.size() || !isInteger(faceElement->properties[indexProperty].type)) {
+        throw std::runtime_error("PLY faces have no integer vertex_indices list: " + path);
+    }
+
+    const size_t faceCount = faceElement->count;
+    stats_.faceCount = faceCount;
+    // Список индексов грани и её длина; остальные свойства записи перешагиваются
+    auto faceIndices = [&](size_t face, const uint8_t*& list) {
+        const uint8_t* data = faceLayout.record(face);
+        for (size_t p = 0;; ++p) {
+            const Property& property = faceElement->properties[p];
+            if (!property.list) {
+                data += typeSize(property.type);
+                continue;
+            }
+            const int64_t count = readInteger(data, property.countType, swap);
+            data += typeSize(property.countType);
+            if (p == indexProperty) {
+                list = data;
+                return static_cast<size_t>(count);
+            }
+            data += static_cast<size_t>(count) * typeSize(property.type);
+        }
+    };
+    auto trianglesOf = [](size_t corners) { return corners >= 3 ? corners - 2 : 0; };
+
+    const size_t faceBlocks = (faceCount + RECORDS_PER_BLOCK - 1) / RECORDS_PER_BLOCK;
+    std::vector<size_t> blockTriangleBase(faceBlocks + 1, 0);
+    const size_t listCount = std::count_if(faceElement->properties.begin(), faceElement->properties.end(),
+                                           [](const Property& property) { return property.list; });
+    if (faceLayout.stride != 0 && listCount == 1) {
+        // Записи одной длины с единственным списком: у всех граней столько же углов, сколько у первой
+        const uint8_t* list = nullptr;
+        const size_t perFace = trianglesOf(faceIndices(0, list));
+        for (size_t block = 0; block < faceBlocks; ++block) {
+            blockTriangleBase[block + 1] = std::min(faceCount, (block + 1) * RECORDS_PER_BLOCK) * perFace;
+        }
+    } else {
+        Parallel::forEach(faceBlocks, [&](size_t block) {
+            const size_t last = std::min(faceCount, (block + 1) * RECORDS_PER_BLOCK);
+            size_t triangles = 0;
+            const uint8_t* list = nullptr;
+            for (size_t face = block * RECORDS_PER_BLOCK; face < last; ++face) {
+                triangles += trianglesOf(faceIndices(face, list));
+            }
+            blockTriangleBase[block + 1] = triangles;
+        }, threadCount_);
+        for (size_t block = 0; block < faceBlocks; ++block) {
+            blockTriangleBase[block + 1] += blockTriangleBase[block];
+        }
+    }
+
+    const size_t indexBase = indices.size();
+    indices.resize(indexBase + blockTriangleBase[faceBlocks] * 3);
+    const ScalarType indexType = faceElement->properties[indexProperty].type;
+    const size_t indexSize = typeSize(indexType);
+    Parallel::forEach(faceBlocks, [&](size_t block) {
+        const size_t last = std::min(faceCount, (block + 1) * RECORDS_PER_BLOCK);
+        uint32_t* out = indices.data() + indexBase + blockTriangleBase[block] * 3;
+        for (size_t face = block * RECORDS_PER_BLOCK; face < last; ++face) {
+            const uint8_t* list = nullptr;
+            const size_t corners = faceIndices(face, list);
+            if (corners < 3) {
+                continue;
+            }
+            auto corner = [&](size_t k) {
+                const int64_t index = readInteger(list + k * indexSize, indexType, swap);
+                if (index < 0 || static_cast<uint64_t>(index) >= vertexCount) {
+                    throw std::runtime_error("PLY face " + std::to_string(face) + " references missing vertex " +
+                                             std::to_string(index) + " in " + path);
+                }
+                return static_cast<uint32_t>(vertexBase + static_cast<size_t>(index));
+            };
+            const uint32_t first = corner(0);
+            uint32_t previous = corner(1);
+            for (size_t k = 2; k < corners; ++k) {
+                const uint32_t current = corner(k);
+                *out++ = first;
+                *out++ = previous;
+                *out++ = current;
+                previous = current;
+            }
+        }
+    }, threadCount_);
+
+    stats_.totalSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+}
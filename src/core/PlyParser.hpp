@@ -0,0 +1,56 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Загрузчик двоичного PLY (binary_little_endian и binary_big_endian)
+ *
+ * Файл отображается в память. Заголовок описывает элементы и их свойства
+ * любых типов, включая списки; у элемента vertex читаются x/y/z, nx/ny/nz,
+ * u/v (или s/t, texture_u/texture_v) и red/green/blue, у элемента face —
+ * список vertex_indices (vertex_index). Остальные свойства и элементы
+ * пропускаются.
+ *
+ * Записи разбираются блоками на нескольких потоках. Если у элемента есть
+ * списки, сначала проверяется, что все записи одной длины (обычный случай:
+ * только треугольники); иначе начала записей находятся одним
+ * последовательным проходом. Многоугольники триангулируются веером.
+ * Вершины в PLY уже индексированы, поэтому склейка не нужна.
+ */
+class PlyParser {
+public:
+    struct Stats {
+        size_t fileSize = 0;       ///< Размер файла в байтах
+        unsigned threadCount = 0;  ///< Сколько потоков разбирало файл
+        size_t faceCount = 0;      ///< Граней в файле (до триангуляции)
+        bool uniformFaces = true;  ///< Все записи граней одной длины: начала записей вычислены без прохода по файлу
+        double totalSeconds = 0.0; ///< Весь load()
+
+        double megabytesPerSecond() const;
+    };
+
+    /**
+     * @param threadCount Число потоков; 0 — по числу ядер
+     */
+    explicit PlyParser(unsigned threadCount = 0);
+
+    /**
+     * @brief Загружает PLY и дописывает результат в vertices/indices
+     * @throws std::runtime_error если файл не открывается, повреждён, текстовый или не содержит граней
+     */
+    void load(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    /// Были ли в последнем load() нормали / цвета вершин (иначе нормали строятся, а цвет белый)
+    bool hasNormals() const { return hasNormals_; }
+    bool hasColors() const { return hasColors_; }
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    unsigned threadCount_;
+    bool hasNormals_ = false;
+    bool hasColors_ = false;
+    Stats stats_;
+};
@@ -0,0 +1,33 @@
+#include "ProcessMemory.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define PSAPI_VERSION 2 // GetProcessMemoryInfo из kernel32, без psapi.lib
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace ProcessMemory {
+    size_t peakResidentBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return 0;
+        }
+        return static_cast<size_t>(counters.PeakWorkingSetSize);
+#else
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);        // В байтах
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024; // В килобайтах
+#endif
+#endif
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+
+namespace ProcessMemory {
+    /**
+     * @brief Пиковый объём физической памяти, занятой процессом (peak RSS / peak working set)
+     * @return Байты; 0, если платформа не сообщает это значение
+     */
+    size_t peakResidentBytes();
+}
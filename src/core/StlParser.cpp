@@ -0,0 +1,104 @@
+#include "StlParser.hpp"
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+#include "VertexWelder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+    constexpr size_t HEADER_SIZE = 80;
+    constexpr size_t RECORD_SIZE = 50;                        // Нормаль, три вершины (float32) и uint16 атрибут
+    constexpr size_t TRIANGLES_PER_BLOCK = 16 * 1024;         // Треугольников на одну задачу потока
+    constexpr size_t PARALLEL_WELD_MIN_CORNERS = 256 * 1024; // Меньшие сетки выгоднее склеивать одним потоком
+
+    /// STL всегда little-endian; целевые платформы тоже, поэтому достаточно невыровненного чтения
+    glm::vec3 loadVec3(const char* data) {
+        float values[3];
+        std::memcpy(values, data, sizeof(values));
+        return {values[0], values[1], values[2]};
+    }
+}
+
+double StlParser::Stats::megabytesPerSecond() const {
+    if (parseSeconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(fileSize) / (1024.0 * 1024.0) / parseSeconds;
+}
+
+StlParser::StlParser(unsigned threadCount, float weldEpsilon)
+    : threadCount_(Parallel::workerCount(threadCount)), weldEpsilon_(weldEpsilon) {}
+
+void StlParser::load(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+
+    MappedFile file(path);
+    stats_ = Stats{};
+    stats_.fileSize = file.size();
+    stats_.threadCount = threadCount_;
+
+    // Размер двоичного файла однозначно задан числом граней; текстовый STL тоже начинается с "solid",
+    // но у двоичного это слово иногда встречается в заголовке, поэтому решает только размер
+    uint32_t triangleCount = 0;
+    if (file.size() >= HEADER_SIZE + sizeof(triangleCount)) {
+        std::memcpy(&triangleCount, file.data() + HEADER_SIZE, sizeof(triangleCount));
+    }
+    const size_t dataOffset = HEADER_SIZE + sizeof(triangleCount);
+    if (file.size() < dataOffset || (file.size() - dataOffset) / RECORD_SIZE != triangleCount ||
+        (file.size() - dataOffset) % RECORD_SIZE != 0) {
+        if (file.size() >= 5 && std::memcmp(file.data(), "solid", 5) == 0) {
+            throw std::runtime_error("ASCII STL is not supported, save " + path + " as binary");
+        }
+        throw std::runtime_error("Invalid binary STL (size does not match the triangle count): " + path);
+    }
+    stats_.triangleCount = triangleCount;
+
+    // 1. Углы треугольников в порядке файла; кроме позиции все атрибуты одинаковы
+    const size_t cornerCount = static_cast<size_t>(triangleCount) * 3;
+    std::vector<Vertex> corners(cornerCount);
+    const char* records = file.data() + dataOffset;
+    const size_t blockCount = (triangleCount + TRIANGLES_PER_BLOCK - 1) / TRIANGLES_PER_BLOCK;
+    Parallel::forEach(blockCount, [&](size_t block) {
+        const size_t last = std::min<size_t>(triangleCount, (block + 1) * TRIANGLES_PER_BLOCK);
+        for (size_t triangle = block * TRIANGLES_PER_BLOCK; triangle < last; ++triangle) {
+            const char* record = records + triangle * RECORD_SIZE;
+            for (size_t k = 0; k < 3; ++k) {
+                Vertex& corner = corners[triangle * 3 + k];
+                corner.pos = loadVec3(record + 12 + k * 12);
+                corner.color = glm::vec3(1.0f);
+                corner.texCoord = glm::vec2(0.0f);
+                corner.normal = glm::vec3(0.0f);
+                corner.tangent = glm::vec4(0.0f);
+            }
+        }
+    }, threadCount_);
+    stats_.parseSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    // 2. Склейка по позиции; результат не зависит от числа потоков
+    const size_t indexBase = indices.size();
+    const unsigned weldThreads = cornerCount >= PARALLEL_WELD_MIN_CORNERS ? threadCount_ : 1;
+    VertexWelder::weldAll(corners, vertices, indices, weldEpsilon_, weldThreads);
+    std::vector<Vertex>().swap(corners);
+
+    // 3. С допуском соседние углы могут слиться в одну вершину: такие треугольники не рисуются
+    size_t kept = indexBase;
+    for (size_t i = indexBase; i < indices.size(); i += 3) {
+        const uint32_t a = indices[i];
+        const uint32_t b = indices[i + 1];
+        const uint32_t c = indices[i + 2];
+        if (a == b || b == c || a == c) {
+            continue;
+        }
+        indices[kept++] = a;
+        indices[kept++] = b;
+        indices[kept++] = c;
+    }
+    stats_.degenerateCount = (indices.size() - kept) / 3;
+    indices.resize(kept);
+
+    stats_.totalSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Загрузчик двоичного STL
+ *
+ * Файл отображается в память: за 80-байтным заголовком и числом граней идут
+ * записи по 50 байт (нормаль грани, три вершины, атрибут). Треугольники STL
+ * не индексированы, поэтому углы разбираются блоками на нескольких потоках и
+ * склеиваются по позиции VertexWelder::weldAll. Нормаль грани отбрасывается:
+ * с ней совпадали бы только углы одной плоскости, а сглаженные нормали
+ * строятся после склейки (TangentSpace). Треугольники, выродившиеся при
+ * склейке с допуском, удаляются.
+ */
+class StlParser {
+public:
+    struct Stats {
+        size_t fileSize = 0;          ///< Размер файла в байтах
+        unsigned threadCount = 0;     ///< Сколько потоков разбирало и склеивало углы
+        size_t triangleCount = 0;     ///< Треугольников в файле
+        size_t degenerateCount = 0;   ///< Удалено выродившихся при склейке
+        double parseSeconds = 0.0;    ///< Разбор записей в углы
+        double totalSeconds = 0.0;    ///< Весь load(), включая склейку
+
+        double megabytesPerSecond() const;
+    };
+
+    /**
+     * @param threadCount Число потоков; 0 — по числу ядер
+     * @param weldEpsilon Шаг сетки для склейки вершин по позиции (см. VertexWelder); 0 — точное сравнение
+     */
+    explicit StlParser(unsigned threadCount = 0, float weldEpsilon = 0.0f);
+
+    /**
+     * @brief Загружает STL и дописывает результат в vertices/indices
+     * @throws std::runtime_error если файл не открывается, повреждён или текстовый (ASCII STL)
+     */
+    void load(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    unsigned threadCount_;
+    float weldEpsilon_;
+    Stats stats_;
+};
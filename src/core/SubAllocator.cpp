@@ -0,0 +1,276 @@
+#include "SubAllocator.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    inline bool isPowerOfTwo(uint64_t value) {
+        return value != 0 && (value & (value - 1)) == 0;
+    }
+}
+
+SubAllocator::SubAllocator(uint64_t blockSize, uint64_t granularity)
+    : blockSize_(std::max(blockSize, CHUNK_SIZE)), granularity_(std::max<uint64_t>(granularity, 1)),
+      partialChunks_(CLASS_COUNT * 2) {
+    if (!isPowerOfTwo(granularity_)) {
+        throw std::runtime_error("Invalid buffer-image granularity");
+    }
+}
+
+size_t SubAllocator::classOf(uint64_t size, uint64_t alignment) {
+    // Слоты выровнены по своему размеру, поэтому класс покрывает и выравнивание
+    const uint64_t footprint = std::max(size, alignment);
+    if (footprint > MAX_CLASS_SIZE) {
+        return CLASS_COUNT;
+    }
+    size_t sizeClass = 0;
+    while (classSize(sizeClass) < footprint) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+SubAllocator::Allocation SubAllocator::allocate(uint64_t size, uint64_t alignment, Kind kind) {
+    if (!isPowerOfTwo(alignment)) {
+        throw std::runtime_error("Allocation alignment must be a power of two");
+    }
+    size = std::max<uint64_t>(size, 1);
+    const size_t sizeClass = classOf(size, alignment);
+    const Allocation allocation = sizeClass < CLASS_COUNT ? allocateSlot(sizeClass, kind, size)
+                                                          : allocateRange(size, alignment, kind);
+    if (allocation.valid()) {
+        ++allocationCount_;
+        allocatedBytes_ += size;
+    }
+    return allocation;
+}
+
+uint32_t SubAllocator::addBlock() {
+    uint32_t id;
+    if (!freeBlockIds_.empty()) {
+        id = freeBlockIds_.back();
+        freeBlockIds_.pop_back();
+    } else {
+        id = static_cast<uint32_t>(blocks_.size());
+        blocks_.emplace_back();
+    }
+    Block& block = blocks_[id];
+    block.live = true;
+    block.freeRanges = {{0, blockSize_}};
+    block.used.clear();
+    ++emptyBlocks_;
+    return id;
+}
+
+uint32_t SubAllocator::free(const Allocation& allocation) {
+    if (!allocation.valid()) {
+        return NO_BLOCK;
+    }
+    --allocationCount_;
+    allocatedBytes_ -= allocation.size;
+    return allocation.chunk != NO_CHUNK ? freeSlot(allocation) : freeRange(allocation.block, allocation.offset);
+}
+
+bool SubAllocator::conflictsBefore(const Block& block, uint64_t start, Kind kind) const {
+    if (granularity_ == 1) {
+        return false;
+    }
+    // Ресурсы не пересекаются и упорядочены: как только один кончается на более ранней странице, дальше искать нечего
+    auto it = block.used.lower_bound(start);
+    while (it != block.used.begin()) {
+        --it;
+        if (page(it->first + it->second.size - 1) != page(start)) {
+            break;
+        }
+        if (it->second.kind != kind) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SubAllocator::conflictsAfter(const Block& block, uint64_t end, Kind kind) const {
+    if (granularity_ == 1) {
+        return false;
+    }
+    for (auto it = block.used.lower_bound(end); it != block.used.end() && page(it->first) == page(end - 1); ++it) {
+        if (it->second.kind != kind) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SubAllocator::placeInBlock(uint32_t id, uint64_t size, uint64_t alignment, Kind kind, uint64_t& offset) {
+    Block& block = blocks_[id];
+    for (auto range = block.freeRanges.begin(); range != block.freeRanges.end(); ++range) {
+        const uint64_t rangeStart = range->first;
+        const uint64_t rangeEnd = range->first + range->second;
+        uint64_t start = alignUp(rangeStart, alignment);
+        if (conflictsBefore(block, start, kind)) {
+            start = alignUp(start, std::max(alignment, granularity_));
+        }
+        const uint64_t end = start + size;
+        if (end > rangeEnd || conflictsAfter(block, end, kind)) {
+            continue;
+        }
+
+        if (block.used.empty()) {
+            --emptyBlocks_;
+        }
+        block.freeRanges.erase(range);
+        if (start > rangeStart) {
+            block.freeRanges[rangeStart] = start - rangeStart;
+        }
+        if (end < rangeEnd) {
+            block.freeRanges[end] = rangeEnd - end;
+        }
+        block.used[start] = Range{size, kind};
+        offset = start;
+        return true;
+    }
+    return false;
+}
+
+SubAllocator::Allocation SubAllocator::allocateRange(uint64_t size, uint64_t alignment, Kind kind) {
+    Allocation allocation;
+    if (size > blockSize_) {
+        return allocation;
+    }
+    for (uint32_t id = 0; id < blocks_.size(); ++id) {
+        if (blocks_[id].live && placeInBlock(id, size, alignment, kind, allocation.offset)) {
+            allocation.block = id;
+            allocation.size = size;
+            return allocation;
+        }
+    }
+    return allocation;
+}
+
+uint32_t SubAllocator::freeRange(uint32_t id, uint64_t offset) {
+    Block& block = blocks_[id];
+    auto used = block.used.find(offset);
+    if (used == block.used.end()) {
+        throw std::runtime_error("Freeing memory that was not allocated");
+    }
+    uint64_t size = used->second.size;
+    block.used.erase(used);
+
+    // Слияние с соседними свободными диапазонами
+    auto next = block.freeRanges.lower_bound(offset);
+    if (next != block.freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            block.freeRanges.erase(previous);
+        }
+    }
+    if (next != block.freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        block.freeRanges.erase(next);
+    }
+    block.freeRanges[offset] = size;
+
+    if (!block.used.empty()) {
+        return NO_BLOCK;
+    }
+    if (emptyBlocks_ == 0) {
+        ++emptyBlocks_; // Первый пустой блок остаётся про запас
+        return NO_BLOCK;
+    }
+    block.live = false;
+    block.freeRanges.clear();
+    freeBlockIds_.push_back(id);
+    return id;
+}
+
+SubAllocator::Allocation SubAllocator::allocateSlot(size_t sizeClass, Kind kind, uint64_t size) {
+    std::vector<uint32_t>& partial = partialChunks(sizeClass, kind);
+    if (partial.empty()) {
+        // Новый участок выровнен по размеру слота, поэтому выровнен каждый слот
+        const Allocation range = allocateRange(CHUNK_SIZE, classSize(sizeClass), kind);
+        if (!range.valid()) {
+            return range;
+        }
+
+        uint32_t id;
+        if (!freeChunkIds_.empty()) {
+            id = freeChunkIds_.back();
+            freeChunkIds_.pop_back();
+        } else {
+            id = static_cast<uint32_t>(chunks_.size());
+            chunks_.emplace_back();
+        }
+        Chunk& chunk = chunks_[id];
+        chunk.block = range.block;
+        chunk.offset = range.offset;
+        chunk.sizeClass = sizeClass;
+        chunk.kind = kind;
+        chunk.freeSlots.clear();
+        // Свободные слоты берутся с конца: первым выдаётся слот 0
+        for (uint32_t slot = static_cast<uint32_t>(CHUNK_SIZE / classSize(sizeClass)); slot-- > 0;) {
+            chunk.freeSlots.push_back(slot);
+        }
+        partial.push_back(id);
+    }
+
+    const uint32_t id = partial.back();
+    Chunk& chunk = chunks_[id];
+    const uint32_t slot = chunk.freeSlots.back();
+    chunk.freeSlots.pop_back();
+    if (chunk.freeSlots.empty()) {
+        partial.pop_back();
+    }
+
+    Allocation allocation;
+    allocation.block = chunk.block;
+    allocation.chunk = id;
+    allocation.offset = chunk.offset + slot * classSize(chunk.sizeClass);
+    allocation.size = size;
+    return allocation;
+}
+
+uint32_t SubAllocator::freeSlot(const Allocation& allocation) {
+    Chunk& chunk = chunks_[allocation.chunk];
+    const uint64_t slotSize = classSize(chunk.sizeClass);
+    const uint32_t slotCount = static_cast<uint32_t>(CHUNK_SIZE / slotSize);
+    std::vector<uint32_t>& partial = partialChunks(chunk.sizeClass, chunk.kind);
+    chunk.freeSlots.push_back(static_cast<uint32_t>((allocation.offset - chunk.offset) / slotSize));
+    if (chunk.freeSlots.size() == 1) {
+        partial.push_back(allocation.chunk);
+    }
+    if (chunk.freeSlots.size() < slotCount) {
+        return NO_BLOCK;
+    }
+
+    // Участок опустел: его диапазон возвращается блоку
+    partial.erase(std::find(partial.begin(), partial.end(), allocation.chunk));
+    chunk.freeSlots.clear();
+    freeChunkIds_.push_back(allocation.chunk);
+    return freeRange(chunk.block, chunk.offset);
+}
+
+SubAllocator::Stats SubAllocator::stats() const {
+    Stats stats;
+    for (const Block& block : blocks_) {
+        if (!block.live) {
+            continue;
+        }
+        ++stats.blockCount;
+        stats.blockBytes += blockSize_;
+        for (const auto& range : block.freeRanges) {
+            ++stats.freeRangeCount;
+            stats.freeBytes += range.second;
+            stats.largestFreeRange = std::max(stats.largestFreeRange, range.second);
+        }
+    }
+    stats.allocationCount = allocationCount_;
+    stats.allocatedBytes = allocatedBytes_;
+    stats.chunkCount = chunks_.size() - freeChunkIds_.size();
+    return stats;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * @brief Размещение ресурсов внутри крупных блоков памяти одного типа
+ *
+ * Логика без Vulkan: блоки — это номера, а места — смещения; сами
+ * VkDeviceMemory держит MemoryAllocator. Мелкие ресурсы (до MAX_CLASS_SIZE)
+ * берутся из классов размеров: участок блока CHUNK_SIZE делится на слоты
+ * одной степени двойки, и освобождённый слот сразу готов к повторному
+ * использованию. Крупные размещаются первым подходящим свободным диапазоном
+ * блока; соседние свободные диапазоны при освобождении сливаются.
+ *
+ * Ресурсы разного вида (Kind) не делят страницу bufferImageGranularity:
+ * такой сосед сдвигает начало на следующую страницу или отвергает диапазон.
+ * Пустой блок отдаётся обратно, только если есть ещё один пустой, — так
+ * повторяющиеся staging-буферы не выделяют память заново.
+ */
+class SubAllocator {
+public:
+    static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+    static constexpr uint32_t NO_CHUNK = UINT32_MAX;
+    static constexpr uint64_t MIN_CLASS_SIZE = 256;
+    static constexpr uint64_t MAX_CLASS_SIZE = 64 * 1024; ///< Больше — из свободных диапазонов блока
+    static constexpr size_t CLASS_COUNT = 9;              ///< 256 Б, 512 Б, ..., 64 КБ
+    static constexpr uint64_t CHUNK_SIZE = 1024 * 1024;   ///< Участок блока под слоты одного класса
+
+    /// Буферы и линейные изображения или изображения с VK_IMAGE_TILING_OPTIMAL
+    enum class Kind : uint8_t { LINEAR, OPTIMAL };
+
+    struct Allocation {
+        uint32_t block = NO_BLOCK;
+        uint32_t chunk = NO_CHUNK; ///< Участок класса размеров или NO_CHUNK
+        uint64_t offset = 0;
+        uint64_t size = 0;         ///< Запрошенный размер
+
+        bool valid() const { return block != NO_BLOCK; }
+    };
+
+    struct Stats {
+        uint32_t blockCount = 0;
+        uint64_t blockBytes = 0;
+        size_t allocationCount = 0;
+        uint64_t allocatedBytes = 0; ///< Сумма запрошенных размеров
+        size_t chunkCount = 0;
+        size_t freeRangeCount = 0;
+        uint64_t freeBytes = 0;      ///< Вне участков и ресурсов
+        uint64_t largestFreeRange = 0;
+    };
+
+    /**
+     * @param blockSize Размер блока, не меньше CHUNK_SIZE
+     * @param granularity bufferImageGranularity устройства, степень двойки
+     */
+    SubAllocator(uint64_t blockSize, uint64_t granularity);
+
+    /**
+     * @brief Ищет место в имеющихся блоках
+     * @param alignment Степень двойки
+     * @return Недействительное размещение, если места нет: нужен addBlock() и повтор
+     */
+    Allocation allocate(uint64_t size, uint64_t alignment, Kind kind);
+
+    /// Добавляет пустой блок; номер освобождённого блока выдаётся повторно
+    uint32_t addBlock();
+
+    /**
+     * @brief Возвращает место
+     * @return Номер блока, который опустел и больше не используется, или NO_BLOCK
+     */
+    uint32_t free(const Allocation& allocation);
+
+    Stats stats() const;
+    uint64_t blockSize() const { return blockSize_; }
+
+    /// Класс размеров ресурса или CLASS_COUNT, если он размещается диапазоном
+    static size_t classOf(uint64_t size, uint64_t alignment);
+    static uint64_t classSize(size_t sizeClass) { return MIN_CLASS_SIZE << sizeClass; }
+
+private:
+    struct Range {
+        uint64_t size = 0;
+        Kind kind = Kind::LINEAR;
+    };
+
+    struct Block {
+        bool live = false;
+        std::map<uint64_t, uint64_t> freeRanges; ///< Смещение -> размер
+        std::map<uint64_t, Range> used;          ///< Ресурсы и участки классов
+    };
+
+    struct Chunk {
+        uint32_t block = NO_BLOCK;
+        uint64_t offset = 0;
+        size_t sizeClass = 0;
+        Kind kind = Kind::LINEAR;
+        std::vector<uint32_t> freeSlots;
+    };
+
+    bool placeInBlock(uint32_t block, uint64_t size, uint64_t alignment, Kind kind, uint64_t& offset);
+    /// Делит ли ресурс другого вида, лежащий до start, с ним страницу
+    bool conflictsBefore(const Block& block, uint64_t start, Kind kind) const;
+    /// Делит ли ресурс другого вида, лежащий с end, страницу с последним байтом [.., end)
+    bool conflictsAfter(const Block& block, uint64_t end, Kind kind) const;
+    Allocation allocateRange(uint64_t size, uint64_t alignment, Kind kind);
+    uint32_t freeRange(uint32_t block, uint64_t offset);
+    Allocation allocateSlot(size_t sizeClass, Kind kind, uint64_t size);
+    uint32_t freeSlot(const Allocation& allocation);
+    uint64_t page(uint64_t offset) const { return offset / granularity_; }
+    std::vector<uint32_t>& partialChunks(size_t sizeClass, Kind kind) {
+        return partialChunks_[sizeClass * 2 + static_cast<size_t>(kind)];
+    }
+
+    uint64_t blockSize_;
+    uint64_t granularity_;
+    std::vector<Block> blocks_;
+    std::vector<uint32_t> freeBlockIds_;
+    uint32_t emptyBlocks_ = 0;
+    std::vector<Chunk> chunks_;
+    std::vector<uint32_t> freeChunkIds_;
+    std::vector<std::vector<uint32_t>> partialChunks_; ///< Участки со свободными слотами по классу и виду
+    size_t allocationCount_ = 0;
+    uint64_t allocatedBytes_ = 0;
+};
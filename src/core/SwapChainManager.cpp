@@ -5,8 +5,7 @@ SwapChainManager::SwapChainManager(DeviceManager& deviceManager, SurfaceManager&
   swapChain(nullptr, VulkanDeleter<VkSwapchainKHR_T, vkDestroySwapchainKHR, VkDevice>(deviceManager.device())),
   renderPass(nullptr, VulkanDeleter<VkRenderPass_T, vkDestroyRenderPass, VkDevice>(nullptr)),
   depthImageView(nullptr, VulkanDeleter<VkImageView_T, vkDestroyImageView, VkDevice>(nullptr)),
-depthImage(nullptr, VulkanDeleter<VkImage_T, vkDestroyImage, VkDevice>(nullptr)),
-depthImageMemory(nullptr, VulkanDeleter<VkDeviceMemory_T, vkFreeMemory, VkDevice>(nullptr))
+depthImage(nullptr, VulkanDeleter<VkImage_T, vkDestroyImage, VkDevice>(nullptr))
   {
     createSwapChain();
 
@@ -78,7 +77,8 @@ void SwapChainManager::createSwapChain() {
     swapChainExtent = extent;
 }
 
-VkImageViewPtr SwapChainManager::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags) {
+VkImageViewPtr SwapChainManager::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
+                                                 uint32_t mipLevels) {
         VkImageViewCreateInfo viewInfo{};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewInfo.image = image;
@@ -86,7 +86,7 @@ VkImageViewPtr SwapChainManager::createImageView(VkImage image, VkFormat format,
         viewInfo.format = format;
         viewInfo.subresourceRange.aspectMask = aspectFlags;
         viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1; // Не используем минимаппинг
+        viewInfo.subresourceRange.levelCount = mipLevels; // Все уровни изображения доступны сэмплеру
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount = 1; // Не используем текстуру-массив
 
@@ -214,7 +214,7 @@ void SwapChainManager::createImage(uint32_t width,
                                 VkImageUsageFlags usage,
                                 VkMemoryPropertyFlags properties,
                                 VkImagePtr& image,
-                                VkDeviceMemoryPtr& imageMemory) 
+                                MemoryAllocation& imageMemory) 
 {
 
     VkImageCreateInfo imageInfo{};
@@ -239,22 +239,8 @@ void SwapChainManager::createImage(uint32_t width,
     image.reset(rawImage); // Передаем владение умному указателю
 
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(deviceManager.device(), image.get(), &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{}; //Выделям память
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = VulkanUtils::findMemoryType(deviceManager.physicalDevice(), memRequirements.memoryTypeBits, properties);
-
-    VkDeviceMemory rawMemory;
-    if (vkAllocateMemory(deviceManager.device(), &allocInfo, nullptr, &rawMemory) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate image memory!");
-    }
-    imageMemory.reset(rawMemory);
-
-    
-    vkBindImageMemory(deviceManager.device(), image.get(), imageMemory.get(), 0); // привязываем память к изображению 
+    // Выделяем место в блоке MemoryAllocator и привязываем его к изображению
+    imageMemory = deviceManager.allocator().allocateImage(image.get(), properties, tiling);
 }
 
 void SwapChainManager::createDepthResources() {
@@ -3,6 +3,7 @@
 #include <vector>
 #include <algorithm>
 #include <limits>
+#include <mutex>
 #include "DeviceManager.hpp"
 #include "VulkanTypes.hpp"
 #include "SurfaceManager.hpp"
@@ -28,6 +29,8 @@ class SwapChainManager{
         VkQueue getPresentQueue() const {
             return presentQueue;
         }
+        /// Захватывается на время vkQueueSubmit/vkQueuePresentKHR: ресурсы модели загружаются с фонового потока
+        std::mutex& getQueueMutex() const { return queueMutex; }
         void setDepthImageView(VkImageViewPtr depthImgView) { depthImageView = std::move(depthImgView); }
         VkImageView getDepthImageView() const {return depthImageView.get(); }
 
@@ -35,7 +38,8 @@ class SwapChainManager{
 
         VkSwapchainKHR getSwapChain() const { return swapChain.get();}
         VkRenderPass getRenderPass() const { return renderPass.get();}
-        VkImageViewPtr createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
+        VkImageViewPtr createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
+            uint32_t mipLevels = 1);
 
         void createImage(uint32_t width,
                     uint32_t height,
@@ -44,7 +48,7 @@ class SwapChainManager{
                     VkImageUsageFlags usage,
                     VkMemoryPropertyFlags properties,
                     VkImagePtr& image,
-                    VkDeviceMemoryPtr& imageMemory);
+                    MemoryAllocation& imageMemory);
                     
     private:
         DeviceManager& deviceManager;
@@ -56,15 +60,16 @@ class SwapChainManager{
 
         VkQueue graphicsQueue;                 
         VkQueue presentQueue;                  
+        mutable std::mutex queueMutex; ///< Очереди Vulkan требуют внешней синхронизации
 
         std::vector<VkImage> swapChainImages;    
         VkFormat swapChainImageFormat;
         VkExtent2D swapChainExtent;
         std::vector<VkImageViewPtr> swapChainImageViews;
 
+        MemoryAllocation depthImageMemory;
         VkImageViewPtr depthImageView;
         VkImagePtr depthImage;
-        VkDeviceMemoryPtr depthImageMemory;
 
         void createDepthResources();
         void createSwapChain();
@@ -0,0 +1,288 @@
+#include "TangentSpace.hpp"
+#include "Parallel.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief Сколько потоков могут держать по накопителю на elementCount элементов в пределах бюджета
+     */
+    unsigned accumulatorThreads(unsigned requested, size_t elementCount, size_t elementSize, size_t triangleCount) {
+        const size_t perThread = std::max<size_t>(1, elementCount * elementSize);
+        const size_t byBudget = std::max<size_t>(1, TangentSpace::ACCUMULATOR_BUDGET / perThread);
+        const size_t byWork = std::max<size_t>(1, triangleCount / 4096); // Мелкие сетки не стоят запуска потоков
+        return static_cast<unsigned>(std::min({static_cast<size_t>(Parallel::workerCount(requested)), byBudget, byWork}));
+    }
+
+    /// fn(i) для i в [0, count): каждый поток берёт непрерывный диапазон, чтобы не делить строки кэша
+    template <typename Fn>
+    void forEachRange(size_t count, unsigned threads, Fn&& fn) {
+        Parallel::forEach(threads, [&](size_t t) {
+            const size_t end = count * (t + 1) / threads;
+            for (size_t i = count * t / threads; i < end; ++i) {
+                fn(i);
+            }
+        }, threads);
+    }
+
+    /**
+     * @brief Раскидывает треугольники по накопителям потоков и складывает накопители
+     *
+     * scatter(triangle, accumulator) добавляет вклад одного треугольника; результат
+     * сложения по всем потокам остаётся в первом накопителе.
+     */
+    template <typename T, typename Scatter>
+    std::vector<T> accumulate(size_t elementCount, size_t triangleCount, unsigned threads, Scatter scatter) {
+        std::vector<std::vector<T>> accumulators(threads);
+        Parallel::forEach(threads, [&](size_t t) {
+            accumulators[t].assign(elementCount, T{});
+            const size_t end = triangleCount * (t + 1) / threads;
+            for (size_t triangle = triangleCount * t / threads; triangle < end; ++triangle) {
+                scatter(triangle, accumulators[t].data());
+            }
+        }, threads);
+
+        // Сложение по диапазонам элементов: каждый поток читает все накопители, но пишет только свой диапазон
+        std::vector<T> total = std::move(accumulators[0]);
+        forEachRange(elementCount, threads, [&](size_t i) {
+            for (size_t other = 1; other < accumulators.size(); ++other) {
+                total[i] += accumulators[other][i];
+            }
+        });
+        return total;
+    }
+
+    /// Угол между векторами; 0, если один из них нулевой
+    float angleBetween(const glm::vec3& u, const glm::vec3& v) {
+        const float lengths = std::sqrt(glm::dot(u, u) * glm::dot(v, v));
+        if (lengths <= 0.0f) {
+            return 0.0f;
+        }
+        return std::acos(std::clamp(glm::dot(u, v) / lengths, -1.0f, 1.0f));
+    }
+
+    /// Угол треугольника при вершине a
+    float cornerAngle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        return angleBetween(b - a, c - a);
+    }
+
+    /// Удвоенная ориентированная площадь треугольника в UV: знак отличает прямую развёртку от отражённой
+    float uvArea(const Vertex& v0, const Vertex& v1, const Vertex& v2) {
+        const glm::vec2 d1 = v1.texCoord - v0.texCoord;
+        const glm::vec2 d2 = v2.texCoord - v0.texCoord;
+        return d1.x * d2.y - d2.x * d1.y;
+    }
+
+    /// Любой единичный вектор, перпендикулярный n
+    glm::vec3 anyPerpendicular(const glm::vec3& n) {
+        const glm::vec3 axis = std::fabs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        return glm::normalize(glm::cross(axis, n));
+    }
+
+    /// Касательные по вершине отдельно от граней с прямой (0) и отражённой (1) развёрткой
+    struct TangentSum {
+        glm::vec3 tangent[2] = {glm::vec3(0.0f), glm::vec3(0.0f)};
+        uint32_t faces[2] = {0, 0};
+
+        TangentSum& operator+=(const TangentSum& other) {
+            for (int orientation = 0; orientation < 2; ++orientation) {
+                tangent[orientation] += other.tangent[orientation];
+                faces[orientation] += other.faces[orientation];
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Номер уникальной позиции для каждой вершины (хеш-таблица с открытой адресацией)
+     *
+     * Ключ — только три float позиции, поэтому это заметно дешевле полной склейки
+     * VertexWelder; -0.0 и 0.0 считаются одной позицией.
+     */
+    std::vector<uint32_t> positionIds(const std::vector<Vertex>& vertices, size_t& positionCount) {
+        constexpr uint32_t EMPTY = UINT32_MAX;
+        constexpr uint32_t NEGATIVE_ZERO = 0x80000000u;
+        auto key = [&](size_t i, uint32_t words[3]) {
+            std::memcpy(words, &vertices[i].pos, sizeof(uint32_t) * 3);
+            for (int k = 0; k < 3; ++k) {
+                if (words[k] == NEGATIVE_ZERO) {
+                    words[k] = 0;
+                }
+            }
+        };
+
+        size_t capacity = 64;
+        while (capacity * 7 < vertices.size() * 10) { // Загрузка не выше 7/10
+            capacity *= 2;
+        }
+        const size_t mask = capacity - 1;
+        std::vector<uint32_t> slots(capacity, EMPTY); // Вершина-представитель позиции
+        std::vector<uint32_t> ids(vertices.size());
+        positionCount = 0;
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            uint32_t words[3];
+            key(i, words);
+            size_t slot = static_cast<size_t>(Hash::bytes(words, sizeof(words))) & mask;
+            for (;;) {
+                if (slots[slot] == EMPTY) {
+                    slots[slot] = static_cast<uint32_t>(i);
+                    ids[i] = static_cast<uint32_t>(positionCount++);
+                    break;
+                }
+                uint32_t other[3];
+                key(slots[slot], other);
+                if (std::memcmp(words, other, sizeof(words)) == 0) {
+                    ids[i] = ids[slots[slot]];
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+        return ids;
+    }
+
+    void checkIndices(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        for (uint32_t index : indices) {
+            if (index >= vertices.size()) {
+                throw std::runtime_error("Vertex index out of range in tangent space generation");
+            }
+        }
+    }
+}
+
+namespace TangentSpace {
+
+    bool hasNormals(const std::vector<Vertex>& vertices) {
+        return std::any_of(vertices.begin(), vertices.end(), [](const Vertex& vertex) {
+            return vertex.normal != glm::vec3(0.0f);
+        });
+    }
+
+    void generateNormals(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, unsigned threadCount) {
+        checkIndices(vertices, indices);
+        const size_t triangleCount = indices.size() / 3;
+
+        size_t positionCount = 0;
+        const std::vector<uint32_t> positionOf = positionIds(vertices, positionCount);
+
+        const unsigned threads = accumulatorThreads(threadCount, positionCount, sizeof(glm::vec3), triangleCount);
+        std::vector<glm::vec3> sums = accumulate<glm::vec3>(positionCount, triangleCount, threads,
+            [&](size_t triangle, glm::vec3* sum) {
+                const uint32_t* corner = &indices[triangle * 3];
+                const glm::vec3& a = vertices[corner[0]].pos;
+                const glm::vec3& b = vertices[corner[1]].pos;
+                const glm::vec3& c = vertices[corner[2]].pos;
+                const glm::vec3 faceNormal = glm::cross(b - a, c - a); // Длина — удвоенная площадь
+                if (faceNormal == glm::vec3(0.0f)) {
+                    return;
+                }
+                sum[positionOf[corner[0]]] += faceNormal * cornerAngle(a, b, c);
+                sum[positionOf[corner[1]]] += faceNormal * cornerAngle(b, c, a);
+                sum[positionOf[corner[2]]] += faceNormal * cornerAngle(c, a, b);
+            });
+
+        forEachRange(vertices.size(), threads, [&](size_t i) {
+            const glm::vec3& sum = sums[positionOf[i]];
+            const float length = glm::length(sum);
+            vertices[i].normal = length > 0.0f ? sum / length : glm::vec3(0.0f);
+        });
+    }
+
+    void generateTangents(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, unsigned threadCount) {
+        checkIndices(vertices, indices);
+        const size_t triangleCount = indices.size() / 3;
+        const size_t vertexCount = vertices.size();
+
+        const unsigned threads = accumulatorThreads(threadCount, vertexCount, sizeof(TangentSum), triangleCount);
+        std::vector<TangentSum> sums = accumulate<TangentSum>(vertexCount, triangleCount, threads,
+            [&](size_t triangle, TangentSum* sum) {
+                const uint32_t* corner = &indices[triangle * 3];
+                const Vertex* v[3] = {&vertices[corner[0]], &vertices[corner[1]], &vertices[corner[2]]};
+                const float area = uvArea(*v[0], *v[1], *v[2]);
+                if (area == 0.0f || !std::isfinite(area)) {
+                    return; // Вырожденная развёртка: грань не задаёт направления
+                }
+                // Направление роста u, без деления на площадь UV: как и в MikkTSpace, длина не важна
+                const glm::vec3 e1 = v[1]->pos - v[0]->pos;
+                const glm::vec3 e2 = v[2]->pos - v[0]->pos;
+                const glm::vec2 d1 = v[1]->texCoord - v[0]->texCoord;
+                const glm::vec2 d2 = v[2]->texCoord - v[0]->texCoord;
+                const glm::vec3 faceTangent = (e1 * d2.y - e2 * d1.y) * (area > 0.0f ? 1.0f : -1.0f);
+                if (faceTangent == glm::vec3(0.0f)) {
+                    return;
+                }
+
+                const int orientation = area > 0.0f ? 0 : 1;
+                for (int k = 0; k < 3; ++k) {
+                    // Каждый угол голосует единичной проекцией касательной грани на плоскость своей нормали
+                    // с весом угла грани в этой плоскости
+                    const glm::vec3& n = v[k]->normal;
+                    const glm::vec3 projected = faceTangent - n * glm::dot(n, faceTangent);
+                    const float length = glm::length(projected);
+                    TangentSum& target = sum[corner[k]];
+                    target.faces[orientation] += 1;
+                    if (length > 0.0f) {
+                        const glm::vec3& a = v[k]->pos;
+                        const glm::vec3 b = v[(k + 1) % 3]->pos - a;
+                        const glm::vec3 c = v[(k + 2) % 3]->pos - a;
+                        const float angle = angleBetween(b - n * glm::dot(n, b), c - n * glm::dot(n, c));
+                        target.tangent[orientation] += projected / length * angle;
+                    }
+                }
+            });
+
+        // Вершина, у которой есть грани обеих ориентаций развёртки (шов зеркальной UV), делится:
+        // исходная остаётся граням с прямой развёрткой, отражённые получают копию в конце массива
+        constexpr uint32_t NO_COPY = UINT32_MAX;
+        std::vector<uint32_t> copyOf(vertexCount, NO_COPY);
+        size_t nextVertex = vertexCount;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            if (sums[i].faces[0] > 0 && sums[i].faces[1] > 0) {
+                copyOf[i] = static_cast<uint32_t>(nextVertex++);
+            }
+        }
+        if (nextVertex > UINT32_MAX) {
+            throw std::runtime_error("Too many vertices after splitting mirrored UV seams");
+        }
+        vertices.resize(nextVertex);
+
+        auto tangentFrame = [](const glm::vec3& n, const glm::vec3& sum, int orientation) {
+            if (n == glm::vec3(0.0f)) {
+                return glm::vec4(0.0f);
+            }
+            const float length = glm::length(sum);
+            const glm::vec3 tangent = length > 1e-12f ? sum / length : anyPerpendicular(n);
+            return glm::vec4(tangent, orientation == 0 ? 1.0f : -1.0f);
+        };
+        forEachRange(vertexCount, threads, [&](size_t i) {
+            const TangentSum& sum = sums[i];
+            Vertex& vertex = vertices[i];
+            const int kept = sum.faces[0] == 0 && sum.faces[1] > 0 ? 1 : 0;
+            vertex.tangent = tangentFrame(vertex.normal, sum.tangent[kept], kept);
+            if (copyOf[i] != NO_COPY) {
+                Vertex& copy = vertices[copyOf[i]];
+                copy = vertex;
+                copy.tangent = tangentFrame(vertex.normal, sum.tangent[1], 1);
+            }
+        });
+
+        if (nextVertex == vertexCount) {
+            return;
+        }
+        forEachRange(triangleCount, threads, [&](size_t triangle) {
+            uint32_t* corner = &indices[triangle * 3];
+            if (!(uvArea(vertices[corner[0]], vertices[corner[1]], vertices[corner[2]]) < 0.0f)) {
+                return;
+            }
+            for (int k = 0; k < 3; ++k) {
+                if (copyOf[corner[k]] != NO_COPY) {
+                    corner[k] = copyOf[corner[k]];
+                }
+            }
+        });
+    }
+}
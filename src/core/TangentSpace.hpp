@@ -0,0 +1,45 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Генерация нормалей и касательных для сеток, в которых их нет
+ *
+ * Треугольники делятся между потоками непрерывными диапазонами; каждый поток
+ * копит суммы в собственном массиве (без атомарных операций), затем массивы
+ * складываются по диапазонам вершин. Суммирование идёт в порядке потоков,
+ * поэтому при одном и том же числе потоков результат повторяется бит в бит.
+ */
+namespace TangentSpace {
+    /// Предел памяти под накопители всех потоков; при большой сетке потоков становится меньше
+    constexpr size_t ACCUMULATOR_BUDGET = size_t{256} << 20;
+
+    /**
+     * @brief Есть ли в сетке хотя бы одна ненулевая нормаль
+     */
+    bool hasNormals(const std::vector<Vertex>& vertices);
+
+    /**
+     * @brief Гладкие нормали: сумма нормалей граней с весом площадь * угол при вершине
+     *
+     * Вершины с одинаковой позицией (швы UV) получают одну и ту же нормаль, поэтому
+     * шов не даёт излома освещения. Вершины без граней получают нулевую нормаль.
+     * @param threadCount Число потоков; 0 — по числу ядер
+     */
+    void generateNormals(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, unsigned threadCount = 0);
+
+    /**
+     * @brief Касательные по алгоритму MikkTSpace
+     *
+     * Касательная грани (направление роста u) для каждого угла проецируется на плоскость
+     * нормали вершины, нормируется и копится с весом угла грани в этой плоскости. Грани
+     * с прямой и отражённой развёрткой копятся раздельно: вершина, где сходятся обе,
+     * дублируется (копия добавляется в конец vertices), и индексы отражённых граней
+     * переводятся на копию. В tangent.w записывается знак базиса: бикасательная в шейдере
+     * восстанавливается как tangent.w * cross(normal, tangent.xyz). Нормали должны быть
+     * уже заполнены. Если UV вырождены, берётся любая касательная, перпендикулярная нормали.
+     */
+    void generateTangents(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, unsigned threadCount = 0);
+}
@@ -0,0 +1,170 @@
+#include "TextureCache.hpp"
+#include "Hash.hpp"
+#include "MipChain.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char CACHE_MAGIC[8] = {'V', 'K', 'T', 'E', 'X', 0, 0, 0};
+
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool isEntry(const std::filesystem::directory_entry& entry) {
+        std::error_code error;
+        return entry.is_regular_file(error) && entry.path().extension() == TextureCache::EXTENSION;
+    }
+}
+
+TextureCache::TextureCache(std::string directory, uint64_t maxBytes)
+    : directory_(std::move(directory)), maxBytes_(maxBytes) {
+}
+
+std::string TextureCache::entryPath(uint64_t sourceHash) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(sourceHash));
+    return (std::filesystem::path(directory_) / (std::string(name) + EXTENSION)).string();
+}
+
+std::unique_ptr<TextureCache::Entry> TextureCache::open(const void* source, size_t sourceSize) const {
+    const uint64_t sourceHash = Hash::bytes(source, sourceSize);
+    const std::string path = entryPath(sourceHash);
+
+    // Время изменения — метка для LRU. Обновляется до отображения: на Windows отображённый файл не изменить
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    if (error) {
+        return nullptr; // Записи нет
+    }
+
+    std::unique_ptr<MappedFile> file;
+    try {
+        file = std::make_unique<MappedFile>(path);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+    if (file->size() < sizeof(Header)) {
+        return nullptr;
+    }
+    Header header;
+    std::memcpy(&header, file->data(), sizeof(Header));
+    const bool valid =
+        std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+        header.version == VERSION &&
+        header.sourceSize == sourceSize &&
+        header.sourceHash == sourceHash &&
+        header.width > 0 && header.height > 0 &&
+        header.mipLevels == MipChain::levelCount(header.width, header.height) &&
+        header.dataSize == MipChain::chainSize(header.width, header.height) &&
+        header.dataOffset % PAGE_SIZE == 0 &&
+        header.dataOffset <= file->size() &&
+        header.dataSize <= file->size() - header.dataOffset;
+    if (!valid) {
+        return nullptr;
+    }
+    return std::make_unique<Entry>(std::move(*file), header);
+}
+
+bool TextureCache::store(const void* source, size_t sourceSize, uint32_t width, uint32_t height,
+                         const uint8_t* base, const uint8_t* mipTail) const {
+    Header header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.width = width;
+    header.height = height;
+    header.mipLevels = MipChain::levelCount(width, height);
+    header.sourceSize = sourceSize;
+    header.sourceHash = Hash::bytes(source, sourceSize);
+    header.dataOffset = alignUp(sizeof(Header), PAGE_SIZE);
+    header.dataSize = MipChain::chainSize(width, height);
+    const size_t baseSize = size_t{width} * height * 4;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    const std::string path = entryPath(header.sourceHash);
+    // Одно изображение может записываться с нескольких потоков сразу (заглушка и модель): у каждого свой файл
+    const std::string tmpPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+                                ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Failed to write texture cache: " << tmpPath << std::endl;
+            return false;
+        }
+        const std::vector<char> padding(header.dataOffset - sizeof(Header), 0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out.write(reinterpret_cast<const char*>(base), static_cast<std::streamsize>(baseSize));
+        out.write(reinterpret_cast<const char*>(mipTail), static_cast<std::streamsize>(header.dataSize - baseSize));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, error);
+            std::cerr << "Failed to write texture cache: " << tmpPath << std::endl;
+            return false;
+        }
+    }
+
+    // Переименование атомарно: другой процесс не увидит наполовину записанную запись
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        std::filesystem::remove(tmpPath, error);
+        std::cerr << "Failed to write texture cache: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint64_t TextureCache::totalBytes() const {
+    uint64_t total = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, error)) {
+        if (isEntry(entry)) {
+            total += entry.file_size(error);
+        }
+    }
+    return total;
+}
+
+uint64_t TextureCache::evict() const {
+    struct CachedFile {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUse;
+        uint64_t size;
+    };
+    std::vector<CachedFile> files;
+    uint64_t total = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, error)) {
+        if (!isEntry(entry)) {
+            continue;
+        }
+        CachedFile file{entry.path(), entry.last_write_time(error), entry.file_size(error)};
+        if (!error) {
+            files.push_back(file);
+            total += file.size;
+        }
+    }
+
+    std::sort(files.begin(), files.end(), [](const CachedFile& a, const CachedFile& b) {
+        return a.lastUse < b.lastUse;
+    });
+    uint64_t removed = 0;
+    for (const CachedFile& file : files) {
+        if (total - removed <= maxBytes_) {
+            break;
+        }
+        // Файл, занятый другим процессом (на Windows — отображённый), просто остаётся до следующего раза
+        if (std::filesystem::remove(file.path, error)) {
+            removed += file.size;
+        }
+    }
+    return removed;
+}
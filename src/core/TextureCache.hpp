@@ -0,0 +1,94 @@
+#pragma once
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Дисковый кэш декодированных текстур с готовой цепочкой мип-уровней
+ *
+ * Ключ — хеш содержимого сжатого изображения (PNG/JPG из файла или
+ * встроенного в glTF), поэтому переименование файла не сбрасывает кэш, а
+ * одинаковые картинки под разными именами хранятся один раз. Запись лежит в
+ * <каталог>/<хеш>.texcache: заголовок и RGBA8 sRGB уровни 0..n-1 подряд
+ * (раскладка MipChain), начиная с границы страницы. При попадании файл
+ * отображается в память и уровни копируются прямо в staging-буфер без
+ * stb_image и без построения мип-уровней.
+ *
+ * Размер каталога ограничен: evict() удаляет записи, которые дольше всех не
+ * использовались (время изменения файла обновляется при каждом попадании).
+ */
+class TextureCache {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t PAGE_SIZE = 4096;
+    static constexpr const char* EXTENSION = ".texcache";
+    static constexpr const char* DEFAULT_DIRECTORY = "texturecache";
+
+    struct Header {
+        char magic[8];       ///< "VKTEX\0\0\0"
+        uint32_t version;    ///< VERSION
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels;  ///< MipChain::levelCount(width, height)
+        uint64_t sourceSize; ///< Размер сжатого изображения в байтах
+        uint64_t sourceHash; ///< Hash::bytes() сжатого изображения
+        uint64_t dataOffset; ///< Кратно PAGE_SIZE
+        uint64_t dataSize;   ///< MipChain::chainSize(width, height)
+    };
+
+    /// Отображённая в память запись кэша; данные действительны, пока объект жив
+    class Entry {
+    public:
+        Entry(MappedFile file, const Header& header) : file_(std::move(file)), header_(header) {}
+
+        uint32_t width() const { return header_.width; }
+        uint32_t height() const { return header_.height; }
+        uint32_t mipLevels() const { return header_.mipLevels; }
+        /// Все уровни подряд, начиная с 0
+        const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(file_.data()) + header_.dataOffset; }
+        size_t size() const { return static_cast<size_t>(header_.dataSize); }
+
+    private:
+        MappedFile file_;
+        Header header_;
+    };
+
+    /**
+     * @param directory Каталог записей; создаётся при первой записи
+     * @param maxBytes Предел суммарного размера записей для evict()
+     */
+    TextureCache(std::string directory, uint64_t maxBytes);
+
+    /**
+     * @brief Ищет запись для сжатого изображения
+     * @return nullptr, если записи нет, она повреждена или принадлежит другому изображению
+     */
+    std::unique_ptr<Entry> open(const void* source, size_t sourceSize) const;
+
+    /**
+     * @brief Сохраняет цепочку уровней (через временный файл)
+     * @param base Уровень 0, width x height RGBA8
+     * @param mipTail Уровни 1..n-1 (MipChain::chainSize() - размер уровня 0 байт)
+     * @return false, если записать не удалось; это не ошибка загрузки
+     */
+    bool store(const void* source, size_t sourceSize, uint32_t width, uint32_t height,
+               const uint8_t* base, const uint8_t* mipTail) const;
+
+    /**
+     * @brief Удаляет давно не использованные записи, пока их суммарный размер больше maxBytes
+     * @return Сколько байт освобождено
+     */
+    uint64_t evict() const;
+
+    /// Суммарный размер записей в каталоге
+    uint64_t totalBytes() const;
+
+    const std::string& directory() const { return directory_; }
+    std::string entryPath(uint64_t sourceHash) const;
+
+private:
+    std::string directory_;
+    uint64_t maxBytes_;
+};
@@ -1,71 +1,786 @@
 #include "TextureManager.hpp"
-#include <stb_image.h>
-TextureManager::TextureManager(BufferManager& bufferManager, DeviceManager& deviceManager, SwapChainManager& swapChainManager):
+#include "ImageDecoder.hpp"
+#include "Ktx2Texture.hpp"
+#include "MipChain.hpp"
+#include "Parallel.hpp"
+#include "TextureCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+
+namespace {
+    const uint8_t WHITE_PIXEL[4] = {255, 255, 255, 255};
+    const uint64_t STREAMING_UPLOAD_BYTES = 32ull * 1024 * 1024; ///< --texture-budget: предел подгрузки уровней за кадр
+
+    struct DecodedTexture {
+        uint32_t width = 1;
+        uint32_t height = 1;
+        std::unique_ptr<Ktx2Texture> compressed; ///< Готовая цепочка из KTX2: уровни копируются без декодирования
+        std::unique_ptr<TextureCache::Entry> cached; ///< Декодированная цепочка из кэша: без stb_image
+        std::unique_ptr<MappedFile> file; ///< Отображённый файл изображения
+        const uint8_t* encoded = nullptr; ///< PNG/JPG, который декодируется в staging-буфер; nullptr — не нужно
+        size_t encodedSize = 0;
+        bool cpuMips = false; ///< Уровни 1..n-1 строит CPU сразу после декодирования
+        std::string virtualPath; ///< .vtex: текстура виртуальная, в обычном наборе — белая 1x1
+        std::shared_ptr<std::vector<uint8_t>> chain; ///< --texture-budget: копия декодированной цепочки для подгрузки
+
+        VkFormat format() const { return compressed ? compressed->getFormat() : VK_FORMAT_R8G8B8A8_SRGB; }
+        uint32_t mipLevels() const {
+            return compressed ? compressed->getLevelCount() : MipChain::levelCount(width, height);
+        }
+        /// В staging-буфер попадают все уровни: из KTX2, из кэша, построенные на CPU или единственный (белая 1x1)
+        bool levelsReady() const { return !encoded || cpuMips; }
+        /// Байты в staging-буфере: все уровни или только уровень 0, если цепочку построит blit
+        VkDeviceSize size() const {
+            if (compressed) {
+                return compressed->getDataSize();
+            }
+            if (cached) {
+                return cached->size();
+            }
+            return cpuMips ? MipChain::chainSize(width, height) : VkDeviceSize{width} * height * 4;
+        }
+        /// Размер каждого уровня в видеопамяти, от 0 до 1x1
+        std::vector<uint64_t> levelBytes() const {
+            std::vector<uint64_t> bytes;
+            if (compressed) {
+                for (uint32_t level = 0; level < compressed->getLevelCount(); ++level) {
+                    bytes.push_back(compressed->getLevelSize(level));
+                }
+                return bytes;
+            }
+            for (const MipChain::Level& level : MipChain::levels(width, height)) {
+                bytes.push_back(level.size());
+            }
+            return bytes;
+        }
+    };
+
+    /// Есть ли тип памяти со всеми флагами properties
+    bool hasMemoryType(VkPhysicalDevice physicalDevice, VkMemoryPropertyFlags properties) {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+            if ((memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Размер уровня level в пикселях
+    inline uint32_t levelExtent(uint32_t size, uint32_t level) {
+        return std::max(1u, size >> level);
+    }
+
+    /**
+     * @brief KTX2 для файла текстуры
+     *
+     * Сам путь, если это .ktx2, или лежащий рядом <имя>.ktx2 (его пишет TextureEncoder),
+     * если он не старше исходного изображения. Пустая строка — сжатой версии нет.
+     */
+    std::string compressedPath(const std::string& path) {
+        const std::filesystem::path source(path);
+        if (source.extension() == ".ktx2") {
+            return path;
+        }
+        const std::filesystem::path candidate = std::filesystem::path(source).replace_extension(".ktx2");
+        std::error_code error;
+        const auto compressedTime = std::filesystem::last_write_time(candidate, error);
+        if (error) {
+            return std::string();
+        }
+        const auto sourceTime = std::filesystem::last_write_time(source, error);
+        return (error || compressedTime >= sourceTime) ? candidate.string() : std::string();
+    }
+
+    /**
+     * @brief Виртуальная текстура для файла текстуры
+     *
+     * Сам путь, если это .vtex, или лежащий рядом <имя>.vtex (его пишет VirtualTextureBuilder),
+     * если он не старше исходного изображения. Пустая строка — виртуальной версии нет.
+     */
+    std::string virtualTexturePath(const std::string& path) {
+        const std::filesystem::path source(path);
+        if (source.extension() == VirtualTexture::EXTENSION) {
+            return path;
+        }
+        const std::filesystem::path candidate = std::filesystem::path(source).replace_extension(VirtualTexture::EXTENSION);
+        std::error_code error;
+        const auto virtualTime = std::filesystem::last_write_time(candidate, error);
+        if (error) {
+            return std::string();
+        }
+        const auto sourceTime = std::filesystem::last_write_time(source, error);
+        return (error || virtualTime >= sourceTime) ? candidate.string() : std::string();
+    }
+
+    inline VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /// 2D-изображение текстуры без памяти
+    VkImagePtr createTextureImage(VkDevice device, uint32_t width, uint32_t height, uint32_t mipLevels,
+                                  VkFormat format, VkImageUsageFlags usage) {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent = {width, height, 1};
+        imageInfo.mipLevels = mipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = usage;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkImage rawImage;
+        if (vkCreateImage(device, &imageInfo, nullptr, &rawImage) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create image!");
+        }
+        return VkImagePtr(rawImage, VulkanDeleter<VkImage_T, vkDestroyImage, VkDevice>(device));
+    }
+
+    VkImageMemoryBarrier layoutBarrier(VkImage image, uint32_t baseLevel, uint32_t levelCount,
+                                       VkImageLayout oldLayout, VkImageLayout newLayout,
+                                       VkAccessFlags srcAccess, VkAccessFlags dstAccess) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, baseLevel, levelCount, 0, 1};
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        return barrier;
+    }
+}
+
+TextureManager::TextureManager(BufferManager& bufferManager, DeviceManager& deviceManager, SwapChainManager& swapChainManager,
+                               const Options& options):
 bufferManager_(bufferManager), deviceManager_(deviceManager),swapChainManager_(swapChainManager),
-textureImageView(nullptr, VulkanDeleter<VkImageView_T, vkDestroyImageView, VkDevice>(nullptr)),
-textureSampler(nullptr, VulkanDeleter<VkSampler_T, vkDestroySampler, VkDevice>(nullptr)),
-textureImageMemory(nullptr, VulkanDeleter<VkDeviceMemory_T, vkFreeMemory, VkDevice>(nullptr)),
-textureImage(nullptr, VulkanDeleter<VkImage_T, vkDestroyImage, VkDevice>(nullptr))
+textureSampler(nullptr, VulkanDeleter<VkSampler_T, vkDestroySampler, VkDevice>(nullptr))
 
 {
-    createTextureImage();
-    createTextureImageView();
+    createTextureImages(options);
     createTextureSampler();
 }
 
+std::vector<VkImageView> TextureManager::getTextureImageViews() const {
+    std::vector<VkImageView> views;
+    views.reserve(textureImageViews.size());
+    for (const VkImageViewPtr& view : textureImageViews) {
+        views.push_back(view.get());
+    }
+    return views;
+}
+
+void TextureManager::createTextureImages(const Options& options){
+    VkDevice device = deviceManager_.device();
+
+    // Разные текстуры материалов: встроенное изображение glTF или путь; "" — белая текстура материала без map_Kd
+    using Source = std::pair<int32_t, std::string>;
+    std::vector<Source> sources;
+    std::map<Source, uint32_t> textureIds;
+    for (const Material& material : bufferManager_.getMesh().getMaterials()) {
+        const Source source = material.embeddedImage >= 0 ? Source{material.embeddedImage, std::string()}
+                            : Source{-1, material.resolved ? material.diffuseTexture : TEXTURE_PATH};
+        const auto inserted = textureIds.emplace(source, static_cast<uint32_t>(sources.size()));
+        if (inserted.second) {
+            sources.push_back(source);
+        }
+        materialTextures_.push_back(inserted.first->second);
+    }
+
+    // Файл с готовой цепочкой в KTX2 не декодируется вовсе, если устройство умеет выбирать из его формата
+    VkPhysicalDevice physicalDevice = deviceManager_.physicalDevice();
+    auto samplable = [physicalDevice](VkFormat format) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+        const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                              VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (properties.optimalTilingFeatures & required) == required;
+    };
+
+    // Виртуальные текстуры пишут обратную связь из фрагментного шейдера; обычное изображение
+    // не может быть больше maxImageDimension2D
+    const bool virtualTextures = deviceManager_.enabledFeatures().fragmentStoresAndAtomics == VK_TRUE;
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    const uint32_t maxDimension = deviceProperties.limits.maxImageDimension2D;
+
+    // PNG/JPG, уже декодированные в прошлые запуски, берутся из кэша по хешу сжатых байтов
+    std::unique_ptr<TextureCache> textureCache;
+    if (options.useTextureCache) {
+        textureCache = std::make_unique<TextureCache>(TextureCache::DEFAULT_DIRECTORY,
+                                                      uint64_t{options.textureCacheLimitMB} * 1024 * 1024);
+    }
+
+    // Первый проход на всех ядрах: KTX2, запись кэша или размеры изображения из заголовка. Пиксели
+    // декодируются вторым проходом прямо в staging-буфер, когда известны смещения всех текстур
+    const std::vector<std::vector<uint8_t>>& embeddedImages = bufferManager_.getMesh().getEmbeddedImages();
+    std::vector<DecodedTexture> textures(sources.size());
+    Parallel::forEach(sources.size(), [&](size_t i) {
+        const int32_t embedded = sources[i].first;
+        const std::string& path = sources[i].second;
+        DecodedTexture& texture = textures[i];
+        const std::string vtexPath = embedded < 0 && !path.empty() ? virtualTexturePath(path) : std::string();
+        if (!vtexPath.empty()) {
+            if (virtualTextures) {
+                texture.virtualPath = vtexPath;
+                return;
+            }
+            std::cerr << "Device cannot write fragment shader feedback, " << vtexPath << " is not used" << std::endl;
+        }
+        const std::string ktxPath = embedded < 0 && !path.empty() ? compressedPath(path) : std::string();
+        if (!ktxPath.empty()) {
+            try {
+                auto compressed = std::make_unique<Ktx2Texture>(ktxPath);
+                if (samplable(compressed->getFormat())) {
+                    if (compressed->getOrientation() != Ktx2Texture::ORIENTATION) {
+                        std::cerr << "KTX2 texture " << ktxPath << " is not stored bottom-up and will appear flipped"
+                                  << std::endl;
+                    }
+                    texture.width = compressed->getWidth();
+                    texture.height = compressed->getHeight();
+                    texture.compressed = std::move(compressed);
+                    return;
+                }
+                std::cerr << "Device cannot sample the format of " << ktxPath << ", decoding the source image"
+                          << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << ", decoding the source image" << std::endl;
+            }
+        }
+
+        // Сжатые байты изображения: встроенные в glTF или отображённый в память файл
+        if (embedded >= 0 && static_cast<size_t>(embedded) < embeddedImages.size()) {
+            texture.encoded = embeddedImages[embedded].data();
+            texture.encodedSize = embeddedImages[embedded].size();
+        } else if (!path.empty()) {
+            try {
+                texture.file = std::make_unique<MappedFile>(path);
+                texture.encoded = reinterpret_cast<const uint8_t*>(texture.file->data());
+                texture.encodedSize = texture.file->size();
+            } catch (const std::exception&) {
+                // Ошибка сообщается ниже, как и для неразборчивого изображения
+            }
+        } else {
+            return; // Белая текстура материала без map_Kd
+        }
+
+        if (texture.encoded && textureCache) {
+            if (std::unique_ptr<TextureCache::Entry> entry = textureCache->open(texture.encoded, texture.encodedSize)) {
+                texture.width = entry->width();
+                texture.height = entry->height();
+                texture.cached = std::move(entry);
+                texture.encoded = nullptr;
+                return;
+            }
+        }
+
+        if (!texture.encoded ||
+            !ImageDecoder::probe(texture.encoded, texture.encodedSize, texture.width, texture.height)) {
+            if (embedded < 0 && path == TEXTURE_PATH) {
+                throw std::runtime_error("failed to load texture image!");
+            }
+            std::cerr << "Failed to load material texture " << (embedded >= 0 ? "(embedded)" : path)
+                      << ", using white" << std::endl;
+            texture.encoded = nullptr;
+        } else if (texture.width > maxDimension || texture.height > maxDimension) {
+            std::cerr << "Material texture " << (embedded >= 0 ? "(embedded)" : path) << " is " << texture.width
+                      << "x" << texture.height << ", larger than maxImageDimension2D " << maxDimension
+                      << "; build a .vtex with VirtualTextureBuilder. Using white" << std::endl;
+            texture.encoded = nullptr;
+            texture.width = 1;
+            texture.height = 1;
+        }
+    });
+
+    // Мип-уровни строит GPU цепочкой vkCmdBlitImage; если формат нельзя линейно фильтровать при blit,
+    // их считает CPU, а на GPU копируется вся цепочка. Запись кэша хранит всю цепочку, поэтому с кэшем
+    // уровни декодированных изображений тоже строит CPU. С бюджетом видеопамяти уровни подгружаются
+    // с хоста, поэтому и там их строит CPU
+    const bool streaming = options.textureBudgetMB > 0;
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, VK_FORMAT_R8G8B8A8_SRGB, &formatProperties);
+    const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                              VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    const bool blitMips = (formatProperties.optimalTilingFeatures & blitFeatures) == blitFeatures;
+    for (DecodedTexture& texture : textures) {
+        texture.cpuMips = texture.encoded && (streaming || !blitMips || textureCache);
+    }
+    // Цепочку blit строит только для изображений без готовых уровней
+    auto blitted = [&](size_t i) { return blitMips && !textures[i].levelsReady(); };
+
+    // С бюджетом изображение начинается с базового уровня MipResidency: сначала это хвост цепочки
+    std::vector<uint32_t> baseLevels(textures.size(), 0);
+    if (streaming) {
+        residency_ = std::make_unique<MipResidency>(uint64_t{options.textureBudgetMB} * 1024 * 1024,
+                                                    STREAMING_UPLOAD_BYTES);
+        for (size_t i = 0; i < textures.size(); ++i) {
+            const uint32_t id = residency_->add(textures[i].width, textures[i].height, textures[i].levelBytes());
+            baseLevels[i] = residency_->baseLevel(id);
+        }
+    }
+    auto imageLevels = [&](size_t i) { return textures[i].mipLevels() - baseLevels[i]; };
+
+    // Каждое изображение получает своё место в блоках MemoryAllocator: пересозданное при подгрузке
+    // освобождает место прежнего, не трогая остальные текстуры
+    VkDeviceSize memorySize = 0;
+    VkDeviceSize uncompressedSize = 0; // Сколько заняли бы те же цепочки в RGBA8
+    size_t compressedCount = 0;
+    size_t cachedCount = 0;
+    size_t blittedCount = 0;
+    for (size_t i = 0; i < textures.size(); ++i) {
+        const bool fromKtx2 = textures[i].compressed != nullptr;
+        // TRANSFER_SRC: уровень служит источником blit для следующего, а при подгрузке уровни
+        // копируются в пересозданное изображение
+        const VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                        (blitted(i) || streaming ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+        textureImages.push_back(createTextureImage(device, levelExtent(textures[i].width, baseLevels[i]),
+                                                   levelExtent(textures[i].height, baseLevels[i]), imageLevels(i),
+                                                   textures[i].format(), usage));
+        textureMemory_.push_back(deviceManager_.allocator().allocateImage(textureImages.back().get(),
+                                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+        const VkDeviceSize imageSize = textureMemory_.back().size();
+        memorySize += imageSize;
+        uncompressedSize += fromKtx2 ? MipChain::chainSize(textures[i].width, textures[i].height) : imageSize;
+        compressedCount += fromKtx2 ? 1 : 0;
+        cachedCount += textures[i].cached ? 1 : 0;
+        blittedCount += blitted(i) ? 1 : 0;
+    }
+
+    // Все пиксели — в один staging-буфер. Смещение копирования должно быть кратно размеру texel-блока:
+    // 4 байтам RGBA8 и 8 или 16 байтам блока BCn. За декодируемым изображением — запас, который просит stb_image.
+    // С бюджетом здесь тоже вся цепочка: декодированная копируется отсюда в память хоста для подгрузки
+    std::vector<VkDeviceSize> stagingOffsets(textures.size());
+    VkDeviceSize stagingSize = 0;
+    for (size_t i = 0; i < textures.size(); ++i) {
+        stagingOffsets[i] = alignUp(stagingSize, 16);
+        stagingSize = stagingOffsets[i] + textures[i].size() + (textures[i].encoded ? ImageDecoder::DESTINATION_PADDING : 0);
+    }
+
+    // stb_image пишет пиксели прямо в staging-буфер, а распаковка PNG и построение уровней читают уже
+    // записанные строки: из кэшируемой памяти хоста это быстро, из write-combined — на порядки медленнее
+    VkMemoryPropertyFlags stagingProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if (hasMemoryType(physicalDevice, stagingProperties | VK_MEMORY_PROPERTY_HOST_CACHED_BIT)) {
+        stagingProperties |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    }
+    MemoryAllocation stagingBufferMemory;
+    VkBufferPtr stagingBuffer = bufferManager_.createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                            stagingProperties, stagingBufferMemory);
+
+    // Второй проход на всех ядрах: каждый поток декодирует свои изображения в отображённый staging-буфер,
+    // строит их уровни там же и копирует туда KTX2 и записи кэша. Если текстур меньше, чем потоков,
+    // строки уровней одной текстуры делятся между оставшимися
+    uint8_t* staging = static_cast<uint8_t*>(stagingBufferMemory.mapped());
+    const unsigned threads = Parallel::workerCount();
+    const unsigned mipThreads = std::max(1u, threads / static_cast<unsigned>(std::max<size_t>(1, textures.size())));
+    const auto decodeStart = std::chrono::steady_clock::now();
+    Parallel::forEach(textures.size(), [&](size_t i) {
+        DecodedTexture& texture = textures[i];
+        uint8_t* destination = staging + stagingOffsets[i];
+        if (texture.compressed) {
+            // Уровни из отображённого файла подряд, начиная с 0
+            const Ktx2Texture& compressed = *texture.compressed;
+            for (uint32_t level = 0; level < compressed.getLevelCount(); ++level) {
+                memcpy(destination, compressed.getLevelData(level), compressed.getLevelSize(level));
+                destination += compressed.getLevelSize(level);
+            }
+            return;
+        }
+        if (texture.cached) {
+            memcpy(destination, texture.cached->data(), texture.cached->size());
+            // Отображённый файл на Windows не удалить: запись закрывается до evict(). С бюджетом она
+            // остаётся источником уровней, и evict() пропустит её до следующего запуска
+            if (!streaming) {
+                texture.cached.reset();
+            }
+            return;
+        }
+        if (!texture.encoded) {
+            memcpy(destination, WHITE_PIXEL, sizeof(WHITE_PIXEL));
+            return;
+        }
+        if (!ImageDecoder::decode(texture.encoded, texture.encodedSize, destination, texture.width, texture.height)) {
+            std::cerr << "Failed to decode material texture "
+                      << (sources[i].first >= 0 ? "(embedded)" : sources[i].second) << ", using white" << std::endl;
+            memset(destination, 255, texture.size());
+        } else {
+            const size_t baseSize = size_t{texture.width} * texture.height * 4;
+            if (texture.cpuMips) {
+                MipChain::generate(destination, texture.width, texture.height, destination + baseSize, true, mipThreads);
+            }
+            if (textureCache) {
+                textureCache->store(texture.encoded, texture.encodedSize, texture.width, texture.height,
+                                    destination, destination + baseSize);
+            }
+        }
+        if (streaming) {
+            texture.chain = std::make_shared<std::vector<uint8_t>>(destination, destination + texture.size());
+        }
+    }, threads);
+    const double decodeMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decodeStart).count();
+    bufferManager_.getMesh().releaseEmbeddedImages(); // Сжатые байты больше не нужны
+
+    // Переходы раскладок, копирование и построение мип-уровней всех текстур одним командным буфером
+    uint32_t maxMipLevels = 1;
+    std::vector<VkImageMemoryBarrier> toTransfer;
+    for (size_t i = 0; i < textures.size(); ++i) {
+        maxMipLevels = std::max(maxMipLevels, textures[i].mipLevels());
+        toTransfer.push_back(layoutBarrier(textureImages[i].get(), 0, imageLevels(i),
+                                           VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                           0, VK_ACCESS_TRANSFER_WRITE_BIT));
+    }
+
+    const auto uploadStart = std::chrono::steady_clock::now();
+    VkCommandBuffer commandBuffer = bufferManager_.beginSingleTimeCommands();
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr, 0, nullptr, static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+    std::vector<VkBufferImageCopy> regions;
+    for (size_t i = 0; i < textures.size(); ++i) {
+        // Все уровни из KTX2, уровень 0 под blit или вся цепочка из кэша либо построенная на CPU.
+        // Уровень level цепочки — уровень level - base изображения
+        regions.clear();
+        const uint32_t base = baseLevels[i];
+        if (textures[i].compressed) {
+            VkDeviceSize offset = stagingOffsets[i];
+            for (uint32_t level = 0; level < textures[i].mipLevels(); ++level) {
+                if (level >= base) {
+                    VkBufferImageCopy region{};
+                    region.bufferOffset = offset;
+                    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - base, 0, 1};
+                    region.imageExtent = {levelExtent(textures[i].width, level),
+                                          levelExtent(textures[i].height, level), 1};
+                    regions.push_back(region);
+                }
+                offset += textures[i].compressed->getLevelSize(level);
+            }
+        } else {
+            const std::vector<MipChain::Level> levels = MipChain::levels(textures[i].width, textures[i].height);
+            for (uint32_t level = base; level < (blitted(i) ? 1u : levels.size()); ++level) {
+                VkBufferImageCopy region{};
+                region.bufferOffset = stagingOffsets[i] + levels[level].offset;
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - base, 0, 1};
+                region.imageExtent = {levels[level].width, levels[level].height, 1};
+                regions.push_back(region);
+            }
+        }
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer.get(), textureImages[i].get(),
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    // Уровень level строится из level - 1: тот сначала переводится в TRANSFER_SRC. Один барьер на уровень
+    // для всех текстур сразу, чтобы blit разных текстур не ждали друг друга
+    std::vector<VkImageMemoryBarrier> toSource;
+    for (uint32_t level = 1; level < maxMipLevels; ++level) {
+        toSource.clear();
+        for (size_t i = 0; i < textures.size(); ++i) {
+            if (blitted(i) && level < textures[i].mipLevels()) {
+                toSource.push_back(layoutBarrier(textureImages[i].get(), level - 1, 1,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT));
+            }
+        }
+        if (toSource.empty()) {
+            break;
+        }
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr, 0, nullptr, static_cast<uint32_t>(toSource.size()), toSource.data());
+        for (size_t i = 0; i < textures.size(); ++i) {
+            if (!blitted(i) || level >= textures[i].mipLevels()) {
+                continue;
+            }
+            const int32_t width = static_cast<int32_t>(textures[i].width);
+            const int32_t height = static_cast<int32_t>(textures[i].height);
+            VkImageBlit blit{};
+            blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1};
+            blit.srcOffsets[1] = {std::max(1, width >> (level - 1)), std::max(1, height >> (level - 1)), 1};
+            blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+            blit.dstOffsets[1] = {std::max(1, width >> level), std::max(1, height >> level), 1};
+            vkCmdBlitImage(commandBuffer,
+                           textureImages[i].get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           textureImages[i].get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1, &blit, VK_FILTER_LINEAR);
+        }
+    }
+
+    std::vector<VkImageMemoryBarrier> toShader;
+    for (size_t i = 0; i < textures.size(); ++i) {
+        const uint32_t last = imageLevels(i) - 1;
+        if (!blitted(i)) {
+            toShader.push_back(layoutBarrier(textureImages[i].get(), 0, last + 1,
+                                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                             VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+            continue;
+        }
+        // После blit все уровни, кроме последнего, остались в TRANSFER_SRC, последний — в TRANSFER_DST
+        if (last > 0) {
+            toShader.push_back(layoutBarrier(textureImages[i].get(), 0, last,
+                                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                             VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT));
+        }
+        toShader.push_back(layoutBarrier(textureImages[i].get(), last, 1,
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+    }
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                         0, nullptr, 0, nullptr, static_cast<uint32_t>(toShader.size()), toShader.data());
+    bufferManager_.endSingleTimeCommands(commandBuffer);
+    const double uploadMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+
+    stagingBuffer.reset();
+    stagingBufferMemory.reset();
+
+    for (size_t i = 0; i < textureImages.size(); ++i) {
+        textureImageViews.push_back(swapChainManager_.createImageView(textureImages[i].get(), textures[i].format(),
+                                                                      VK_IMAGE_ASPECT_COLOR_BIT, imageLevels(i)));
+    }
+    mipLevels_ = maxMipLevels;
+
+    // Источники подгрузки: отображённые KTX2 и записи кэша, копии декодированных цепочек, белый пиксель
+    if (streaming) {
+        levelSources_.resize(textures.size());
+        for (size_t i = 0; i < textures.size(); ++i) {
+            DecodedTexture& texture = textures[i];
+            LevelSource& source = levelSources_[i];
+            source.width = texture.width;
+            source.height = texture.height;
+            source.format = texture.format();
+            if (texture.compressed) {
+                for (uint32_t level = 0; level < texture.compressed->getLevelCount(); ++level) {
+                    source.levels.push_back(texture.compressed->getLevelData(level));
+                    source.levelSizes.push_back(texture.compressed->getLevelSize(level));
+                }
+                source.owner = std::shared_ptr<const Ktx2Texture>(std::move(texture.compressed));
+                continue;
+            }
+            const uint8_t* chain = WHITE_PIXEL;
+            if (texture.cached) {
+                chain = texture.cached->data();
+                source.owner = std::shared_ptr<const TextureCache::Entry>(std::move(texture.cached));
+            } else if (texture.chain) {
+                chain = texture.chain->data();
+                source.owner = std::move(texture.chain);
+            }
+            for (const MipChain::Level& level : MipChain::levels(texture.width, texture.height)) {
+                source.levels.push_back(chain + level.offset);
+                source.levelSizes.push_back(level.size());
+            }
+        }
+    }
+
+    // Виртуальные текстуры: атлас, таблица страниц и самый грубый уровень, остальное — по обратной связи
+    std::vector<int32_t> textureVirtual(textures.size(), -1);
+    for (size_t i = 0; i < textures.size(); ++i) {
+        if (textures[i].virtualPath.empty()) {
+            continue;
+        }
+        try {
+            virtualTextures_.push_back(std::make_unique<VirtualTextureStreamer>(
+                textures[i].virtualPath, bufferManager_, deviceManager_, swapChainManager_));
+            textureVirtual[i] = static_cast<int32_t>(virtualTextures_.size() - 1);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << ", using white" << std::endl;
+        }
+    }
+    for (uint32_t texture : materialTextures_) {
+        materialVirtual_.push_back(textureVirtual[texture]);
+    }
+
+    const double megabytes = memorySize / (1024.0 * 1024.0);
+    std::cout << "Loaded " << textures.size() << " textures for " << materialTextures_.size() << " materials: "
+              << megabytes << (streaming ? " MB resident" : " MB of video memory") << ", up to " << maxMipLevels
+              << " mip levels (" << blittedCount << " built by GPU blits)" << std::endl;
+    if (streaming) {
+        std::cout << "  texture budget " << options.textureBudgetMB << " MB: mip tails resident, "
+                  << residency_->residentBytes() / (1024.0 * 1024.0)
+                  << " MB, finer levels are streamed in on demand" << std::endl;
+    }
+    std::cout << "  decoded into staging in " << decodeMilliseconds << " ms on " << threads
+              << " threads, copies and blits in one submission " << uploadMilliseconds << " ms" << std::endl;
+    std::cout << "  " << compressedCount << " of " << textures.size() << " textures block-compressed from KTX2, "
+              << megabytes / textures.size() << " MB per texture on average (RGBA8 would take "
+              << uncompressedSize / (1024.0 * 1024.0) / textures.size() << " MB)" << std::endl;
+
+    if (textureCache) {
+        const uint64_t evicted = textureCache->evict();
+        std::cout << "  " << cachedCount << " textures decoded from cache " << textureCache->directory();
+        if (evicted > 0) {
+            std::cout << ", evicted " << evicted / (1024.0 * 1024.0) << " MB of least recently used entries";
+        }
+        std::cout << std::endl;
+    }
+}
+
+std::vector<VirtualTextureBindings> TextureManager::getVirtualTextureBindings() const {
+    std::vector<VirtualTextureBindings> bindings;
+    for (const std::unique_ptr<VirtualTextureStreamer>& texture : virtualTextures_) {
+        bindings.push_back(texture->bindings());
+    }
+    return bindings;
+}
+
+void TextureManager::updateVirtualTextures() {
+    for (const std::unique_ptr<VirtualTextureStreamer>& texture : virtualTextures_) {
+        texture->update();
+    }
+}
 
-void TextureManager::createTextureImage(){
-
-    namespace fs = std::filesystem;
-    
-
-    int texWidth, texHeight, texChannels;
-    stbi_set_flip_vertically_on_load(true);
-    stbi_uc* pixels = stbi_load(TEXTURE_PATH.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    stbi_set_flip_vertically_on_load(false);
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
-    if (!pixels) {
-        throw std::runtime_error("failed to load texture image!"); 
-    }  
-    
-
-    bufferManager_.createBuffer(imageSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT, // TRANSFER_SRC означает, что буфер будет источником данных для операций копирования
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT // HOST_VISIBLE — память доступна для записи/чтения с CPU (хост-устройства).
-        | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, // HOST_COHERENT — гарантирует автоматическую синхронизацию кэшей CPU и GPU.                                                                              
-        stagingBuffer,
-        stagingBufferMemory
-    );
-
-   
-    void* data;
-    //Заполняет data, используя staging-буфер
-    vkMapMemory(deviceManager_.device(), stagingBufferMemory, 0, imageSize, 0, &data);
-    //Копирует данные pixels в data
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
-    //После этой штуки data недействителен
-    vkUnmapMemory(deviceManager_.device(), stagingBufferMemory);
-
-    stbi_image_free(pixels);
-    swapChainManager_.createImage(texWidth,
-                texHeight,
-                VK_FORMAT_R8G8B8A8_SRGB,
-                VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                textureImage, textureImageMemory);
-
-    bufferManager_.transitionImageLayout(textureImage.get(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    bufferManager_.copyBufferToImage(stagingBuffer, textureImage.get(), static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
-    bufferManager_.transitionImageLayout(textureImage.get(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-    vkDestroyBuffer(deviceManager_.device(), stagingBuffer, nullptr);
-    vkFreeMemory(deviceManager_.device(), stagingBufferMemory, nullptr);
+void TextureManager::requestDetail(uint32_t texture, float uvPerPixel) {
+    if (!residency_) {
+        return;
+    }
+    const LevelSource& source = levelSources_[texture];
+    const float texelsPerPixel = uvPerPixel * static_cast<float>(std::max(source.width, source.height));
+    residency_->request(texture, MipResidency::levelForFootprint(texelsPerPixel,
+                                                                  static_cast<uint32_t>(source.levels.size())));
 }
 
-void TextureManager::createTextureImageView() {
-    textureImageView = swapChainManager_.createImageView(textureImage.get(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
+std::vector<uint32_t> TextureManager::updateResidency() {
+    std::vector<uint32_t> changed;
+    if (!residency_) {
+        return changed;
+    }
+    const std::vector<MipResidency::Change> changes = residency_->update();
+    if (changes.empty()) {
+        return changed;
+    }
+    VkDevice device = deviceManager_.device();
+
+    // Догружаемые уровни [base, previousBase) — из памяти хоста через один staging-буфер
+    std::vector<VkDeviceSize> stagingOffsets(changes.size());
+    VkDeviceSize stagingSize = 0;
+    for (size_t c = 0; c < changes.size(); ++c) {
+        const LevelSource& source = levelSources_[changes[c].texture];
+        stagingOffsets[c] = alignUp(stagingSize, 16);
+        stagingSize = stagingOffsets[c];
+        for (uint32_t level = changes[c].base; level < changes[c].previousBase; ++level) {
+            stagingSize += source.levelSizes[level];
+        }
+    }
+    MemoryAllocation stagingBufferMemory;
+    VkBufferPtr stagingBuffer(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr));
+    if (stagingSize > 0) {
+        stagingBuffer = bufferManager_.createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                    stagingBufferMemory);
+        void* data = stagingBufferMemory.mapped();
+        for (size_t c = 0; c < changes.size(); ++c) {
+            const LevelSource& source = levelSources_[changes[c].texture];
+            uint8_t* destination = static_cast<uint8_t*>(data) + stagingOffsets[c];
+            for (uint32_t level = changes[c].base; level < changes[c].previousBase; ++level) {
+                memcpy(destination, source.levels[level], source.levelSizes[level]);
+                destination += source.levelSizes[level];
+            }
+        }
+    }
+
+    // Новое изображение начинается с нового базового уровня; у него своё место в памяти
+    std::vector<VkImagePtr> images;
+    std::vector<MemoryAllocation> memories;
+    std::vector<VkImageMemoryBarrier> toTransfer;
+    for (const MipResidency::Change& change : changes) {
+        const LevelSource& source = levelSources_[change.texture];
+        const uint32_t levelCount = static_cast<uint32_t>(source.levels.size());
+        images.push_back(createTextureImage(device, levelExtent(source.width, change.base),
+                                            levelExtent(source.height, change.base), levelCount - change.base,
+                                            source.format, VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT));
+        memories.push_back(deviceManager_.allocator().allocateImage(images.back().get(),
+                                                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+        toTransfer.push_back(layoutBarrier(textureImages[change.texture].get(), 0, levelCount - change.previousBase,
+                                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                           VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT));
+        toTransfer.push_back(layoutBarrier(images.back().get(), 0, levelCount - change.base,
+                                           VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                           0, VK_ACCESS_TRANSFER_WRITE_BIT));
+    }
+
+    // Уровни, которые остаются, копируются на GPU из прежнего изображения, новые — из staging-буфера
+    VkCommandBuffer commandBuffer = bufferManager_.beginSingleTimeCommands();
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr, 0, nullptr, static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+    std::vector<VkImageCopy> copies;
+    std::vector<VkBufferImageCopy> regions;
+    std::vector<VkImageMemoryBarrier> toShader;
+    for (size_t c = 0; c < changes.size(); ++c) {
+        const MipResidency::Change& change = changes[c];
+        const LevelSource& source = levelSources_[change.texture];
+        const uint32_t levelCount = static_cast<uint32_t>(source.levels.size());
+
+        copies.clear();
+        for (uint32_t level = std::max(change.base, change.previousBase); level < levelCount; ++level) {
+            VkImageCopy copy{};
+            copy.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - change.previousBase, 0, 1};
+            copy.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - change.base, 0, 1};
+            copy.extent = {levelExtent(source.width, level), levelExtent(source.height, level), 1};
+            copies.push_back(copy);
+        }
+        vkCmdCopyImage(commandBuffer, textureImages[change.texture].get(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       images[c].get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       static_cast<uint32_t>(copies.size()), copies.data());
+
+        regions.clear();
+        VkDeviceSize offset = stagingOffsets[c];
+        for (uint32_t level = change.base; level < change.previousBase; ++level) {
+            VkBufferImageCopy region{};
+            region.bufferOffset = offset;
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - change.base, 0, 1};
+            region.imageExtent = {levelExtent(source.width, level), levelExtent(source.height, level), 1};
+            regions.push_back(region);
+            offset += source.levelSizes[level];
+        }
+        if (!regions.empty()) {
+            vkCmdCopyBufferToImage(commandBuffer, stagingBuffer.get(), images[c].get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   static_cast<uint32_t>(regions.size()), regions.data());
+        }
+        toShader.push_back(layoutBarrier(images[c].get(), 0, levelCount - change.base,
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+    }
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                         0, nullptr, 0, nullptr, static_cast<uint32_t>(toShader.size()), toShader.data());
+    bufferManager_.endSingleTimeCommands(commandBuffer);
+
+    stagingBuffer.reset();
+    stagingBufferMemory.reset();
+
+    // Копирование завершено: прежние вид, изображение и память освобождаются именно в этом порядке
+    uint32_t streamedIn = 0;
+    for (size_t c = 0; c < changes.size(); ++c) {
+        const MipResidency::Change& change = changes[c];
+        const LevelSource& source = levelSources_[change.texture];
+        textureImageViews[change.texture] = swapChainManager_.createImageView(
+            images[c].get(), source.format, VK_IMAGE_ASPECT_COLOR_BIT,
+            static_cast<uint32_t>(source.levels.size()) - change.base);
+        textureImages[change.texture] = std::move(images[c]);
+        textureMemory_[change.texture] = std::move(memories[c]);
+        changed.push_back(change.texture);
+        streamedIn += change.base < change.previousBase ? 1 : 0;
+    }
+    std::cout << "Texture streaming: " << streamedIn << " textures refined, " << changes.size() - streamedIn
+              << " evicted, " << residency_->residentBytes() / (1024.0 * 1024.0) << " of "
+              << residency_->budgetBytes() / (1024.0 * 1024.0) << " MB resident" << std::endl;
+    return changed;
 }
+
 void TextureManager::createTextureSampler() {
 
 
@@ -89,7 +804,7 @@ void TextureManager::createTextureSampler() {
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(mipLevels_); // Весь диапазон самой длинной цепочки; короткие ограничит их вид
 
     VkSampler rawTextureSampler;
     if (vkCreateSampler(deviceManager_.device(), &samplerInfo, nullptr, &rawTextureSampler) != VK_SUCCESS) {
@@ -1,41 +1,124 @@
 #pragma once
 #include <vulkan/vulkan.h>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include "VulkanUtils.hpp"
 #include "BufferManager.hpp"
 #include "DeviceManager.hpp"
 #include "SwapChainManager.hpp"
+#include "MipResidency.hpp"
+#include "Options.hpp"
+#include "VirtualTextureStreamer.hpp"
+
+/**
+ * @brief Текстуры материалов модели
+ *
+ * Каждая разная текстура загружается один раз, сколько бы материалов на неё ни
+ * ссылалось. Все изображения лежат в одном выделении видеопамяти и заливаются
+ * через один staging-буфер и один командный буфер, поэтому сотни материалов не
+ * дают сотен vkAllocateMemory и ожиданий очереди.
+ *
+ * Материал без map_Kd получает белую текстуру 1x1 (цвет задаёт Kd), материал,
+ * не найденный в .mtl, — текстуру по умолчанию TEXTURE_PATH. Изображения,
+ * встроенные в glTF, и файлы текстур декодируются параллельно в два прохода:
+ * сначала из заголовков читаются размеры, затем каждый поток декодирует свои
+ * изображения прямо в отображённый staging-буфер (ImageDecoder) и там же
+ * строит их мип-уровни.
+ *
+ * У каждой текстуры полная цепочка мип-уровней до 1x1: при уменьшении
+ * выборка идёт из уровня подходящего размера, а не из всего изображения.
+ *
+ * Если рядом с файлом текстуры лежит не более старый <имя>.ktx2 (его пишет
+ * TextureEncoder), а устройство умеет выбирать из его формата, уровни BC1/BC5/BC7
+ * копируются из отображённого файла прямо в staging-буфер без декодирования.
+ * Декодированные PNG/JPG с цепочкой уровней сохраняются в TextureCache, и при
+ * следующем запуске stb_image не вызывается.
+ *
+ * С --texture-budget в видеопамяти сначала лежат только хвосты цепочек
+ * (MipResidency), а детальные уровни подгружаются, когда рендер через
+ * requestDetail() сообщает, что они нужны на экране, и вытесняются, когда
+ * бюджет исчерпан. Уровни всех текстур остаются в памяти хоста (KTX2 и записи
+ * кэша — отображёнными файлами), поэтому подгрузка не декодирует изображения.
+ *
+ * Текстура, для которой рядом лежит не более старый <имя>.vtex (его пишет
+ * VirtualTextureBuilder), становится виртуальной (VirtualTextureStreamer):
+ * её размер не ограничен maxImageDimension2D, а в видеопамяти лежат только
+ * видимые страницы. Такие материалы рисуются отдельным конвейером, а в
+ * обычном наборе у них белая текстура 1x1.
+ */
 class TextureManager{
 
     public:
-    TextureManager(BufferManager& bufferManager, DeviceManager& deviceManager, SwapChainManager& swapChainManager);
+    TextureManager(BufferManager& bufferManager, DeviceManager& deviceManager, SwapChainManager& swapChainManager,
+                   const Options& options = {});
 
-    VkImageView getTextureImageView() const { return textureImageView.get(); }
     VkSampler getTextureSampler() const { return textureSampler.get(); }
-    
-    
-        
-    private:
+    size_t getTextureCount() const { return textureImageViews.size(); }
+    std::vector<VkImageView> getTextureImageViews() const;
+    /// Номер текстуры материала (индекс в getTextureImageViews())
+    uint32_t getMaterialTexture(size_t material) const { return materialTextures_[material]; }
+    /// Номер виртуальной текстуры материала (индекс в getVirtualTextureBindings()) или -1
+    int32_t getMaterialVirtualTexture(size_t material) const { return materialVirtual_[material]; }
+    size_t getVirtualTextureCount() const { return virtualTextures_.size(); }
+    std::vector<VirtualTextureBindings> getVirtualTextureBindings() const;
+
+    /**
+     * @brief Подгружает страницы виртуальных текстур по обратной связи завершённого кадра
+     *
+     * Вызывается, когда GPU не использует текстуры (после ожидания fence кадра).
+     */
+    void updateVirtualTextures();
+
+    /// Включена ли подгрузка мип-уровней по бюджету (--texture-budget)
+    bool isStreaming() const { return residency_ != nullptr; }
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
+    /**
+     * @brief Заявка кадра на детальность текстуры
+     * @param uvPerPixel Сколько единиц UV приходится на пиксель экрана вдоль стороны
+     */
+    void requestDetail(uint32_t texture, float uvPerPixel);
+
+    /**
+     * @brief Применяет заявки кадра: догружает и вытесняет уровни одной отправкой команд
+     *
+     * Вызывается, когда GPU не использует текстуры (после ожидания fence кадра).
+     * Пересозданные текстуры получают новые виды изображений.
+     * @return Номера текстур, чей вид из getTextureImageViews() сменился
+     */
+    std::vector<uint32_t> updateResidency();
+
+    private:
 
     BufferManager& bufferManager_;
     DeviceManager& deviceManager_;
     SwapChainManager& swapChainManager_;
 
-    VkImageViewPtr textureImageView;
+    /// Место каждой текстуры в блоках MemoryAllocator; освобождается после изображений
+    std::vector<MemoryAllocation> textureMemory_;
+    std::vector<VkImagePtr> textureImages;
+    std::vector<VkImageViewPtr> textureImageViews;
     VkSamplerPtr textureSampler;
 
-    VkImagePtr textureImage;
-    VkDeviceMemoryPtr textureImageMemory;
-
-   
-    
+    std::vector<uint32_t> materialTextures_;
+    uint32_t mipLevels_ = 1; ///< Уровней в самой длинной цепочке; задаёт maxLod сэмплера
 
+    /// Уровни текстуры в памяти хоста, из которых подгружаются вытесненные
+    struct LevelSource {
+        std::shared_ptr<const void> owner; ///< KTX2, запись кэша или декодированная цепочка
+        std::vector<const uint8_t*> levels;
+        std::vector<VkDeviceSize> levelSizes;
+        uint32_t width = 1;
+        uint32_t height = 1;
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+    };
+    std::vector<LevelSource> levelSources_;
+    std::unique_ptr<MipResidency> residency_;
 
+    std::vector<std::unique_ptr<VirtualTextureStreamer>> virtualTextures_;
+    std::vector<int32_t> materialVirtual_;
 
     void createTextureSampler();
-    void createTextureImageView();
-    void createTextureImage();
-};
\ No newline at end of file
+    void createTextureImages(const Options& options);
+};
@@ -1,52 +1,66 @@
 #include "Vertex.hpp"
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
+#include "ObjParser.hpp"
+#include "PlyParser.hpp"
+#include "StlParser.hpp"
+#include "TangentSpace.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 
-std::vector<Vertex> vertices;
-std::vector<uint32_t> indices;
-
-void loadModel() {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, MODEL_PATH.c_str())) {
-        throw std::runtime_error(warn + err);
-    }
-
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{}; // Для устранения дубликатов вершин
-
-    for (const auto& shape : shapes) {
-        for (const auto& index : shape.mesh.indices) {
-            Vertex vertex{};
-
-            // Индекс содержит:
-            //   index.vertex_index  - позиция
-            //   index.texcoord_index - UV
+std::string modelFormat(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
 
-            vertex.pos = {
-                attrib.vertices[3 * index.vertex_index + 0], //x
-                attrib.vertices[3 * index.vertex_index + 1], //y
-                attrib.vertices[3 * index.vertex_index + 2]  //z
-            };
+MeshData loadModel(const Options& options) {
+    MeshData mesh;
+    const std::string path = modelPath(options);
+    const std::string format = modelFormat(path);
+    if (format == ".ply") {
+        PlyParser parser; // Записи вершин и граней разбираются блоками на всех ядрах
+        parser.load(path, mesh.vertices, mesh.indices);
 
-            vertex.texCoord = {
-                attrib.texcoords[2 * index.texcoord_index + 0], //U
-                1.0f - attrib.texcoords[2 * index.texcoord_index + 1] //V
-            };
+        const PlyParser::Stats& stats = parser.getStats();
+        std::cout << "PLY parsed: " << stats.fileSize / (1024.0 * 1024.0) << " MB in "
+                  << stats.totalSeconds * 1000.0 << " ms (" << stats.megabytesPerSecond() << " MB/s, "
+                  << stats.threadCount << " threads), " << stats.faceCount << " faces"
+                  << (stats.uniformFaces ? "" : " of mixed size") << (parser.hasColors() ? ", vertex colors" : "")
+                  << "\n";
+    } else if (format == ".stl") {
+        StlParser parser(0, options.weldEpsilon); // Углы разбираются и склеиваются на всех ядрах
+        parser.load(path, mesh.vertices, mesh.indices);
 
-            vertex.color = {1.0f, 1.0f, 1.0f};
+        const StlParser::Stats& stats = parser.getStats();
+        std::cout << "STL parsed: " << stats.fileSize / (1024.0 * 1024.0) << " MB in "
+                  << stats.parseSeconds * 1000.0 << " ms (" << stats.megabytesPerSecond() << " MB/s, "
+                  << stats.threadCount << " threads), " << stats.triangleCount << " triangles welded to "
+                  << mesh.vertices.size() << " vertices (" << stats.degenerateCount << " degenerate removed), total load "
+                  << stats.totalSeconds * 1000.0 << " ms\n";
+    } else {
+        ObjParser parser(0, options.weldEpsilon); // Разбирает OBJ на всех ядрах прямо из отображённого в память файла
+        parser.load(path, mesh.vertices, mesh.indices);
 
-            if (uniqueVertices.count(vertex) == 0) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
-            }
+        const ObjParser::Stats& stats = parser.getStats();
+        std::cout << "OBJ parsed: " << stats.fileSize / (1024.0 * 1024.0) << " MB in "
+                  << stats.parseSeconds * 1000.0 << " ms (" << stats.megabytesPerSecond() << " MB/s, "
+                  << stats.threadCount << " threads), total load " << stats.totalSeconds * 1000.0 << " ms\n";
+        mesh.meshMaterials = parser.getMaterials();
+    }
 
-            indices.push_back(uniqueVertices[vertex]);
-        }
+    // OBJ-загрузчик не читает vn, в STL только нормали граней: нормали и касательные строятся здесь, до загрузки в GPU
+    const auto startTime = std::chrono::steady_clock::now();
+    if (!TangentSpace::hasNormals(mesh.vertices)) {
+        TangentSpace::generateNormals(mesh.vertices, mesh.indices);
     }
+    TangentSpace::generateTangents(mesh.vertices, mesh.indices);
+    std::cout << "Normals and tangents generated in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count()
+              << " ms\n";
+    return mesh;
 }
 VkVertexInputBindingDescription Vertex::getBindingDescription() { // Описывает организацию данных в буфере вершин
     VkVertexInputBindingDescription bindingDescription{};
@@ -61,8 +75,8 @@ VkVertexInputBindingDescription Vertex::getBindingDescription() { // Описы
     bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
     return bindingDescription;
 }
-std::array<VkVertexInputAttributeDescription, 3> Vertex::getAttributeDescriptions() { //Описывает отдельные атрибуты вершины (позиция, цвет, UV)
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+std::array<VkVertexInputAttributeDescription, 5> Vertex::getAttributeDescriptions() { //Описывает отдельные атрибуты вершины (позиция, цвет, UV, нормаль, касательная)
+    std::array<VkVertexInputAttributeDescription, 5> attributeDescriptions{};
     /**Параметр binding сообщает Vulkan, из какого связывания поступают данные для каждой вершины.
      * Параметр location ссылается на директиву location ввода в вершинном шейдере.
      * Параметр format описывает тип данных для атрибута.
@@ -87,5 +101,17 @@ std::array<VkVertexInputAttributeDescription, 3> Vertex::getAttributeDescription
     attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
     attributeDescriptions[2].offset = offsetof(Vertex, texCoord);
 
+    // Normal (Location 3)
+    attributeDescriptions[3].binding = 0;
+    attributeDescriptions[3].location = 3;
+    attributeDescriptions[3].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[3].offset = offsetof(Vertex, normal);
+
+    // Tangent (Location 4)
+    attributeDescriptions[4].binding = 0;
+    attributeDescriptions[4].location = 4;
+    attributeDescriptions[4].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    attributeDescriptions[4].offset = offsetof(Vertex, tangent);
+
     return attributeDescriptions;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
+#ifndef GLM_ENABLE_EXPERIMENTAL
 #define GLM_ENABLE_EXPERIMENTAL
+#endif
 #include <glm/glm.hpp>
 #include <vector>
 #include <array>
@@ -7,14 +9,24 @@
 #include <vulkan/vulkan.h>
 #include <unordered_map>
 #include <glm/gtx/hash.hpp>
+#include "Options.hpp"
+#include "Material.hpp"
 
 
+#ifndef MODEL_PATH // Тесты задают путь к модели через определение компилятора
 const std::string MODEL_PATH = "model/viking.obj";
+#endif
 const std::string TEXTURE_PATH = "textures/viking.png";
 
 
 
-void loadModel();
+/// Путь к модели: --model или MODEL_PATH
+inline std::string modelPath(const Options& options) {
+    return options.modelPath.empty() ? std::string(MODEL_PATH) : options.modelPath;
+}
+
+/// Расширение файла модели в нижнем регистре (".obj", ".ply", ".stl", ".glb", ...) — по нему выбирается загрузчик
+std::string modelFormat(const std::string& path);
 
 struct UniformBufferObject { // не больше 256 байта
     glm::mat4 model; //64 байта
@@ -27,15 +39,17 @@ struct Vertex{
     glm::vec3 color;
     glm::vec2 texCoord;
     glm::vec3 normal;
+    glm::vec4 tangent; ///< xyz — касательная, w — знак бикасательной (соглашение MikkTSpace)
     
     static VkVertexInputBindingDescription getBindingDescription();
-    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
+    static std::array<VkVertexInputAttributeDescription, 5> getAttributeDescriptions();
 
     bool operator==(const Vertex& other) const {
        return pos == other.pos && 
               color == other.color &&
               texCoord == other.texCoord &&
-              normal == other.normal;
+              normal == other.normal &&
+              tangent == other.tangent;
    }
 };
 
@@ -51,7 +65,24 @@ namespace std {
    };
 }
 
-extern std::vector<Vertex> vertices; 
-extern std::vector<uint32_t> indices;
+/**
+ * @brief Геометрия модели в памяти CPU: живёт от разбора файла до загрузки в GPU
+ */
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    MeshMaterials meshMaterials; ///< Диапазоны indices по материалам модели
+
+    /// Байты, занятые вершинами и индексами
+    size_t byteSize() const { return vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t); }
+
+    /// Освобождает массивы (clear() оставил бы выделенную память)
+    void release() { *this = MeshData{}; }
+};
+
+/**
+ * @brief Разбирает модель из options (OBJ, PLY или STL) и строит нормали и касательные
+ */
+MeshData loadModel(const Options& options = {});
 
 
@@ -0,0 +1,223 @@
+#include "VertexWelder.hpp"
+#include "Hash.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(Vertex) % sizeof(uint32_t) == 0, "Vertex must consist of 32-bit components");
+
+namespace {
+    constexpr size_t MIN_CAPACITY = 64;
+
+    // Параметры weldAll(); на результат не влияют, только на распределение работы
+    constexpr size_t SHARD_COUNT = 256;       // Степень двойки, шард хранится в uint16_t
+    constexpr size_t MAX_BLOCKS = 256;        // Блоки углов для подсчёта и префиксных сумм
+    constexpr size_t MIN_BLOCK_SIZE = 16384;
+
+    // Максимальная загрузка 7/10: дальше линейное пробирование заметно замедляется
+    inline size_t capacityFor(size_t count) {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity * 7 < count * 10) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    constexpr uint32_t NEGATIVE_ZERO = 0x80000000u;
+}
+
+VertexWelder::VertexWelder(std::vector<Vertex>& vertices, size_t expectedVertices, float positionEpsilon)
+    : vertices_(vertices),
+      inverseEpsilon_(positionEpsilon > 0.0f ? 1.0f / positionEpsilon : 0.0f) {
+    rehash(capacityFor(expectedVertices));
+    vertices_.reserve(vertices_.size() + expectedVertices);
+}
+
+VertexWelder::Key VertexWelder::makeKey(const Vertex& vertex, float inverseEpsilon) {
+    Key key;
+    std::memcpy(key.words, &vertex, sizeof(key.words));
+    for (uint32_t& word : key.words) {
+        if (word == NEGATIVE_ZERO) {
+            word = 0; // -0.0 == 0.0, как в Vertex::operator==
+        }
+    }
+
+    if (inverseEpsilon > 0.0f) {
+        const size_t first = offsetof(Vertex, pos) / sizeof(float);
+        for (size_t i = 0; i < 3; ++i) {
+            const float cell = std::floor(vertex.pos[static_cast<int>(i)] * inverseEpsilon + 0.5f);
+            key.words[first + i] = static_cast<uint32_t>(static_cast<int32_t>(cell));
+        }
+    }
+    return key;
+}
+
+uint64_t VertexWelder::hashKey(const Key& key) {
+    return Hash::bytes(key.words, sizeof(key.words));
+}
+
+void VertexWelder::rehash(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    slots_.assign(capacity, Slot{0, EMPTY});
+    mask_ = capacity - 1;
+
+    for (const Slot& slot : old) {
+        if (slot.index == EMPTY) {
+            continue;
+        }
+        const uint64_t hash = hashKey(makeKey(vertices_[slot.index]));
+        size_t position = static_cast<size_t>(hash) & mask_;
+        while (slots_[position].index != EMPTY) {
+            position = (position + 1) & mask_;
+        }
+        slots_[position] = slot;
+    }
+}
+
+uint32_t VertexWelder::weld(const Vertex& vertex) {
+    if ((count_ + 1) * 10 > slots_.size() * 7) {
+        rehash(slots_.size() * 2);
+    }
+
+    const Key key = makeKey(vertex);
+    const uint64_t hash = hashKey(key);
+    const uint32_t fingerprint = static_cast<uint32_t>(hash >> 32);
+
+    size_t position = static_cast<size_t>(hash) & mask_;
+    while (true) {
+        Slot& slot = slots_[position];
+        if (slot.index == EMPTY) {
+            if (vertices_.size() >= EMPTY) {
+                throw std::runtime_error("Too many unique vertices for 32-bit indices");
+            }
+            slot.fingerprint = fingerprint;
+            slot.index = static_cast<uint32_t>(vertices_.size());
+            vertices_.push_back(vertex);
+            ++count_;
+            return slot.index;
+        }
+        if (slot.fingerprint == fingerprint) {
+            const Vertex& candidate = vertices_[slot.index];
+            // Обычно совпадают все байты; ключ пересчитываем только ради -0.0 и сетки позиций
+            if (inverseEpsilon_ == 0.0f && std::memcmp(&candidate, &vertex, sizeof(Vertex)) == 0) {
+                return slot.index;
+            }
+            const Key existing = makeKey(candidate);
+            if (std::memcmp(existing.words, key.words, sizeof(key.words)) == 0) {
+                return slot.index;
+            }
+        }
+        position = (position + 1) & mask_;
+    }
+}
+
+void VertexWelder::weldAll(const std::vector<Vertex>& corners, std::vector<Vertex>& vertices,
+                           std::vector<uint32_t>& indices, float positionEpsilon, unsigned threadCount) {
+    threadCount = Parallel::workerCount(threadCount);
+    const size_t count = corners.size();
+    if (count >= EMPTY) {
+        throw std::runtime_error("Too many corners for 32-bit indices");
+    }
+
+    const size_t blockCount = std::max<size_t>(1, std::min<size_t>(MAX_BLOCKS, count / MIN_BLOCK_SIZE));
+    const size_t shardCount = SHARD_COUNT;
+    auto blockBegin = [&](size_t block) { return count * block / blockCount; };
+
+    // 1. Шард каждого угла и число углов каждого шарда в каждом блоке
+    const float inverseEpsilon = positionEpsilon > 0.0f ? 1.0f / positionEpsilon : 0.0f;
+    std::vector<uint16_t> cornerShard(count);
+    std::vector<size_t> blockShardOffset(blockCount * shardCount, 0);
+    Parallel::forEach(blockCount, [&](size_t block) {
+        size_t* counts = &blockShardOffset[block * shardCount];
+        for (size_t c = blockBegin(block); c < blockBegin(block + 1); ++c) {
+            // Шард берётся из перемешанного хеша, чтобы не совпадать с битами позиции в таблице шарда
+            const auto shard = static_cast<uint16_t>(Hash::mix(hashKey(makeKey(corners[c], inverseEpsilon))) & (shardCount - 1));
+            cornerShard[c] = shard;
+            ++counts[shard];
+        }
+    }, threadCount);
+
+    // 2. Смещения: внутри шарда углы идут по возрастанию номера
+    std::vector<size_t> shardBegin(shardCount + 1, 0);
+    size_t offset = 0;
+    for (size_t shard = 0; shard < shardCount; ++shard) {
+        shardBegin[shard] = offset;
+        for (size_t block = 0; block < blockCount; ++block) {
+            const size_t blockCountInShard = blockShardOffset[block * shardCount + shard];
+            blockShardOffset[block * shardCount + shard] = offset;
+            offset += blockCountInShard;
+        }
+    }
+    shardBegin[shardCount] = offset;
+
+    std::vector<uint32_t> shardCorners(count);
+    Parallel::forEach(blockCount, [&](size_t block) {
+        size_t* cursor = &blockShardOffset[block * shardCount];
+        for (size_t c = blockBegin(block); c < blockBegin(block + 1); ++c) {
+            shardCorners[cursor[cornerShard[c]]++] = static_cast<uint32_t>(c);
+        }
+    }, threadCount);
+    std::vector<uint16_t>().swap(cornerShard);
+
+    // 3. Каждый шард склеивается независимо; для угла запоминаем первый равный ему угол
+    std::vector<uint32_t> firstCorner(count);
+    Parallel::forEach(shardCount, [&](size_t shard) {
+        const size_t begin = shardBegin[shard];
+        const size_t end = shardBegin[shard + 1];
+        std::vector<Vertex> unique;
+        std::vector<uint32_t> uniqueFirstCorner;
+        VertexWelder welder(unique, (end - begin) / 2, positionEpsilon);
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t c = shardCorners[i];
+            const uint32_t local = welder.weld(corners[c]);
+            if (local == uniqueFirstCorner.size()) {
+                uniqueFirstCorner.push_back(c);
+            }
+            firstCorner[c] = uniqueFirstCorner[local];
+        }
+    }, threadCount);
+    std::vector<uint32_t>().swap(shardCorners);
+
+    // 4. Номер вершины — число первых вхождений до неё (префиксная сумма по блокам)
+    std::vector<size_t> blockUnique(blockCount + 1, 0);
+    Parallel::forEach(blockCount, [&](size_t block) {
+        size_t unique = 0;
+        for (size_t c = blockBegin(block); c < blockBegin(block + 1); ++c) {
+            unique += (firstCorner[c] == c);
+        }
+        blockUnique[block + 1] = unique;
+    }, threadCount);
+    for (size_t block = 0; block < blockCount; ++block) {
+        blockUnique[block + 1] += blockUnique[block];
+    }
+
+    const size_t vertexBase = vertices.size();
+    const size_t indexBase = indices.size();
+    if (vertexBase + blockUnique[blockCount] >= EMPTY) {
+        throw std::runtime_error("Too many unique vertices for 32-bit indices");
+    }
+    vertices.resize(vertexBase + blockUnique[blockCount]);
+    indices.resize(indexBase + count);
+
+    Parallel::forEach(blockCount, [&](size_t block) {
+        auto next = static_cast<uint32_t>(vertexBase + blockUnique[block]);
+        for (size_t c = blockBegin(block); c < blockBegin(block + 1); ++c) {
+            if (firstCorner[c] == c) {
+                vertices[next] = corners[c];
+                indices[indexBase + c] = next++;
+            }
+        }
+    }, threadCount);
+    // Остальные углы берут номер своего первого вхождения, записанный на предыдущем шаге;
+    // сами первые вхождения не переписываются — их в это время читают другие блоки
+    Parallel::forEach(blockCount, [&](size_t block) {
+        for (size_t c = blockBegin(block); c < blockBegin(block + 1); ++c) {
+            if (firstCorner[c] != c) {
+                indices[indexBase + c] = indices[indexBase + firstCorner[c]];
+            }
+        }
+    }, threadCount);
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Vertex.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Устранение дубликатов вершин на хеш-таблице с открытой адресацией
+ *
+ * Замена std::unordered_map<Vertex, uint32_t>: таблица плоская (линейное
+ * пробирование, без узлов в куче), ключ — упакованные байты вершины,
+ * хеш — Hash::bytes, поиск и вставка выполняются за один проход.
+ *
+ * В точном режиме вершины равны, если равны все компоненты (как в
+ * Vertex::operator==, то есть -0.0 == 0.0). С positionEpsilon > 0 позиции
+ * перед сравнением привязываются к сетке с шагом epsilon; остальные
+ * атрибуты по-прежнему сравниваются точно, поэтому швы UV сохраняются.
+ * В результат попадает первая встреченная вершина.
+ *
+ * Для больших сеток есть weldAll(): углы раскладываются по шардам по хешу
+ * ключа, каждый шард обрабатывается своим потоком, а итоговые номера вершин
+ * назначаются префиксной суммой в порядке углов. Поэтому результат не зависит
+ * от числа потоков и совпадает с последовательным вызовом weld() для всех углов.
+ */
+class VertexWelder {
+public:
+    /**
+     * @param vertices Массив, в который дописываются уникальные вершины
+     * @param expectedVertices Оценка числа уникальных вершин (резерв таблицы)
+     * @param positionEpsilon Шаг сетки позиций; 0 — точное сравнение
+     */
+    explicit VertexWelder(std::vector<Vertex>& vertices, size_t expectedVertices = 0, float positionEpsilon = 0.0f);
+
+    /**
+     * @brief Возвращает индекс вершины в vertices, добавляя её при первой встрече
+     */
+    uint32_t weld(const Vertex& vertex);
+
+    /// Число уникальных вершин, добавленных этим объектом
+    size_t size() const { return count_; }
+
+    /// Память, занятая таблицей (без самих вершин)
+    size_t memoryBytes() const { return slots_.capacity() * sizeof(Slot); }
+
+    /**
+     * @brief Параллельно устраняет дубликаты среди corners
+     *
+     * Дописывает уникальные вершины в vertices и по индексу на каждый угол в indices.
+     * @param threadCount Число потоков; 0 — по числу ядер
+     */
+    static void weldAll(const std::vector<Vertex>& corners, std::vector<Vertex>& vertices,
+                        std::vector<uint32_t>& indices, float positionEpsilon = 0.0f, unsigned threadCount = 0);
+
+private:
+    static constexpr size_t KEY_WORDS = sizeof(Vertex) / sizeof(uint32_t);
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    struct Key {
+        uint32_t words[KEY_WORDS];
+    };
+
+    struct Slot {
+        uint32_t fingerprint; ///< Старшие биты хеша: отсекают почти все лишние сравнения ключей
+        uint32_t index;       ///< Индекс в vertices_ или EMPTY
+    };
+
+    static Key makeKey(const Vertex& vertex, float inverseEpsilon);
+    Key makeKey(const Vertex& vertex) const { return makeKey(vertex, inverseEpsilon_); }
+    static uint64_t hashKey(const Key& key);
+    void rehash(size_t capacity);
+
+    std::vector<Vertex>& vertices_;
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t count_ = 0;
+    float inverseEpsilon_ = 0.0f;
+};
@@ -0,0 +1,133 @@
+#include "VirtualTexture.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    const char VTEX_MAGIC[8] = {'V', 'K', 'V', 'T', 'E', 'X', 0, 0};
+
+    inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    inline uint32_t levelExtent(uint32_t size, uint32_t level) {
+        return std::max(1u, size >> level);
+    }
+
+    /// Первая страница каждого уровня и общее число страниц (последний элемент)
+    std::vector<size_t> levelOffsets(uint32_t width, uint32_t height, uint32_t tileSize, uint32_t levelCount) {
+        std::vector<size_t> offsets(levelCount + 1, 0);
+        for (uint32_t level = 0; level < levelCount; ++level) {
+            offsets[level + 1] = offsets[level] + size_t{VirtualTexture::tilesAlong(width, level, tileSize)} *
+                                                  VirtualTexture::tilesAlong(height, level, tileSize);
+        }
+        return offsets;
+    }
+}
+
+uint32_t VirtualTexture::levelCount(uint32_t width, uint32_t height, uint32_t tileSize) {
+    uint32_t level = 0;
+    while (std::max(levelExtent(width, level), levelExtent(height, level)) > tileSize) {
+        ++level;
+    }
+    return level + 1;
+}
+
+uint32_t VirtualTexture::tilesAlong(uint32_t size, uint32_t level, uint32_t tileSize) {
+    return (levelExtent(size, level) + tileSize - 1) / tileSize;
+}
+
+VirtualTexture::VirtualTexture(const std::string& path) : file_(path) {
+    if (file_.size() < sizeof(Header)) {
+        throw std::runtime_error("Not a virtual texture: " + path);
+    }
+    std::memcpy(&header_, file_.data(), sizeof(Header));
+    if (std::memcmp(header_.magic, VTEX_MAGIC, sizeof(VTEX_MAGIC)) != 0 || header_.version != VERSION) {
+        throw std::runtime_error("Not a virtual texture: " + path);
+    }
+    const bool validLayout =
+        header_.width > 0 && header_.height > 0 && header_.tileSize > 0 && header_.border <= header_.tileSize &&
+        header_.levelCount == levelCount(header_.width, header_.height, header_.tileSize) &&
+        header_.levelCount <= MAX_LEVELS && header_.dataOffset % PAGE_SIZE == 0;
+    if (!validLayout) {
+        throw std::runtime_error("Corrupt virtual texture header: " + path);
+    }
+    std::vector<size_t> offsets = levelOffsets(header_.width, header_.height, header_.tileSize, header_.levelCount);
+    if (offsets.back() != header_.tileCount ||
+        header_.dataOffset > file_.size() ||
+        (file_.size() - header_.dataOffset) / getPageBytes() < header_.tileCount) {
+        throw std::runtime_error("Truncated virtual texture: " + path);
+    }
+    offsets.pop_back();
+    levelOffsets_ = std::move(offsets);
+}
+
+const uint8_t* VirtualTexture::getTileData(size_t tile) const {
+    return reinterpret_cast<const uint8_t*>(file_.data()) + header_.dataOffset + tile * getPageBytes();
+}
+
+void VirtualTexture::write(const std::string& path, uint32_t width, uint32_t height,
+                           const std::vector<const uint8_t*>& levels, uint32_t tileSize, uint32_t border) {
+    const uint32_t count = width > 0 && height > 0 && tileSize > 0 ? levelCount(width, height, tileSize) : 0;
+    if (count == 0 || count > MAX_LEVELS || border > tileSize || levels.size() < count) {
+        throw std::runtime_error("Invalid virtual texture level chain for " + path);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, VTEX_MAGIC, sizeof(VTEX_MAGIC));
+    header.version = VERSION;
+    header.width = width;
+    header.height = height;
+    header.tileSize = tileSize;
+    header.border = border;
+    header.levelCount = count;
+    header.dataOffset = alignUp(sizeof(Header), PAGE_SIZE);
+    header.tileCount = levelOffsets(width, height, tileSize, count).back();
+
+    const uint32_t extent = tileSize + 2 * border;
+    std::vector<uint8_t> page(size_t{extent} * extent * 4);
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to write virtual texture: " + tmpPath);
+        }
+        const std::vector<char> padding(header.dataOffset - sizeof(Header), 0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        for (uint32_t level = 0; level < count; ++level) {
+            const uint32_t levelWidth = levelExtent(width, level);
+            const uint32_t levelHeight = levelExtent(height, level);
+            const uint8_t* pixels = levels[level];
+            for (uint32_t tileY = 0; tileY < tilesAlong(height, level, tileSize); ++tileY) {
+                for (uint32_t tileX = 0; tileX < tilesAlong(width, level, tileSize); ++tileX) {
+                    // Тексель страницы (i, j) — тексель уровня со сдвигом на рамку; за краем уровня — крайний
+                    for (uint32_t j = 0; j < extent; ++j) {
+                        const int64_t sourceY = std::clamp<int64_t>(int64_t{tileY} * tileSize + j - border,
+                                                                    0, levelHeight - 1);
+                        const uint8_t* row = pixels + static_cast<size_t>(sourceY) * levelWidth * 4;
+                        for (uint32_t i = 0; i < extent; ++i) {
+                            const int64_t sourceX = std::clamp<int64_t>(int64_t{tileX} * tileSize + i - border,
+                                                                        0, levelWidth - 1);
+                            std::memcpy(&page[(size_t{j} * extent + i) * 4], row + sourceX * 4, 4);
+                        }
+                    }
+                    out.write(reinterpret_cast<const char*>(page.data()), static_cast<std::streamsize>(page.size()));
+                }
+            }
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write virtual texture: " + tmpPath);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        std::filesystem::remove(tmpPath, error);
+        throw std::runtime_error("Failed to write virtual texture: " + path);
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Текстура, заранее нарезанная на страницы для виртуального текстурирования (.vtex)
+ *
+ * Каждый мип-уровень разбит на квадратные страницы по tileSize полезных
+ * текселей; вокруг страницы — рамка border из соседних текселей того же
+ * уровня (на краях уровня — повтор крайнего), поэтому билинейная фильтрация
+ * внутри страницы атласа не задевает чужие страницы. Уровни идут до первого,
+ * который помещается в одну страницу. Страницы хранятся RGBA8 sRGB подряд:
+ * уровень 0 построчно, затем уровень 1 и т. д., каждая занимает ровно
+ * getPageBytes() байт, начиная с границы PAGE_SIZE, поэтому страница читается
+ * из отображённого файла одним обращением без разбора.
+ *
+ * Строки хранятся с переворотом по вертикали, как их загружает TextureManager.
+ * Размер текстуры ограничен только диском: в памяти остаются лишь нужные
+ * страницы, и ни один VkImage не должен вмещать уровень 0 целиком.
+ */
+class VirtualTexture {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t DEFAULT_TILE_SIZE = 120; ///< Со стандартной рамкой страница 128x128
+    static constexpr uint32_t DEFAULT_BORDER = 4;      ///< Хватает для билинейной и 4x анизотропной выборки
+    static constexpr uint32_t MAX_LEVELS = 16;
+    static constexpr uint64_t PAGE_SIZE = 4096;
+    static constexpr const char* EXTENSION = ".vtex";
+
+    struct Header {
+        char magic[8];       ///< "VKVTEX\0\0"
+        uint32_t version;    ///< VERSION
+        uint32_t width;      ///< Размер уровня 0 в текселях
+        uint32_t height;
+        uint32_t tileSize;   ///< Полезных текселей на сторону страницы
+        uint32_t border;     ///< Текселей рамки с каждой стороны
+        uint32_t levelCount; ///< levelCount(width, height, tileSize)
+        uint64_t dataOffset; ///< Кратно PAGE_SIZE
+        uint64_t tileCount;  ///< Страниц на всех уровнях
+    };
+
+    /**
+     * @brief Отображает файл и проверяет заголовок
+     * @throws std::runtime_error если файл не .vtex, повреждён или обрезан
+     */
+    explicit VirtualTexture(const std::string& path);
+
+    uint32_t getWidth() const { return header_.width; }
+    uint32_t getHeight() const { return header_.height; }
+    uint32_t getTileSize() const { return header_.tileSize; }
+    uint32_t getBorder() const { return header_.border; }
+    uint32_t getLevelCount() const { return header_.levelCount; }
+    /// Сторона страницы вместе с рамкой
+    uint32_t getPageExtent() const { return header_.tileSize + 2 * header_.border; }
+    size_t getPageBytes() const { return size_t{getPageExtent()} * getPageExtent() * 4; }
+    size_t getTileCount() const { return static_cast<size_t>(header_.tileCount); }
+    uint32_t getTilesX(uint32_t level) const { return tilesAlong(header_.width, level, header_.tileSize); }
+    uint32_t getTilesY(uint32_t level) const { return tilesAlong(header_.height, level, header_.tileSize); }
+
+    /// Номер страницы среди всех уровней
+    size_t tileIndex(uint32_t level, uint32_t x, uint32_t y) const {
+        return levelOffsets_[level] + size_t{y} * getTilesX(level) + x;
+    }
+    /// RGBA8 страницы с рамкой, getPageExtent() x getPageExtent(), прямо в отображённом файле
+    const uint8_t* getTileData(size_t tile) const;
+
+    /// Уровней до первого, который помещается в одну страницу
+    static uint32_t levelCount(uint32_t width, uint32_t height, uint32_t tileSize);
+    /// Страниц вдоль стороны size на уровне level
+    static uint32_t tilesAlong(uint32_t size, uint32_t level, uint32_t tileSize);
+
+    /**
+     * @brief Нарезает цепочку уровней на страницы и записывает .vtex (через временный файл)
+     * @param levels RGBA8 уровни от 0 с размерами MipChain::levels(); нужны первые levelCount()
+     * @throws std::runtime_error если уровней не хватает, размеры неверны или файл не записать
+     */
+    static void write(const std::string& path, uint32_t width, uint32_t height,
+                      const std::vector<const uint8_t*>& levels, uint32_t tileSize = DEFAULT_TILE_SIZE,
+                      uint32_t border = DEFAULT_BORDER);
+
+private:
+    MappedFile file_;
+    Header header_;
+    std::vector<size_t> levelOffsets_; ///< Номер первой страницы уровня
+};
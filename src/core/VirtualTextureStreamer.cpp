@@ -0,0 +1,287 @@
+#include "VirtualTextureStreamer.hpp"
+#include "VulkanUtils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+    /// Страниц по горизонтали и вертикали на каждом уровне
+    std::vector<std::pair<uint32_t, uint32_t>> tilesPerLevel(const VirtualTexture& texture) {
+        std::vector<std::pair<uint32_t, uint32_t>> tiles;
+        for (uint32_t level = 0; level < texture.getLevelCount(); ++level) {
+            tiles.emplace_back(texture.getTilesX(level), texture.getTilesY(level));
+        }
+        return tiles;
+    }
+}
+
+VirtualTextureStreamer::VirtualTextureStreamer(const std::string& path, BufferManager& bufferManager,
+                                               DeviceManager& deviceManager, SwapChainManager& swapChainManager)
+    : bufferManager_(bufferManager), deviceManager_(deviceManager), swapChainManager_(swapChainManager),
+      texture_(path), pageTable_(tilesPerLevel(texture_), ATLAS_PAGES * ATLAS_PAGES),
+      atlas_(nullptr, VulkanDeleter<VkImage_T, vkDestroyImage, VkDevice>(nullptr)),
+      atlasView_(nullptr, VulkanDeleter<VkImageView_T, vkDestroyImageView, VkDevice>(nullptr)),
+      sampler_(nullptr, VulkanDeleter<VkSampler_T, vkDestroySampler, VkDevice>(nullptr)),
+      pageTableBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
+      feedbackBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
+      stagingBuffer_(nullptr, VulkanDeleter<VkBuffer_T, vkDestroyBuffer, VkDevice>(nullptr)),
+      pending_(texture_.getTileCount(), false) {
+    const uint32_t coarsest = texture_.getLevelCount() - 1;
+    const size_t coarsestTiles = size_t{texture_.getTilesX(coarsest)} * texture_.getTilesY(coarsest);
+    if (coarsestTiles > pageTable_.slotCount() / 2) {
+        throw std::runtime_error("Coarsest level of " + path + " does not fit the page atlas");
+    }
+    createAtlas();
+    createSampler();
+
+    // Таблица страниц: заголовок и по записи на каждую страницу каждого уровня
+    pageTableSize_ = sizeof(PageTableHeader) + texture_.getTileCount() * sizeof(PageTable::Entry);
+    pageTableMapped_ = static_cast<PageTableHeader*>(createMappedBuffer(
+        pageTableSize_, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, pageTableBuffer_, pageTableMemory_));
+    PageTableHeader header{};
+    header.width = texture_.getWidth();
+    header.height = texture_.getHeight();
+    header.tileSize = texture_.getTileSize();
+    header.border = texture_.getBorder();
+    header.atlasPages = ATLAS_PAGES;
+    header.levelCount = texture_.getLevelCount();
+    header.frame = frame_;
+    for (uint32_t level = 0; level < texture_.getLevelCount(); ++level) {
+        header.levels[level][0] = static_cast<uint32_t>(pageTable_.levelOffset(level));
+        header.levels[level][1] = texture_.getTilesX(level);
+        header.levels[level][2] = texture_.getTilesY(level);
+    }
+    *pageTableMapped_ = header;
+
+    // Обратную связь читает CPU: кэшируемая память хоста читается на порядки быстрее write-combined
+    const VkDeviceSize feedbackSize = texture_.getTileCount() * sizeof(uint32_t);
+    VkMemoryPropertyFlags feedbackProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(deviceManager_.physicalDevice(), &memoryProperties);
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        const VkMemoryPropertyFlags cached = feedbackProperties | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        if ((memoryProperties.memoryTypes[i].propertyFlags & cached) == cached) {
+            feedbackProperties = cached;
+            break;
+        }
+    }
+    void* feedback = createMappedBuffer(feedbackSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                        feedbackProperties, feedbackBuffer_, feedbackMemory_);
+    std::memset(feedback, 0, feedbackSize);
+    feedbackMapped_ = static_cast<const uint32_t*>(feedback);
+
+    stagingMapped_ = static_cast<uint8_t*>(createMappedBuffer(
+        MAX_UPLOADS_PER_UPDATE * texture_.getPageBytes(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer_, stagingMemory_));
+
+    // Самый грубый уровень — сразу и навсегда: у любой страницы есть резидентный предок
+    std::vector<std::pair<uint32_t, const uint8_t*>> pages;
+    for (uint32_t y = 0; y < texture_.getTilesY(coarsest); ++y) {
+        for (uint32_t x = 0; x < texture_.getTilesX(coarsest); ++x) {
+            const size_t tile = texture_.tileIndex(coarsest, x, y);
+            pages.emplace_back(pageTable_.map(tile, true), texture_.getTileData(tile));
+        }
+    }
+    upload(pages, VK_IMAGE_LAYOUT_UNDEFINED);
+    writePageTable();
+
+    for (unsigned i = 0; i < LOADER_THREADS; ++i) {
+        loaders_.emplace_back(&VirtualTextureStreamer::loaderLoop, this);
+    }
+
+    const uint32_t atlasExtent = ATLAS_PAGES * texture_.getPageExtent();
+    std::cout << "Virtual texture " << path << ": " << texture_.getWidth() << "x" << texture_.getHeight() << ", "
+              << texture_.getLevelCount() << " levels, " << texture_.getTileCount() << " pages of "
+              << texture_.getPageExtent() << "x" << texture_.getPageExtent() << "; atlas " << atlasExtent << "x"
+              << atlasExtent << " (" << atlasExtent * double(atlasExtent) * 4 / (1024.0 * 1024.0)
+              << " MB), page table " << pageTableSize_ / 1024.0 << " KB" << std::endl;
+}
+
+VirtualTextureStreamer::~VirtualTextureStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& loader : loaders_) {
+        loader.join();
+    }
+}
+
+void VirtualTextureStreamer::createAtlas() {
+    const uint32_t extent = ATLAS_PAGES * texture_.getPageExtent();
+    swapChainManager_.createImage(extent, extent, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
+                                  VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, atlas_, atlasMemory_);
+    atlasView_ = swapChainManager_.createImageView(atlas_.get(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+void* VirtualTextureStreamer::createMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                                                 VkMemoryPropertyFlags properties, VkBufferPtr& buffer,
+                                                 MemoryAllocation& memory) {
+    buffer = bufferManager_.createBuffer(size, usage, properties, memory);
+    return memory.mapped();
+}
+
+void VirtualTextureStreamer::createSampler() {
+    // Уровень выбирает шейдер, а у атласа один уровень: только билинейная выборка внутри страницы
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = 0.0f;
+
+    VkSampler rawSampler;
+    if (vkCreateSampler(deviceManager_.device(), &samplerInfo, nullptr, &rawSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create texture sampler!");
+    }
+    sampler_ = VkSamplerPtr(rawSampler, VulkanDeleter<VkSampler_T, vkDestroySampler, VkDevice>(deviceManager_.device()));
+}
+
+VirtualTextureBindings VirtualTextureStreamer::bindings() const {
+    VirtualTextureBindings result;
+    result.sampler = sampler_.get();
+    result.atlas = atlasView_.get();
+    result.pageTable = pageTableBuffer_.get();
+    result.pageTableSize = pageTableSize_;
+    result.feedback = feedbackBuffer_.get();
+    result.feedbackSize = texture_.getTileCount() * sizeof(uint32_t);
+    return result;
+}
+
+void VirtualTextureStreamer::update() {
+    // Кадр с меткой frame_ завершён: drawFrame() дождался его fence
+    std::vector<size_t> requested;
+    for (size_t tile = 0; tile < texture_.getTileCount(); ++tile) {
+        if (feedbackMapped_[tile] == frame_) {
+            requested.push_back(tile);
+        }
+    }
+    const std::vector<size_t> missing = pageTable_.touch(requested);
+
+    std::vector<LoadedPage> loaded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Очередь заменяется заказом этого кадра: страницы, ушедшие с экрана до загрузки, не читаются
+        for (size_t tile : queue_) {
+            pending_[tile] = false;
+        }
+        queue_.clear();
+        for (size_t tile : missing) {
+            if (!pending_[tile]) {
+                pending_[tile] = true;
+                queue_.push_back(tile);
+            }
+        }
+        const size_t count = std::min(loaded_.size(), MAX_UPLOADS_PER_UPDATE);
+        loaded.assign(std::make_move_iterator(loaded_.begin()), std::make_move_iterator(loaded_.begin() + count));
+        loaded_.erase(loaded_.begin(), loaded_.begin() + count);
+    }
+    if (!queue_.empty()) {
+        wake_.notify_all();
+    }
+
+    // Готовые страницы получают слоты; если все слоты нужны этому кадру, страница будет заказана снова
+    std::vector<std::pair<uint32_t, const uint8_t*>> pages;
+    for (const LoadedPage& page : loaded) {
+        pending_[page.tile] = false;
+        const uint32_t slot = pageTable_.map(page.tile);
+        if (slot != PageTable::NO_SLOT) {
+            pages.emplace_back(slot, page.pixels.data());
+        }
+    }
+    if (!pages.empty()) {
+        upload(pages, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    if (pageTable_.isDirty()) {
+        writePageTable();
+    }
+
+    pageTable_.nextFrame();
+    ++frame_;
+    pageTableMapped_->frame = frame_;
+}
+
+void VirtualTextureStreamer::upload(const std::vector<std::pair<uint32_t, const uint8_t*>>& pages,
+                                    VkImageLayout oldLayout) {
+    const uint32_t extent = texture_.getPageExtent();
+    const size_t pageBytes = texture_.getPageBytes();
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = atlas_.get();
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    for (size_t first = 0; first < pages.size(); first += MAX_UPLOADS_PER_UPDATE) {
+        const size_t count = std::min(MAX_UPLOADS_PER_UPDATE, pages.size() - first);
+        std::vector<VkBufferImageCopy> regions(count);
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t slot = pages[first + i].first;
+            std::memcpy(stagingMapped_ + i * pageBytes, pages[first + i].second, pageBytes);
+            regions[i].bufferOffset = i * pageBytes;
+            regions[i].imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+            regions[i].imageOffset = {static_cast<int32_t>(slot % ATLAS_PAGES * extent),
+                                      static_cast<int32_t>(slot / ATLAS_PAGES * extent), 0};
+            regions[i].imageExtent = {extent, extent, 1};
+        }
+
+        // Остальные слоты атласа сохраняют содержимое: переход из SHADER_READ, а не из UNDEFINED
+        VkCommandBuffer commandBuffer = bufferManager_.beginSingleTimeCommands();
+        barrier.oldLayout = first == 0 ? oldLayout : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = barrier.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED ? 0 : VK_ACCESS_SHADER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer_.get(), atlas_.get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+        bufferManager_.endSingleTimeCommands(commandBuffer);
+    }
+}
+
+void VirtualTextureStreamer::writePageTable() {
+    const std::vector<PageTable::Entry>& entries = pageTable_.entries();
+    std::memcpy(pageTableMapped_ + 1, entries.data(), entries.size() * sizeof(PageTable::Entry));
+}
+
+void VirtualTextureStreamer::loaderLoop() {
+    const size_t pageBytes = texture_.getPageBytes();
+    for (;;) {
+        size_t tile;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            tile = queue_.front();
+            queue_.pop_front();
+        }
+        // Чтение из отображённого файла: страницы подкачиваются с диска здесь, а не на потоке рендера
+        const uint8_t* data = texture_.getTileData(tile);
+        LoadedPage page{tile, std::vector<uint8_t>(data, data + pageBytes)};
+        std::lock_guard<std::mutex> lock(mutex_);
+        loaded_.push_back(std::move(page));
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BufferManager.hpp"
+#include "DeviceManager.hpp"
+#include "PageTable.hpp"
+#include "SwapChainManager.hpp"
+#include "VirtualTexture.hpp"
+
+/// Ресурсы виртуальной текстуры для набора дескрипторов фрагментного шейдера (set = 1)
+struct VirtualTextureBindings {
+    VkSampler sampler = VK_NULL_HANDLE;
+    VkImageView atlas = VK_NULL_HANDLE;     ///< binding = 0: атлас физических страниц
+    VkBuffer pageTable = VK_NULL_HANDLE;    ///< binding = 1: заголовок и записи таблицы страниц
+    VkDeviceSize pageTableSize = 0;
+    VkBuffer feedback = VK_NULL_HANDLE;     ///< binding = 2: метки кадров, в которых страницы были нужны
+    VkDeviceSize feedbackSize = 0;
+};
+
+/**
+ * @brief Виртуальная текстура на GPU: атлас страниц, таблица страниц и обратная связь
+ *
+ * Уровень 0 не создаётся как VkImage, поэтому размер текстуры не ограничен
+ * maxImageDimension2D. В видеопамяти — атлас фиксированного размера
+ * (ATLAS_PAGES x ATLAS_PAGES страниц) и таблица страниц по 8 байт на страницу,
+ * так что расход памяти зависит от видимой детальности, а не от размера
+ * исходника.
+ *
+ * Фрагментный шейдер (shader_virtual.frag) выбирает уровень по производным
+ * UV, читает запись таблицы и берёт тексели из атласа; номер нужной страницы
+ * он пишет в буфер обратной связи меткой текущего кадра. update() после fence
+ * кадра читает этот буфер, ставит недостающие страницы в очередь потокам
+ * загрузки (они читают страницы из отображённого .vtex, поэтому обращения к
+ * диску идут не на потоке рендера) и заливает готовые страницы в атлас одной
+ * отправкой. Самый грубый уровень загружается сразу и не вытесняется.
+ */
+class VirtualTextureStreamer {
+public:
+    static constexpr uint32_t ATLAS_PAGES = 32;              ///< 4096x4096 текселей при странице 128
+    static constexpr unsigned LOADER_THREADS = 2;
+    static constexpr size_t MAX_UPLOADS_PER_UPDATE = 64;     ///< Страниц в атлас за кадр
+
+    /// Заголовок буфера таблицы страниц; раскладка std430 совпадает с shader_virtual.frag
+    struct PageTableHeader {
+        uint32_t width;
+        uint32_t height;
+        uint32_t tileSize;
+        uint32_t border;
+        uint32_t atlasPages;
+        uint32_t levelCount;
+        uint32_t frame;                 ///< Метка текущего кадра для обратной связи
+        uint32_t padding;
+        uint32_t levels[VirtualTexture::MAX_LEVELS][4]; ///< Первая запись уровня, страниц по x и по y, 0
+    };
+
+    /**
+     * @brief Открывает .vtex, создаёт атлас и буферы и загружает самый грубый уровень
+     * @throws std::runtime_error если файл не открыть или грубый уровень не помещается в атлас
+     */
+    VirtualTextureStreamer(const std::string& path, BufferManager& bufferManager, DeviceManager& deviceManager,
+                           SwapChainManager& swapChainManager);
+    ~VirtualTextureStreamer();
+
+    VirtualTextureStreamer(const VirtualTextureStreamer&) = delete;
+    VirtualTextureStreamer& operator=(const VirtualTextureStreamer&) = delete;
+
+    /**
+     * @brief Читает обратную связь завершённого кадра, заказывает страницы и заливает готовые
+     *
+     * Вызывается, когда GPU не использует атлас и таблицу (после ожидания fence кадра).
+     */
+    void update();
+
+    VirtualTextureBindings bindings() const;
+    const VirtualTexture& texture() const { return texture_; }
+
+private:
+    struct LoadedPage {
+        size_t tile = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    void createAtlas();
+    void createSampler();
+    /// Буфер в памяти хоста, отображённый на всё время жизни
+    void* createMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                             VkBufferPtr& buffer, MemoryAllocation& memory);
+    /// Копирует страницы в слоты атласа одним командным буфером
+    void upload(const std::vector<std::pair<uint32_t, const uint8_t*>>& pages, VkImageLayout oldLayout);
+    void writePageTable();
+    void loaderLoop();
+
+    BufferManager& bufferManager_;
+    DeviceManager& deviceManager_;
+    SwapChainManager& swapChainManager_;
+
+    VirtualTexture texture_;
+    PageTable pageTable_;
+    uint32_t frame_ = 1;
+
+    MemoryAllocation atlasMemory_;
+    VkImagePtr atlas_;
+    VkImageViewPtr atlasView_;
+    VkSamplerPtr sampler_;
+    MemoryAllocation pageTableMemory_;
+    VkBufferPtr pageTableBuffer_;
+    VkDeviceSize pageTableSize_ = 0;
+    PageTableHeader* pageTableMapped_ = nullptr;
+    MemoryAllocation feedbackMemory_;
+    VkBufferPtr feedbackBuffer_;
+    const uint32_t* feedbackMapped_ = nullptr;
+    MemoryAllocation stagingMemory_;
+    VkBufferPtr stagingBuffer_;
+    uint8_t* stagingMapped_ = nullptr;
+
+    // Очередь потоков загрузки; pending_ — страница в очереди, читается или ждёт заливки
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<size_t> queue_;
+    std::vector<LoadedPage> loaded_;
+    std::vector<bool> pending_;
+    bool stopping_ = false;
+    std::vector<std::thread> loaders_;
+};
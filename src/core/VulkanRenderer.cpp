@@ -1,4 +1,8 @@
 #include "VulkanRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
 
 
 VulkanRenderer::VulkanRenderer(WindowManager& windowManager, 
@@ -18,8 +22,9 @@ VulkanRenderer::VulkanRenderer(WindowManager& windowManager,
       instanceManager_(instanceManager),
       surfaceManager_(surfaceManager),
       commandManager_(commandManager),
-      bufferManager_(bufferManager),
-      textureManager_(textureManager),
+      bufferManager_(&bufferManager),
+      textureManager_(&textureManager),
+      mesh_(nullptr),
       enableValidationLayers_(enableValidationLayers),
       renderPass(nullptr, VulkanDeleter<VkRenderPass_T, vkDestroyRenderPass, VkDevice>(nullptr)),
       graphicsPipeline(nullptr, VulkanDeleter<VkPipeline_T, vkDestroyPipeline, VkDevice>(nullptr))
@@ -27,13 +32,62 @@ VulkanRenderer::VulkanRenderer(WindowManager& windowManager,
        {
         pipelineManager_.createDescriptorSetLayout();
         pipelineManager_.createPipelineLayout();
-        pipelineManager_.createGraphicsPipeline();
-        pipelineManager_.createDescriptorPool();
-        pipelineManager_.createDescriptorSets(bufferManager_.getUniformBuffers(),
-                                                textureManager_.getTextureSampler(),
-                                                textureManager_.getTextureImageView());
+        bindAssets();
       }
 
+void VulkanRenderer::bindAssets() {
+    mesh_ = &bufferManager_->getMesh();
+    const size_t virtualTextureCount = textureManager_->getVirtualTextureCount();
+    pipelineManager_.createGraphicsPipeline(mesh_->getVertexFormat(), virtualTextureCount > 0);
+    pipelineManager_.createDescriptorPool(textureManager_->getTextureCount(), virtualTextureCount);
+    pipelineManager_.createUniformSet(bufferManager_->getUniformBuffer());
+    pipelineManager_.createTextureDescriptorSets(textureManager_->getTextureSampler(),
+                                                 textureManager_->getTextureImageViews());
+    pipelineManager_.createVirtualTextureDescriptorSets(textureManager_->getVirtualTextureBindings());
+    lodSelector_ = LodSelector(mesh_->getLodLevels(), mesh_->getBoundingSphere().w);
+    currentLod_ = 0;
+    culledIndexCount_ = 0;
+    materialDraws_.clear();
+    buildMaterialDraws();
+}
+
+void VulkanRenderer::replaceAssets(BufferManager& bufferManager, TextureManager& textureManager) {
+    // Кадр в полёте один: после его fence старые буферы и наборы дескрипторов GPU больше не читает
+    VkFence rawInFlightFence = commandManager_.inFlightFence();
+    vkWaitForFences(deviceManager_.device(), 1, &rawInFlightFence, VK_TRUE, UINT64_MAX);
+    bufferManager_ = &bufferManager;
+    textureManager_ = &textureManager;
+    bindAssets();
+}
+
+void VulkanRenderer::buildMaterialDraws() {
+    const std::vector<Material>& materials = mesh_->getMaterials();
+    for (const Submesh& submesh : mesh_->getSubmeshes()) {
+        DrawCall draw;
+        draw.firstIndex = submesh.firstIndex;
+        draw.indexCount = submesh.indexCount;
+        draw.texture = textureManager_->getMaterialTexture(submesh.material);
+        draw.virtualTexture = textureManager_->getMaterialVirtualTexture(submesh.material);
+        draw.constants.diffuse = glm::vec4(materials[submesh.material].diffuse, 1.0f);
+        draw.constants.texture = draw.texture;
+        materialDraws_.push_back(draw);
+    }
+    // Материалы с общей текстурой подряд: набор дескрипторов меняется один раз на текстуру,
+    // а виртуальные текстуры в конце, чтобы конвейер переключался один раз
+    std::stable_sort(materialDraws_.begin(), materialDraws_.end(), [](const DrawCall& a, const DrawCall& b) {
+        return a.virtualTexture != b.virtualTexture ? a.virtualTexture < b.virtualTexture : a.texture < b.texture;
+    });
+
+    if (materialDraws_.size() > 1) {
+        std::cout << materialDraws_.size() << " draw calls per frame, ";
+        if (pipelineManager_.isBindless()) {
+            std::cout << "one bindless array of " << textureManager_->getTextureCount() << " textures" << std::endl;
+        } else {
+            std::cout << textureManager_->getTextureCount() << " texture bindings" << std::endl;
+        }
+    }
+}
+
 void VulkanRenderer::drawFrame() {
     // Получаем сырые указатели из умных
     VkFence rawInFlightFence = commandManager_.inFlightFence();
@@ -43,6 +97,8 @@ void VulkanRenderer::drawFrame() {
     // Ожидаем завершение предыдущего кадра
     vkWaitForFences(deviceManager_.device(), 1, &rawInFlightFence, VK_TRUE, UINT64_MAX);
     vkResetFences(deviceManager_.device(), 1, &rawInFlightFence);
+    // GPU дочитал uniform-данные предыдущего кадра: область снова свободна
+    bufferManager_->beginUniformFrame();
 
 
     // Получаем индекс изображения из цепочки подкачки
@@ -56,15 +112,34 @@ void VulkanRenderer::drawFrame() {
     &imageIndex);
 
 
-    updateUniformBuffer(currentFrame);
+    updateUniformBuffer();
 
 
     VkCommandBuffer commandBuffer = commandManager_.getCommandBuffer();
     
     // Подготавливаем командный буфер
     vkResetCommandBuffer(commandManager_.getCommandBuffer(), 0);
-    commandManager_.recordCommandBuffer(commandManager_.getCommandBuffer(), imageIndex,
-                             bufferManager_.getVertexBuffer(), bufferManager_.getIndexBuffer());
+    if (materialDraws_.size() > 1) {
+        // Несколько материалов: LOD и мешлеты для такой модели не строятся, рисуется LOD0 по диапазонам
+        commandManager_.recordCommandBuffer(commandManager_.getCommandBuffer(), imageIndex,
+                                 mesh_->getVertexBuffer(), mesh_->getIndexBuffer(),
+                                 materialDraws_, mesh_->getVertexQuantization());
+    } else if (mesh_->getMeshlets().meshlets.empty()) {
+        // Один материал: уровень детализации — диапазон общего индексного буфера
+        frameDraws_.assign(1, materialDraws_[0]);
+        frameDraws_[0].firstIndex = lodSelector_.level(currentLod_).firstIndex;
+        frameDraws_[0].indexCount = lodSelector_.level(currentLod_).indexCount;
+        commandManager_.recordCommandBuffer(commandManager_.getCommandBuffer(), imageIndex,
+                                 mesh_->getVertexBuffer(), mesh_->getIndexBuffer(),
+                                 frameDraws_, mesh_->getVertexQuantization());
+    } else {
+        frameDraws_.assign(1, materialDraws_[0]);
+        frameDraws_[0].firstIndex = 0;
+        frameDraws_[0].indexCount = culledIndexCount_;
+        commandManager_.recordCommandBuffer(commandManager_.getCommandBuffer(), imageIndex,
+                                 mesh_->getVertexBuffer(), mesh_->getCulledIndexBuffer(),
+                                 frameDraws_, mesh_->getVertexQuantization());
+    }
 
 
     // Настраиваем информацию для отправки команд
@@ -85,7 +160,8 @@ void VulkanRenderer::drawFrame() {
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    // Отправляем командный буфер в очередь
+    // Отправляем командный буфер в очередь; её же с фонового потока использует AssetLoader
+    std::unique_lock<std::mutex> queueLock(swapChainManager_.getQueueMutex());
     if (vkQueueSubmit(swapChainManager_.getGraphicsQueue(), 1, &submitInfo, rawInFlightFence) != VK_SUCCESS) {
         throw std::runtime_error("failed to submit draw command buffer!");
     }
@@ -103,8 +179,9 @@ void VulkanRenderer::drawFrame() {
 
     // Отображаем кадр
     vkQueuePresentKHR(swapChainManager_.getPresentQueue(), &presentInfo);
+    queueLock.unlock();
 }
-void VulkanRenderer::updateUniformBuffer(uint32_t currentImage) {
+void VulkanRenderer::updateUniformBuffer() {
     static auto startTime = std::chrono::high_resolution_clock::now();
 
     auto currentTime = std::chrono::high_resolution_clock::now();
@@ -116,5 +193,76 @@ void VulkanRenderer::updateUniformBuffer(uint32_t currentImage) {
     ubo.proj = glm::perspective(glm::radians(45.0f), swapChainManager_.getSwapChainExtent().width / (float) swapChainManager_.getSwapChainExtent().height, 0.1f, 10.0f);
     ubo.proj[1][1] *= -1;
 
-    memcpy(bufferManager_.getUniformBuffersMapped()[currentImage], &ubo, sizeof(ubo));
-}
\ No newline at end of file
+    // Все вызовы рисуют одну модель и делят один срез; у объекта со своей матрицей был бы свой
+    const BufferManager::UniformSlice slice = bufferManager_->allocateUniform(sizeof(ubo));
+    memcpy(slice.data, &ubo, sizeof(ubo));
+    for (DrawCall& draw : materialDraws_) {
+        draw.uniformOffset = slice.offset;
+    }
+    if (mesh_->getMeshlets().meshlets.empty()) {
+        selectLod(ubo);
+    } else {
+        cullMeshlets(ubo);
+    }
+    if (textureManager_->isStreaming()) {
+        streamTextures(ubo);
+    }
+    // Обратная связь прочитана после fence кадра; новые страницы появятся в этом кадре
+    textureManager_->updateVirtualTextures();
+}
+
+void VulkanRenderer::selectLod(const UniformBufferObject& ubo) {
+    const glm::vec4 sphere = mesh_->getBoundingSphere();
+    const glm::vec4 center = ubo.view * ubo.model * glm::vec4(glm::vec3(sphere), 1.0f);
+    const float distance = -center.z; // Камера смотрит вдоль -z в пространстве вида
+
+    float projectedRadius = std::numeric_limits<float>::max(); // Камера внутри сферы: только LOD0
+    if (distance > sphere.w) {
+        const float halfHeight = swapChainManager_.getSwapChainExtent().height * 0.5f;
+        projectedRadius = sphere.w * std::fabs(ubo.proj[1][1]) / distance * halfHeight;
+    }
+
+    currentLod_ = lodSelector_.select(projectedRadius);
+}
+void VulkanRenderer::streamTextures(const UniformBufferObject& ubo) {
+    // Ближайшая к камере точка описанной сферы задаёт самый детальный уровень, который может понадобиться
+    const glm::vec4 sphere = mesh_->getBoundingSphere();
+    const glm::vec4 center = ubo.view * ubo.model * glm::vec4(glm::vec3(sphere), 1.0f);
+    const float distance = std::max(0.1f, glm::length(glm::vec3(center)) - sphere.w); // 0.1 — ближняя плоскость
+    const float worldPerPixel =
+        2.0f * distance / (std::fabs(ubo.proj[1][1]) * swapChainManager_.getSwapChainExtent().height);
+
+    // UV на единицу длины: из развёртки диапазона, а если она неизвестна — текстура на диаметр модели
+    const std::vector<float>& uvDensity = mesh_->getUvDensity();
+    const float fallbackDensity = sphere.w > 0.0f ? 0.5f / sphere.w : 1.0f;
+    const std::vector<Submesh>& submeshes = mesh_->getSubmeshes();
+    for (size_t k = 0; k < submeshes.size(); ++k) {
+        const float density = k < uvDensity.size() && uvDensity[k] > 0.0f ? uvDensity[k] : fallbackDensity;
+        textureManager_->requestDetail(textureManager_->getMaterialTexture(submeshes[k].material),
+                                       density * worldPerPixel);
+    }
+
+    // Кадр, читавший прежние наборы, уже завершён: drawFrame() дождался его fence
+    const std::vector<uint32_t> changed = textureManager_->updateResidency();
+    if (changed.empty()) {
+        return;
+    }
+    const std::vector<VkImageView> views = textureManager_->getTextureImageViews();
+    for (uint32_t texture : changed) {
+        pipelineManager_.updateTextureDescriptorSet(texture, textureManager_->getTextureSampler(), views[texture]);
+    }
+}
+
+void VulkanRenderer::cullMeshlets(const UniformBufferObject& ubo) {
+    const glm::mat4 modelView = ubo.view * ubo.model;
+    const MeshletBuilder::Frustum frustum = MeshletBuilder::Frustum::fromMatrix(ubo.proj * modelView);
+    const glm::vec3 cameraPosition = glm::vec3(glm::inverse(modelView)[3]); // Камера в пространстве модели
+
+    const MeshletMesh& meshlets = mesh_->getMeshlets();
+    MeshletBuilder::cull(meshlets, frustum, cameraPosition, culledIndices_);
+
+    // Предыдущий кадр уже завершён: drawFrame() дождался его fence
+    culledIndexCount_ = static_cast<uint32_t>(culledIndices_.size());
+    memcpy(mesh_->getCulledIndexBufferMapped(), culledIndices_.data(),
+           culledIndices_.size() * sizeof(uint32_t));
+}
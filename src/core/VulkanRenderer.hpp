@@ -10,6 +10,7 @@
 #include "Vertex.hpp"
 #include "BufferManager.hpp"
 #include "TextureManager.hpp"
+#include "LodSelector.hpp"
 #include <memory>
 #include <chrono>
 #include <glm/glm.hpp>
@@ -36,9 +37,44 @@ public:
      */
     void drawFrame();
 
-    void updateUniformBuffer(uint32_t currentImage);
+    void updateUniformBuffer();
+
+    /**
+     * @brief Переключает рендер на другие ресурсы модели на границе кадров
+     *
+     * Дожидается кадра в полёте и пересоздаёт конвейер (формат вершин мог
+     * измениться), наборы дескрипторов, выбор LOD и вызовы отрисовки. Прежние
+     * BufferManager/TextureManager после возврата можно освобождать.
+     */
+    void replaceAssets(BufferManager& bufferManager, TextureManager& textureManager);
 
 private:
+    /**
+     * @brief Создаёт всё, что зависит от текущих bufferManager_, его сетки и textureManager_
+     */
+    void bindAssets();
+
+    /**
+     * @brief Выбирает уровень детализации по радиусу описанной сферы модели на экране
+     */
+    void selectLod(const UniformBufferObject& ubo);
+
+    /**
+     * @brief Вызовы отрисовки по материалам модели, отсортированные по текстуре
+     */
+    void buildMaterialDraws();
+
+    /**
+     * @brief Отсекает мешлеты по пирамиде видимости и конусам нормалей и пишет индексы видимых в отображённый индексный буфер сетки
+     */
+    void cullMeshlets(const UniformBufferObject& ubo);
+
+    /**
+     * @brief С --texture-budget: заявляет нужную детальность текстур по размеру модели на экране
+     * и подгружает уровни; пересозданные текстуры получают новые наборы дескрипторов
+     */
+    void streamTextures(const UniformBufferObject& ubo);
+
     
     // Ссылки на менеджеры (владение объектами остается за ними)
     InstanceManager& instanceManager_;
@@ -48,12 +84,18 @@ private:
     PipelineManager& pipelineManager_;
     CommandManager& commandManager_;
     WindowManager& windowManager_;
-    BufferManager& bufferManager_;
-    TextureManager& textureManager_;
+    BufferManager* bufferManager_;   ///< Сначала заглушка, затем модель из AssetLoader
+    TextureManager* textureManager_;
+    const Mesh* mesh_;               ///< Рисуемая сетка из реестра bufferManager_
   
     bool enableValidationLayers_;///< Флаг использования слоев валидации
 
-    uint32_t currentFrame = 0;
+    LodSelector lodSelector_;
+    size_t currentLod_ = 0;
+    std::vector<uint32_t> culledIndices_; ///< Переиспользуется между кадрами, чтобы не выделять память
+    uint32_t culledIndexCount_ = 0;
+    std::vector<DrawCall> materialDraws_; ///< По одному на Submesh, в порядке смены текстур
+    std::vector<DrawCall> frameDraws_;    ///< Вызовы текущего кадра; переиспользуется между кадрами
 
     VkRenderPassPtr renderPass;
     VkPipelinePtr graphicsPipeline;
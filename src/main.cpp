@@ -1,11 +1,9 @@
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
 #include "core/Application.hpp"
 #include <iostream>
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "Starting application..." << std::endl;
-    Application app;
+    Application app(Options::parse(argc, argv));
     try {
         app.run();
     } catch (const std::exception& e) {
@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "BlockCompression.hpp"
+
+namespace {
+    /// Эталонные декодеры по спецификации BCn: кодировщик проверяется через восстановленные пиксели
+    void decodeBc1(const uint8_t* block, uint8_t* pixels) {
+        const uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+        const uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+        int palette[4][4];
+        const uint16_t colors[2] = {color0, color1};
+        for (int e = 0; e < 2; ++e) {
+            const int r = (colors[e] >> 11) & 31, g = (colors[e] >> 5) & 63, b = colors[e] & 31;
+            palette[e][0] = (r << 3) | (r >> 2);
+            palette[e][1] = (g << 2) | (g >> 4);
+            palette[e][2] = (b << 3) | (b >> 2);
+            palette[e][3] = 255;
+        }
+        for (int c = 0; c < 3; ++c) {
+            if (color0 > color1) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            } else {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = color0 > color1 ? 255 : 0;
+        const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (uint32_t{block[7]} << 24);
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                pixels[i * 4 + c] = static_cast<uint8_t>(palette[(indices >> (2 * i)) & 3][c]);
+            }
+        }
+    }
+
+    void decodeBc4(const uint8_t* block, uint8_t* values) {
+        const int a0 = block[0], a1 = block[1];
+        int palette[8] = {a0, a1};
+        if (a0 > a1) {
+            for (int i = 1; i < 7; ++i) {
+                palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+            }
+        } else {
+            for (int i = 1; i < 5; ++i) {
+                palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+        uint64_t indices = 0;
+        for (int i = 0; i < 6; ++i) {
+            indices |= uint64_t{block[2 + i]} << (8 * i);
+        }
+        for (int i = 0; i < 16; ++i) {
+            values[i] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+        }
+    }
+
+    uint32_t readBits(const uint8_t* block, int& position, int count) {
+        uint32_t value = 0;
+        for (int i = 0; i < count; ++i, ++position) {
+            value |= uint32_t{(block[position >> 3] >> (position & 7)) & 1u} << i;
+        }
+        return value;
+    }
+
+    /// Только режим 6 — другие кодировщик не выдаёт
+    void decodeBc7Mode6(const uint8_t* block, uint8_t* pixels) {
+        const int weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+        int position = 0;
+        ASSERT_EQ(readBits(block, position, 7), 1u << 6);
+        int endpoints[2][4];
+        for (int c = 0; c < 4; ++c) {
+            endpoints[0][c] = static_cast<int>(readBits(block, position, 7));
+            endpoints[1][c] = static_cast<int>(readBits(block, position, 7));
+        }
+        const int p0 = static_cast<int>(readBits(block, position, 1));
+        const int p1 = static_cast<int>(readBits(block, position, 1));
+        for (int c = 0; c < 4; ++c) {
+            endpoints[0][c] = (endpoints[0][c] << 1) | p0;
+            endpoints[1][c] = (endpoints[1][c] << 1) | p1;
+        }
+        for (int i = 0; i < 16; ++i) {
+            const int w = weights[readBits(block, position, i == 0 ? 3 : 4)];
+            for (int c = 0; c < 4; ++c) {
+                pixels[i * 4 + c] = static_cast<uint8_t>(((64 - w) * endpoints[0][c] + w * endpoints[1][c] + 32) >> 6);
+            }
+        }
+        EXPECT_EQ(position, 128);
+    }
+
+    /// Плавный градиент с шумом: похож на фотографическую текстуру
+    std::vector<uint8_t> photo(uint32_t width, uint32_t height) {
+        std::vector<uint8_t> pixels(size_t{width} * height * 4);
+        uint32_t state = 777;
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                state = state * 1664525u + 1013904223u;
+                const int noise = static_cast<int>(state >> 29) - 4;
+                uint8_t* pixel = &pixels[(size_t{y} * width + x) * 4];
+                pixel[0] = static_cast<uint8_t>(std::min(255, std::max(0, static_cast<int>(x * 255 / width) + noise)));
+                pixel[1] = static_cast<uint8_t>(std::min(255, std::max(0, static_cast<int>(y * 255 / height) + noise)));
+                pixel[2] = static_cast<uint8_t>(128 + noise);
+                pixel[3] = 255;
+            }
+        }
+        return pixels;
+    }
+
+    /// PSNR по выбранным каналам [first, first + count)
+    double psnr(const uint8_t* a, const uint8_t* b, size_t pixelCount, int first, int count) {
+        double sum = 0.0;
+        for (size_t i = 0; i < pixelCount; ++i) {
+            for (int c = first; c < first + count; ++c) {
+                const double difference = static_cast<int>(a[i * 4 + c]) - static_cast<int>(b[i * 4 + c]);
+                sum += difference * difference;
+            }
+        }
+        const double mse = sum / (pixelCount * count);
+        return mse == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+    }
+
+    /// Распаковывает всё изображение обратно в RGBA8
+    std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded, uint32_t width, uint32_t height,
+                                BlockCompression::Format format) {
+        const uint32_t blocksX = (width + 3) / 4;
+        const size_t bytes = BlockCompression::blockBytes(format);
+        std::vector<uint8_t> pixels(size_t{width} * height * 4);
+        for (uint32_t by = 0; by < (height + 3) / 4; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                const uint8_t* block = &encoded[(size_t{by} * blocksX + bx) * bytes];
+                uint8_t tile[64] = {};
+                if (format == BlockCompression::Format::BC1) {
+                    decodeBc1(block, tile);
+                } else if (format == BlockCompression::Format::BC7) {
+                    decodeBc7Mode6(block, tile);
+                } else {
+                    uint8_t red[16], green[16];
+                    decodeBc4(block, red);
+                    decodeBc4(block + 8, green);
+                    for (int i = 0; i < 16; ++i) {
+                        tile[i * 4] = red[i];
+                        tile[i * 4 + 1] = green[i];
+                    }
+                }
+                for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y) {
+                    for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x) {
+                        std::copy(tile + (y * 4 + x) * 4, tile + (y * 4 + x) * 4 + 4,
+                                  &pixels[((size_t{by} * 4 + y) * width + bx * 4 + x) * 4]);
+                    }
+                }
+            }
+        }
+        return pixels;
+    }
+}
+
+TEST(BlockCompressionTest, EncodedSizes) {
+    using BlockCompression::Format;
+    EXPECT_EQ(BlockCompression::encodedSize(Format::BC1, 256, 256), 256u * 256u / 2u); // 4 бита на пиксель
+    EXPECT_EQ(BlockCompression::encodedSize(Format::BC7, 256, 256), 256u * 256u);      // 8 бит на пиксель
+    EXPECT_EQ(BlockCompression::encodedSize(Format::BC5, 5, 3), 2u * 1u * 16u);       // Неполные блоки округляются
+    EXPECT_EQ(BlockCompression::encodedSize(Format::BC1, 1, 1), 8u);
+}
+
+TEST(BlockCompressionTest, SolidBlocksAreNearlyExact) {
+    uint8_t pixels[64];
+    for (int i = 0; i < 16; ++i) {
+        pixels[i * 4] = 200;
+        pixels[i * 4 + 1] = 100;
+        pixels[i * 4 + 2] = 50;
+        pixels[i * 4 + 3] = 255;
+    }
+    uint8_t block[16];
+    uint8_t decoded[64];
+
+    BlockCompression::encodeBc1Block(pixels, block);
+    decodeBc1(block, decoded);
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_NEAR(decoded[i * 4], 200, 4);     // Шаг 5 бит
+        EXPECT_NEAR(decoded[i * 4 + 1], 100, 2); // Шаг 6 бит
+        EXPECT_EQ(decoded[i * 4 + 3], 255);
+    }
+
+    BlockCompression::encodeBc7Block(pixels, block);
+    decodeBc7Mode6(block, decoded);
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_NEAR(decoded[i], pixels[i], 1); // 7 бит и p-бит: ошибка не больше единицы
+    }
+
+    BlockCompression::encodeBc5Block(pixels, block);
+    uint8_t red[16], green[16];
+    decodeBc4(block, red);
+    decodeBc4(block + 8, green);
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(red[i], 200);
+        EXPECT_EQ(green[i], 100);
+    }
+}
+
+TEST(BlockCompressionTest, Bc1KeepsPunchThroughAlpha) {
+    uint8_t pixels[64];
+    for (int i = 0; i < 16; ++i) {
+        pixels[i * 4] = static_cast<uint8_t>(i * 16);
+        pixels[i * 4 + 1] = 64;
+        pixels[i * 4 + 2] = 32;
+        pixels[i * 4 + 3] = (i % 3 == 0) ? 0 : 255;
+    }
+    uint8_t block[8];
+    uint8_t decoded[64];
+    BlockCompression::encodeBc1Block(pixels, block);
+    decodeBc1(block, decoded);
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(decoded[i * 4 + 3], pixels[i * 4 + 3]) << "pixel " << i;
+    }
+}
+
+TEST(BlockCompressionTest, Bc7AnchorIndexFitsThreeBits) {
+    // Градиент от светлого к тёмному: без перестановки концов первый пиксель получил бы индекс >= 8
+    uint8_t pixels[64];
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            pixels[i * 4 + c] = static_cast<uint8_t>(255 - i * 17);
+        }
+    }
+    uint8_t block[16];
+    uint8_t decoded[64];
+    BlockCompression::encodeBc7Block(pixels, block);
+    decodeBc7Mode6(block, decoded);
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_NEAR(decoded[i], pixels[i], 3);
+    }
+}
+
+TEST(BlockCompressionTest, ImageQualityAndThreadIndependence) {
+    using BlockCompression::Format;
+    const uint32_t width = 67;
+    const uint32_t height = 45;
+    const std::vector<uint8_t> pixels = photo(width, height);
+    const size_t pixelCount = size_t{width} * height;
+
+    const double minimumPsnr[3] = {30.0, 38.0, 38.0};
+    const Format formats[3] = {Format::BC1, Format::BC5, Format::BC7};
+    for (int f = 0; f < 3; ++f) {
+        const std::vector<uint8_t> single = BlockCompression::encode(pixels.data(), width, height, formats[f], 1);
+        const std::vector<uint8_t> multi = BlockCompression::encode(pixels.data(), width, height, formats[f], 4);
+        ASSERT_EQ(single.size(), BlockCompression::encodedSize(formats[f], width, height));
+        EXPECT_EQ(single, multi);
+
+        const std::vector<uint8_t> decoded = decode(single, width, height, formats[f]);
+        const int channels = formats[f] == Format::BC5 ? 2 : (formats[f] == Format::BC7 ? 4 : 3);
+        EXPECT_GT(psnr(pixels.data(), decoded.data(), pixelCount, 0, channels), minimumPsnr[f]) << "format " << f;
+    }
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "FrameArena.hpp"
+
+TEST(FrameArenaTest, SlicesAreAlignedAndConsecutive) {
+    FrameArena arena(4096, 256, 2);
+    arena.begin(0);
+    EXPECT_EQ(arena.allocate(208), 0u);
+    EXPECT_EQ(arena.allocate(208), 256u); // Следующий срез — с границы выравнивания
+    EXPECT_EQ(arena.allocate(1), 512u);
+    EXPECT_EQ(arena.used(), 513u);
+    EXPECT_EQ(arena.size(), 2u * 4096u);
+}
+
+TEST(FrameArenaTest, FramesUseSeparateRegions) {
+    FrameArena arena(1000, 256, 3);
+    EXPECT_EQ(arena.frameCapacity(), 1024u); // Округлена, чтобы области начинались с границы
+    arena.begin(1);
+    EXPECT_EQ(arena.allocate(100), 1024u);
+    arena.begin(2);
+    EXPECT_EQ(arena.allocate(100), 2048u);
+
+    // Сброс кадра не трогает остальные: кадр 2 продолжает с прежней вершины
+    arena.begin(1);
+    EXPECT_EQ(arena.allocate(100), 1024u);
+    arena.begin(2);
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.peak(), 100u);
+}
+
+TEST(FrameArenaTest, FullFrameReturnsNoSpace) {
+    FrameArena arena(1024, 256, 2);
+    arena.begin(0);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NE(arena.allocate(200), FrameArena::NO_SPACE);
+    }
+    EXPECT_EQ(arena.allocate(1), FrameArena::NO_SPACE);
+    EXPECT_EQ(arena.allocate(2048), FrameArena::NO_SPACE);
+
+    // Соседний кадр не переполняется из-за текущего
+    arena.begin(1);
+    EXPECT_EQ(arena.allocate(1024), 1024u);
+    EXPECT_EQ(arena.allocate(1), FrameArena::NO_SPACE);
+
+    // После сброса место снова есть
+    arena.begin(0);
+    EXPECT_EQ(arena.allocate(1024), 0u);
+    EXPECT_EQ(arena.peak(), 1024u);
+}
+
+TEST(FrameArenaTest, RejectsInvalidParameters) {
+    EXPECT_THROW(FrameArena(1024, 48, 2), std::runtime_error);
+    EXPECT_THROW(FrameArena(1024, 256, 0), std::runtime_error);
+    FrameArena arena(1024, 256, 2);
+    EXPECT_THROW(arena.begin(2), std::runtime_error);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "GltfLoader.hpp"
+#include "Json.hpp"
+#include "ObjParser.hpp"
+#include "TangentSpace.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    /// Собирает .glb из JSON и бинарного чанка
+    void writeGlb(const fs::path& path, std::string json, std::vector<uint8_t> binary) {
+        json.resize((json.size() + 3) & ~size_t{3}, ' ');
+        binary.resize((binary.size() + 3) & ~size_t{3}, 0);
+        auto word = [](std::ofstream& file, uint32_t value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        std::ofstream file(path, std::ios::binary);
+        word(file, 0x46546C67);
+        word(file, 2);
+        word(file, static_cast<uint32_t>(12 + 8 + json.size() + 8 + binary.size()));
+        word(file, static_cast<uint32_t>(json.size()));
+        word(file, 0x4E4F534A);
+        file.write(json.data(), json.size());
+        word(file, static_cast<uint32_t>(binary.size()));
+        word(file, 0x004E4942);
+        file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+    }
+
+    template <typename T>
+    void append(std::vector<uint8_t>& binary, std::initializer_list<T> values) {
+        for (T value : values) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+            binary.insert(binary.end(), bytes, bytes + sizeof(T));
+        }
+    }
+
+    // Треугольник (36 байт), индексы uint16 (6 байт + 2 выравнивания), «изображение» (8 байт)
+    std::vector<uint8_t> triangleBuffer() {
+        std::vector<uint8_t> binary;
+        append<float>(binary, {0, 0, 0, 1, 0, 0, 0, 1, 0});
+        append<uint16_t>(binary, {0, 1, 2, 0});
+        const char image[] = "fakepng!";
+        binary.insert(binary.end(), image, image + 8);
+        return binary;
+    }
+
+    const std::string TRIANGLE_VIEWS = R"("buffers":[{"byteLength":52}],
+        "bufferViews":[{"buffer":0,"byteLength":36},{"buffer":0,"byteOffset":36,"byteLength":6},
+                       {"buffer":0,"byteOffset":44,"byteLength":8}])";
+}
+
+TEST(GltfLoaderTest, ParsesJson) {
+    const std::string text = R"( {"a": [1, -2.5e2, true, null], "s": "x\n\"\u00e9\ud83d\ude00", "o": {"k": {}}} )";
+    const Json::Value root = Json::parse(text.data(), text.size());
+    ASSERT_TRUE(root.isObject());
+    EXPECT_EQ(root["a"].size(), 4u);
+    EXPECT_EQ(root["a"][1].number(), -250.0);
+    EXPECT_TRUE(root["a"][2].boolean());
+    EXPECT_TRUE(root["a"][3].isNull());
+    EXPECT_EQ(root["s"].string(), "x\n\"\xC3\xA9\xF0\x9F\x98\x80");
+    EXPECT_TRUE(root["o"]["k"].isObject());
+    EXPECT_TRUE(root["missing"]["deeper"][3].isNull());
+
+    for (const std::string bad : {"[1,]", "{\"a\" 1}", "\"open", "tru", "[1] 2", "01x", "\"\\ud800\""}) {
+        EXPECT_THROW(Json::parse(bad.data(), bad.size()), std::runtime_error) << bad;
+    }
+}
+
+TEST(GltfLoaderTest, RoundTripsObjModel) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+    TangentSpace::generateNormals(vertices, indices);
+    TangentSpace::generateTangents(vertices, indices);
+
+    const auto glbPath = fs::temp_directory_path() / "gltf_round_trip.glb";
+    GltfLoader::writeGlb(glbPath.string(), vertices, indices);
+
+    GltfLoader gltf(glbPath.string());
+    ASSERT_EQ(gltf.vertexCount(), vertices.size());
+    ASSERT_EQ(gltf.indexCount(), indices.size());
+    EXPECT_TRUE(gltf.hasNormals());
+    EXPECT_TRUE(gltf.hasTangents());
+    ASSERT_EQ(gltf.getMeshMaterials().submeshes.size(), 1u);
+
+    for (unsigned threads : {1u, 4u}) {
+        std::vector<Vertex> loaded(gltf.vertexCount());
+        std::vector<uint32_t> loadedIndices(gltf.indexCount());
+        gltf.writeVertices(loaded.data(), threads);
+        gltf.writeIndices(loadedIndices.data());
+
+        EXPECT_EQ(loadedIndices, indices); // uint32 без смещения: копируется как есть
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            ASSERT_EQ(loaded[i].pos, vertices[i].pos);
+            ASSERT_EQ(loaded[i].normal, vertices[i].normal);
+            ASSERT_EQ(loaded[i].tangent, vertices[i].tangent);
+            ASSERT_NEAR(loaded[i].texCoord.x, vertices[i].texCoord.x, 1e-6f);
+            ASSERT_NEAR(loaded[i].texCoord.y, vertices[i].texCoord.y, 1e-6f); // v переворачивается дважды
+        }
+    }
+
+    const glm::vec4 sphere = gltf.getBoundingSphere();
+    for (const Vertex& vertex : vertices) {
+        ASSERT_LE(glm::length(vertex.pos - glm::vec3(sphere)), sphere.w * 1.0001f);
+    }
+    fs::remove(glbPath);
+}
+
+TEST(GltfLoaderTest, NodeTransformsAndMaterials) {
+    const auto path = fs::temp_directory_path() / "gltf_scene.glb";
+    writeGlb(path, R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],
+        "nodes":[{"children":[1],"translation":[10,0,0]},{"mesh":0,"scale":[-1,1,1]}],
+        "meshes":[{"primitives":[{"attributes":{"POSITION":0},"indices":1,"material":1},
+                                 {"attributes":{"POSITION":0}},
+                                 {"attributes":{"POSITION":0},"mode":1}]}],
+        "materials":[{"name":"unused"},
+                     {"name":"red","pbrMetallicRoughness":{"baseColorFactor":[1,0,0,1],"baseColorTexture":{"index":0}}}],
+        "textures":[{"source":0}],"images":[{"bufferView":2,"mimeType":"image/png"}],
+        "accessors":[{"bufferView":0,"componentType":5126,"count":3,"type":"VEC3","min":[0,0,0],"max":[1,1,0]},
+                     {"bufferView":1,"componentType":5123,"count":3,"type":"SCALAR"}],)" + TRIANGLE_VIEWS + "}",
+             triangleBuffer());
+
+    GltfLoader gltf(path.string());
+    ASSERT_EQ(gltf.vertexCount(), 6u); // Линии (mode 1) пропущены
+    ASSERT_EQ(gltf.indexCount(), 6u);
+    EXPECT_FALSE(gltf.hasNormals());
+
+    const std::vector<Submesh> submeshes = {{0, 3, 0}, {3, 3, 1}};
+    EXPECT_EQ(gltf.getMeshMaterials().submeshes, submeshes);
+    const std::vector<Material>& materials = gltf.getMaterials();
+    ASSERT_EQ(materials.size(), 2u);
+    EXPECT_EQ(materials[0].name, "red");
+    EXPECT_EQ(materials[0].diffuse, glm::vec3(1.0f, 0.0f, 0.0f));
+    EXPECT_EQ(materials[0].embeddedImage, 0);
+    EXPECT_EQ(materials[1].diffuse, glm::vec3(1.0f));
+    EXPECT_EQ(materials[1].embeddedImage, -1);
+    EXPECT_TRUE(materials[1].resolved);
+
+    const std::vector<std::vector<uint8_t>> images = gltf.copyEmbeddedImages();
+    ASSERT_EQ(images.size(), 1u);
+    EXPECT_EQ(std::string(images[0].begin(), images[0].end()), "fakepng!");
+
+    std::vector<Vertex> vertices(6);
+    std::vector<uint32_t> indices(6);
+    gltf.writeVertices(vertices.data());
+    gltf.writeIndices(indices.data());
+    EXPECT_EQ(vertices[1].pos, glm::vec3(9.0f, 0.0f, 0.0f)); // x' = 10 - x
+    EXPECT_EQ(vertices[5].pos, glm::vec3(10.0f, 1.0f, 0.0f));
+    EXPECT_EQ(vertices[0].color, glm::vec3(1.0f));
+    const std::vector<uint32_t> flipped = {0, 2, 1, 3, 5, 4}; // Зеркальный масштаб меняет обход
+    EXPECT_EQ(indices, flipped);
+
+    const glm::vec4 sphere = gltf.getBoundingSphere();
+    EXPECT_EQ(glm::vec3(sphere), glm::vec3(9.5f, 0.5f, 0.0f));
+    fs::remove(path);
+}
+
+TEST(GltfLoaderTest, RejectsInvalidFiles) {
+    const auto path = fs::temp_directory_path() / "gltf_invalid.glb";
+    auto load = [&](const std::string& accessors, const std::string& extra = "") {
+        writeGlb(path, R"({"asset":{"version":"2.0"},"meshes":[{"primitives":[{"attributes":{"POSITION":0},"indices":1}]}],
+            "accessors":[)" + accessors + "]," + extra + TRIANGLE_VIEWS + "}", triangleBuffer());
+        GltfLoader gltf(path.string());
+        std::vector<Vertex> vertices(gltf.vertexCount());
+        std::vector<uint32_t> indices(gltf.indexCount());
+        gltf.writeVertices(vertices.data());
+        gltf.writeIndices(indices.data());
+    };
+    const std::string position = R"({"bufferView":0,"componentType":5126,"count":3,"type":"VEC3"})";
+    const std::string index = R"({"bufferView":1,"componentType":5123,"count":3,"type":"SCALAR"})";
+
+    EXPECT_NO_THROW(load(position + "," + index));
+    // Аксессор длиннее своего bufferView
+    EXPECT_THROW(load(R"({"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"},)" + index), std::runtime_error);
+    // Индекс за пределами вершин примитива
+    EXPECT_THROW(load(R"({"bufferView":0,"componentType":5126,"count":2,"type":"VEC3"},)" + index), std::runtime_error);
+    EXPECT_THROW(load(position + "," + index, R"("extensionsRequired":["KHR_draco_mesh_compression"],)"),
+                 std::runtime_error);
+
+    std::ofstream(path, std::ios::binary) << "glTF is not JSON";
+    EXPECT_THROW(GltfLoader(path.string()), std::runtime_error);
+    fs::remove(path);
+    EXPECT_THROW(GltfLoader(path.string()), std::runtime_error);
+}
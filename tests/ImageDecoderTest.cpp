@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <stb_image.h>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "ImageDecoder.hpp"
+
+namespace {
+    std::vector<uint8_t> readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    /// Результат обычного stbi_load: строки сверху вниз, буфер из кучи
+    std::vector<uint8_t> referenceDecode(const std::vector<uint8_t>& file, int& width, int& height) {
+        int channels;
+        stbi_uc* pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+                                                &width, &height, &channels, STBI_rgb_alpha);
+        std::vector<uint8_t> result(pixels, pixels + size_t(width) * height * 4);
+        stbi_image_free(pixels);
+        return result;
+    }
+}
+
+TEST(ImageDecoderTest, DecodesPngAndJpegBottomUp) {
+    for (const char* path : {"textures/viking.png", "textures/texture.jpg"}) {
+        const std::vector<uint8_t> file = readFile(path);
+        ASSERT_FALSE(file.empty()) << path;
+        int referenceWidth, referenceHeight;
+        const std::vector<uint8_t> reference = referenceDecode(file, referenceWidth, referenceHeight);
+
+        uint32_t width = 0, height = 0;
+        ASSERT_TRUE(ImageDecoder::probe(file.data(), file.size(), width, height)) << path;
+        ASSERT_EQ(width, static_cast<uint32_t>(referenceWidth));
+        ASSERT_EQ(height, static_cast<uint32_t>(referenceHeight));
+
+        // Запас по краям ловит запись мимо назначения
+        const size_t rowSize = size_t{width} * 4;
+        std::vector<uint8_t> destination(rowSize * height + 32, 0xCD);
+        ASSERT_TRUE(ImageDecoder::decode(file.data(), file.size(), destination.data() + 16, width, height));
+        for (uint32_t y = 0; y < height; ++y) {
+            ASSERT_EQ(std::memcmp(destination.data() + 16 + y * rowSize,
+                                  reference.data() + (height - 1 - y) * rowSize, rowSize), 0) << path << " row " << y;
+        }
+        for (size_t i = 0; i < 16; ++i) {
+            EXPECT_EQ(destination[i], 0xCD);
+            EXPECT_EQ(destination[destination.size() - 1 - i], 0xCD);
+        }
+    }
+}
+
+TEST(ImageDecoderTest, RejectsCorruptAndMismatchedImages) {
+    std::vector<uint8_t> file = readFile("textures/texture.jpg");
+    ASSERT_FALSE(file.empty());
+    uint32_t width = 0, height = 0;
+    ASSERT_TRUE(ImageDecoder::probe(file.data(), file.size(), width, height));
+
+    // Размеры не совпали с заявленными: в назначение другого размера не пишется
+    std::vector<uint8_t> destination(size_t{width} * height * 4);
+    EXPECT_FALSE(ImageDecoder::decode(file.data(), file.size(), destination.data(), width - 1, height));
+
+    const uint8_t garbage[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    EXPECT_FALSE(ImageDecoder::probe(garbage, sizeof(garbage), width, height));
+    EXPECT_FALSE(ImageDecoder::decode(garbage, sizeof(garbage), destination.data(), 2, 2));
+
+    // После неудачи обычные выделения stb_image снова идут в кучу
+    int referenceWidth, referenceHeight;
+    EXPECT_FALSE(referenceDecode(file, referenceWidth, referenceHeight).empty());
+}
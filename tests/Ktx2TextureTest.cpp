@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "Ktx2Texture.hpp"
+
+namespace {
+    /// Уровни с узнаваемым содержимым: байт = номер уровня + смещение
+    std::vector<std::vector<uint8_t>> makeLevels(VkFormat format, uint32_t width, uint32_t height, uint32_t count) {
+        std::vector<std::vector<uint8_t>> levels(count);
+        for (uint32_t level = 0; level < count; ++level) {
+            levels[level].resize(Ktx2Texture::levelSize(format, std::max(1u, width >> level),
+                                                        std::max(1u, height >> level)));
+            for (size_t i = 0; i < levels[level].size(); ++i) {
+                levels[level][i] = static_cast<uint8_t>(level * 31 + i);
+            }
+        }
+        return levels;
+    }
+
+    std::vector<char> readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& path, const std::vector<char>& bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+TEST(Ktx2TextureTest, LevelSizes) {
+    EXPECT_EQ(Ktx2Texture::levelSize(VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 256, 128), 64u * 32u * 8u);
+    EXPECT_EQ(Ktx2Texture::levelSize(VK_FORMAT_BC7_SRGB_BLOCK, 2, 1), 16u); // Меньше блока — всё равно блок
+    EXPECT_EQ(Ktx2Texture::levelSize(VK_FORMAT_BC5_UNORM_BLOCK, 9, 4), 3u * 16u);
+    EXPECT_EQ(Ktx2Texture::levelSize(VK_FORMAT_R8G8B8A8_SRGB, 3, 3), 36u);
+    EXPECT_TRUE(Ktx2Texture::isBlockCompressed(VK_FORMAT_BC7_UNORM_BLOCK));
+    EXPECT_FALSE(Ktx2Texture::isBlockCompressed(VK_FORMAT_R8G8B8A8_UNORM));
+    EXPECT_FALSE(Ktx2Texture::isSupportedFormat(VK_FORMAT_BC3_SRGB_BLOCK));
+    EXPECT_THROW(Ktx2Texture::levelSize(VK_FORMAT_D32_SFLOAT, 4, 4), std::runtime_error);
+}
+
+TEST(Ktx2TextureTest, WriteAndReadRoundTrip) {
+    const std::string path = "ktx2_roundtrip_test.ktx2";
+    const VkFormat formats[3] = {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, VK_FORMAT_BC5_UNORM_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK};
+    for (VkFormat format : formats) {
+        const std::vector<std::vector<uint8_t>> levels = makeLevels(format, 37, 20, 6);
+        Ktx2Texture::write(path, format, 37, 20, levels);
+
+        Ktx2Texture texture(path);
+        EXPECT_EQ(texture.getFormat(), format);
+        EXPECT_EQ(texture.getWidth(), 37u);
+        EXPECT_EQ(texture.getHeight(), 20u);
+        EXPECT_EQ(texture.getOrientation(), Ktx2Texture::ORIENTATION);
+        ASSERT_EQ(texture.getLevelCount(), 6u);
+        size_t total = 0;
+        for (uint32_t level = 0; level < 6; ++level) {
+            ASSERT_EQ(texture.getLevelSize(level), levels[level].size());
+            EXPECT_EQ(std::memcmp(texture.getLevelData(level), levels[level].data(), levels[level].size()), 0);
+            total += levels[level].size();
+        }
+        EXPECT_EQ(texture.getDataSize(), total);
+        // Уровни в файле — от меньшего к большему
+        EXPECT_LT(texture.getLevelData(5), texture.getLevelData(0));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Ktx2TextureTest, HeaderFieldsFollowSpecification) {
+    const std::string path = "ktx2_header_test.ktx2";
+    Ktx2Texture::write(path, VK_FORMAT_BC7_SRGB_BLOCK, 8, 8, makeLevels(VK_FORMAT_BC7_SRGB_BLOCK, 8, 8, 4));
+    const std::vector<char> bytes = readFile(path);
+    std::remove(path.c_str());
+    ASSERT_GE(bytes.size(), 80u);
+
+    const unsigned char identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    EXPECT_EQ(std::memcmp(bytes.data(), identifier, 12), 0);
+    uint32_t fields[9];
+    std::memcpy(fields, bytes.data() + 12, sizeof(fields));
+    EXPECT_EQ(fields[0], static_cast<uint32_t>(VK_FORMAT_BC7_SRGB_BLOCK));
+    EXPECT_EQ(fields[1], 1u); // typeSize
+    EXPECT_EQ(fields[4], 0u); // pixelDepth
+    EXPECT_EQ(fields[5], 0u); // layerCount
+    EXPECT_EQ(fields[6], 1u); // faceCount
+    EXPECT_EQ(fields[7], 4u); // levelCount
+    EXPECT_EQ(fields[8], 0u); // Без суперсжатия
+
+    // DFD: модель цвета KHR_DF_MODEL_BC7 и передаточная функция sRGB
+    uint32_t dfdOffset;
+    std::memcpy(&dfdOffset, bytes.data() + 48, 4);
+    uint32_t descriptor[3];
+    std::memcpy(descriptor, bytes.data() + dfdOffset + 4, sizeof(descriptor));
+    EXPECT_EQ(descriptor[2] & 0xFF, 134u);
+    EXPECT_EQ((descriptor[2] >> 16) & 0xFF, 2u);
+
+    // Данные каждого уровня выровнены по размеру блока
+    for (uint32_t level = 0; level < 4; ++level) {
+        uint64_t offset;
+        std::memcpy(&offset, bytes.data() + 80 + level * 24, 8);
+        EXPECT_EQ(offset % 16, 0u);
+    }
+}
+
+TEST(Ktx2TextureTest, RejectsInvalidFiles) {
+    const std::string path = "ktx2_invalid_test.ktx2";
+    EXPECT_THROW(Ktx2Texture::write(path, VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, 8, {std::vector<uint8_t>(7)}),
+                 std::runtime_error);
+    EXPECT_THROW(Ktx2Texture::write(path, VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, 8,
+                                    makeLevels(VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, 8, 5)), std::runtime_error);
+
+    Ktx2Texture::write(path, VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, 8, makeLevels(VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, 8, 4));
+    const std::vector<char> valid = readFile(path);
+
+    std::vector<char> broken = valid;
+    broken[1] = 'X';
+    writeFile(path, broken);
+    EXPECT_THROW(Ktx2Texture texture(path), std::runtime_error);
+
+    broken = valid;
+    broken[44] = 2; // supercompressionScheme = Zstandard
+    writeFile(path, broken);
+    EXPECT_THROW(Ktx2Texture texture(path), std::runtime_error);
+
+    broken = valid;
+    broken.resize(broken.size() - 1); // Последний уровень (уровень 0) обрезан
+    writeFile(path, broken);
+    EXPECT_THROW(Ktx2Texture texture(path), std::runtime_error);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "Material.hpp"
+#include "ObjParser.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    void writeText(const fs::path& path, const std::string& text) {
+        std::ofstream(path, std::ios::binary).write(text.data(), text.size());
+    }
+
+    std::vector<Material> parseText(const std::string& text, const std::string& directory = "") {
+        return MaterialLibrary::parse(text.data(), text.size(), directory);
+    }
+
+    /**
+     * @brief OBJ из отдельных треугольников, материал которых закодирован в z вершин
+     *
+     * Материалы чередуются через usemtl, первые грани идут до первого usemtl;
+     * файл больше 256 КБ, чтобы разбиться на несколько участков.
+     */
+    std::string stripedObj(size_t triangleCount, size_t run) {
+        const char* names[] = {"red", "green", "blue"};
+        std::ostringstream obj;
+        obj << "mtllib striped.mtl\n";
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const size_t runIndex = t / run;
+            const int material = runIndex == 0 ? -1 : static_cast<int>(runIndex % 3); // -1 — до первого usemtl
+            if (t % run == 0 && material >= 0) {
+                obj << "usemtl " << names[material] << "\n";
+            }
+            for (int k = 0; k < 3; ++k) {
+                obj << "v " << t << " " << k << " " << material << "\n";
+            }
+            obj << "f -3 -2 -1\n";
+        }
+        return obj.str();
+    }
+}
+
+TEST(MaterialTest, ParsesLibrary) {
+    const std::vector<Material> materials = parseText(
+        "# comment\n"
+        "newmtl first\n"
+        "Kd 0.25 0.5 0.75\n"
+        "map_Kd -s 1 1 1 -bm 0.5 textures/first.png\n"
+        "newmtl grey\r\n"
+        "Kd 0.5\r\n"
+        "newmtl plain\n",
+        "model");
+
+    ASSERT_EQ(materials.size(), 3u);
+    EXPECT_EQ(materials[0].name, "first");
+    EXPECT_EQ(materials[0].diffuse, glm::vec3(0.25f, 0.5f, 0.75f));
+    EXPECT_EQ(materials[0].diffuseTexture, "model/textures/first.png");
+    EXPECT_TRUE(materials[0].resolved);
+
+    EXPECT_EQ(materials[1].name, "grey");
+    EXPECT_EQ(materials[1].diffuse, glm::vec3(0.5f));
+    EXPECT_TRUE(materials[1].diffuseTexture.empty());
+
+    EXPECT_EQ(materials[2].diffuse, glm::vec3(1.0f));
+}
+
+TEST(MaterialTest, GroupsTrianglesStably) {
+    std::vector<uint32_t> indices = {7, 7, 7, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    const std::vector<uint32_t> triangleMaterials = {2, 0, 2, 0};
+    const std::vector<Submesh> submeshes = MaterialLibrary::groupByMaterial(indices, 3, triangleMaterials, 3);
+
+    const std::vector<uint32_t> expected = {7, 7, 7, 3, 4, 5, 9, 10, 11, 0, 1, 2, 6, 7, 8};
+    EXPECT_EQ(indices, expected);
+    const std::vector<Submesh> expectedSubmeshes = {{3, 6, 0}, {9, 6, 2}}; // Пустой материал 1 пропущен
+    EXPECT_EQ(submeshes, expectedSubmeshes);
+
+    EXPECT_THROW(MaterialLibrary::groupByMaterial(indices, 3, {0, 0, 3, 0}, 3), std::runtime_error);
+    EXPECT_THROW(MaterialLibrary::groupByMaterial(indices, 3, {0}, 3), std::runtime_error);
+}
+
+TEST(MaterialTest, MissingLibraryIsNotFatal) {
+    MeshMaterials meshMaterials;
+    meshMaterials.materialNames = {"", "absent"};
+    meshMaterials.libraries = {(fs::temp_directory_path() / "no_such_library.mtl").generic_string()};
+
+    std::vector<Material> materials;
+    ASSERT_NO_THROW(materials = MaterialLibrary::resolve(meshMaterials));
+    ASSERT_EQ(materials.size(), 2u);
+    EXPECT_EQ(materials[1].name, "absent");
+    EXPECT_FALSE(materials[0].resolved);
+    EXPECT_FALSE(materials[1].resolved);
+}
+
+TEST(MaterialTest, ParserGroupsAcrossChunks) {
+    const auto modelPath = fs::temp_directory_path() / "striped.obj";
+    writeText(modelPath, stripedObj(6000, 700));
+    writeText(fs::temp_directory_path() / "striped.mtl",
+              "newmtl red\nKd 1 0 0\nnewmtl green\nKd 0 1 0\nnewmtl blue\nKd 0 0 1\nmap_Kd blue.png\n");
+    ASSERT_GT(fs::file_size(modelPath), 256u * 1024u);
+
+    std::vector<std::vector<uint32_t>> results;
+    for (unsigned threads : {1u, 4u}) {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        ObjParser parser(threads);
+        parser.load(modelPath.string(), vertices, indices);
+        const MeshMaterials& meshMaterials = parser.getMaterials();
+
+        // Порядок первого появления: грани до usemtl, затем green, blue, red
+        const std::vector<std::string> names = {"", "green", "blue", "red"};
+        const float materialZ[] = {-1.0f, 1.0f, 2.0f, 0.0f};
+        EXPECT_EQ(meshMaterials.materialNames, names);
+        ASSERT_EQ(meshMaterials.submeshes.size(), names.size());
+
+        uint32_t next = 0;
+        for (const Submesh& submesh : meshMaterials.submeshes) {
+            EXPECT_EQ(submesh.firstIndex, next);
+            next += submesh.indexCount;
+            for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i) {
+                ASSERT_EQ(vertices[indices[i]].pos.z, materialZ[submesh.material]);
+            }
+        }
+        EXPECT_EQ(next, indices.size());
+        EXPECT_EQ(meshMaterials.libraries.size(), 1u);
+
+        const std::vector<Material> materials = MaterialLibrary::resolve(meshMaterials);
+        EXPECT_FALSE(materials[0].resolved);
+        EXPECT_EQ(materials[3].diffuse, glm::vec3(1.0f, 0.0f, 0.0f));
+        EXPECT_EQ(fs::path(materials[2].diffuseTexture), fs::temp_directory_path() / "blue.png");
+        results.push_back(indices);
+    }
+    EXPECT_EQ(results[0], results[1]);
+
+    fs::remove(modelPath);
+    fs::remove(fs::temp_directory_path() / "striped.mtl");
+}
+
+TEST(MaterialTest, SplitsModelByMaterial) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser parser;
+    parser.load("model/escandalosos.obj", vertices, indices);
+    const MeshMaterials& meshMaterials = parser.getMaterials();
+
+    EXPECT_EQ(meshMaterials.materialNames.size(), 7u);
+    ASSERT_EQ(meshMaterials.submeshes.size(), 7u);
+    uint32_t next = 0;
+    for (const Submesh& submesh : meshMaterials.submeshes) {
+        EXPECT_EQ(submesh.firstIndex, next);
+        next += submesh.indexCount;
+    }
+    EXPECT_EQ(next, indices.size());
+
+    const std::vector<Material> materials = MaterialLibrary::resolve(meshMaterials);
+    for (const Material& material : materials) {
+        EXPECT_TRUE(material.resolved) << material.name;
+    }
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "MeshCache.hpp"
+#include "ObjParser.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    void writeText(const fs::path& path, const std::string& text) {
+        std::ofstream(path, std::ios::binary).write(text.data(), text.size());
+    }
+
+    const std::string QUAD_OBJ =
+        "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+        "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+        "f 1/1 2/2 3/3 4/4\n";
+}
+
+TEST(MeshCacheTest, RoundTrip) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+
+    const auto modelPath = fs::temp_directory_path() / "mesh_cache_test.obj";
+    fs::copy_file(MODEL_PATH, modelPath, fs::copy_options::overwrite_existing);
+    ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices));
+
+    {
+        MeshCache cache;
+        ASSERT_TRUE(cache.open(modelPath.string()));
+        ASSERT_EQ(vertices.size(), cache.vertexCount());
+        ASSERT_EQ(indices.size(), cache.indexCount());
+        EXPECT_EQ(0, std::memcmp(vertices.data(), cache.vertices(), vertices.size() * sizeof(Vertex)));
+        EXPECT_EQ(0, std::memcmp(indices.data(), cache.indices(), indices.size() * sizeof(uint32_t)));
+
+        // Отображение начинается с границы страницы, значит и массивы выровнены по странице
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(cache.vertices()) % MeshCache::PAGE_SIZE);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(cache.indices()) % MeshCache::PAGE_SIZE);
+    }
+
+    fs::remove(MeshCache::cachePath(modelPath.string()));
+    fs::remove(modelPath);
+}
+
+TEST(MeshCacheTest, StaleWhenSourceChanges) {
+    const auto modelPath = fs::temp_directory_path() / "mesh_cache_stale.obj";
+    writeText(modelPath, QUAD_OBJ);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(modelPath.string(), vertices, indices);
+    ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices));
+
+    MeshCache cache;
+    EXPECT_TRUE(cache.open(modelPath.string()));
+    EXPECT_FALSE(cache.open(modelPath.string(), 0.01f)); // Кэш собран без склейки по позиции
+    EXPECT_FALSE(cache.open(modelPath.string(), 0.0f, MeshCache::PROCESS_VERTEX_CACHE)); // И без оптимизации порядка
+
+    // Тот же размер, другое содержимое: отличить можно только по хешу
+    std::string changed = QUAD_OBJ;
+    changed[2] = '5';
+    writeText(modelPath, changed);
+    EXPECT_FALSE(cache.open(modelPath.string()));
+    EXPECT_EQ(nullptr, cache.vertices());
+
+    fs::remove(MeshCache::cachePath(modelPath.string()));
+    fs::remove(modelPath);
+}
+
+TEST(MeshCacheTest, RejectsCorruptedCache) {
+    const auto modelPath = fs::temp_directory_path() / "mesh_cache_corrupt.obj";
+    writeText(modelPath, QUAD_OBJ);
+    writeText(MeshCache::cachePath(modelPath.string()), "not a mesh cache");
+
+    MeshCache cache;
+    EXPECT_FALSE(cache.open(modelPath.string()));
+    EXPECT_FALSE(cache.open("non_existent_model.obj"));
+
+    fs::remove(MeshCache::cachePath(modelPath.string()));
+    fs::remove(modelPath);
+}
+
+TEST(MeshCacheTest, RejectsHeaderAndIndicesOutOfRange) {
+    const auto modelPath = fs::temp_directory_path() / "mesh_cache_range.obj";
+    writeText(modelPath, QUAD_OBJ);
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(modelPath.string(), vertices, indices);
+    const std::string path = MeshCache::cachePath(modelPath.string());
+
+    // Подменяет поле заголовка или индекс уже записанного кэша
+    auto patch = [&](uint64_t offset, const void* value, size_t size) {
+        ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices));
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(static_cast<const char*>(value), static_cast<std::streamsize>(size));
+    };
+    MeshCache::Header header{};
+    ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices));
+    std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    // vertexOffset + vertexCount * sizeof(Vertex) переполняет uint64 и оказывается меньше размера файла
+    const uint64_t wrappingCount = (UINT64_MAX / sizeof(Vertex)) + 1;
+    patch(offsetof(MeshCache::Header, vertexCount), &wrappingCount, sizeof(wrappingCount));
+    MeshCache cache;
+    EXPECT_FALSE(cache.open(modelPath.string()));
+
+    const uint64_t wrappingIndexCount = (UINT64_MAX / sizeof(uint32_t)) + 1;
+    patch(offsetof(MeshCache::Header, indexCount), &wrappingIndexCount, sizeof(wrappingIndexCount));
+    EXPECT_FALSE(cache.open(modelPath.string()));
+
+    // Индекс за последней вершиной: хеш исходной модели при этом совпадает
+    const uint32_t badIndex = static_cast<uint32_t>(vertices.size());
+    patch(header.indexOffset + sizeof(uint32_t), &badIndex, sizeof(badIndex));
+    EXPECT_FALSE(cache.open(modelPath.string()));
+
+    ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices));
+    {
+        MeshCache valid;
+        EXPECT_TRUE(valid.open(modelPath.string()));
+    }
+    fs::remove(path);
+    fs::remove(modelPath);
+}
+
+TEST(MeshCacheTest, StoresLodTable) {
+    const auto modelPath = fs::temp_directory_path() / "mesh_cache_lods.obj";
+    writeText(modelPath, QUAD_OBJ);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(modelPath.string(), vertices, indices);
+    indices.insert(indices.end(), {0, 1, 2}); // Условный «LOD1» из одного треугольника
+    const std::vector<LodLevel> lods = {{0, 6, 0.0f}, {6, 3, 0.25f}};
+    ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices, MeshCache::PROCESS_LOD, lods));
+
+    MeshCache cache;
+    EXPECT_FALSE(cache.open(modelPath.string())); // Без LOD индексный массив был бы другим
+    ASSERT_TRUE(cache.open(modelPath.string(), 0.0f, MeshCache::PROCESS_LOD));
+    const std::vector<LodLevel> stored = cache.lods();
+    ASSERT_EQ(lods.size(), stored.size());
+    for (size_t i = 0; i < lods.size(); ++i) {
+        EXPECT_EQ(lods[i].firstIndex, stored[i].firstIndex);
+        EXPECT_EQ(lods[i].indexCount, stored[i].indexCount);
+        EXPECT_EQ(lods[i].error, stored[i].error);
+    }
+
+    fs::remove(MeshCache::cachePath(modelPath.string()));
+    fs::remove(modelPath);
+}
+
+TEST(MeshCacheTest, StoresMaterialTable) {
+    const auto modelPath = fs::temp_directory_path() / "mesh_cache_materials.obj";
+    writeText(modelPath, QUAD_OBJ);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(modelPath.string(), vertices, indices);
+    MeshMaterials materials;
+    materials.submeshes = {{0, 3, 1}, {3, 3, 0}};
+    materials.materialNames = {"", "second"};
+    materials.libraries = {"model/first.mtl", "model/second.mtl"};
+    ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices, 0, {}, materials));
+
+    MeshCache cache;
+    ASSERT_TRUE(cache.open(modelPath.string()));
+    EXPECT_EQ(materials.submeshes, cache.materials().submeshes);
+    EXPECT_EQ(materials.materialNames, cache.materials().materialNames);
+    EXPECT_EQ(materials.libraries, cache.materials().libraries);
+
+    // Диапазон за пределами индексного буфера — повреждённый кэш
+    materials.submeshes = {{0, 9, 0}};
+    ASSERT_TRUE(MeshCache::store(modelPath.string(), 0.0f, vertices, indices, 0, {}, materials));
+    EXPECT_FALSE(cache.open(modelPath.string()));
+
+    fs::remove(MeshCache::cachePath(modelPath.string()));
+    fs::remove(modelPath);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include "MeshOptimizer.hpp"
+#include "ObjParser.hpp"
+
+namespace {
+    // Треугольник с точностью до циклического сдвига: обход грани должен сохраниться
+    std::array<uint32_t, 3> canonicalTriangle(const uint32_t* corner) {
+        const int first = static_cast<int>(std::min_element(corner, corner + 3) - corner);
+        return {corner[first], corner[(first + 1) % 3], corner[(first + 2) % 3]};
+    }
+
+    std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t>& indices) {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            triangles.push_back(canonicalTriangle(&indices[i]));
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // Регулярная сетка side x side квадратов с треугольниками в случайном порядке
+    std::vector<uint32_t> shuffledGrid(uint32_t side, size_t& vertexCount) {
+        vertexCount = static_cast<size_t>(side + 1) * (side + 1);
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t y = 0; y < side; ++y) {
+            for (uint32_t x = 0; x < side; ++x) {
+                const uint32_t v = y * (side + 1) + x;
+                triangles.push_back({v, v + 1, v + side + 2});
+                triangles.push_back({v, v + side + 2, v + side + 1});
+            }
+        }
+        std::mt19937 random(5);
+        std::shuffle(triangles.begin(), triangles.end(), random);
+
+        std::vector<uint32_t> indices;
+        for (const auto& triangle : triangles) {
+            indices.insert(indices.end(), triangle.begin(), triangle.end());
+        }
+        return indices;
+    }
+}
+
+TEST(MeshOptimizerTest, AnalyzeSingleTriangle) {
+    const MeshOptimizer::VertexCacheStats stats = MeshOptimizer::analyzeVertexCache({0, 1, 2, 2, 1, 0}, 3);
+    EXPECT_EQ(2u, stats.triangleCount);
+    EXPECT_EQ(3u, stats.vertexCount);
+    EXPECT_EQ(3u, stats.vertexTransforms); // Второй треугольник целиком из кэша
+    EXPECT_DOUBLE_EQ(1.5, stats.acmr());
+    EXPECT_DOUBLE_EQ(1.0, stats.atvr());
+}
+
+TEST(MeshOptimizerTest, KeepsTrianglesAndImprovesShuffledGrid) {
+    size_t vertexCount = 0;
+    const std::vector<uint32_t> original = shuffledGrid(64, vertexCount);
+    std::vector<uint32_t> optimized = original;
+    MeshOptimizer::optimizeVertexCache(optimized, vertexCount);
+
+    EXPECT_EQ(sortedTriangles(original), sortedTriangles(optimized));
+
+    const auto before = MeshOptimizer::analyzeVertexCache(original, vertexCount);
+    const auto after = MeshOptimizer::analyzeVertexCache(optimized, vertexCount);
+    EXPECT_GT(before.acmr(), 2.0);
+    EXPECT_LT(after.acmr(), 0.8);
+    EXPECT_LT(after.atvr(), before.atvr());
+}
+
+TEST(MeshOptimizerTest, IsDeterministic) {
+    size_t vertexCount = 0;
+    std::vector<uint32_t> first = shuffledGrid(32, vertexCount);
+    std::vector<uint32_t> second = first;
+    MeshOptimizer::optimizeVertexCache(first, vertexCount);
+    MeshOptimizer::optimizeVertexCache(second, vertexCount);
+    EXPECT_EQ(first, second);
+}
+
+TEST(MeshOptimizerTest, HandlesDegenerateTriangles) {
+    std::vector<uint32_t> indices = {0, 0, 1, 1, 2, 3, 3, 3, 3};
+    const std::vector<uint32_t> original = indices;
+    MeshOptimizer::optimizeVertexCache(indices, 4);
+    EXPECT_EQ(sortedTriangles(original), sortedTriangles(indices));
+}
+
+TEST(MeshOptimizerTest, RejectsOutOfRangeIndex) {
+    std::vector<uint32_t> indices = {0, 1, 5};
+    EXPECT_THROW(MeshOptimizer::optimizeVertexCache(indices, 3), std::runtime_error);
+}
+
+TEST(MeshOptimizerTest, ModelAcmrDoesNotGetWorse) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+
+    const auto before = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+    MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+    const auto after = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+    EXPECT_LE(after.acmr(), before.acmr());
+    EXPECT_EQ(before.vertexCount, after.vertexCount);
+}
+
+namespace {
+    // Куб с отдельными вершинами у каждой грани (как после загрузки OBJ с нормалями), грани смотрят наружу
+    void appendCube(float halfSize, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        const glm::vec3 normals[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+        for (const glm::vec3& n : normals) {
+            // Базис грани: u x v == n, поэтому обход 0-1-2, 0-2-3 идёт против часовой стрелки снаружи
+            const glm::vec3 u = std::fabs(n.x) > 0.5f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+            const glm::vec3 v = glm::cross(n, u);
+            const uint32_t base = static_cast<uint32_t>(vertices.size());
+            const glm::vec2 corners[4] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+            for (const glm::vec2& corner : corners) {
+                Vertex vertex{};
+                vertex.pos = (n + u * corner.x + v * corner.y) * halfSize;
+                vertex.normal = n;
+                vertices.push_back(vertex);
+            }
+            indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+        }
+    }
+}
+
+TEST(MeshOptimizerTest, OverdrawEstimatorSeesDrawOrder) {
+    // Внутренний куб первым: его передние грани рисуются, а потом закрываются внешним
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> innerFirst;
+    appendCube(0.5f, vertices, innerFirst);
+    appendCube(1.0f, vertices, innerFirst);
+
+    std::vector<uint32_t> outerFirst(innerFirst.begin() + 36, innerFirst.end());
+    outerFirst.insert(outerFirst.end(), innerFirst.begin(), innerFirst.begin() + 36);
+
+    const auto worse = MeshOptimizer::analyzeOverdraw(vertices, innerFirst);
+    const auto better = MeshOptimizer::analyzeOverdraw(vertices, outerFirst);
+    EXPECT_EQ(worse.pixelsCovered, better.pixelsCovered);
+    EXPECT_NEAR(1.0, better.overdraw(), 1e-9);
+    EXPECT_GT(worse.overdraw(), 1.1);
+}
+
+TEST(MeshOptimizerTest, OverdrawOptimizationDrawsOuterShellFirst) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    appendCube(0.5f, vertices, indices);
+    appendCube(1.0f, vertices, indices);
+    const std::vector<uint32_t> original = indices;
+
+    const auto before = MeshOptimizer::analyzeOverdraw(vertices, indices);
+    MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+    MeshOptimizer::optimizeOverdraw(indices, vertices);
+    const auto after = MeshOptimizer::analyzeOverdraw(vertices, indices);
+
+    EXPECT_EQ(sortedTriangles(original), sortedTriangles(indices));
+    EXPECT_LT(after.overdraw(), before.overdraw());
+    EXPECT_NEAR(1.0, after.overdraw(), 1e-9);
+}
+
+TEST(MeshOptimizerTest, VertexFetchFollowsFirstUse) {
+    std::vector<Vertex> vertices(5);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        vertices[i].pos = glm::vec3(static_cast<float>(i));
+    }
+    std::vector<uint32_t> indices = {3, 1, 4, 4, 1, 0}; // Вершина 2 не используется
+    const std::vector<uint32_t> original = indices;
+    const std::vector<Vertex> originalVertices = vertices;
+
+    MeshOptimizer::optimizeVertexFetch(vertices, indices);
+
+    EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 2, 1, 3}), indices);
+    ASSERT_EQ(4u, vertices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        EXPECT_EQ(originalVertices[original[i]].pos, vertices[indices[i]].pos);
+    }
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include "LodSelector.hpp"
+#include "MeshSimplifier.hpp"
+#include "ObjParser.hpp"
+#include "TestGeometry.hpp"
+
+using TestGeometry::flat;
+using TestGeometry::makeGrid;
+
+namespace {
+    bool onBorder(const glm::vec3& p) {
+        return p.x == 0.0f || p.x == 1.0f || p.y == 0.0f || p.y == 1.0f;
+    }
+}
+
+TEST(MeshSimplifierTest, FlatGridCollapsesWithoutError) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(16, flat, vertices, indices);
+
+    float error = -1.0f;
+    const std::vector<uint32_t> simplified = MeshSimplifier::simplify(vertices, indices, 0, 0.01f, &error);
+
+    // Внутренние вершины плоскости удаляются без ошибки; граница закреплена
+    EXPECT_LT(simplified.size(), indices.size() / 4);
+    EXPECT_EQ(0.0f, error);
+    ASSERT_EQ(0u, simplified.size() % 3);
+    for (uint32_t index : simplified) {
+        ASSERT_LT(index, vertices.size());
+    }
+
+    std::set<uint32_t> borderBefore;
+    std::set<uint32_t> borderAfter;
+    for (uint32_t index : indices) {
+        if (onBorder(vertices[index].pos)) borderBefore.insert(index);
+    }
+    for (uint32_t index : simplified) {
+        if (onBorder(vertices[index].pos)) borderAfter.insert(index);
+    }
+    EXPECT_EQ(borderBefore, borderAfter);
+}
+
+TEST(MeshSimplifierTest, KeepsOrientation) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(16, [](float u, float v) { return 0.05f * std::sin(6.0f * u) * std::cos(5.0f * v); }, vertices, indices);
+
+    const std::vector<uint32_t> simplified = MeshSimplifier::simplify(vertices, indices, indices.size() / 4, MeshSimplifier::LOD_TARGET_ERROR);
+    ASSERT_FALSE(simplified.empty());
+    EXPECT_LE(simplified.size(), indices.size() / 4);
+    for (size_t i = 0; i < simplified.size(); i += 3) {
+        const glm::vec3 a = vertices[simplified[i]].pos;
+        const glm::vec3 b = vertices[simplified[i + 1]].pos;
+        const glm::vec3 c = vertices[simplified[i + 2]].pos;
+        EXPECT_GE(glm::cross(b - a, c - a).z, 0.0f); // Ни одна грань не перевернулась вниз
+    }
+}
+
+TEST(MeshSimplifierTest, RespectsErrorLimit) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(32, [](float u, float v) { return 0.2f * std::sin(9.0f * u) * std::sin(7.0f * v); }, vertices, indices);
+
+    float loose = 0.0f;
+    float strict = 0.0f;
+    const auto coarse = MeshSimplifier::simplify(vertices, indices, 0, 0.05f, &loose);
+    const auto fine = MeshSimplifier::simplify(vertices, indices, 0, 0.001f, &strict);
+
+    const float radius = std::sqrt(2.0f) * 0.5f; // Для сетки 1 x 1 с небольшим рельефом
+    EXPECT_LE(strict, 0.001f * radius * 1.1f);
+    EXPECT_LE(loose, 0.05f * radius * 1.1f);
+    EXPECT_LT(coarse.size(), fine.size());
+}
+
+TEST(MeshSimplifierTest, DoesNotCollapseAcrossUvSeam) {
+    // Две половины сетки с разными UV: вершины шва x = 0.5 продублированы
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(8, flat, vertices, indices);
+    const size_t originalVertexCount = vertices.size();
+    for (size_t i = 0; i < originalVertexCount; ++i) {
+        if (vertices[i].pos.x == 0.5f) {
+            Vertex copy = vertices[i];
+            copy.texCoord.x += 10.0f;
+            vertices.push_back(copy);
+        }
+    }
+    // Треугольники правой половины ссылаются на копии вершин шва
+    for (size_t t = 0; t < indices.size(); t += 3) {
+        const float centerX = (vertices[indices[t]].pos.x + vertices[indices[t + 1]].pos.x + vertices[indices[t + 2]].pos.x) / 3.0f;
+        if (centerX < 0.5f) continue;
+        for (size_t k = t; k < t + 3; ++k) {
+            if (vertices[indices[k]].pos.x != 0.5f) continue;
+            for (size_t copy = originalVertexCount; copy < vertices.size(); ++copy) {
+                if (vertices[copy].pos == vertices[indices[k]].pos) {
+                    indices[k] = static_cast<uint32_t>(copy);
+                    break;
+                }
+            }
+        }
+    }
+
+    const std::vector<uint32_t> simplified = MeshSimplifier::simplify(vertices, indices, 0, 0.01f);
+    ASSERT_FALSE(simplified.empty());
+    EXPECT_LT(simplified.size(), indices.size());
+
+    // Каждая грань лежит по одну сторону шва и использует только свои UV
+    for (size_t t = 0; t < simplified.size(); t += 3) {
+        bool left = false;
+        bool right = false;
+        for (size_t k = t; k < t + 3; ++k) {
+            const Vertex& vertex = vertices[simplified[k]];
+            left = left || vertex.pos.x < 0.5f || (vertex.pos.x == 0.5f && vertex.texCoord.x < 5.0f);
+            right = right || vertex.pos.x > 0.5f || (vertex.pos.x == 0.5f && vertex.texCoord.x > 5.0f);
+        }
+        EXPECT_FALSE(left && right);
+    }
+}
+
+TEST(MeshSimplifierTest, IsDeterministic) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(24, [](float u, float v) { return 0.1f * std::sin(5.0f * u + 3.0f * v); }, vertices, indices);
+    EXPECT_EQ(MeshSimplifier::simplify(vertices, indices, indices.size() / 8, 0.05f),
+              MeshSimplifier::simplify(vertices, indices, indices.size() / 8, 0.05f));
+}
+
+TEST(MeshSimplifierTest, RejectsOutOfRangeIndex) {
+    std::vector<Vertex> vertices(3);
+    EXPECT_THROW(MeshSimplifier::simplify(vertices, {0, 1, 3}, 0, 0.1f), std::runtime_error);
+}
+
+TEST(MeshSimplifierTest, ModelLodChainShrinks) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+    const size_t originalCount = indices.size();
+
+    const std::vector<LodLevel> lods = MeshSimplifier::buildLodChain(vertices, indices);
+    ASSERT_GE(lods.size(), 3u);
+    ASSERT_LE(lods.size(), MeshSimplifier::MAX_LOD_LEVELS);
+    EXPECT_EQ(0u, lods[0].firstIndex);
+    EXPECT_EQ(originalCount, lods[0].indexCount);
+
+    for (size_t i = 1; i < lods.size(); ++i) {
+        EXPECT_EQ(lods[i - 1].firstIndex + lods[i - 1].indexCount, lods[i].firstIndex);
+        EXPECT_LT(lods[i].indexCount, lods[i - 1].indexCount);
+        EXPECT_GE(lods[i].error, lods[i - 1].error);
+        EXPECT_EQ(0u, lods[i].indexCount % 3);
+    }
+    EXPECT_EQ(indices.size(), static_cast<size_t>(lods.back().firstIndex) + lods.back().indexCount);
+    for (uint32_t index : indices) {
+        ASSERT_LT(index, vertices.size());
+    }
+}
+
+TEST(LodSelectorTest, SwitchesWithHysteresis) {
+    // Радиус сетки 1, ошибки уровней 0, 0.01, 0.04 в единицах модели; порог — 1 пиксель
+    LodSelector selector({{0, 300, 0.0f}, {300, 150, 0.01f}, {450, 75, 0.04f}}, 1.0f);
+
+    EXPECT_EQ(0u, selector.select(500.0f)); // 5 px ошибки у LOD1
+    EXPECT_EQ(1u, selector.select(60.0f));  // 0.6 px у LOD1, 2.4 px у LOD2
+    EXPECT_EQ(1u, selector.select(95.0f));  // 0.95 px: ещё в пределах порога
+    EXPECT_EQ(0u, selector.select(110.0f)); // 1.1 px: ошибка заметна
+
+    // На обратном пути LOD1 включается только с запасом (0.8 px)
+    EXPECT_EQ(0u, selector.select(90.0f));
+    EXPECT_EQ(1u, selector.select(79.0f));
+    EXPECT_EQ(2u, selector.select(10.0f));
+    EXPECT_EQ(2u, selector.select(24.0f));
+    EXPECT_EQ(1u, selector.select(26.0f));
+}
+
+TEST(LodSelectorTest, SingleLevelAlwaysSelected) {
+    LodSelector selector({{0, 36, 0.0f}}, 1.0f);
+    EXPECT_EQ(0u, selector.select(0.0f));
+    EXPECT_EQ(0u, selector.select(1e9f));
+}
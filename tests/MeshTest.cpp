@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include "Mesh.hpp"
+#include "ObjParser.hpp"
+
+TEST(MeshTest, RegistryKeepsIdsStableAcrossRemoval) {
+    MeshRegistry registry;
+    const MeshId first = registry.add(std::make_unique<Mesh>());
+    const MeshId second = registry.add(std::make_unique<Mesh>());
+    EXPECT_NE(first, second);
+    EXPECT_EQ(registry.size(), 2u);
+
+    const Mesh* secondMesh = &registry.get(second);
+    registry.remove(first);
+    EXPECT_FALSE(registry.contains(first));
+    EXPECT_TRUE(registry.contains(second));
+    EXPECT_EQ(&registry.get(second), secondMesh); // Остальные сетки не переезжают
+    EXPECT_EQ(registry.size(), 1u);
+
+    // Номер удалённой сетки не выдаётся повторно
+    const MeshId third = registry.add(std::make_unique<Mesh>());
+    EXPECT_NE(third, first);
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_EQ(registry.gpuBytes(), 0u); // Буферов у пустых сеток нет
+}
+
+TEST(MeshTest, RegistryRejectsUnknownIds) {
+    MeshRegistry registry;
+    EXPECT_THROW(registry.get(0), std::out_of_range);
+    EXPECT_THROW(registry.get(MeshRegistry::INVALID_ID), std::out_of_range);
+    EXPECT_THROW(registry.add(nullptr), std::invalid_argument);
+
+    const MeshId id = registry.add(std::make_unique<Mesh>());
+    registry.remove(id);
+    EXPECT_THROW(registry.remove(id), std::out_of_range);
+    EXPECT_THROW(registry.get(id), std::out_of_range);
+    EXPECT_EQ(registry.size(), 0u);
+}
+
+TEST(MeshTest, BoundingSphereContainsModel) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+
+    const glm::vec4 sphere = Mesh::computeBoundingSphere(vertices.data(), vertices.size());
+    ASSERT_GT(sphere.w, 0.0f);
+    float farthest = 0.0f;
+    for (const Vertex& vertex : vertices) {
+        farthest = std::max(farthest, glm::length(vertex.pos - glm::vec3(sphere)));
+    }
+    EXPECT_NEAR(farthest, sphere.w, sphere.w * 1e-5f); // Радиус — расстояние до самой дальней вершины
+
+    EXPECT_EQ(Mesh::computeBoundingSphere(nullptr, 0), glm::vec4(0.0f));
+}
+
+TEST(MeshTest, UvDensityPerSubmesh) {
+    // Квадрат 2x2 с развёрткой на всю текстуру и квадрат 1x1 с развёрткой на её четверть
+    std::vector<Vertex> vertices(8);
+    const glm::vec2 corners[4] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    for (int i = 0; i < 4; ++i) {
+        vertices[i].pos = glm::vec3(corners[i] * 2.0f, 0.0f);
+        vertices[i].texCoord = corners[i];
+        vertices[4 + i].pos = glm::vec3(corners[i], 1.0f);
+        vertices[4 + i].texCoord = corners[i] * 0.5f;
+    }
+    const std::vector<uint32_t> indices = {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7};
+
+    const std::vector<float> density =
+        Mesh::computeUvDensity(vertices.data(), indices.data(), indices.size(), {Submesh{0, 6, 0}, Submesh{6, 6, 1}});
+    ASSERT_EQ(density.size(), 2u);
+    EXPECT_FLOAT_EQ(density[0], 0.5f); // Одна UV-единица на 2 единицы длины
+    EXPECT_FLOAT_EQ(density[1], 0.5f);
+
+    // Без материалов — один диапазон на все индексы LOD0
+    const std::vector<float> whole = Mesh::computeUvDensity(vertices.data(), indices.data(), 6, {});
+    ASSERT_EQ(whole.size(), 1u);
+    EXPECT_FLOAT_EQ(whole[0], 0.5f);
+
+    // Без развёртки плотность неизвестна
+    for (Vertex& vertex : vertices) {
+        vertex.texCoord = glm::vec2(0.0f);
+    }
+    EXPECT_EQ(Mesh::computeUvDensity(vertices.data(), indices.data(), 6, {})[0], 0.0f);
+}
+
+TEST(MeshTest, MeshDataReleaseFreesMemory) {
+    MeshData data;
+    data.vertices.resize(1000);
+    data.indices.resize(3000);
+    data.meshMaterials.materialNames = {"stone"};
+    EXPECT_EQ(data.byteSize(), 1000 * sizeof(Vertex) + 3000 * sizeof(uint32_t));
+
+    data.release();
+    EXPECT_EQ(data.byteSize(), 0u);
+    EXPECT_EQ(data.vertices.capacity(), 0u);
+    EXPECT_EQ(data.indices.capacity(), 0u);
+    EXPECT_TRUE(data.meshMaterials.materialNames.empty());
+}
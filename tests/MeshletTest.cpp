@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Meshlet.hpp"
+#include "MeshOptimizer.hpp"
+#include "ObjParser.hpp"
+#include "TestGeometry.hpp"
+
+namespace {
+    std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t>& indices) {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            triangles.push_back({indices[i], indices[i + 1], indices[i + 2]});
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // Все треугольники мешлетов в глобальных индексах
+    std::vector<uint32_t> expand(const MeshletMesh& mesh) {
+        std::vector<uint32_t> indices;
+        for (const Meshlet& meshlet : mesh.meshlets) {
+            for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+                indices.push_back(mesh.vertices[meshlet.vertexOffset + mesh.triangles[meshlet.triangleOffset + i]]);
+            }
+        }
+        return indices;
+    }
+
+    MeshletBuilder::Frustum lookAtOrigin(const glm::vec3& eye) {
+        const glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 proj = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 10.0f);
+        return MeshletBuilder::Frustum::fromMatrix(proj * view);
+    }
+}
+
+TEST(MeshletTest, ModelMeshletsRespectLimitsAndKeepTriangles) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+    MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+
+    const MeshletMesh mesh = MeshletBuilder::build(vertices.data(), vertices.size(), indices.data(), indices.size());
+    ASSERT_FALSE(mesh.meshlets.empty());
+    EXPECT_EQ(indices.size() / 3, mesh.triangleCount());
+    EXPECT_EQ(sortedTriangles(indices), sortedTriangles(expand(mesh)));
+
+    for (const Meshlet& meshlet : mesh.meshlets) {
+        EXPECT_LE(meshlet.vertexCount, MeshletBuilder::MAX_VERTICES);
+        EXPECT_LE(meshlet.triangleCount, MeshletBuilder::MAX_TRIANGLES);
+        EXPECT_EQ(0u, meshlet.triangleOffset % 4);
+
+        // Сфера содержит все вершины мешлета
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            const glm::vec3& p = vertices[mesh.vertices[meshlet.vertexOffset + i]].pos;
+            EXPECT_LE(glm::length(p - glm::vec3(meshlet.sphere)), meshlet.sphere.w * 1.0001f + 1e-6f);
+        }
+    }
+
+    // После оптимизации под кэш вершины мешлетов почти не повторяются
+    EXPECT_LT(static_cast<double>(mesh.vertices.size()) / mesh.meshlets.size(), 64.0);
+}
+
+TEST(MeshletTest, PackedBufferLayout) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    // Квадрат с центром в начале координат, лицевая сторона смотрит в +z
+    TestGeometry::makeGrid(16, TestGeometry::flat, vertices, indices, glm::vec3(-0.5f, -0.5f, 0.0f));
+    const MeshletMesh mesh = MeshletBuilder::build(vertices.data(), vertices.size(), indices.data(), indices.size());
+
+    size_t vertexBase = 0;
+    size_t triangleBase = 0;
+    const std::vector<uint8_t> buffer = MeshletBuilder::pack(mesh, vertexBase, triangleBase);
+    EXPECT_EQ(0u, vertexBase % 16);
+    EXPECT_EQ(0u, triangleBase % 16);
+    EXPECT_GE(vertexBase, mesh.meshlets.size() * sizeof(Meshlet));
+    ASSERT_GE(buffer.size(), triangleBase + mesh.triangles.size());
+    EXPECT_EQ(0, std::memcmp(buffer.data(), mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet)));
+    EXPECT_EQ(0, std::memcmp(buffer.data() + vertexBase, mesh.vertices.data(), mesh.vertices.size() * sizeof(uint32_t)));
+    EXPECT_EQ(0, std::memcmp(buffer.data() + triangleBase, mesh.triangles.data(), mesh.triangles.size()));
+}
+
+TEST(MeshletTest, CullsBackfacingAndOffscreenMeshlets) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    // Квадрат с центром в начале координат, лицевая сторона смотрит в +z
+    TestGeometry::makeGrid(16, TestGeometry::flat, vertices, indices, glm::vec3(-0.5f, -0.5f, 0.0f));
+    const MeshletMesh mesh = MeshletBuilder::build(vertices.data(), vertices.size(), indices.data(), indices.size());
+    ASSERT_GT(mesh.meshlets.size(), 1u);
+
+    std::vector<uint32_t> visible;
+
+    // Спереди видно всё
+    const glm::vec3 front(0.0f, 0.0f, 3.0f);
+    EXPECT_EQ(mesh.meshlets.size(), MeshletBuilder::cull(mesh, lookAtOrigin(front), front, visible));
+    EXPECT_EQ(indices.size(), visible.size());
+
+    // Сзади плоскость повёрнута изнанкой: конусы нормалей отсекают всё
+    const glm::vec3 back(0.0f, 0.0f, -3.0f);
+    EXPECT_EQ(0u, MeshletBuilder::cull(mesh, lookAtOrigin(back), back, visible));
+    EXPECT_TRUE(visible.empty());
+
+    // Камера спереди, но смотрит в сторону: всё вне пирамиды видимости
+    const glm::mat4 view = glm::lookAt(front, front + glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 proj = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 10.0f);
+    EXPECT_EQ(0u, MeshletBuilder::cull(mesh, MeshletBuilder::Frustum::fromMatrix(proj * view), front, visible));
+}
+
+TEST(MeshletTest, RejectsOutOfRangeIndex) {
+    std::vector<Vertex> vertices(3);
+    const uint32_t indices[] = {0, 1, 3};
+    EXPECT_THROW(MeshletBuilder::build(vertices.data(), vertices.size(), indices, 3), std::runtime_error);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "MipChain.hpp"
+
+namespace {
+    std::vector<uint8_t> solid(uint32_t width, uint32_t height, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+        std::vector<uint8_t> pixels(size_t{width} * height * 4);
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            pixels[i] = r;
+            pixels[i + 1] = g;
+            pixels[i + 2] = b;
+            pixels[i + 3] = a;
+        }
+        return pixels;
+    }
+
+    /// Псевдослучайное изображение: детерминированный LCG
+    std::vector<uint8_t> noise(uint32_t width, uint32_t height) {
+        std::vector<uint8_t> pixels(size_t{width} * height * 4);
+        uint32_t state = 12345;
+        for (uint8_t& value : pixels) {
+            state = state * 1664525u + 1013904223u;
+            value = static_cast<uint8_t>(state >> 24);
+        }
+        return pixels;
+    }
+}
+
+TEST(MipChainTest, LevelLayout) {
+    EXPECT_EQ(MipChain::levelCount(1, 1), 1u);
+    EXPECT_EQ(MipChain::levelCount(4096, 4096), 13u);
+    EXPECT_EQ(MipChain::levelCount(5, 3), 3u);
+    EXPECT_EQ(MipChain::levelCount(1, 8), 4u);
+
+    const std::vector<MipChain::Level> levels = MipChain::levels(10, 3);
+    ASSERT_EQ(levels.size(), 4u);
+    const uint32_t sizes[4][2] = {{10, 3}, {5, 1}, {2, 1}, {1, 1}};
+    size_t offset = 0;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        EXPECT_EQ(levels[i].width, sizes[i][0]);
+        EXPECT_EQ(levels[i].height, sizes[i][1]);
+        EXPECT_EQ(levels[i].offset, offset); // Уровни уложены подряд
+        EXPECT_EQ(levels[i].offset % 4, 0u); // Смещения копирования RGBA8 кратны 4
+        offset += levels[i].size();
+    }
+    EXPECT_EQ(MipChain::chainSize(10, 3), offset);
+}
+
+TEST(MipChainTest, SolidColorSurvivesEveryLevel) {
+    // Перевод sRGB -> линейное -> sRGB не должен сдвигать ни одно значение
+    for (uint32_t value = 0; value < 256; ++value) {
+        const uint8_t v = static_cast<uint8_t>(value);
+        const std::vector<uint8_t> base = solid(7, 5, v, v, v, v);
+        std::vector<uint8_t> tail(MipChain::chainSize(7, 5) - base.size());
+        MipChain::generate(base.data(), 7, 5, tail.data(), true, 1);
+        for (uint8_t channel : tail) {
+            ASSERT_EQ(channel, v);
+        }
+    }
+}
+
+TEST(MipChainTest, SrgbAveragesInLinearSpace) {
+    // Чёрные и белые пиксели через один, альфа 0 и 255
+    std::vector<uint8_t> checker(2 * 2 * 4);
+    for (size_t i = 0; i < 4; ++i) {
+        const uint8_t v = (i == 0 || i == 3) ? 255 : 0;
+        checker[i * 4] = checker[i * 4 + 1] = checker[i * 4 + 2] = checker[i * 4 + 3] = v;
+    }
+    uint8_t srgb[4];
+    MipChain::downsample(checker.data(), 2, 2, srgb, true);
+    EXPECT_EQ(srgb[0], 188); // Половина линейной яркости в sRGB, а не 128
+    EXPECT_EQ(srgb[3], 128); // Альфа усредняется линейно
+
+    uint8_t linear[4];
+    MipChain::downsample(checker.data(), 2, 2, linear, false);
+    EXPECT_EQ(linear[0], 128);
+    EXPECT_EQ(linear[3], 128);
+}
+
+TEST(MipChainTest, OddEdgesAreNotDropped) {
+    // Белый только последний столбец 3x2: он должен попасть в единственный пиксель результата
+    std::vector<uint8_t> image = solid(3, 2, 0, 0, 0, 0);
+    for (uint32_t y = 0; y < 2; ++y) {
+        image[(y * 3 + 2) * 4] = 255;
+    }
+    uint8_t result[4];
+    MipChain::downsample(image.data(), 3, 2, result, false);
+    EXPECT_EQ(result[0], 85); // (0 + 0 + 255) * 2 / 6
+    EXPECT_EQ(result[1], 0);
+}
+
+TEST(MipChainTest, ThreadCountDoesNotChangeResult) {
+    const uint32_t width = 301;
+    const uint32_t height = 97;
+    const std::vector<uint8_t> base = noise(width, height);
+    const size_t tailSize = MipChain::chainSize(width, height) - base.size();
+    std::vector<uint8_t> single(tailSize), multi(tailSize);
+    MipChain::generate(base.data(), width, height, single.data(), true, 1);
+    MipChain::generate(base.data(), width, height, multi.data(), true, 4);
+    EXPECT_EQ(single, multi);
+
+    // Второй уровень равен уменьшению первого отдельным вызовом
+    const std::vector<MipChain::Level> levels = MipChain::levels(width, height);
+    std::vector<uint8_t> level1(levels[1].size());
+    MipChain::downsample(base.data(), width, height, level1.data(), true);
+    EXPECT_TRUE(std::equal(level1.begin(), level1.end(), single.begin()));
+}
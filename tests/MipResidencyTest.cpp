@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "MipChain.hpp"
+#include "MipResidency.hpp"
+
+namespace {
+    /// Размеры уровней RGBA8 цепочки size x size
+    std::vector<uint64_t> levelBytes(uint32_t size) {
+        std::vector<uint64_t> bytes;
+        for (const MipChain::Level& level : MipChain::levels(size, size)) {
+            bytes.push_back(level.size());
+        }
+        return bytes;
+    }
+
+    uint64_t chainBytes(uint32_t size, uint32_t fromLevel) {
+        uint64_t total = 0;
+        const std::vector<uint64_t> bytes = levelBytes(size);
+        for (size_t level = fromLevel; level < bytes.size(); ++level) {
+            total += bytes[level];
+        }
+        return total;
+    }
+}
+
+TEST(MipResidencyTest, StartsWithTailOnly) {
+    MipResidency residency(1u << 30, 1u << 30);
+    const uint32_t big = residency.add(1024, 1024, levelBytes(1024));
+    const uint32_t small = residency.add(32, 32, levelBytes(32));
+    EXPECT_EQ(residency.tailLevel(big), 4u); // 1024 >> 4 = 64
+    EXPECT_EQ(residency.baseLevel(big), 4u);
+    EXPECT_EQ(residency.baseLevel(small), 0u);
+    EXPECT_EQ(residency.residentBytes(), chainBytes(1024, 4) + chainBytes(32, 0));
+
+    // Без заявок ничего не меняется
+    EXPECT_TRUE(residency.update().empty());
+}
+
+TEST(MipResidencyTest, StreamsRequestedLevelsWithinUploadLimit) {
+    // За один update() помещается уровень 1 (512x512), но не уровень 0
+    MipResidency residency(1u << 30, chainBytes(1024, 1));
+    const uint32_t texture = residency.add(1024, 1024, levelBytes(1024));
+    residency.request(texture, 0);
+    std::vector<MipResidency::Change> changes = residency.update();
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].previousBase, 4u);
+    EXPECT_EQ(changes[0].base, 1u);
+
+    residency.request(texture, 0);
+    changes = residency.update();
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].base, 0u);
+    EXPECT_EQ(residency.residentBytes(), chainBytes(1024, 0));
+}
+
+TEST(MipResidencyTest, EvictsLeastRecentlyUsedUnderBudget) {
+    // Бюджет вмещает одну текстуру 512x512 целиком и хвосты остальных
+    const uint64_t budget = chainBytes(512, 0) + 2 * chainBytes(512, 3);
+    MipResidency residency(budget, 1u << 30);
+    const uint32_t first = residency.add(512, 512, levelBytes(512));
+    const uint32_t second = residency.add(512, 512, levelBytes(512));
+    const uint32_t third = residency.add(512, 512, levelBytes(512));
+
+    residency.request(first, 0);
+    residency.update();
+    EXPECT_EQ(residency.baseLevel(first), 0u);
+
+    residency.request(second, 0);
+    residency.update(); // Второй кадр: first давно не нужен, его место занимает second
+    EXPECT_EQ(residency.baseLevel(first), residency.tailLevel(first));
+    EXPECT_EQ(residency.baseLevel(second), 0u);
+    EXPECT_LE(residency.residentBytes(), budget);
+
+    // Обе нужны сразу: места на обе нет, third детализируется только до помещающегося уровня
+    residency.request(second, 0);
+    residency.request(third, 0);
+    const std::vector<MipResidency::Change> changes = residency.update();
+    EXPECT_EQ(residency.baseLevel(second), 0u);
+    EXPECT_GT(residency.baseLevel(third), 0u);
+    EXPECT_LE(residency.residentBytes(), budget);
+    for (const MipResidency::Change& change : changes) {
+        EXPECT_NE(change.texture, second);
+    }
+}
+
+TEST(MipResidencyTest, ShrinksTexturesHoldingMoreDetailThanNeeded) {
+    const uint64_t budget = chainBytes(512, 0) + chainBytes(512, 1);
+    MipResidency residency(budget, 1u << 30);
+    const uint32_t near = residency.add(512, 512, levelBytes(512));
+    const uint32_t far = residency.add(512, 512, levelBytes(512));
+    residency.request(near, 0);
+    residency.request(far, 1);
+    residency.update();
+    EXPECT_EQ(residency.baseLevel(near), 0u);
+    EXPECT_EQ(residency.baseLevel(far), 1u);
+
+    // Камера подошла к far и отошла от near: near отдаёт лишние детали, хотя всё ещё видна
+    residency.request(near, 2);
+    residency.request(far, 0);
+    const std::vector<MipResidency::Change> changes = residency.update();
+    ASSERT_EQ(changes.size(), 2u);
+    EXPECT_EQ(changes[0].texture, near); // Вытеснение — раньше догрузки
+    EXPECT_EQ(residency.baseLevel(near), 2u);
+    EXPECT_EQ(residency.baseLevel(far), 0u);
+}
+
+TEST(MipResidencyTest, LevelForFootprint) {
+    EXPECT_EQ(MipResidency::levelForFootprint(0.25f, 10), 0u); // Увеличение: нужен уровень 0
+    EXPECT_EQ(MipResidency::levelForFootprint(1.0f, 10), 0u);
+    EXPECT_EQ(MipResidency::levelForFootprint(2.0f, 10), 1u);
+    EXPECT_EQ(MipResidency::levelForFootprint(7.9f, 10), 2u);
+    EXPECT_EQ(MipResidency::levelForFootprint(1e9f, 10), 9u);
+}
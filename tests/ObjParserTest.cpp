@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "ObjParser.hpp"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Прежний путь загрузки через tinyobj — эталон для сравнения; треугольники
+    // сгруппированы по материалам в порядке их первого появления, как в ObjParser
+    void loadWithTinyObj(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+        const std::string directory = fs::path(path).parent_path().string() + "/";
+        ASSERT_TRUE(tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), directory.c_str())) << warn << err;
+
+        std::unordered_map<Vertex, uint32_t> uniqueVertices;
+        std::vector<int> triangleMaterials;
+        for (const auto& shape : shapes) {
+            triangleMaterials.insert(triangleMaterials.end(), shape.mesh.material_ids.begin(), shape.mesh.material_ids.end());
+            for (const auto& index : shape.mesh.indices) {
+                Vertex vertex{};
+                vertex.pos = {
+                    attrib.vertices[3 * index.vertex_index + 0],
+                    attrib.vertices[3 * index.vertex_index + 1],
+                    attrib.vertices[3 * index.vertex_index + 2]
+                };
+                if (index.texcoord_index >= 0) {
+                    vertex.texCoord = {
+                        attrib.texcoords[2 * index.texcoord_index + 0],
+                        1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+                    };
+                } else {
+                    vertex.texCoord = {0.0f, 1.0f};
+                }
+                vertex.color = {1.0f, 1.0f, 1.0f};
+
+                if (uniqueVertices.count(vertex) == 0) {
+                    uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+                    vertices.push_back(vertex);
+                }
+                indices.push_back(uniqueVertices[vertex]);
+            }
+        }
+
+        std::vector<int> materialOrder;
+        for (int material : triangleMaterials) {
+            if (std::find(materialOrder.begin(), materialOrder.end(), material) == materialOrder.end()) {
+                materialOrder.push_back(material);
+            }
+        }
+        std::vector<uint32_t> grouped;
+        for (int material : materialOrder) {
+            for (size_t triangle = 0; triangle < triangleMaterials.size(); ++triangle) {
+                if (triangleMaterials[triangle] == material) {
+                    grouped.insert(grouped.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3);
+                }
+            }
+        }
+        indices = grouped;
+    }
+
+    void expectSameAsTinyObj(const std::string& path, unsigned threadCount) {
+        std::vector<Vertex> expectedVertices, vertices;
+        std::vector<uint32_t> expectedIndices, indices;
+        loadWithTinyObj(path, expectedVertices, expectedIndices);
+
+        ObjParser parser(threadCount);
+        parser.load(path, vertices, indices);
+
+        EXPECT_EQ(expectedIndices, indices);
+        ASSERT_EQ(expectedVertices.size(), vertices.size());
+        // Сравниваем побайтово: результат должен совпадать бит в бит
+        EXPECT_EQ(0, std::memcmp(expectedVertices.data(), vertices.data(), vertices.size() * sizeof(Vertex)));
+    }
+}
+
+TEST(ObjParserTest, MatchesTinyObjOnModels) {
+    for (unsigned threads : {1u, 4u}) {
+        expectSameAsTinyObj(MODEL_PATH, threads);
+        expectSameAsTinyObj("model/escandalosos.obj", threads);
+        expectSameAsTinyObj("model/cube.obj", threads);
+    }
+}
+
+TEST(ObjParserTest, RelativeIndicesAndPolygons) {
+    const auto tmpPath = fs::temp_directory_path() / "obj_parser_test.obj";
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        // Достаточно строк, чтобы файл разрезался на участки, а углов хватило для параллельной склейки
+        for (int i = 0; i < 30000; ++i) {
+            out << "v " << i << " 0.5 -1.25e-1\r\n"
+                << "v " << i + 1 << " 1.5 0\r\n"
+                << "v " << i + 1 << " 2.5 0.125\r\n"
+                << "v " << i << ".5 3 0\r\n"
+                << "v " << i << " 2 1E-3\r\n"
+                << "vt 0.25 0.75\r\n"
+                << "f -5/-1 -4/-1 -3/-1 -2/-1 -1/-1 # пятиугольник\r\n"
+                << "f " << 5 * i + 1 << " " << 5 * i + 2 << " " << 5 * i + 3 << " " << 5 * i + 4 << "\r\n";
+        }
+    }
+    expectSameAsTinyObj(tmpPath.string(), 4);
+    fs::remove(tmpPath);
+}
+
+TEST(ObjParserTest, ReportsThroughput) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser parser(2);
+    parser.load(MODEL_PATH, vertices, indices);
+
+    const auto& stats = parser.getStats();
+    EXPECT_EQ(fs::file_size(MODEL_PATH), stats.fileSize);
+    EXPECT_EQ(2u, stats.threadCount);
+    EXPECT_GE(stats.chunkCount, 1u);
+    EXPECT_GT(stats.megabytesPerSecond(), 0.0);
+}
+
+TEST(ObjParserTest, FileNotFound) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    EXPECT_THROW(ObjParser().load("non_existent_model.obj", vertices, indices), std::runtime_error);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include "ObjParser.hpp"
+#include "ObjStreamReader.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Собирает все порции в общие массивы, проверяя глобальную нумерацию
+    class CollectingSink : public MeshSink {
+    public:
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        size_t batches = 0;
+        bool indicesInRange = true;
+
+        void consume(const std::vector<Vertex>& batchVertices, const std::vector<uint32_t>& batchIndices) override {
+            vertices.insert(vertices.end(), batchVertices.begin(), batchVertices.end());
+            for (uint32_t index : batchIndices) {
+                indicesInRange = indicesInRange && index < vertices.size();
+            }
+            indices.insert(indices.end(), batchIndices.begin(), batchIndices.end());
+            ++batches;
+        }
+    };
+
+    std::vector<Vertex> expand(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        std::vector<Vertex> corners;
+        for (uint32_t index : indices) {
+            corners.push_back(vertices[index]);
+        }
+        return corners;
+    }
+
+    std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t>& indices) {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            triangles.push_back({indices[i], indices[i + 1], indices[i + 2]});
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+}
+
+TEST(ObjStreamReaderTest, SingleBatchMatchesObjParser) {
+    for (const char* path : {MODEL_PATH, "model/escandalosos.obj"}) {
+        std::vector<Vertex> expectedVertices;
+        std::vector<uint32_t> expectedIndices;
+        ObjParser parser;
+        parser.load(path, expectedVertices, expectedIndices);
+
+        CollectingSink sink;
+        ObjStreamReader reader(ObjStreamReader::Settings{});
+        reader.read(path, sink);
+
+        EXPECT_EQ(1u, sink.batches);
+        EXPECT_EQ(expectedVertices, sink.vertices) << path;
+        if (parser.getMaterials().submeshes.size() > 1) {
+            // ObjParser группирует треугольники по материалам, потоковое чтение оставляет порядок файла
+            EXPECT_EQ(sortedTriangles(expectedIndices), sortedTriangles(sink.indices)) << path;
+        } else {
+            EXPECT_EQ(expectedIndices, sink.indices) << path;
+        }
+        EXPECT_EQ(fs::file_size(path), reader.getStats().bytesRead);
+        EXPECT_GT(reader.getStats().peakTrackedBytes, 0u);
+    }
+}
+
+TEST(ObjStreamReaderTest, SmallWindowsAndBatches) {
+    std::vector<Vertex> expectedVertices;
+    std::vector<uint32_t> expectedIndices;
+    ObjParser().load(MODEL_PATH, expectedVertices, expectedIndices);
+
+    ObjStreamReader::Settings settings;
+    settings.windowSize = 4096;
+    settings.batchVertices = 500;
+    CollectingSink sink;
+    ObjStreamReader reader(settings);
+    reader.read(MODEL_PATH, sink);
+
+    EXPECT_GT(sink.batches, 1u);
+    EXPECT_TRUE(sink.indicesInRange);
+    EXPECT_EQ(sink.batches, reader.getStats().batchCount);
+    EXPECT_EQ(sink.indices.size(), reader.getStats().indexCount);
+    // Вершины на границах порций могут повторяться, но треугольники те же
+    EXPECT_EQ(expand(expectedVertices, expectedIndices), expand(sink.vertices, sink.indices));
+}
+
+TEST(ObjStreamReaderTest, MemoryLimitTooLow) {
+    ObjStreamReader::Settings settings;
+    settings.windowSize = 4096;
+    settings.memoryLimit = 64 * 1024; // Одних позиций viking.obj больше
+    CollectingSink sink;
+    ObjStreamReader reader(settings);
+    EXPECT_THROW(reader.read(MODEL_PATH, sink), std::runtime_error);
+}
+
+TEST(ObjStreamReaderTest, ForwardReferenceRejected) {
+    const auto tmpPath = fs::temp_directory_path() / "obj_stream_forward.obj";
+    std::ofstream(tmpPath) << "v 0 0 0\nv 1 0 0\nf 1 2 3\nv 0 1 0\n";
+
+    CollectingSink sink;
+    ObjStreamReader reader(ObjStreamReader::Settings{});
+    EXPECT_THROW(reader.read(tmpPath.string(), sink), std::runtime_error);
+    fs::remove(tmpPath);
+}
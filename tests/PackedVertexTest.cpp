@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include "ObjParser.hpp"
+#include "PackedVertex.hpp"
+
+namespace {
+    std::vector<Vertex> randomVertices(size_t count, unsigned seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> coordinate(-3.0f, 5.0f);
+        std::uniform_real_distribution<float> uv(-1.0f, 2.0f);
+        std::normal_distribution<float> direction(0.0f, 1.0f);
+
+        std::vector<Vertex> vertices(count);
+        for (auto& vertex : vertices) {
+            vertex.pos = {coordinate(random), coordinate(random), 0.25f * coordinate(random)};
+            vertex.color = {1.0f, 1.0f, 1.0f};
+            vertex.texCoord = {uv(random), uv(random)};
+            vertex.normal = glm::normalize(glm::vec3(direction(random), direction(random), direction(random)));
+        }
+        return vertices;
+    }
+
+    bool samePacked(const PackedVertex& a, const PackedVertex& b) {
+        return std::memcmp(&a, &b, sizeof(PackedVertex)) == 0;
+    }
+}
+
+TEST(PackedVertexTest, SimdMatchesScalar) {
+    // 1003 — не кратно четырём: хвост кодируется скалярно
+    const std::vector<Vertex> vertices = randomVertices(1003, 7);
+    const VertexQuantization quantization = VertexPacking::computeQuantization(vertices.data(), vertices.size());
+
+    std::vector<PackedVertex> simd(vertices.size()), scalar(vertices.size());
+    VertexPacking::encode(vertices.data(), vertices.size(), quantization, simd.data());
+    VertexPacking::encodeScalar(vertices.data(), vertices.size(), quantization, scalar.data());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        ASSERT_TRUE(samePacked(simd[i], scalar[i])) << "vertex " << i;
+    }
+}
+
+TEST(PackedVertexTest, RoundTripErrorIsBounded) {
+    const std::vector<Vertex> vertices = randomVertices(5000, 11);
+    VertexQuantization quantization;
+    const std::vector<PackedVertex> packed = VertexPacking::pack(vertices, quantization);
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex decoded = VertexPacking::decode(packed[i], quantization);
+        for (int axis = 0; axis < 3; ++axis) {
+            // Полшага сетки плюс запас на округление float
+            EXPECT_NEAR(vertices[i].pos[axis], decoded.pos[axis], quantization.positionScale[axis] / 65535.0f);
+        }
+        for (int axis = 0; axis < 2; ++axis) {
+            EXPECT_NEAR(vertices[i].texCoord[axis], decoded.texCoord[axis], quantization.texCoordScaleOffset[axis] / 65535.0f);
+        }
+        EXPECT_GT(glm::dot(vertices[i].normal, decoded.normal), 0.99999f) << "vertex " << i;
+        EXPECT_EQ(0, packed[i].position[3]);
+    }
+}
+
+TEST(PackedVertexTest, HandlesDegenerateInput) {
+    Vertex vertex{};
+    vertex.pos = {1.0f, 2.0f, 3.0f};
+    vertex.normal = {0.0f, 0.0f, -1.0f};
+    std::vector<Vertex> vertices(5, vertex);
+    vertices[4].normal = glm::vec3(0.0f); // Нормали в файле не было
+
+    VertexQuantization quantization;
+    const std::vector<PackedVertex> packed = VertexPacking::pack(vertices, quantization);
+
+    // Все позиции и UV совпадают: нулевой диапазон не должен давать деления на ноль
+    const Vertex decoded = VertexPacking::decode(packed[0], quantization);
+    EXPECT_EQ(vertex.pos, decoded.pos);
+    EXPECT_EQ(vertex.texCoord, decoded.texCoord);
+    EXPECT_NEAR(-1.0f, decoded.normal.z, 1e-6f);
+    EXPECT_TRUE(samePacked(packed[0], packed[3]));
+    EXPECT_EQ(0, packed[4].normal[0]);
+    EXPECT_EQ(0, packed[4].normal[1]);
+}
+
+TEST(PackedVertexTest, ModelVertexMemoryShrinks) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+    ASSERT_FALSE(vertices.empty());
+
+    VertexQuantization quantization;
+    const std::vector<PackedVertex> packed = VertexPacking::pack(vertices, quantization);
+    EXPECT_LT(packed.size() * sizeof(PackedVertex) * 2, vertices.size() * sizeof(Vertex));
+
+    // Ошибка позиции не больше шага сетки по самой длинной оси
+    const float step = std::max({quantization.positionScale.x, quantization.positionScale.y,
+                                 quantization.positionScale.z}) / 65535.0f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex decoded = VertexPacking::decode(packed[i], quantization);
+        ASSERT_LE(glm::length(decoded.pos - vertices[i].pos), step) << "vertex " << i;
+    }
+}
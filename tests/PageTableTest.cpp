@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "PageTable.hpp"
+
+namespace {
+    /// Уровни 4x4, 2x2 и 1x1 страница
+    PageTable makeTable(uint32_t slotCount) {
+        return PageTable({{4, 4}, {2, 2}, {1, 1}}, slotCount);
+    }
+
+    uint32_t slotOf(const PageTable::Entry& entry) { return entry.slotAndLevel & 0xFFFFFF; }
+    uint32_t levelOf(const PageTable::Entry& entry) { return entry.slotAndLevel >> 24; }
+}
+
+TEST(PageTableTest, MissingTilesFallBackToResidentAncestor) {
+    PageTable table = makeTable(8);
+    EXPECT_EQ(table.tileCount(), 16u + 4u + 1u);
+    EXPECT_EQ(table.levelOf(table.tileIndex(1, 1, 1)), 1u);
+
+    const size_t root = table.tileIndex(2, 0, 0);
+    ASSERT_EQ(table.map(root, true), 0u);
+    const size_t parent = table.tileIndex(1, 1, 0);
+    ASSERT_EQ(table.map(parent), 1u);
+    const size_t leaf = table.tileIndex(0, 3, 1);
+    ASSERT_EQ(table.map(leaf), 2u);
+    EXPECT_TRUE(table.isDirty());
+
+    const std::vector<PageTable::Entry>& entries = table.entries();
+    EXPECT_FALSE(table.isDirty());
+    // Резидентная страница указывает на себя
+    EXPECT_EQ(slotOf(entries[leaf]), 2u);
+    EXPECT_EQ(levelOf(entries[leaf]), 0u);
+    EXPECT_EQ(entries[leaf].tile, 3u | (1u << 16));
+    // Соседка на уровне 0 с тем же родителем — на родителя
+    const PageTable::Entry& sibling = entries[table.tileIndex(0, 2, 0)];
+    EXPECT_EQ(slotOf(sibling), 1u);
+    EXPECT_EQ(levelOf(sibling), 1u);
+    EXPECT_EQ(sibling.tile, 1u);
+    // Страница другой ветви — на корень
+    const PageTable::Entry& other = entries[table.tileIndex(0, 0, 3)];
+    EXPECT_EQ(slotOf(other), 0u);
+    EXPECT_EQ(levelOf(other), 2u);
+}
+
+TEST(PageTableTest, TouchReturnsMissingTilesCoarseFirst) {
+    PageTable table = makeTable(8);
+    table.map(table.tileIndex(2, 0, 0), true);
+    const size_t fine = table.tileIndex(0, 1, 1);
+    const size_t coarse = table.tileIndex(1, 0, 0);
+    const std::vector<size_t> missing = table.touch({fine, table.tileIndex(2, 0, 0), coarse, fine, 1000});
+    ASSERT_EQ(missing.size(), 2u);
+    EXPECT_EQ(missing[0], coarse);
+    EXPECT_EQ(missing[1], fine);
+}
+
+TEST(PageTableTest, EvictsLeastRecentlyUsedButNotCurrentOrPinned) {
+    PageTable table = makeTable(3);
+    const size_t root = table.tileIndex(2, 0, 0);
+    const size_t a = table.tileIndex(0, 0, 0);
+    const size_t b = table.tileIndex(0, 1, 0);
+    const size_t c = table.tileIndex(0, 2, 0);
+    table.map(root, true);
+    table.map(a);
+    table.nextFrame();
+    table.map(b);
+    // Все слоты заняты, a и b нужны в этом кадре: вытеснять нечего
+    table.touch({a, b});
+    EXPECT_EQ(table.map(c), PageTable::NO_SLOT);
+
+    // В следующем кадре нужна только b: вытесняется a, закреплённый корень остаётся
+    table.nextFrame();
+    table.touch({b});
+    const uint32_t slotA = table.slotOf(a);
+    EXPECT_EQ(table.map(c), slotA);
+    EXPECT_FALSE(table.isResident(a));
+    EXPECT_TRUE(table.isResident(root));
+    EXPECT_TRUE(table.isResident(b));
+    EXPECT_EQ(table.residentCount(), 3u);
+
+    // Вытесненная страница снова смотрит на предка
+    const std::vector<PageTable::Entry>& entries = table.entries();
+    EXPECT_EQ(levelOf(entries[a]), 2u);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "PlyParser.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    /// Тело PLY в заданном порядке байтов
+    class PlyBody {
+    public:
+        explicit PlyBody(bool bigEndian) : bigEndian_(bigEndian) {}
+
+        template <typename T>
+        PlyBody& put(T value) {
+            char buffer[sizeof(T)];
+            std::memcpy(buffer, &value, sizeof(T));
+            if (bigEndian_) {
+                std::reverse(buffer, buffer + sizeof(T));
+            }
+            bytes.insert(bytes.end(), buffer, buffer + sizeof(T));
+            return *this;
+        }
+
+        std::string bytes;
+
+    private:
+        bool bigEndian_;
+    };
+
+    void writeFile(const fs::path& path, const std::string& contents) {
+        std::ofstream(path, std::ios::binary) << contents;
+    }
+
+    std::string format(bool bigEndian) {
+        return bigEndian ? "format binary_big_endian 1.0\n" : "format binary_little_endian 1.0\n";
+    }
+
+    /**
+     * Четырёхугольник и треугольник; у вершин есть список произвольной длины,
+     * между vertex и face лежит лишний элемент со списком, у граней — свойство после индексов
+     */
+    std::string mixedPly(bool bigEndian) {
+        const std::string header = "ply\n" + format(bigEndian) +
+            "comment mixed property lists\n"
+            "element vertex 5\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+            "property list uchar float weights\n"
+            "property double quality\n"
+            "element edge 1\n"
+            "property int vertex1\nproperty list ushort short points\n"
+            "element face 2\n"
+            "property list uchar int vertex_indices\n"
+            "property uchar flags\n"
+            "end_header\n";
+        PlyBody body(bigEndian);
+        const float positions[5][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {2, 0, 0}};
+        for (uint8_t i = 0; i < 5; ++i) {
+            body.put(positions[i][0]).put(positions[i][1]).put(positions[i][2]);
+            body.put<uint8_t>(255).put<uint8_t>(static_cast<uint8_t>(i * 51)).put<uint8_t>(0);
+            body.put<uint8_t>(i); // i весов
+            for (uint8_t w = 0; w < i; ++w) {
+                body.put(0.5f);
+            }
+            body.put(0.25 * i);
+        }
+        body.put<int32_t>(7).put<uint16_t>(3).put<int16_t>(1).put<int16_t>(2).put<int16_t>(3);
+        body.put<uint8_t>(4).put<int32_t>(0).put<int32_t>(1).put<int32_t>(2).put<int32_t>(3).put<uint8_t>(9);
+        body.put<uint8_t>(3).put<int32_t>(1).put<int32_t>(4).put<int32_t>(2).put<uint8_t>(9);
+        return header + body.bytes;
+    }
+
+    /// Сетка size x size вершин с нормалями и UV, только треугольники (записи граней одной длины)
+    std::string gridPly(uint32_t size) {
+        std::string header = "ply\n" + format(false) +
+            "element vertex " + std::to_string(size * size) + "\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "property float nx\nproperty float ny\nproperty float nz\n"
+            "property float s\nproperty float t\n"
+            "element face " + std::to_string(2 * (size - 1) * (size - 1)) + "\n"
+            "property list uchar uint vertex_indices\n"
+            "end_header\n";
+        PlyBody body(false);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                body.put(static_cast<float>(x)).put(static_cast<float>(y)).put(0.0f);
+                body.put(0.0f).put(0.0f).put(1.0f);
+                body.put(x / float(size)).put(y / float(size));
+            }
+        }
+        for (uint32_t y = 0; y + 1 < size; ++y) {
+            for (uint32_t x = 0; x + 1 < size; ++x) {
+                const uint32_t corner = y * size + x;
+                body.put<uint8_t>(3).put(corner).put(corner + 1).put(corner + size + 1);
+                body.put<uint8_t>(3).put(corner).put(corner + size + 1).put(corner + size);
+            }
+        }
+        return header + body.bytes;
+    }
+}
+
+TEST(PlyParserTest, ReadsListsColorsAndPolygons) {
+    const auto path = fs::temp_directory_path() / "ply_mixed.ply";
+    std::vector<Vertex> reference;
+    std::vector<uint32_t> referenceIndices;
+    for (bool bigEndian : {false, true}) {
+        writeFile(path, mixedPly(bigEndian));
+        std::vector<Vertex> vertices(1); // Результат дописывается после уже загруженного
+        std::vector<uint32_t> indices = {0};
+        PlyParser parser;
+        parser.load(path.string(), vertices, indices);
+
+        ASSERT_EQ(vertices.size(), 6u);
+        const std::vector<uint32_t> expected = {0, 1, 2, 3, 1, 3, 4, 2, 5, 3};
+        EXPECT_EQ(indices, expected); // Четырёхугольник — веером из первой вершины
+        EXPECT_TRUE(parser.hasColors());
+        EXPECT_FALSE(parser.hasNormals());
+        EXPECT_FALSE(parser.getStats().uniformFaces);
+        EXPECT_EQ(vertices[3].pos, glm::vec3(1.0f, 1.0f, 0.0f));
+        EXPECT_EQ(vertices[3].color, glm::vec3(1.0f, 102.0f / 255.0f, 0.0f));
+        EXPECT_EQ(vertices[5].pos, glm::vec3(2.0f, 0.0f, 0.0f));
+
+        if (bigEndian) {
+            EXPECT_EQ(vertices, reference);
+            EXPECT_EQ(indices, referenceIndices);
+        }
+        reference = vertices;
+        referenceIndices = indices;
+    }
+    fs::remove(path);
+}
+
+TEST(PlyParserTest, UniformFacesDoNotDependOnThreadCount) {
+    const auto path = fs::temp_directory_path() / "ply_grid.ply";
+    const uint32_t size = 200; // 79202 треугольника: больше одного блока записей
+    writeFile(path, gridPly(size));
+
+    std::vector<Vertex> single, multi;
+    std::vector<uint32_t> singleIndices, multiIndices;
+    PlyParser(1).load(path.string(), single, singleIndices);
+    PlyParser parser(4);
+    parser.load(path.string(), multi, multiIndices);
+
+    EXPECT_TRUE(parser.getStats().uniformFaces);
+    EXPECT_TRUE(parser.hasNormals());
+    EXPECT_FALSE(parser.hasColors());
+    ASSERT_EQ(multi.size(), size_t{size} * size);
+    ASSERT_EQ(multiIndices.size(), size_t{6} * (size - 1) * (size - 1));
+    EXPECT_EQ(multi, single);
+    EXPECT_EQ(multiIndices, singleIndices);
+
+    const Vertex& last = multi.back();
+    EXPECT_EQ(last.pos, glm::vec3(size - 1.0f, size - 1.0f, 0.0f));
+    EXPECT_EQ(last.normal, glm::vec3(0.0f, 0.0f, 1.0f));
+    EXPECT_EQ(last.color, glm::vec3(1.0f));
+    EXPECT_FLOAT_EQ(last.texCoord.y, 1.0f - (size - 1.0f) / size); // v переворачивается, как в OBJ
+    const std::vector<uint32_t> lastTriangle = {size * (size - 1) - 2, size * size - 1, size * size - 2};
+    EXPECT_EQ(std::vector<uint32_t>(multiIndices.end() - 3, multiIndices.end()), lastTriangle);
+    fs::remove(path);
+}
+
+TEST(PlyParserTest, RejectsInvalidFiles) {
+    const auto path = fs::temp_directory_path() / "ply_invalid.ply";
+    auto load = [&](const std::string& contents) {
+        writeFile(path, contents);
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        PlyParser().load(path.string(), vertices, indices);
+    };
+    const std::string valid = mixedPly(false);
+    EXPECT_NO_THROW(load(valid));
+    EXPECT_THROW(load(valid.substr(0, valid.size() - 1)), std::runtime_error); // Обрезанный файл
+
+    std::string badIndex = valid;
+    badIndex[badIndex.size() - 5] = 5; // Последний индекс последней грани: вершины 5 нет
+    EXPECT_THROW(load(badIndex), std::runtime_error);
+
+    EXPECT_THROW(load("ply\nformat ascii 1.0\nelement vertex 0\nelement face 0\nend_header\n"), std::runtime_error);
+    EXPECT_THROW(load("ply\n" + format(false) + "element vertex 1\nproperty float x\nproperty float y\n"
+                      "property float z\nend_header\n" + std::string(12, '\0')), std::runtime_error); // Без граней
+    EXPECT_THROW(load("ply\n" + format(false) + "element vertex 1\nproperty float x\n"), std::runtime_error);
+    EXPECT_THROW(load("not a ply file"), std::runtime_error);
+    fs::remove(path);
+}
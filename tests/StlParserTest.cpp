@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include "ObjParser.hpp"
+#include "StlParser.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    /// Двоичный STL из треугольников сетки; нормаль грани нулевая, атрибут — номер треугольника
+    void writeStl(const fs::path& path, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                  const std::string& headerText = "binary stl") {
+        std::string header = headerText;
+        header.resize(80, ' ');
+        std::ofstream file(path, std::ios::binary);
+        file.write(header.data(), header.size());
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        file.write(reinterpret_cast<const char*>(&triangleCount), sizeof(triangleCount));
+        for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+            const float normal[3] = {0.0f, 0.0f, 0.0f};
+            file.write(reinterpret_cast<const char*>(normal), sizeof(normal));
+            for (size_t k = 0; k < 3; ++k) {
+                file.write(reinterpret_cast<const char*>(&vertices[indices[triangle * 3 + k]].pos), 12);
+            }
+            const uint16_t attribute = static_cast<uint16_t>(triangle);
+            file.write(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+        }
+    }
+}
+
+TEST(StlParserTest, WeldsModelTriangles) {
+    std::vector<Vertex> model;
+    std::vector<uint32_t> modelIndices;
+    ObjParser().load(MODEL_PATH, model, modelIndices);
+    std::set<std::array<float, 3>> positions;
+    for (const Vertex& vertex : model) {
+        positions.insert({vertex.pos.x, vertex.pos.y, vertex.pos.z});
+    }
+
+    // Заголовок, начинающийся с "solid", не делает двоичный файл текстовым
+    const auto path = fs::temp_directory_path() / "stl_model.stl";
+    writeStl(path, model, modelIndices, "solid exported by a CAD tool");
+
+    std::vector<Vertex> single, multi;
+    std::vector<uint32_t> singleIndices, multiIndices;
+    StlParser(1).load(path.string(), single, singleIndices);
+    StlParser parser(4);
+    parser.load(path.string(), multi, multiIndices);
+
+    EXPECT_EQ(multi, single);
+    EXPECT_EQ(multiIndices, singleIndices);
+    EXPECT_EQ(parser.getStats().triangleCount, modelIndices.size() / 3);
+    EXPECT_EQ(multi.size(), positions.size()); // Одна вершина на позицию: UV и нормалей в STL нет
+    ASSERT_EQ(multiIndices.size() + parser.getStats().degenerateCount * 3, modelIndices.size());
+
+    if (parser.getStats().degenerateCount == 0) {
+        for (size_t i = 0; i < modelIndices.size(); ++i) {
+            ASSERT_EQ(multi[multiIndices[i]].pos, model[modelIndices[i]].pos);
+        }
+    }
+    for (const Vertex& vertex : multi) {
+        EXPECT_EQ(vertex.normal, glm::vec3(0.0f)); // Строятся после склейки
+        EXPECT_EQ(vertex.color, glm::vec3(1.0f));
+    }
+    fs::remove(path);
+}
+
+TEST(StlParserTest, EpsilonWeldDropsCollapsedTriangles) {
+    std::vector<Vertex> corners(4);
+    corners[0].pos = {0.0f, 0.0f, 0.0f};
+    corners[1].pos = {1.0f, 0.0f, 0.0f};
+    corners[2].pos = {0.0f, 1.0f, 0.0f};
+    corners[3].pos = {1.0004f, 0.0001f, 0.0f}; // Совпадает с 1 при шаге 0.01
+    const std::vector<uint32_t> triangles = {0, 1, 2, 1, 3, 2};
+
+    const auto path = fs::temp_directory_path() / "stl_epsilon.stl";
+    writeStl(path, corners, triangles);
+
+    std::vector<Vertex> exact, welded;
+    std::vector<uint32_t> exactIndices, weldedIndices;
+    StlParser(1).load(path.string(), exact, exactIndices);
+    StlParser parser(1, 0.01f);
+    parser.load(path.string(), welded, weldedIndices);
+
+    EXPECT_EQ(exact.size(), 4u);
+    EXPECT_EQ(exactIndices.size(), 6u);
+    EXPECT_EQ(welded.size(), 3u);
+    const std::vector<uint32_t> kept = {0, 1, 2};
+    EXPECT_EQ(weldedIndices, kept);
+    EXPECT_EQ(parser.getStats().degenerateCount, 1u);
+    fs::remove(path);
+}
+
+TEST(StlParserTest, RejectsInvalidFiles) {
+    const auto path = fs::temp_directory_path() / "stl_invalid.stl";
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    std::ofstream(path, std::ios::binary) << "solid cube\n  facet normal 0 0 1\n  endfacet\nendsolid cube\n";
+    EXPECT_THROW(StlParser().load(path.string(), vertices, indices), std::runtime_error);
+
+    std::vector<Vertex> corners(3);
+    writeStl(path, corners, {0, 1, 2});
+    fs::resize_file(path, fs::file_size(path) - 1); // Число граней не сходится с размером
+    EXPECT_THROW(StlParser().load(path.string(), vertices, indices), std::runtime_error);
+
+    fs::remove(path);
+    EXPECT_THROW(StlParser().load(path.string(), vertices, indices), std::runtime_error);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "SubAllocator.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr uint64_t BLOCK_SIZE = 16 * 1024 * 1024;
+
+    /// Размещение с повтором после нового блока, как в MemoryAllocator
+    SubAllocator::Allocation allocate(SubAllocator& allocator, uint64_t size, uint64_t alignment,
+                                      SubAllocator::Kind kind) {
+        SubAllocator::Allocation allocation = allocator.allocate(size, alignment, kind);
+        if (!allocation.valid()) {
+            allocator.addBlock();
+            allocation = allocator.allocate(size, alignment, kind);
+        }
+        return allocation;
+    }
+
+    struct Placed {
+        SubAllocator::Allocation allocation;
+        uint64_t alignment = 1;
+        SubAllocator::Kind kind = SubAllocator::Kind::LINEAR;
+    };
+}
+
+TEST(SubAllocatorTest, SizeClassesRoundUpToPowersOfTwo) {
+    EXPECT_EQ(SubAllocator::classOf(1, 1), 0u);
+    EXPECT_EQ(SubAllocator::classOf(256, 4), 0u);
+    EXPECT_EQ(SubAllocator::classOf(257, 4), 1u);
+    EXPECT_EQ(SubAllocator::classOf(100, 4096), 4u); // Выравнивание больше размера
+    EXPECT_EQ(SubAllocator::classOf(SubAllocator::MAX_CLASS_SIZE, 256), SubAllocator::CLASS_COUNT - 1);
+    EXPECT_EQ(SubAllocator::classOf(SubAllocator::MAX_CLASS_SIZE + 1, 256), SubAllocator::CLASS_COUNT);
+}
+
+TEST(SubAllocatorTest, SmallResourcesShareOneChunk) {
+    SubAllocator allocator(BLOCK_SIZE, 1);
+    EXPECT_FALSE(allocator.allocate(64, 16, SubAllocator::Kind::LINEAR).valid()); // Блоков ещё нет
+
+    std::vector<SubAllocator::Allocation> small;
+    for (int i = 0; i < 100; ++i) {
+        small.push_back(allocate(allocator, 200, 16, SubAllocator::Kind::LINEAR));
+        ASSERT_TRUE(small.back().valid());
+        EXPECT_NE(small.back().chunk, SubAllocator::NO_CHUNK);
+        EXPECT_EQ(small.back().offset % 256, 0u);
+    }
+    SubAllocator::Stats stats = allocator.stats();
+    EXPECT_EQ(stats.blockCount, 1u);
+    EXPECT_EQ(stats.chunkCount, 1u);
+    EXPECT_EQ(stats.allocationCount, 100u);
+    EXPECT_EQ(stats.allocatedBytes, 100u * 200u);
+
+    // Освобождённый слот выдаётся снова, не трогая блок
+    const uint64_t reused = small[42].offset;
+    allocator.free(small[42]);
+    EXPECT_EQ(allocate(allocator, 256, 256, SubAllocator::Kind::LINEAR).offset, reused);
+}
+
+TEST(SubAllocatorTest, LargeResourcesUseCoalescedRanges) {
+    SubAllocator allocator(BLOCK_SIZE, 1);
+    const uint64_t quarter = BLOCK_SIZE / 4;
+    std::vector<SubAllocator::Allocation> large;
+    for (int i = 0; i < 4; ++i) {
+        large.push_back(allocate(allocator, quarter, 4096, SubAllocator::Kind::OPTIMAL));
+        EXPECT_EQ(large.back().chunk, SubAllocator::NO_CHUNK);
+        EXPECT_EQ(large.back().offset, i * quarter);
+    }
+    EXPECT_EQ(allocator.stats().blockCount, 1u);
+    EXPECT_EQ(allocator.stats().freeBytes, 0u);
+
+    // Два соседних освобождённых диапазона сливаются и вмещают половину блока
+    allocator.free(large[1]);
+    allocator.free(large[2]);
+    EXPECT_EQ(allocator.stats().largestFreeRange, 2 * quarter);
+    const SubAllocator::Allocation half = allocator.allocate(2 * quarter, 4096, SubAllocator::Kind::OPTIMAL);
+    ASSERT_TRUE(half.valid());
+    EXPECT_EQ(half.offset, quarter);
+
+    // Больше блока не размещается: такому ресурсу нужно отдельное выделение
+    EXPECT_FALSE(allocator.allocate(BLOCK_SIZE + 1, 1, SubAllocator::Kind::LINEAR).valid());
+}
+
+TEST(SubAllocatorTest, DifferentKindsDoNotShareGranularityPage) {
+    const uint64_t granularity = 64 * 1024;
+    SubAllocator allocator(BLOCK_SIZE, granularity);
+    const SubAllocator::Allocation buffer = allocate(allocator, 100 * 1024, 256, SubAllocator::Kind::LINEAR);
+    const SubAllocator::Allocation image = allocate(allocator, 100 * 1024, 256, SubAllocator::Kind::OPTIMAL);
+    const SubAllocator::Allocation nextBuffer = allocate(allocator, 100 * 1024, 256, SubAllocator::Kind::LINEAR);
+    ASSERT_TRUE(buffer.valid() && image.valid() && nextBuffer.valid());
+    EXPECT_EQ(buffer.offset, 0u);
+    EXPECT_EQ(image.offset, 2 * granularity); // Сдвинуто со страницы, где кончается буфер
+    EXPECT_EQ(nextBuffer.offset, 4 * granularity);
+
+    // Ресурс того же вида ложится вплотную
+    const SubAllocator::Allocation sameKind = allocate(allocator, 100 * 1024, 256, SubAllocator::Kind::LINEAR);
+    EXPECT_EQ(sameKind.offset, nextBuffer.offset + 100 * 1024);
+
+    // Освободившийся промежуток кончается посреди страницы, где начинается буфер sameKind:
+    // изображение туда не ложится, а буфер — ложится
+    allocator.free(nextBuffer);
+    const SubAllocator::Allocation secondImage = allocate(allocator, 100 * 1024, 256, SubAllocator::Kind::OPTIMAL);
+    EXPECT_GE(secondImage.offset, sameKind.offset + sameKind.size);
+    const SubAllocator::Allocation refill = allocate(allocator, 100 * 1024, 256, SubAllocator::Kind::LINEAR);
+    EXPECT_EQ(refill.offset, 4 * granularity);
+}
+
+TEST(SubAllocatorTest, EmptyBlocksAreReleasedExceptOne) {
+    SubAllocator allocator(BLOCK_SIZE, 1);
+    const SubAllocator::Allocation first = allocate(allocator, BLOCK_SIZE, 1, SubAllocator::Kind::LINEAR);
+    const SubAllocator::Allocation second = allocate(allocator, BLOCK_SIZE, 1, SubAllocator::Kind::LINEAR);
+    ASSERT_NE(first.block, second.block);
+    EXPECT_EQ(allocator.stats().blockCount, 2u);
+
+    EXPECT_EQ(allocator.free(first), SubAllocator::NO_BLOCK); // Остаётся про запас
+    EXPECT_EQ(allocator.free(second), second.block);
+    EXPECT_EQ(allocator.stats().blockCount, 1u);
+
+    // Запасной блок используется без нового
+    const SubAllocator::Allocation again = allocator.allocate(1024 * 1024, 1, SubAllocator::Kind::LINEAR);
+    EXPECT_EQ(again.block, first.block);
+}
+
+TEST(SubAllocatorTest, RandomAllocationsNeverOverlap) {
+    const uint64_t granularity = 4096;
+    SubAllocator allocator(BLOCK_SIZE, granularity);
+    std::mt19937 random(12345);
+    std::vector<Placed> live;
+
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || random() % 100 < 55) {
+            Placed placed;
+            // В основном мелкие, иногда средние и крупные ресурсы
+            const uint32_t roll = random() % 100;
+            const uint64_t size = roll < 70 ? 1 + random() % 4096
+                                : roll < 95 ? 4096 + random() % (512 * 1024)
+                                            : 1024 * 1024 + random() % (4 * 1024 * 1024);
+            placed.alignment = uint64_t{1} << (random() % 13);
+            placed.kind = random() % 2 ? SubAllocator::Kind::LINEAR : SubAllocator::Kind::OPTIMAL;
+            placed.allocation = allocate(allocator, size, placed.alignment, placed.kind);
+            ASSERT_TRUE(placed.allocation.valid());
+            ASSERT_EQ(placed.allocation.offset % placed.alignment, 0u);
+            ASSERT_LE(placed.allocation.offset + size, BLOCK_SIZE);
+            live.push_back(placed);
+        } else {
+            const size_t index = random() % live.size();
+            allocator.free(live[index].allocation);
+            live[index] = live.back();
+            live.pop_back();
+        }
+
+        if (step % 500 != 0) {
+            continue;
+        }
+        std::vector<Placed> sorted = live;
+        std::sort(sorted.begin(), sorted.end(), [](const Placed& a, const Placed& b) {
+            return a.allocation.block != b.allocation.block ? a.allocation.block < b.allocation.block
+                                                            : a.allocation.offset < b.allocation.offset;
+        });
+        for (size_t i = 1; i < sorted.size(); ++i) {
+            const SubAllocator::Allocation& previous = sorted[i - 1].allocation;
+            const SubAllocator::Allocation& current = sorted[i].allocation;
+            if (previous.block != current.block) {
+                continue;
+            }
+            ASSERT_LE(previous.offset + previous.size, current.offset);
+            // Соседи разного вида — на разных страницах
+            if (sorted[i - 1].kind != sorted[i].kind) {
+                ASSERT_LT((previous.offset + previous.size - 1) / granularity, current.offset / granularity);
+            }
+        }
+        const SubAllocator::Stats stats = allocator.stats();
+        ASSERT_EQ(stats.allocationCount, live.size());
+        ASSERT_LE(stats.freeBytes, stats.blockBytes);
+    }
+
+    for (const Placed& placed : live) {
+        allocator.free(placed.allocation);
+    }
+    const SubAllocator::Stats stats = allocator.stats();
+    EXPECT_EQ(stats.allocationCount, 0u);
+    EXPECT_EQ(stats.allocatedBytes, 0u);
+    EXPECT_EQ(stats.chunkCount, 0u);
+    EXPECT_EQ(stats.blockCount, 1u);
+    EXPECT_EQ(stats.freeRangeCount, 1u);
+    EXPECT_EQ(stats.largestFreeRange, BLOCK_SIZE);
+}
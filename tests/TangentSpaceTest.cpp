@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "ObjParser.hpp"
+#include "TangentSpace.hpp"
+#include "TestGeometry.hpp"
+
+using TestGeometry::flat;
+using TestGeometry::makeGrid;
+
+namespace {
+    void expectNear(const glm::vec3& expected, const glm::vec3& actual, float tolerance) {
+        EXPECT_NEAR(expected.x, actual.x, tolerance);
+        EXPECT_NEAR(expected.y, actual.y, tolerance);
+        EXPECT_NEAR(expected.z, actual.z, tolerance);
+    }
+}
+
+TEST(TangentSpaceTest, FlatGridFacesUpWithTangentAlongU) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(8, flat, vertices, indices);
+    EXPECT_FALSE(TangentSpace::hasNormals(vertices));
+
+    TangentSpace::generateNormals(vertices, indices);
+    TangentSpace::generateTangents(vertices, indices);
+    EXPECT_TRUE(TangentSpace::hasNormals(vertices));
+
+    for (const Vertex& vertex : vertices) {
+        expectNear(glm::vec3(0, 0, 1), vertex.normal, 1e-6f);
+        expectNear(glm::vec3(1, 0, 0), glm::vec3(vertex.tangent), 1e-6f);
+        EXPECT_EQ(1.0f, vertex.tangent.w); // cross(n, t) = +v
+    }
+}
+
+TEST(TangentSpaceTest, MirroredUvFlipsHandedness) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(4, flat, vertices, indices);
+    for (Vertex& vertex : vertices) {
+        vertex.texCoord.y = 1.0f - vertex.texCoord.y; // Развёртка отражена по v
+    }
+    TangentSpace::generateNormals(vertices, indices);
+    TangentSpace::generateTangents(vertices, indices);
+
+    for (const Vertex& vertex : vertices) {
+        expectNear(glm::vec3(1, 0, 0), glm::vec3(vertex.tangent), 1e-6f);
+        EXPECT_EQ(-1.0f, vertex.tangent.w);
+    }
+}
+
+TEST(TangentSpaceTest, UvSeamSharesNormal) {
+    // Две грани под прямым углом, у общего ребра вершины продублированы (разные UV)
+    std::vector<Vertex> vertices(6);
+    vertices[0].pos = {0, 0, 0}; vertices[1].pos = {1, 0, 0}; vertices[2].pos = {0, 1, 0};
+    vertices[3].pos = {0, 0, 0}; vertices[4].pos = {0, 1, 0}; vertices[5].pos = {0, 0, 1};
+    vertices[3].texCoord = {5, 5};
+    const std::vector<uint32_t> indices = {0, 1, 2, 3, 4, 5};
+
+    TangentSpace::generateNormals(vertices, indices);
+
+    // Нормаль в общей позиции — среднее нормалей +z и +x (веса равны: одинаковые площади и углы)
+    const glm::vec3 shared = glm::normalize(glm::vec3(1, 0, 1));
+    expectNear(shared, vertices[0].normal, 1e-6f);
+    expectNear(shared, vertices[3].normal, 1e-6f);
+    expectNear(glm::vec3(0, 0, 1), vertices[1].normal, 1e-6f);
+    expectNear(glm::vec3(1, 0, 0), vertices[5].normal, 1e-6f);
+}
+
+TEST(TangentSpaceTest, TangentFrameIsOrthonormal) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(64, [](float u, float v) { return 0.2f * std::sin(7.0f * u) * std::cos(5.0f * v); }, vertices, indices);
+
+    TangentSpace::generateNormals(vertices, indices, 4);
+    TangentSpace::generateTangents(vertices, indices, 4);
+    for (const Vertex& vertex : vertices) {
+        const glm::vec3 tangent(vertex.tangent);
+        EXPECT_NEAR(1.0f, glm::length(vertex.normal), 1e-5f);
+        EXPECT_NEAR(1.0f, glm::length(tangent), 1e-5f);
+        EXPECT_NEAR(0.0f, glm::dot(vertex.normal, tangent), 1e-5f);
+        EXPECT_GT(vertex.normal.z, 0.0f);
+        EXPECT_GT(tangent.x, 0.0f); // Касательная по-прежнему идёт вдоль роста u
+    }
+}
+
+TEST(TangentSpaceTest, ThreadCountDoesNotChangeResult) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjParser().load(MODEL_PATH, vertices, indices);
+
+    std::vector<Vertex> single = vertices;
+    std::vector<uint32_t> singleIndices = indices;
+    TangentSpace::generateNormals(single, singleIndices, 1);
+    TangentSpace::generateTangents(single, singleIndices, 1);
+
+    std::vector<Vertex> multi = vertices;
+    std::vector<uint32_t> multiIndices = indices;
+    TangentSpace::generateNormals(multi, multiIndices, 8);
+    TangentSpace::generateTangents(multi, multiIndices, 8);
+
+    // Деление вершин зависит только от развёртки; суммы — с точностью до округления
+    ASSERT_EQ(single.size(), multi.size());
+    EXPECT_EQ(singleIndices, multiIndices);
+    for (size_t i = 0; i < single.size(); ++i) {
+        expectNear(single[i].normal, multi[i].normal, 1e-4f);
+        expectNear(glm::vec3(single[i].tangent), glm::vec3(multi[i].tangent), 1e-3f);
+    }
+}
+
+TEST(TangentSpaceTest, MirroredUvSeamSplitsVertices) {
+    // Левая половина сетки отражена по u: на средней линии сходятся грани обеих ориентаций
+    const uint32_t side = 8;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeGrid(side, flat, vertices, indices);
+    for (Vertex& vertex : vertices) {
+        vertex.texCoord.x = std::fabs(vertex.pos.x - 0.5f);
+    }
+    const size_t gridVertices = vertices.size();
+    TangentSpace::generateNormals(vertices, indices);
+    TangentSpace::generateTangents(vertices, indices);
+
+    ASSERT_EQ(gridVertices + side + 1, vertices.size()); // Копии получает только средняя линия
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const Vertex& v0 = vertices[indices[i]];
+        const bool mirrored = v0.pos.x + vertices[indices[i + 1]].pos.x + vertices[indices[i + 2]].pos.x < 1.5f;
+        for (size_t k = 0; k < 3; ++k) {
+            const Vertex& vertex = vertices[indices[i + k]];
+            // На левой половине u растёт к -x, и базис отражён
+            expectNear(glm::vec3(mirrored ? -1.0f : 1.0f, 0, 0), glm::vec3(vertex.tangent), 1e-6f);
+            EXPECT_EQ(mirrored ? -1.0f : 1.0f, vertex.tangent.w);
+        }
+    }
+}
+
+TEST(TangentSpaceTest, RejectsOutOfRangeIndex) {
+    std::vector<Vertex> vertices(3);
+    EXPECT_THROW(TangentSpace::generateNormals(vertices, {0, 1, 3}), std::runtime_error);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Vertex.hpp"
+
+/// Процедурная геометрия для тестов
+namespace TestGeometry {
+    inline float flat(float, float) { return 0.0f; }
+
+    /**
+     * @brief Сетка side x side квадратов на плоскости z = height(u, v)
+     *
+     * Вершина (u, v) из [0, 1]² лежит в origin + (u, v, height(u, v)) и получает UV = (u, v).
+     * Нормали не задаются. Лицевая сторона треугольников смотрит в +z.
+     */
+    template <typename Height>
+    void makeGrid(uint32_t side, Height height, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                  const glm::vec3& origin = glm::vec3(0.0f)) {
+        for (uint32_t y = 0; y <= side; ++y) {
+            for (uint32_t x = 0; x <= side; ++x) {
+                Vertex vertex{};
+                const float u = static_cast<float>(x) / side;
+                const float v = static_cast<float>(y) / side;
+                vertex.pos = origin + glm::vec3(u, v, height(u, v));
+                vertex.texCoord = glm::vec2(u, v);
+                vertices.push_back(vertex);
+            }
+        }
+        for (uint32_t y = 0; y < side; ++y) {
+            for (uint32_t x = 0; x < side; ++x) {
+                const uint32_t v = y * (side + 1) + x;
+                indices.insert(indices.end(), {v, v + 1, v + side + 2, v, v + side + 2, v + side + 1});
+            }
+        }
+    }
+}
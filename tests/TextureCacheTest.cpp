@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "Hash.hpp"
+#include "MipChain.hpp"
+#include "TextureCache.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    /// Уровень 0 и хвост цепочки с узнаваемым содержимым
+    struct Chain {
+        std::vector<uint8_t> base;
+        std::vector<uint8_t> tail;
+    };
+
+    Chain makeChain(uint32_t width, uint32_t height) {
+        Chain chain;
+        chain.base.resize(size_t{width} * height * 4);
+        chain.tail.resize(MipChain::chainSize(width, height) - chain.base.size());
+        for (size_t i = 0; i < chain.base.size(); ++i) {
+            chain.base[i] = static_cast<uint8_t>(i * 7);
+        }
+        for (size_t i = 0; i < chain.tail.size(); ++i) {
+            chain.tail[i] = static_cast<uint8_t>(i * 13 + 1);
+        }
+        return chain;
+    }
+
+    fs::path freshDirectory(const std::string& name) {
+        const fs::path directory = fs::temp_directory_path() / name;
+        fs::remove_all(directory);
+        return directory;
+    }
+}
+
+TEST(TextureCacheTest, StoreAndOpenRoundTrip) {
+    const fs::path directory = freshDirectory("texture_cache_roundtrip");
+    const TextureCache cache(directory.string(), 1 << 30);
+    const std::string source = "compressed image bytes";
+    const Chain chain = makeChain(37, 20);
+
+    EXPECT_EQ(cache.open(source.data(), source.size()), nullptr);
+    ASSERT_TRUE(cache.store(source.data(), source.size(), 37, 20, chain.base.data(), chain.tail.data()));
+
+    {
+        const auto entry = cache.open(source.data(), source.size());
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->width(), 37u);
+        EXPECT_EQ(entry->height(), 20u);
+        EXPECT_EQ(entry->mipLevels(), MipChain::levelCount(37, 20));
+        ASSERT_EQ(entry->size(), MipChain::chainSize(37, 20));
+        EXPECT_EQ(std::memcmp(entry->data(), chain.base.data(), chain.base.size()), 0);
+        EXPECT_EQ(std::memcmp(entry->data() + chain.base.size(), chain.tail.data(), chain.tail.size()), 0);
+        // Отображение начинается с границы страницы, значит и уровни выровнены по странице
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(entry->data()) % TextureCache::PAGE_SIZE, 0u);
+    }
+
+    // Ключ — содержимое, а не имя: другое изображение записи не находит
+    const std::string other = "other image bytes";
+    EXPECT_EQ(cache.open(other.data(), other.size()), nullptr);
+    EXPECT_GE(cache.totalBytes(), MipChain::chainSize(37, 20));
+    fs::remove_all(directory);
+}
+
+TEST(TextureCacheTest, RejectsCorruptEntries) {
+    const fs::path directory = freshDirectory("texture_cache_corrupt");
+    const TextureCache cache(directory.string(), 1 << 30);
+    const std::string source = "image";
+    const Chain chain = makeChain(8, 8);
+    ASSERT_TRUE(cache.store(source.data(), source.size(), 8, 8, chain.base.data(), chain.tail.data()));
+    const std::string entryPath = cache.entryPath(Hash::bytes(source.data(), source.size()));
+    ASSERT_TRUE(fs::exists(entryPath));
+
+    // Обрезанные уровни
+    fs::resize_file(entryPath, TextureCache::PAGE_SIZE + 10);
+    EXPECT_EQ(cache.open(source.data(), source.size()), nullptr);
+
+    // Испорченная сигнатура
+    ASSERT_TRUE(cache.store(source.data(), source.size(), 8, 8, chain.base.data(), chain.tail.data()));
+    {
+        std::fstream file(entryPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.put('X');
+    }
+    EXPECT_EQ(cache.open(source.data(), source.size()), nullptr);
+    fs::remove_all(directory);
+}
+
+TEST(TextureCacheTest, EvictsLeastRecentlyUsed) {
+    const fs::path directory = freshDirectory("texture_cache_evict");
+    const Chain chain = makeChain(64, 64);
+    const std::string sources[3] = {"first", "second", "third"};
+    {
+        const TextureCache unbounded(directory.string(), 1 << 30);
+        for (const std::string& source : sources) {
+            ASSERT_TRUE(unbounded.store(source.data(), source.size(), 64, 64, chain.base.data(), chain.tail.data()));
+        }
+    }
+    const uint64_t entrySize = fs::file_size(fs::directory_iterator(directory)->path());
+
+    // Все записи старые, затем к первой обратились: её метка свежее остальных
+    const TextureCache cache(directory.string(), entrySize * 2);
+    const auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        fs::last_write_time(entry.path(), past);
+    }
+    ASSERT_NE(cache.open(sources[0].data(), sources[0].size()), nullptr);
+
+    EXPECT_EQ(cache.evict(), entrySize);
+    EXPECT_EQ(cache.totalBytes(), entrySize * 2);
+    EXPECT_NE(cache.open(sources[0].data(), sources[0].size()), nullptr);
+    EXPECT_EQ(cache.evict(), 0u);
+    fs::remove_all(directory);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "VertexWelder.hpp"
+
+namespace {
+    Vertex makeVertex(float x, float y, float z, float u = 0.0f, float v = 0.0f) {
+        Vertex vertex{};
+        vertex.pos = {x, y, z};
+        vertex.color = {1.0f, 1.0f, 1.0f};
+        vertex.texCoord = {u, v};
+        return vertex;
+    }
+}
+
+TEST(VertexWelderTest, MatchesUnorderedMap) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> coordinate(0, 40);
+
+    std::vector<Vertex> expectedVertices, vertices;
+    std::vector<uint32_t> expectedIndices, indices;
+    std::unordered_map<Vertex, uint32_t> uniqueVertices;
+    VertexWelder welder(vertices, 16); // Намеренно маленький резерв: таблица должна расти
+
+    for (int i = 0; i < 20000; ++i) {
+        const Vertex vertex = makeVertex(static_cast<float>(coordinate(random)), 0.5f,
+                                         static_cast<float>(coordinate(random)), 0.25f * (i % 3));
+        if (uniqueVertices.count(vertex) == 0) {
+            uniqueVertices[vertex] = static_cast<uint32_t>(expectedVertices.size());
+            expectedVertices.push_back(vertex);
+        }
+        expectedIndices.push_back(uniqueVertices[vertex]);
+        indices.push_back(welder.weld(vertex));
+    }
+
+    EXPECT_EQ(expectedIndices, indices);
+    EXPECT_EQ(expectedVertices, vertices);
+    EXPECT_EQ(vertices.size(), welder.size());
+}
+
+TEST(VertexWelderTest, NegativeZeroEqualsZero) {
+    std::vector<Vertex> vertices;
+    VertexWelder welder(vertices);
+    EXPECT_EQ(welder.weld(makeVertex(0.0f, 1.0f, 2.0f)), welder.weld(makeVertex(-0.0f, 1.0f, 2.0f)));
+    EXPECT_EQ(1u, vertices.size());
+}
+
+TEST(VertexWelderTest, AppendsAfterExistingVertices) {
+    std::vector<Vertex> vertices = {makeVertex(1.0f, 2.0f, 3.0f)};
+    VertexWelder welder(vertices);
+    EXPECT_EQ(1u, welder.weld(makeVertex(1.0f, 2.0f, 3.0f)));
+    EXPECT_EQ(2u, vertices.size());
+}
+
+TEST(VertexWelderTest, WeldsByQuantizedPosition) {
+    std::vector<Vertex> vertices;
+    VertexWelder welder(vertices, 0, 0.01f);
+
+    const uint32_t first = welder.weld(makeVertex(1.0f, 1.0f, 1.0f));
+    EXPECT_EQ(first, welder.weld(makeVertex(1.001f, 0.999f, 1.002f)));
+    EXPECT_NE(first, welder.weld(makeVertex(1.05f, 1.0f, 1.0f)));
+    // Шов UV не склеивается, даже если позиции совпали
+    EXPECT_NE(first, welder.weld(makeVertex(1.0f, 1.0f, 1.0f, 0.5f)));
+
+    EXPECT_EQ(3u, vertices.size());
+    EXPECT_EQ(1.0f, vertices[first].pos.x); // Сохраняется первая встреченная вершина
+}
+
+TEST(VertexWelderTest, WeldAllMatchesSequential) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> coordinate(0, 300);
+    std::vector<Vertex> corners;
+    for (int i = 0; i < 200000; ++i) {
+        corners.push_back(makeVertex(static_cast<float>(coordinate(random)) * 0.01f, 1.0f,
+                                     static_cast<float>(coordinate(random)) * 0.01f, 0.5f * (i % 2)));
+    }
+
+    for (float epsilon : {0.0f, 0.05f}) {
+        std::vector<Vertex> expectedVertices;
+        std::vector<uint32_t> expectedIndices;
+        VertexWelder welder(expectedVertices, 0, epsilon);
+        for (const Vertex& corner : corners) {
+            expectedIndices.push_back(welder.weld(corner));
+        }
+
+        for (unsigned threads : {1u, 3u, 8u}) {
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+            VertexWelder::weldAll(corners, vertices, indices, epsilon, threads);
+            EXPECT_EQ(expectedIndices, indices) << "threads=" << threads << " epsilon=" << epsilon;
+            EXPECT_EQ(expectedVertices, vertices) << "threads=" << threads << " epsilon=" << epsilon;
+        }
+    }
+}
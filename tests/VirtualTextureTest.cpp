@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "MipChain.hpp"
+#include "VirtualTexture.hpp"
+
+namespace {
+    /// Цепочка, в которой каждый тексель кодирует свой уровень и координаты
+    std::vector<uint8_t> makeChain(uint32_t width, uint32_t height) {
+        std::vector<uint8_t> chain(MipChain::chainSize(width, height));
+        const std::vector<MipChain::Level> levels = MipChain::levels(width, height);
+        for (size_t level = 0; level < levels.size(); ++level) {
+            for (uint32_t y = 0; y < levels[level].height; ++y) {
+                for (uint32_t x = 0; x < levels[level].width; ++x) {
+                    uint8_t* texel = &chain[levels[level].offset + (size_t{y} * levels[level].width + x) * 4];
+                    texel[0] = static_cast<uint8_t>(x);
+                    texel[1] = static_cast<uint8_t>(y);
+                    texel[2] = static_cast<uint8_t>(level);
+                    texel[3] = 255;
+                }
+            }
+        }
+        return chain;
+    }
+
+    std::vector<const uint8_t*> levelPointers(const std::vector<uint8_t>& chain, uint32_t width, uint32_t height) {
+        std::vector<const uint8_t*> pointers;
+        for (const MipChain::Level& level : MipChain::levels(width, height)) {
+            pointers.push_back(chain.data() + level.offset);
+        }
+        return pointers;
+    }
+
+    const uint8_t* texel(const VirtualTexture& texture, size_t tile, uint32_t i, uint32_t j) {
+        return texture.getTileData(tile) + (size_t{j} * texture.getPageExtent() + i) * 4;
+    }
+}
+
+TEST(VirtualTextureTest, LevelsAndTileCounts) {
+    EXPECT_EQ(VirtualTexture::levelCount(120, 120, 120), 1u);
+    EXPECT_EQ(VirtualTexture::levelCount(121, 10, 120), 2u);
+    EXPECT_EQ(VirtualTexture::levelCount(32768, 32768, 120), 10u); // 32768 >> 9 = 64
+    EXPECT_EQ(VirtualTexture::tilesAlong(32768, 0, 120), 274u);
+    EXPECT_EQ(VirtualTexture::tilesAlong(300, 1, 120), 2u);
+    EXPECT_EQ(VirtualTexture::tilesAlong(1, 5, 120), 1u);
+}
+
+TEST(VirtualTextureTest, WriteAndReadTilesWithBorders) {
+    const std::string path = "virtual_texture_test.vtex";
+    const uint32_t width = 50;
+    const uint32_t height = 30;
+    const std::vector<uint8_t> chain = makeChain(width, height);
+    VirtualTexture::write(path, width, height, levelPointers(chain, width, height), 16, 2);
+
+    {
+        VirtualTexture texture(path);
+        EXPECT_EQ(texture.getWidth(), width);
+        EXPECT_EQ(texture.getHeight(), height);
+        EXPECT_EQ(texture.getPageExtent(), 20u);
+        ASSERT_EQ(texture.getLevelCount(), 3u); // 50x30, 25x15, 12x7
+        EXPECT_EQ(texture.getTilesX(0), 4u);
+        EXPECT_EQ(texture.getTilesY(0), 2u);
+        EXPECT_EQ(texture.getTilesX(1), 2u);
+        EXPECT_EQ(texture.getTileCount(), 8u + 2u + 1u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(texture.getTileData(0)) % VirtualTexture::PAGE_SIZE, 0u);
+
+        // Страница (1, 1) уровня 0: полезная часть начинается с текселя (16, 16), рамка — соседние тексели
+        const size_t tile = texture.tileIndex(0, 1, 1);
+        EXPECT_EQ(texel(texture, tile, 2, 2)[0], 16);
+        EXPECT_EQ(texel(texture, tile, 2, 2)[1], 16);
+        EXPECT_EQ(texel(texture, tile, 0, 2)[0], 14);
+        EXPECT_EQ(texel(texture, tile, 2, 0)[1], 14);
+        // За нижним краем уровня (y >= 30) повторяется последняя строка
+        EXPECT_EQ(texel(texture, tile, 2, 19)[1], 29);
+
+        // Единственная страница уровня 2 с повтором крайних текселей по краям
+        const size_t last = texture.tileIndex(2, 0, 0);
+        EXPECT_EQ(last, texture.getTileCount() - 1);
+        EXPECT_EQ(texel(texture, last, 0, 0)[0], 0);
+        EXPECT_EQ(texel(texture, last, 5, 4)[0], 3);
+        EXPECT_EQ(texel(texture, last, 5, 4)[1], 2);
+        EXPECT_EQ(texel(texture, last, 19, 19)[0], 11);
+        EXPECT_EQ(texel(texture, last, 19, 19)[2], 2);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(VirtualTextureTest, RejectsInvalidFiles) {
+    const std::string path = "virtual_texture_invalid_test.vtex";
+    const std::vector<uint8_t> chain = makeChain(40, 40);
+    std::vector<const uint8_t*> levels = levelPointers(chain, 40, 40);
+    EXPECT_THROW(VirtualTexture::write(path, 40, 40, {levels[0]}, 16, 2), std::runtime_error);
+    EXPECT_THROW(VirtualTexture::write(path, 40, 40, levels, 16, 17), std::runtime_error);
+
+    VirtualTexture::write(path, 40, 40, levels, 16, 2);
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto writeBytes = [&](const std::vector<char>& content) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    };
+
+    std::vector<char> broken = bytes;
+    broken[0] = 'X';
+    writeBytes(broken);
+    EXPECT_THROW(VirtualTexture texture(path), std::runtime_error);
+
+    broken = bytes;
+    broken.resize(broken.size() - 1); // Последняя страница обрезана
+    writeBytes(broken);
+    EXPECT_THROW(VirtualTexture texture(path), std::runtime_error);
+
+    broken = bytes;
+    uint32_t levelCount = 1; // Не сходится с размерами
+    std::memcpy(&broken[offsetof(VirtualTexture::Header, levelCount)], &levelCount, sizeof(levelCount));
+    writeBytes(broken);
+    EXPECT_THROW(VirtualTexture texture(path), std::runtime_error);
+
+    std::remove(path.c_str());
+}
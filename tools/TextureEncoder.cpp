@@ -0,0 +1,135 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include "BlockCompression.hpp"
+#include "Ktx2Texture.hpp"
+#include "MipChain.hpp"
+#include "Parallel.hpp"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Офлайн-сжатие текстур: PNG/JPG -> KTX2 с полной цепочкой мип-уровней в BC1,
+ * BC5 или BC7. Файл <имя>.ktx2 пишется рядом с исходным, и TextureManager
+ * подхватывает его вместо декодирования изображения, если он не старше
+ * исходника. Уровни строятся MipChain (для sRGB — в линейном пространстве),
+ * блоки кодируются на всех ядрах.
+ *
+ * Запуск: TextureEncoder [--format bc1|bc5|bc7] [--threads N] [--force] image...
+ *  - bc7 (по умолчанию) — цветные текстуры с альфой, 8 бит на пиксель;
+ *  - bc1 — цветные текстуры без плавной альфы, 4 бита на пиксель;
+ *  - bc5 — карты нормалей (каналы R и G, линейные), 8 бит на пиксель.
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct EncoderOptions {
+        BlockCompression::Format format = BlockCompression::Format::BC7;
+        unsigned threads = 0;
+        bool force = false;
+        std::vector<std::string> inputs;
+    };
+
+    EncoderOptions parseArguments(int argc, char** argv) {
+        EncoderOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (argument == "--format" && i + 1 < argc) {
+                const std::string format = argv[++i];
+                if (format == "bc1") {
+                    options.format = BlockCompression::Format::BC1;
+                } else if (format == "bc5") {
+                    options.format = BlockCompression::Format::BC5;
+                } else if (format == "bc7") {
+                    options.format = BlockCompression::Format::BC7;
+                } else {
+                    throw std::runtime_error("Unknown format: " + format + " (expected bc1, bc5 or bc7)");
+                }
+            } else if (argument == "--threads" && i + 1 < argc) {
+                options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (argument == "--force") {
+                options.force = true;
+            } else if (!argument.empty() && argument[0] == '-') {
+                throw std::runtime_error("Unknown option: " + argument);
+            } else {
+                options.inputs.push_back(argument);
+            }
+        }
+        if (options.inputs.empty()) {
+            throw std::runtime_error("Usage: TextureEncoder [--format bc1|bc5|bc7] [--threads N] [--force] image...");
+        }
+        return options;
+    }
+
+    VkFormat vulkanFormat(BlockCompression::Format format) {
+        switch (format) {
+            case BlockCompression::Format::BC1: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            case BlockCompression::Format::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+            case BlockCompression::Format::BC7: return VK_FORMAT_BC7_SRGB_BLOCK;
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    void encodeFile(const std::string& input, const EncoderOptions& options) {
+        const std::filesystem::path output = std::filesystem::path(input).replace_extension(".ktx2");
+        if (!options.force && std::filesystem::exists(output) &&
+            std::filesystem::last_write_time(output) >= std::filesystem::last_write_time(input)) {
+            std::cout << input << ": up to date" << std::endl;
+            return;
+        }
+
+        const auto start = Clock::now();
+        // Строки хранятся так же, как их загружает TextureManager: с переворотом по вертикали
+        int width, height, channels;
+        stbi_set_flip_vertically_on_load(true);
+        std::unique_ptr<stbi_uc, void (*)(void*)> pixels(
+            stbi_load(input.c_str(), &width, &height, &channels, STBI_rgb_alpha), stbi_image_free);
+        if (!pixels) {
+            throw std::runtime_error("Failed to load image: " + input);
+        }
+
+        // Карта нормалей хранит векторы, а не цвет: её уровни усредняются линейно
+        const bool srgb = options.format != BlockCompression::Format::BC5;
+        const std::vector<MipChain::Level> chain = MipChain::levels(width, height);
+        std::vector<uint8_t> tail(MipChain::chainSize(width, height) - chain[0].size());
+        MipChain::generate(pixels.get(), width, height, tail.data(), srgb, options.threads);
+
+        std::vector<std::vector<uint8_t>> levels;
+        size_t encodedBytes = 0;
+        for (size_t level = 0; level < chain.size(); ++level) {
+            const uint8_t* source = level == 0 ? pixels.get() : tail.data() + (chain[level].offset - chain[0].size());
+            levels.push_back(BlockCompression::encode(source, chain[level].width, chain[level].height,
+                                                      options.format, options.threads));
+            encodedBytes += levels.back().size();
+        }
+        Ktx2Texture::write(output.string(), vulkanFormat(options.format), width, height, levels);
+
+        const size_t rawBytes = chain.back().offset + chain.back().size();
+        std::cout << input << " -> " << output.string() << ": " << width << "x" << height << ", "
+                  << chain.size() << " levels, " << rawBytes / (1024.0 * 1024.0) << " MB RGBA8 -> "
+                  << encodedBytes / (1024.0 * 1024.0) << " MB (x" << static_cast<double>(rawBytes) / encodedBytes
+                  << ") in " << milliseconds(start) << " ms on " << Parallel::workerCount(options.threads)
+                  << " threads" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const EncoderOptions options = parseArguments(argc, argv);
+        for (const std::string& input : options.inputs) {
+            encodeFile(input, options);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include "MipChain.hpp"
+#include "Parallel.hpp"
+#include "VirtualTexture.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Офлайн-нарезка текстур на страницы: PNG/JPG -> .vtex (VirtualTexture) с
+ * цепочкой уровней до первого, помещающегося в одну страницу. Файл
+ * <имя>.vtex пишется рядом с исходным, и TextureManager рисует материал
+ * виртуальной текстурой, если он не старше исходника.
+ *
+ * Запуск: VirtualTextureBuilder [--tile N] [--border N] [--threads N] [--force]
+ *                               [--grid CxR --output file.vtex] image...
+ *  - --tile и --border — полезный размер страницы и рамка в текселях;
+ *  - --grid — изображения являются частями одной текстуры одинакового размера,
+ *    перечисленными по строкам сверху вниз. Так собираются текстуры больше
+ *    того, что stb_image декодирует за раз (около 2 ГБ пикселей).
+ */
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct BuilderOptions {
+        uint32_t tileSize = VirtualTexture::DEFAULT_TILE_SIZE;
+        uint32_t border = VirtualTexture::DEFAULT_BORDER;
+        uint32_t columns = 0; ///< 0 — каждое изображение отдельная текстура
+        uint32_t rows = 0;
+        std::string output;
+        unsigned threads = 0;
+        bool force = false;
+        std::vector<std::string> inputs;
+    };
+
+    BuilderOptions parseArguments(int argc, char** argv) {
+        BuilderOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (argument == "--tile" && i + 1 < argc) {
+                options.tileSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (argument == "--border" && i + 1 < argc) {
+                options.border = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (argument == "--grid" && i + 1 < argc) {
+                const std::string grid = argv[++i];
+                const size_t separator = grid.find('x');
+                if (separator == std::string::npos) {
+                    throw std::runtime_error("Invalid grid: " + grid + " (expected CxR, e.g. 4x4)");
+                }
+                options.columns = static_cast<uint32_t>(std::stoul(grid.substr(0, separator)));
+                options.rows = static_cast<uint32_t>(std::stoul(grid.substr(separator + 1)));
+            } else if (argument == "--output" && i + 1 < argc) {
+                options.output = argv[++i];
+            } else if (argument == "--threads" && i + 1 < argc) {
+                options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (argument == "--force") {
+                options.force = true;
+            } else if (!argument.empty() && argument[0] == '-') {
+                throw std::runtime_error("Unknown option: " + argument);
+            } else {
+                options.inputs.push_back(argument);
+            }
+        }
+        if (options.inputs.empty()) {
+            throw std::runtime_error("Usage: VirtualTextureBuilder [--tile N] [--border N] [--threads N] [--force] "
+                                     "[--grid CxR --output file.vtex] image...");
+        }
+        if (options.columns > 0 && size_t{options.columns} * options.rows != options.inputs.size()) {
+            throw std::runtime_error("--grid " + std::to_string(options.columns) + "x" +
+                                     std::to_string(options.rows) + " needs " +
+                                     std::to_string(options.columns * options.rows) + " images");
+        }
+        return options;
+    }
+
+    using Pixels = std::unique_ptr<stbi_uc, void (*)(void*)>;
+
+    /// Строки хранятся так же, как их загружает TextureManager: с переворотом по вертикали
+    Pixels loadImage(const std::string& path, int& width, int& height) {
+        int channels;
+        stbi_set_flip_vertically_on_load(true);
+        Pixels pixels(stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha), stbi_image_free);
+        if (!pixels) {
+            throw std::runtime_error("Failed to load image: " + path + " (" + stbi_failure_reason() + ")");
+        }
+        return pixels;
+    }
+
+    /**
+     * @brief Уровень 0 цепочки: одно изображение или части сетки, сложенные в одно
+     */
+    std::vector<uint8_t> loadBase(const std::vector<std::string>& inputs, const BuilderOptions& options,
+                                  uint32_t& width, uint32_t& height) {
+        const uint32_t columns = std::max(1u, options.columns);
+        const uint32_t rows = std::max(1u, options.rows);
+        std::vector<uint8_t> base;
+        uint32_t partWidth = 0;
+        uint32_t partHeight = 0;
+        for (size_t part = 0; part < inputs.size(); ++part) {
+            int w, h;
+            const Pixels pixels = loadImage(inputs[part], w, h);
+            if (part == 0) {
+                partWidth = static_cast<uint32_t>(w);
+                partHeight = static_cast<uint32_t>(h);
+                width = partWidth * columns;
+                height = partHeight * rows;
+                base.resize(MipChain::chainSize(width, height));
+            } else if (static_cast<uint32_t>(w) != partWidth || static_cast<uint32_t>(h) != partHeight) {
+                throw std::runtime_error("Grid image " + inputs[part] + " is " + std::to_string(w) + "x" +
+                                         std::to_string(h) + ", expected " + std::to_string(partWidth) + "x" +
+                                         std::to_string(partHeight));
+            }
+            // Части перечислены сверху вниз, а строки уровня хранятся снизу вверх
+            const size_t column = part % columns;
+            const size_t row = rows - 1 - part / columns;
+            const size_t rowBytes = size_t{partWidth} * 4;
+            for (uint32_t y = 0; y < partHeight; ++y) {
+                std::memcpy(&base[((row * partHeight + y) * width + column * partWidth) * 4],
+                            pixels.get() + y * rowBytes, rowBytes);
+            }
+        }
+        return base;
+    }
+
+    void buildTexture(const std::vector<std::string>& inputs, const std::string& output, const BuilderOptions& options) {
+        if (!options.force && std::filesystem::exists(output)) {
+            bool upToDate = true;
+            for (const std::string& input : inputs) {
+                upToDate = upToDate && std::filesystem::last_write_time(output) >= std::filesystem::last_write_time(input);
+            }
+            if (upToDate) {
+                std::cout << output << ": up to date" << std::endl;
+                return;
+            }
+        }
+
+        const auto start = Clock::now();
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> chain = loadBase(inputs, options, width, height);
+        const std::vector<MipChain::Level> levels = MipChain::levels(width, height);
+        MipChain::generate(chain.data(), width, height, chain.data() + levels[0].size(), true, options.threads);
+
+        std::vector<const uint8_t*> levelData;
+        for (const MipChain::Level& level : levels) {
+            levelData.push_back(chain.data() + level.offset);
+        }
+        VirtualTexture::write(output, width, height, levelData, options.tileSize, options.border);
+
+        const VirtualTexture texture(output);
+        std::cout << output << ": " << width << "x" << height << ", " << texture.getLevelCount() << " levels, "
+                  << texture.getTileCount() << " pages of " << texture.getPageExtent() << "x"
+                  << texture.getPageExtent() << ", " << std::filesystem::file_size(output) / (1024.0 * 1024.0)
+                  << " MB in " << milliseconds(start) << " ms on " << Parallel::workerCount(options.threads)
+                  << " threads" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        const BuilderOptions options = parseArguments(argc, argv);
+        if (options.columns > 0) {
+            const std::string output = !options.output.empty() ? options.output
+                : std::filesystem::path(options.inputs[0]).replace_extension(VirtualTexture::EXTENSION).string();
+            buildTexture(options.inputs, output, options);
+        } else {
+            for (const std::string& input : options.inputs) {
+                buildTexture({input}, std::filesystem::path(input).replace_extension(VirtualTexture::EXTENSION).string(),
+                             options);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}